@@ -7,6 +7,7 @@
 #include <cstdint>
 #include <iterator>
 #include <memory>
+#include <random>
 #include <set>
 #include <vector>
 
@@ -472,3 +473,133 @@ UNIT_TEST(CompressedBitVector_SparseLeaveFirstNBits)
   for (uint64_t bit = 0; bit < (1 << 10); ++bit)
     TEST(!cbv->GetBit(bit), (bit));
 }
+
+namespace
+{
+// Set bits of all kinds of chunks: sparse positions, long runs and a dense random bitmap.
+vector<uint64_t> GetChunkedSetBits(uint32_t seed)
+{
+  uint64_t const kChunkSize = coding::ChunkedCBV::kChunkSize;
+  mt19937 rng(seed);
+  set<uint64_t> bits;
+  for (size_t i = 0; i < 3000; ++i)
+    bits.insert(rng() % kChunkSize);
+  for (uint64_t i = 1000 + seed; i < 30000; ++i)
+    bits.insert(kChunkSize + i);
+  for (size_t i = 0; i < kChunkSize; ++i)
+  {
+    if (rng() % 2 == 0)
+      bits.insert(3 * kChunkSize + i);
+  }
+  for (size_t i = 0; i < 100; ++i)
+    bits.insert(5 * kChunkSize + rng() % (2 * kChunkSize));
+  return vector<uint64_t>(bits.begin(), bits.end());
+}
+
+vector<uint64_t> GetSetBits(coding::CompressedBitVector const & cbv)
+{
+  vector<uint64_t> result;
+  coding::CompressedBitVectorEnumerator::ForEach(cbv, [&](uint64_t pos) { result.push_back(pos); });
+  return result;
+}
+}  // namespace
+
+UNIT_TEST(CompressedBitVector_Chunked)
+{
+  auto setBits = GetChunkedSetBits(0);
+  coding::ChunkedCBV const cbv(setBits);
+  TEST_EQUAL(cbv.PopCount(), setBits.size(), ());
+  TEST_EQUAL(cbv.NumChunks(), 5, ());
+  TEST_EQUAL(GetSetBits(cbv), setBits, ());
+  for (uint64_t pos = 0; pos < 8 * coding::ChunkedCBV::kChunkSize; pos += 7)
+    TEST_EQUAL(cbv.GetBit(pos), binary_search(setBits.begin(), setBits.end(), pos), (pos));
+
+  auto const first = cbv.LeaveFirstSetNBits(5000);
+  TEST_EQUAL(GetSetBits(*first), vector<uint64_t>(setBits.begin(), setBits.begin() + 5000), ());
+
+  auto const built = coding::CompressedBitVectorBuilder::FromBitPositions(setBits);
+  TEST_EQUAL(built->GetStorageStrategy(), coding::CompressedBitVector::StorageStrategy::Chunked,
+             ());
+
+  auto const stored = coding::CompressedBitVectorBuilder::FromBitPositionsDenseOrSparse(setBits);
+  TEST_NOT_EQUAL(stored->GetStorageStrategy(),
+                 coding::CompressedBitVector::StorageStrategy::Chunked, ());
+  TEST_EQUAL(GetSetBits(*stored), setBits, ());
+}
+
+UNIT_TEST(CompressedBitVector_ChunkedOps)
+{
+  using Strategy = coding::CompressedBitVector::StorageStrategy;
+
+  auto setBits1 = GetChunkedSetBits(1);
+  auto setBits2 = GetChunkedSetBits(2);
+
+  // Dense and sparse vectors of a half of the bits of the second vector.
+  vector<uint64_t> denseBits;
+  vector<uint64_t> sparseBits;
+  for (size_t i = 0; i < setBits2.size(); i += 2)
+  {
+    if (setBits2[i] < 2 * coding::ChunkedCBV::kChunkSize)
+      denseBits.push_back(setBits2[i]);
+    sparseBits.push_back(setBits2[i]);
+  }
+
+  coding::ChunkedCBV const chunked1(setBits1);
+  vector<unique_ptr<coding::CompressedBitVector>> cbvs;
+  cbvs.push_back(make_unique<coding::ChunkedCBV>(setBits2));
+  cbvs.push_back(make_unique<coding::DenseCBV>(denseBits));
+  cbvs.push_back(make_unique<coding::SparseCBV>(sparseBits));
+  vector<vector<uint64_t>> cbvsBits = {setBits2, denseBits, sparseBits};
+
+  for (size_t i = 0; i < cbvs.size(); ++i)
+  {
+    auto & bits = cbvsBits[i];
+    auto const & cbv = *cbvs[i];
+    auto const strategy = cbv.GetStorageStrategy();
+
+    vector<uint64_t> expected;
+    Intersect(setBits1, bits, expected);
+    TEST_EQUAL(GetSetBits(*coding::CompressedBitVector::Intersect(chunked1, cbv)), expected,
+               (strategy));
+    TEST_EQUAL(GetSetBits(*coding::CompressedBitVector::Intersect(cbv, chunked1)), expected,
+               (strategy));
+
+    expected.clear();
+    Union(setBits1, bits, expected);
+    TEST_EQUAL(GetSetBits(*coding::CompressedBitVector::Union(chunked1, cbv)), expected, (strategy));
+    TEST_EQUAL(GetSetBits(*coding::CompressedBitVector::Union(cbv, chunked1)), expected, (strategy));
+
+    expected.clear();
+    Subtract(setBits1, bits, expected);
+    auto const difference = coding::CompressedBitVector::Subtract(chunked1, cbv);
+    TEST_EQUAL(difference->GetStorageStrategy(), Strategy::Chunked, ());
+    TEST_EQUAL(GetSetBits(*difference), expected, (strategy));
+    TEST_EQUAL(difference->PopCount(), expected.size(), (strategy));
+
+    expected.clear();
+    Subtract(bits, setBits1, expected);
+    TEST_EQUAL(GetSetBits(*coding::CompressedBitVector::Subtract(cbv, chunked1)), expected,
+               (strategy));
+  }
+}
+
+UNIT_TEST(CompressedBitVector_SerializationChunked)
+{
+  auto const setBits = GetChunkedSetBits(3);
+  vector<uint8_t> buf;
+  {
+    MemWriter<vector<uint8_t>> writer(buf);
+    coding::ChunkedCBV(setBits).Serialize(writer);
+  }
+  // Chunked vectors are written as dense or sparse ones.
+  TEST(!buf.empty(), ());
+  TEST_LESS_OR_EQUAL(buf[0], 1, ());
+
+  MemReader reader(buf.data(), buf.size());
+  auto cbv = coding::CompressedBitVectorBuilder::DeserializeFromReader(reader);
+  TEST(cbv.get(), ());
+  TEST_NOT_EQUAL(coding::CompressedBitVector::StorageStrategy::Chunked, cbv->GetStorageStrategy(),
+                 ());
+  TEST_EQUAL(setBits.size(), cbv->PopCount(), ());
+  TEST_EQUAL(GetSetBits(*cbv), setBits, ());
+}
@@ -1,3 +1,4 @@
+#include "testing/benchmark.hpp"
 #include "testing/testing.hpp"
 
 #include "coding/byte_stream.hpp"
@@ -16,6 +17,7 @@
 
 #include <cstddef>
 #include <cstdint>
+#include <random>
 #include <vector>
 
 using namespace coding;
@@ -82,6 +84,99 @@ void TestEncodePolyline(string name, m2::PointU maxPoint, vector<m2::PointU> con
   TestPolylineEncode(name + "2", points, maxPoint, &EncodePolylinePrev2, &DecodePolylinePrev2);
   TestPolylineEncode(name + "3", points, maxPoint, &EncodePolylinePrev3, &DecodePolylinePrev3);
 }
+
+vector<m2::PointU> GetLargePolygon()
+{
+  size_t const count = ARRAY_SIZE(LargePolygon::kLargePolygon);
+  vector<m2::PointU> points;
+  points.reserve(count);
+  for (size_t i = 0; i < count; ++i)
+  {
+    points.push_back(
+        m2::PointU(static_cast<uint32_t>(LargePolygon::kLargePolygon[i].x * 10000),
+                   static_cast<uint32_t>((LargePolygon::kLargePolygon[i].y + 200) * 10000)));
+  }
+  return points;
+}
+
+// Floating point predictions and decoders which decode every delta just before its point.
+// The current predictions and decoders must return the same points.
+m2::PointU ClampPoint(m2::PointD const & maxPoint, m2::PointD const & p)
+{
+  return m2::PointU(static_cast<uint32_t>(base::Clamp(p.x, 0.0, maxPoint.x)),
+                    static_cast<uint32_t>(base::Clamp(p.y, 0.0, maxPoint.y)));
+}
+
+m2::PointU PredictPointInPolylineReference(m2::PointD const & maxPoint, m2::PointU const & p1,
+                                           m2::PointU const & p2)
+{
+  return ClampPoint(maxPoint, PD(p1) + (PD(p1) - PD(p2)) / 2.0);
+}
+
+m2::PointU PredictPointInTriangleReference(m2::PointD const & maxPoint, m2::PointU const & p1,
+                                           m2::PointU const & p2, m2::PointU const & p3)
+{
+  return ClampPoint(maxPoint, PD(p1 + p2) - PD(p3));
+}
+
+void DecodePolylinePrev2Reference(InDeltasT const & deltas, m2::PointU const & basePoint,
+                                  m2::PointU const & maxPoint, OutPointsT & points)
+{
+  size_t const count = deltas.size();
+  if (count == 0)
+    return;
+
+  points.push_back(DecodePointDeltaFromUint(deltas[0], basePoint));
+  if (count == 1)
+    return;
+
+  m2::PointD const maxPointD(maxPoint);
+  points.push_back(DecodePointDeltaFromUint(deltas[1], points.back()));
+  for (size_t i = 2; i < count; ++i)
+  {
+    size_t const n = points.size();
+    points.push_back(DecodePointDeltaFromUint(
+        deltas[i], PredictPointInPolylineReference(maxPointD, points[n - 1], points[n - 2])));
+  }
+}
+
+void DecodeTriangleStripReference(InDeltasT const & deltas, m2::PointU const & basePoint,
+                                  m2::PointU const & maxPoint, OutPointsT & points)
+{
+  size_t const count = deltas.size();
+  points.push_back(DecodePointDeltaFromUint(deltas[0], basePoint));
+  points.push_back(DecodePointDeltaFromUint(deltas[1], points.back()));
+  points.push_back(DecodePointDeltaFromUint(deltas[2], points.back()));
+
+  m2::PointD const maxPointD(maxPoint);
+  for (size_t i = 3; i < count; ++i)
+  {
+    size_t const n = points.size();
+    m2::PointU const prediction =
+        PredictPointInTriangleReference(maxPointD, points[n - 1], points[n - 2], points[n - 3]);
+    points.push_back(DecodePointDeltaFromUint(deltas[i], prediction));
+  }
+}
+
+using DecodeFn = void (*)(InDeltasT const & deltas, m2::PointU const & basePoint,
+                          m2::PointU const & maxPoint, OutPointsT & points);
+
+vector<m2::PointU> Decode(DecodeFn fn, vector<uint64_t> const & deltas, m2::PointU const & maxPoint)
+{
+  vector<m2::PointU> points(deltas.size());
+  OutPointsT pointsA(points);
+  fn(make_read_adapter(deltas), m2::PointU::Zero(), maxPoint, pointsA);
+  return points;
+}
+
+vector<uint64_t> EncodeLargePolygon()
+{
+  auto const points = GetLargePolygon();
+  vector<uint64_t> deltas(points.size());
+  OutDeltasT deltasA(deltas);
+  EncodePolylinePrev2(make_read_adapter(points), m2::PointU::Zero(), GetMaxPoint(), deltasA);
+  return deltas;
+}
 }  // namespace
 
 UNIT_TEST(EncodePointDeltaAsUint)
@@ -155,15 +250,10 @@ UNIT_TEST(EncodePolyline)
 {
   size_t const kSizes[] = {0, 1, 2, 3, 4, ARRAY_SIZE(LargePolygon::kLargePolygon)};
   m2::PointU const maxPoint(1000000000, 1000000000);
+  auto const largePolygon = GetLargePolygon();
   for (size_t iSize = 0; iSize < ARRAY_SIZE(kSizes); ++iSize)
   {
-    size_t const polygonSize = kSizes[iSize];
-    vector<m2::PointU> points;
-    points.reserve(polygonSize);
-    for (size_t i = 0; i < polygonSize; ++i)
-      points.push_back(
-          m2::PointU(static_cast<uint32_t>(LargePolygon::kLargePolygon[i].x * 10000),
-                     static_cast<uint32_t>((LargePolygon::kLargePolygon[i].y + 200) * 10000)));
+    vector<m2::PointU> points(largePolygon.begin(), largePolygon.begin() + kSizes[iSize]);
 
     TestEncodePolyline("Unsimp", maxPoint, points);
     TestEncodePolyline("1simp", maxPoint, SimplifyPoints(points, 1));
@@ -190,3 +280,68 @@ UNIT_TEST(DecodeEncodePolyline_DataSet1)
 
   TestPolylineEncode("DataSet1", points, GetMaxPoint(), &EncodePolyline, &DecodePolyline);
 }
+
+UNIT_TEST(EncodeTriangleStrip)
+{
+  auto const points = GetLargePolygon();
+  TestPolylineEncode("TriangleStrip", points, m2::PointU(1000000000, 1000000000),
+                     &EncodeTriangleStrip, &DecodeTriangleStrip);
+}
+
+UNIT_TEST(PredictPoints_SameAsFloatingPoint)
+{
+  mt19937 rng(0);
+  uniform_int_distribution<uint32_t> coord(0, 1U << 30);
+  for (size_t i = 0; i < 100000; ++i)
+  {
+    m2::PointD const maxPoint(coord(rng), coord(rng));
+    PU const p1(coord(rng), coord(rng));
+    PU const p2(coord(rng), coord(rng));
+    PU const p3(coord(rng), coord(rng));
+
+    TEST_EQUAL(PredictPointInPolyline(maxPoint, p1, p2),
+               PredictPointInPolylineReference(maxPoint, p1, p2), (maxPoint, p1, p2));
+    TEST_EQUAL(PredictPointInTriangle(maxPoint, p1, p2, p3),
+               PredictPointInTriangleReference(maxPoint, p1, p2, p3), (maxPoint, p1, p2, p3));
+  }
+}
+
+UNIT_TEST(DecodePolyline_RandomDeltas)
+{
+  // Arbitrary deltas overflow coordinates, decoded points must wrap around in the same way.
+  mt19937_64 rng(0);
+  for (size_t count : {1, 2, 3, 4, 7, 8, 9, 63, 64, 65, 1000})
+  {
+    vector<uint64_t> deltas(count);
+    for (auto & d : deltas)
+      d = rng() | 1;
+
+    TEST_EQUAL(Decode(&DecodePolylinePrev2, deltas, GetMaxPoint()),
+               Decode(&DecodePolylinePrev2Reference, deltas, GetMaxPoint()), (count));
+    if (count > 2)
+    {
+      TEST_EQUAL(Decode(&DecodeTriangleStrip, deltas, GetMaxPoint()),
+                 Decode(&DecodeTriangleStripReference, deltas, GetMaxPoint()), (count));
+    }
+  }
+}
+
+#ifndef DEBUG
+BENCHMARK_TEST(DecodePolylinePrev2_Reference)
+{
+  auto const deltas = EncodeLargePolygon();
+  BENCHMARK_N_TIMES(10000, 5.0)
+  {
+    FORCE_USE_VALUE(Decode(&DecodePolylinePrev2Reference, deltas, GetMaxPoint()).back().x);
+  }
+}
+
+BENCHMARK_TEST(DecodePolylinePrev2)
+{
+  auto const deltas = EncodeLargePolygon();
+  BENCHMARK_N_TIMES(10000, 5.0)
+  {
+    FORCE_USE_VALUE(Decode(&DecodePolylinePrev2, deltas, GetMaxPoint()).back().x);
+  }
+}
+#endif
@@ -181,3 +181,48 @@ UNIT_TEST(ReadVarInt64Array)
   }
 }
 
+
+UNIT_TEST(ReadVarUint64Array_OneByteRuns)
+{
+  // Runs of one byte varints of different lengths interleaved with long varints.
+  vector<uint64_t> values;
+  for (size_t run = 0; run < 20; ++run)
+  {
+    for (size_t i = 0; i < run; ++i)
+      values.push_back((run * 31 + i) % 128);
+    values.push_back(128 + run);
+    values.push_back(0xFFFFFFFFFFULL + run);
+  }
+  for (size_t i = 0; i < 100; ++i)
+    values.push_back(i);
+
+  vector<uint8_t> data;
+  {
+    PushBackByteSink<vector<uint8_t>> dst(data);
+    for (auto const v : values)
+      WriteVarUint(dst, v);
+  }
+
+  for (size_t count = 0; count <= values.size(); ++count)
+  {
+    vector<uint64_t> const expected(values.begin(), values.begin() + count);
+
+    ArrayByteSource src(data.data());
+    for (size_t i = 0; i < count; ++i)
+      ReadVarUint<uint64_t>(src);
+    void const * pDataEnd = src.Ptr();
+
+    {
+      vector<uint64_t> result;
+      void const * pEnd = ReadVarUint64Array(data.data(), pDataEnd, base::MakeBackInsertFunctor(result));
+      TEST_EQUAL(pEnd, pDataEnd, ("UntilBufferEnd", count));
+      TEST_EQUAL(result, expected, ("UntilBufferEnd", count));
+    }
+    {
+      vector<uint64_t> result;
+      void const * pEnd = ReadVarUint64Array(data.data(), count, base::MakeBackInsertFunctor(result));
+      TEST_EQUAL(pEnd, pDataEnd, ("GivenSize", count));
+      TEST_EQUAL(result, expected, ("GivenSize", count));
+    }
+  }
+}
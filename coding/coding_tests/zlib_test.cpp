@@ -70,6 +70,30 @@ UNIT_TEST(ZLib_Large)
   TestDeflateInflate(original);
 }
 
+UNIT_TEST(ZLib_MaxOutSize)
+{
+  string const original(100000, 'a');
+
+  Deflate const deflate(Deflate::Format::ZLib, Deflate::Level::BestCompression);
+  Inflate const inflate(Inflate::Format::ZLib);
+
+  string compressed;
+  TEST(deflate(original, back_inserter(compressed)), ());
+
+  {
+    string s;
+    TEST(inflate(compressed.data(), compressed.size(), original.size(), back_inserter(s)), ());
+    TEST_EQUAL(s, original, ());
+  }
+
+  {
+    string s;
+    TEST(!inflate(compressed.data(), compressed.size(), original.size() - 1, back_inserter(s)),
+         ());
+    TEST_LESS_OR_EQUAL(s.size(), original.size() - 1, ());
+  }
+}
+
 UNIT_TEST(GZip_ForeignData)
 {
   // To get this array of bytes, type following:
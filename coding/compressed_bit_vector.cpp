@@ -6,6 +6,7 @@
 #include "base/bits.hpp"
 
 #include <algorithm>
+#include <limits>
 
 namespace coding
 {
@@ -55,6 +56,16 @@ struct IntersectOp
     set_intersection(a.Begin(), a.End(), b.Begin(), b.End(), back_inserter(resPos));
     return make_unique<coding::SparseCBV>(std::move(resPos));
   }
+
+  // The smaller vector is copied to the result.
+  unique_ptr<coding::CompressedBitVector> operator()(coding::ChunkedCBV const & a,
+                                                     coding::ChunkedCBV const & b) const
+  {
+    bool const aIsSmaller = a.DataSize() <= b.DataSize();
+    auto res = ChunkedCBV::FromCBV(aIsSmaller ? a : b);
+    res->IntersectWith(aIsSmaller ? b : a);
+    return res;
+  }
 };
 
 struct SubtractOp
@@ -118,6 +129,14 @@ struct SubtractOp
     set_difference(a.Begin(), a.End(), b.Begin(), b.End(), back_inserter(resPos));
     return CompressedBitVectorBuilder::FromBitPositions(std::move(resPos));
   }
+
+  unique_ptr<coding::CompressedBitVector> operator()(coding::ChunkedCBV const & a,
+                                                     coding::ChunkedCBV const & b) const
+  {
+    auto res = ChunkedCBV::FromCBV(a);
+    res->SubtractWith(b);
+    return res;
+  }
 };
 
 struct UnionOp
@@ -211,6 +230,16 @@ struct UnionOp
     set_union(a.Begin(), a.End(), b.Begin(), b.End(), back_inserter(resPos));
     return CompressedBitVectorBuilder::FromBitPositions(std::move(resPos));
   }
+
+  // The larger vector is copied to the result.
+  unique_ptr<coding::CompressedBitVector> operator()(coding::ChunkedCBV const & a,
+                                                     coding::ChunkedCBV const & b) const
+  {
+    bool const aIsLarger = a.DataSize() >= b.DataSize();
+    auto res = ChunkedCBV::FromCBV(aIsLarger ? a : b);
+    res->UniteWith(aIsLarger ? b : a);
+    return res;
+  }
 };
 
 template <typename TBinaryOp>
@@ -220,6 +249,22 @@ unique_ptr<coding::CompressedBitVector> Apply(TBinaryOp const & op, CompressedBi
   using strat = CompressedBitVector::StorageStrategy;
   auto const stratA = lhs.GetStorageStrategy();
   auto const stratB = rhs.GetStorageStrategy();
+  if (stratA == strat::Chunked || stratB == strat::Chunked)
+  {
+    // The other vector is converted because chunked vectors are the large ones.
+    unique_ptr<ChunkedCBV> converted;
+    if (stratA != strat::Chunked)
+    {
+      converted = ChunkedCBV::FromCBV(lhs);
+      return op(*converted, static_cast<ChunkedCBV const &>(rhs));
+    }
+    if (stratB != strat::Chunked)
+    {
+      converted = ChunkedCBV::FromCBV(rhs);
+      return op(static_cast<ChunkedCBV const &>(lhs), *converted);
+    }
+    return op(static_cast<ChunkedCBV const &>(lhs), static_cast<ChunkedCBV const &>(rhs));
+  }
   if (stratA == strat::Dense && stratB == strat::Dense)
   {
     DenseCBV const & a = static_cast<DenseCBV const &>(lhs);
@@ -259,18 +304,299 @@ bool DenseEnough(uint64_t popCount, uint64_t totalBits)
   return popCount * 10 >= totalBits * 3;
 }
 
+// |allowChunked| is false for vectors which are written to mwms, see
+// CompressedBitVectorBuilder::FromBitPositionsDenseOrSparse.
 template <typename TBitPositions>
-unique_ptr<CompressedBitVector> BuildFromBitPositions(TBitPositions && setBits)
+unique_ptr<CompressedBitVector> BuildFromBitPositions(TBitPositions && setBits, bool allowChunked)
 {
   if (setBits.empty())
     return make_unique<SparseCBV>(std::forward<TBitPositions>(setBits));
   uint64_t const maxBit = *max_element(setBits.begin(), setBits.end());
+  bool const denseEnough = DenseEnough(setBits.size(), maxBit);
 
-  if (DenseEnough(setBits.size(), maxBit))
+  // Small vectors don't gain anything from chunks.
+  uint64_t const kMinChunkedPopCount = 1024;
+  if (allowChunked && setBits.size() >= kMinChunkedPopCount &&
+      is_sorted(setBits.begin(), setBits.end()))
+  {
+    auto chunked = make_unique<ChunkedCBV>(setBits);
+    uint64_t const size = denseEnough ? (maxBit / DenseCBV::kBlockSize + 1) * sizeof(uint64_t)
+                                      : setBits.size() * sizeof(uint64_t);
+    if (chunked->DataSize() * 2 <= size)
+      return chunked;
+  }
+
+  if (denseEnough)
     return make_unique<DenseCBV>(std::forward<TBitPositions>(setBits));
 
   return make_unique<SparseCBV>(std::forward<TBitPositions>(setBits));
 }
+
+using Chunk = ChunkedCBV::Chunk;
+
+bool GetChunkBit(Chunk const & chunk, uint16_t pos)
+{
+  switch (chunk.m_type)
+  {
+  case Chunk::Type::Array:
+    return binary_search(chunk.m_values.begin(), chunk.m_values.end(), pos);
+  case Chunk::Type::Bitmap:
+    return ((chunk.m_bitmap[pos / 64] >> (pos % 64)) & 1) > 0;
+  case Chunk::Type::Runs:
+  {
+    // Looks for the last run which starts not after |pos|.
+    size_t lo = 0;
+    size_t hi = chunk.m_values.size() / 2;
+    while (lo < hi)
+    {
+      size_t const mid = lo + (hi - lo) / 2;
+      if (chunk.m_values[2 * mid] <= pos)
+        lo = mid + 1;
+      else
+        hi = mid;
+    }
+    return lo > 0 && pos <= chunk.m_values[2 * lo - 1];
+  }
+  }
+  UNREACHABLE();
+}
+
+// Sets bits from |first| to |last| inclusive.
+void SetBits(vector<uint64_t> & bitmap, uint32_t first, uint32_t last)
+{
+  for (uint32_t i = first; i <= last;)
+  {
+    uint32_t const offset = i % 64;
+    uint32_t const count = min<uint32_t>(64 - offset, last - i + 1);
+    bitmap[i / 64] |= (count == 64 ? ~uint64_t{0} : ((uint64_t{1} << count) - 1)) << offset;
+    i += count;
+  }
+}
+
+// Returns the bitmap of |chunk|, the bitmap of a Bitmap chunk is moved out of it.
+vector<uint64_t> TakeBitmap(Chunk & chunk)
+{
+  if (chunk.m_type == Chunk::Type::Bitmap)
+    return std::move(chunk.m_bitmap);
+
+  vector<uint64_t> bitmap(ChunkedCBV::kBitGroupsPerChunk);
+  if (chunk.m_type == Chunk::Type::Array)
+  {
+    for (auto const v : chunk.m_values)
+      bitmap[v / 64] |= uint64_t{1} << (v % 64);
+  }
+  else
+  {
+    for (size_t i = 0; i < chunk.m_values.size(); i += 2)
+      SetBits(bitmap, chunk.m_values[i], chunk.m_values[i + 1]);
+  }
+  return bitmap;
+}
+
+vector<uint64_t> GetBitmap(Chunk const & chunk)
+{
+  if (chunk.m_type == Chunk::Type::Bitmap)
+    return chunk.m_bitmap;
+  Chunk copy;
+  copy.m_type = chunk.m_type;
+  copy.m_values = chunk.m_values;
+  return TakeBitmap(copy);
+}
+
+// Stores |bitmap| in |chunk| in the most compact form.
+void SetBitmap(Chunk & chunk, vector<uint64_t> && bitmap)
+{
+  ASSERT_EQUAL(bitmap.size(), ChunkedCBV::kBitGroupsPerChunk, ());
+
+  // These loops have no dependencies between iterations but sums, so they are vectorized.
+  uint32_t popCount = 0;
+  for (auto const group : bitmap)
+    popCount += bits::PopCount(group);
+
+  // A run starts at every set bit whose previous bit is not set.
+  uint32_t numRuns = bits::PopCount(bitmap[0] & ~(bitmap[0] << 1));
+  for (size_t i = 1; i < bitmap.size(); ++i)
+    numRuns += bits::PopCount(bitmap[i] & ~((bitmap[i] << 1) | (bitmap[i - 1] >> 63)));
+
+  chunk.m_popCount = popCount;
+  chunk.m_values.clear();
+  chunk.m_bitmap.clear();
+
+  size_t const bitmapSize = bitmap.size() * sizeof(uint64_t);
+  size_t const arraySize =
+      popCount <= ChunkedCBV::kMaxArraySize ? popCount * sizeof(uint16_t) : bitmapSize;
+  size_t const runsSize = numRuns * 2 * sizeof(uint16_t);
+
+  if (runsSize < min(arraySize, bitmapSize))
+  {
+    chunk.m_type = Chunk::Type::Runs;
+    chunk.m_values.reserve(2 * numRuns);
+    bool inRun = false;
+    for (uint32_t i = 0; i < ChunkedCBV::kChunkSize; ++i)
+    {
+      bool const isSet = ((bitmap[i / 64] >> (i % 64)) & 1) > 0;
+      if (isSet && !inRun)
+        chunk.m_values.push_back(static_cast<uint16_t>(i));
+      else if (!isSet && inRun)
+        chunk.m_values.push_back(static_cast<uint16_t>(i - 1));
+      inRun = isSet;
+    }
+    if (inRun)
+      chunk.m_values.push_back(static_cast<uint16_t>(ChunkedCBV::kChunkSize - 1));
+  }
+  else if (arraySize < bitmapSize)
+  {
+    chunk.m_type = Chunk::Type::Array;
+    chunk.m_values.reserve(popCount);
+    for (size_t i = 0; i < bitmap.size(); ++i)
+    {
+      for (uint64_t group = bitmap[i]; group != 0; group &= group - 1)
+      {
+        auto const j = bits::PopCount((group & (~group + 1)) - 1);
+        chunk.m_values.push_back(static_cast<uint16_t>(64 * i + j));
+      }
+    }
+  }
+  else
+  {
+    chunk.m_type = Chunk::Type::Bitmap;
+    chunk.m_bitmap = std::move(bitmap);
+  }
+}
+
+// Stores sorted |values| in |chunk| in the most compact form.
+void SetValues(Chunk & chunk, vector<uint16_t> && values)
+{
+  size_t numRuns = 0;
+  for (size_t i = 0; i < values.size(); ++i)
+  {
+    if (i == 0 || values[i] != values[i - 1] + 1)
+      ++numRuns;
+  }
+
+  chunk.m_type = Chunk::Type::Array;
+  chunk.m_popCount = static_cast<uint32_t>(values.size());
+  chunk.m_values = std::move(values);
+  chunk.m_bitmap.clear();
+
+  // Lets SetBitmap choose between runs and a bitmap.
+  if (chunk.m_popCount > ChunkedCBV::kMaxArraySize || numRuns * 2 < chunk.m_popCount)
+    SetBitmap(chunk, TakeBitmap(chunk));
+}
+
+// Keeps the bits of |a| which are set (if |keep| is true) or not set in |b|.
+void FilterValues(Chunk & a, Chunk const & b, bool keep)
+{
+  ASSERT(a.m_type == Chunk::Type::Array, ());
+  auto & values = a.m_values;
+  values.erase(remove_if(values.begin(), values.end(),
+                         [&](uint16_t v) { return GetChunkBit(b, v) != keep; }),
+               values.end());
+  a.m_popCount = static_cast<uint32_t>(values.size());
+}
+
+// Returns false if the result is empty.
+bool IntersectChunk(Chunk & a, Chunk const & b)
+{
+  if (a.m_type == Chunk::Type::Array && b.m_type == Chunk::Type::Array)
+  {
+    // The output range of set_intersection must not overlap the input ones.
+    vector<uint16_t> values;
+    values.reserve(min(a.m_values.size(), b.m_values.size()));
+    set_intersection(a.m_values.begin(), a.m_values.end(), b.m_values.begin(), b.m_values.end(),
+                     back_inserter(values));
+    a.m_values = std::move(values);
+    a.m_popCount = static_cast<uint32_t>(a.m_values.size());
+  }
+  else if (a.m_type == Chunk::Type::Array)
+  {
+    FilterValues(a, b, true /* keep */);
+  }
+  else if (b.m_type == Chunk::Type::Array)
+  {
+    Chunk res;
+    res.m_key = a.m_key;
+    res.m_values = b.m_values;
+    FilterValues(res, a, true /* keep */);
+    a = std::move(res);
+  }
+  else
+  {
+    auto bitmap = TakeBitmap(a);
+    if (b.m_type == Chunk::Type::Bitmap)
+    {
+      for (size_t i = 0; i < bitmap.size(); ++i)
+        bitmap[i] &= b.m_bitmap[i];
+    }
+    else
+    {
+      auto const other = GetBitmap(b);
+      for (size_t i = 0; i < bitmap.size(); ++i)
+        bitmap[i] &= other[i];
+    }
+    SetBitmap(a, std::move(bitmap));
+  }
+  return a.m_popCount != 0;
+}
+
+// Returns false if the result is empty.
+bool SubtractChunk(Chunk & a, Chunk const & b)
+{
+  if (a.m_type == Chunk::Type::Array)
+  {
+    FilterValues(a, b, false /* keep */);
+    return a.m_popCount != 0;
+  }
+
+  auto bitmap = TakeBitmap(a);
+  if (b.m_type == Chunk::Type::Array)
+  {
+    for (auto const v : b.m_values)
+      bitmap[v / 64] &= ~(uint64_t{1} << (v % 64));
+  }
+  else
+  {
+    auto const other = b.m_type == Chunk::Type::Bitmap ? vector<uint64_t>() : GetBitmap(b);
+    auto const & groups = b.m_type == Chunk::Type::Bitmap ? b.m_bitmap : other;
+    for (size_t i = 0; i < bitmap.size(); ++i)
+      bitmap[i] &= ~groups[i];
+  }
+  SetBitmap(a, std::move(bitmap));
+  return a.m_popCount != 0;
+}
+
+void UniteChunk(Chunk & a, Chunk const & b)
+{
+  if (a.m_type == Chunk::Type::Array && b.m_type == Chunk::Type::Array &&
+      a.m_popCount + b.m_popCount <= ChunkedCBV::kMaxArraySize)
+  {
+    vector<uint16_t> values;
+    values.reserve(a.m_values.size() + b.m_values.size());
+    set_union(a.m_values.begin(), a.m_values.end(), b.m_values.begin(), b.m_values.end(),
+              back_inserter(values));
+    a.m_values = std::move(values);
+    a.m_popCount = static_cast<uint32_t>(a.m_values.size());
+    return;
+  }
+
+  auto bitmap = TakeBitmap(a);
+  switch (b.m_type)
+  {
+  case Chunk::Type::Array:
+    for (auto const v : b.m_values)
+      bitmap[v / 64] |= uint64_t{1} << (v % 64);
+    break;
+  case Chunk::Type::Bitmap:
+    for (size_t i = 0; i < bitmap.size(); ++i)
+      bitmap[i] |= b.m_bitmap[i];
+    break;
+  case Chunk::Type::Runs:
+    for (size_t i = 0; i < b.m_values.size(); i += 2)
+      SetBits(bitmap, b.m_values[i], b.m_values[i + 1]);
+    break;
+  }
+  SetBitmap(a, std::move(bitmap));
+}
 }  // namespace
 
 // static
@@ -417,18 +743,237 @@ unique_ptr<CompressedBitVector> SparseCBV::Clone() const
   return unique_ptr<CompressedBitVector>(cbv);
 }
 
+// static
+uint64_t const ChunkedCBV::kChunkSize;
+size_t const ChunkedCBV::kBitGroupsPerChunk;
+uint32_t const ChunkedCBV::kMaxArraySize;
+
+ChunkedCBV::ChunkedCBV(vector<uint64_t> const & setBits)
+{
+  ASSERT(is_sorted(setBits.begin(), setBits.end()), ());
+  for (size_t i = 0; i < setBits.size();)
+  {
+    uint64_t const key = setBits[i] / kChunkSize;
+    CHECK_LESS_OR_EQUAL(key, std::numeric_limits<uint32_t>::max(), ());
+
+    vector<uint16_t> values;
+    for (; i < setBits.size() && setBits[i] / kChunkSize == key; ++i)
+    {
+      if (values.empty() || values.back() != setBits[i] % kChunkSize)
+        values.push_back(static_cast<uint16_t>(setBits[i] % kChunkSize));
+    }
+
+    m_chunks.emplace_back();
+    m_chunks.back().m_key = static_cast<uint32_t>(key);
+    SetValues(m_chunks.back(), std::move(values));
+  }
+  UpdatePopCount();
+}
+
+// static
+unique_ptr<ChunkedCBV> ChunkedCBV::FromCBV(CompressedBitVector const & cbv)
+{
+  auto res = make_unique<ChunkedCBV>();
+  switch (cbv.GetStorageStrategy())
+  {
+  case StorageStrategy::Chunked:
+  {
+    auto const & chunked = static_cast<ChunkedCBV const &>(cbv);
+    res->m_chunks = chunked.m_chunks;
+    res->m_popCount = chunked.m_popCount;
+    return res;
+  }
+  case StorageStrategy::Dense:
+  {
+    auto const & dense = static_cast<DenseCBV const &>(cbv);
+    for (size_t i = 0; i < dense.NumBitGroups(); i += kBitGroupsPerChunk)
+    {
+      vector<uint64_t> bitmap(kBitGroupsPerChunk);
+      bool empty = true;
+      for (size_t j = 0; j < kBitGroupsPerChunk; ++j)
+      {
+        bitmap[j] = dense.GetBitGroup(i + j);
+        empty = empty && bitmap[j] == 0;
+      }
+      if (empty)
+        continue;
+
+      res->m_chunks.emplace_back();
+      res->m_chunks.back().m_key = static_cast<uint32_t>(i / kBitGroupsPerChunk);
+      SetBitmap(res->m_chunks.back(), std::move(bitmap));
+    }
+    res->UpdatePopCount();
+    return res;
+  }
+  case StorageStrategy::Sparse:
+  {
+    auto const & sparse = static_cast<SparseCBV const &>(cbv);
+    return make_unique<ChunkedCBV>(vector<uint64_t>(sparse.Begin(), sparse.End()));
+  }
+  }
+  UNREACHABLE();
+}
+
+uint64_t ChunkedCBV::DataSize() const
+{
+  uint64_t size = 0;
+  for (auto const & chunk : m_chunks)
+  {
+    size += sizeof(chunk.m_key) + sizeof(chunk.m_type) + sizeof(chunk.m_popCount) +
+            chunk.m_values.size() * sizeof(uint16_t) + chunk.m_bitmap.size() * sizeof(uint64_t);
+  }
+  return size;
+}
+
+void ChunkedCBV::IntersectWith(ChunkedCBV const & rhs)
+{
+  size_t const n = rhs.m_chunks.size();
+  size_t count = 0;
+  size_t j = 0;
+  for (size_t i = 0; i < m_chunks.size() && j < n; ++i)
+  {
+    auto & chunk = m_chunks[i];
+    while (j < n && rhs.m_chunks[j].m_key < chunk.m_key)
+      ++j;
+    if (j == n || rhs.m_chunks[j].m_key != chunk.m_key)
+      continue;
+
+    if (IntersectChunk(chunk, rhs.m_chunks[j]))
+    {
+      if (count != i)
+        m_chunks[count] = std::move(chunk);
+      ++count;
+    }
+  }
+  m_chunks.erase(m_chunks.begin() + count, m_chunks.end());
+  UpdatePopCount();
+}
+
+void ChunkedCBV::SubtractWith(ChunkedCBV const & rhs)
+{
+  size_t const n = rhs.m_chunks.size();
+  size_t count = 0;
+  size_t j = 0;
+  for (size_t i = 0; i < m_chunks.size(); ++i)
+  {
+    auto & chunk = m_chunks[i];
+    while (j < n && rhs.m_chunks[j].m_key < chunk.m_key)
+      ++j;
+    if (j < n && rhs.m_chunks[j].m_key == chunk.m_key && !SubtractChunk(chunk, rhs.m_chunks[j]))
+      continue;
+
+    if (count != i)
+      m_chunks[count] = std::move(chunk);
+    ++count;
+  }
+  m_chunks.erase(m_chunks.begin() + count, m_chunks.end());
+  UpdatePopCount();
+}
+
+void ChunkedCBV::UniteWith(ChunkedCBV const & rhs)
+{
+  vector<Chunk> chunks;
+  chunks.reserve(m_chunks.size() + rhs.m_chunks.size());
+  size_t i = 0;
+  size_t j = 0;
+  while (i < m_chunks.size() || j < rhs.m_chunks.size())
+  {
+    if (j == rhs.m_chunks.size() ||
+        (i < m_chunks.size() && m_chunks[i].m_key < rhs.m_chunks[j].m_key))
+    {
+      chunks.push_back(std::move(m_chunks[i++]));
+    }
+    else if (i == m_chunks.size() || rhs.m_chunks[j].m_key < m_chunks[i].m_key)
+    {
+      chunks.push_back(rhs.m_chunks[j++]);
+    }
+    else
+    {
+      UniteChunk(m_chunks[i], rhs.m_chunks[j++]);
+      chunks.push_back(std::move(m_chunks[i++]));
+    }
+  }
+  m_chunks = std::move(chunks);
+  UpdatePopCount();
+}
+
+uint64_t ChunkedCBV::PopCount() const { return m_popCount; }
+
+bool ChunkedCBV::GetBit(uint64_t pos) const
+{
+  uint64_t const key = pos / kChunkSize;
+  auto const it = lower_bound(m_chunks.begin(), m_chunks.end(), key,
+                              [](Chunk const & chunk, uint64_t key) { return chunk.m_key < key; });
+  if (it == m_chunks.end() || it->m_key != key)
+    return false;
+  return GetChunkBit(*it, static_cast<uint16_t>(pos % kChunkSize));
+}
+
+unique_ptr<CompressedBitVector> ChunkedCBV::LeaveFirstSetNBits(uint64_t n) const
+{
+  if (PopCount() <= n)
+    return Clone();
+
+  vector<uint64_t> positions;
+  positions.reserve(static_cast<size_t>(n));
+  ForEach([&](uint64_t pos) {
+    if (positions.size() == n)
+      return base::ControlFlow::Break;
+    positions.push_back(pos);
+    return base::ControlFlow::Continue;
+  });
+  return CompressedBitVectorBuilder::FromBitPositions(std::move(positions));
+}
+
+CompressedBitVector::StorageStrategy ChunkedCBV::GetStorageStrategy() const
+{
+  return CompressedBitVector::StorageStrategy::Chunked;
+}
+
+void ChunkedCBV::Serialize(Writer & writer) const
+{
+  // Chunked vectors are never written as is: released clients can't read them.
+  vector<uint64_t> setBits;
+  setBits.reserve(m_popCount);
+  ForEach([&setBits](uint64_t pos) { setBits.push_back(pos); });
+  BuildFromBitPositions(std::move(setBits), false /* allowChunked */)->Serialize(writer);
+}
+
+unique_ptr<CompressedBitVector> ChunkedCBV::Clone() const { return FromCBV(*this); }
+
+void ChunkedCBV::UpdatePopCount()
+{
+  m_popCount = 0;
+  for (auto const & chunk : m_chunks)
+    m_popCount += chunk.m_popCount;
+}
+
 // static
 unique_ptr<CompressedBitVector> CompressedBitVectorBuilder::FromBitPositions(
     vector<uint64_t> const & setBits)
 {
-  return BuildFromBitPositions(setBits);
+  return BuildFromBitPositions(setBits, true /* allowChunked */);
 }
 
 // static
 unique_ptr<CompressedBitVector> CompressedBitVectorBuilder::FromBitPositions(
     vector<uint64_t> && setBits)
 {
-  return BuildFromBitPositions(std::move(setBits));
+  return BuildFromBitPositions(std::move(setBits), true /* allowChunked */);
+}
+
+// static
+unique_ptr<CompressedBitVector> CompressedBitVectorBuilder::FromBitPositionsDenseOrSparse(
+    vector<uint64_t> const & setBits)
+{
+  return BuildFromBitPositions(setBits, false /* allowChunked */);
+}
+
+// static
+unique_ptr<CompressedBitVector> CompressedBitVectorBuilder::FromBitPositionsDenseOrSparse(
+    vector<uint64_t> && setBits)
+{
+  return BuildFromBitPositions(std::move(setBits), false /* allowChunked */);
 }
 
 // static
@@ -468,6 +1013,7 @@ std::string DebugPrint(CompressedBitVector::StorageStrategy strat)
   {
   case CompressedBitVector::StorageStrategy::Dense: return "Dense";
   case CompressedBitVector::StorageStrategy::Sparse: return "Sparse";
+  case CompressedBitVector::StorageStrategy::Chunked: return "Chunked";
   }
   UNREACHABLE();
 }
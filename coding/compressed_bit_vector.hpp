@@ -5,6 +5,7 @@
 #include "coding/writer.hpp"
 
 #include "base/assert.hpp"
+#include "base/bits.hpp"
 #include "base/control_flow.hpp"
 #include "base/ref_counted.hpp"
 
@@ -23,7 +24,8 @@ public:
   enum class StorageStrategy
   {
     Dense,
-    Sparse
+    Sparse,
+    Chunked
   };
 
   virtual ~CompressedBitVector() = default;
@@ -72,6 +74,8 @@ public:
   // Writes the contents of a bit vector to writer.
   // The first byte is always the header that defines the format.
   // Currently the header is 0 or 1 for Dense and Sparse strategies respectively.
+  // Chunked vectors are written as dense or sparse ones, so the format is readable by
+  // the released clients.
   // It is easier to dispatch via virtual method calls and not bother
   // with template TWriters here as we do in similar places in our code.
   // This should not pose too much a problem because commonly
@@ -178,6 +182,113 @@ private:
   std::vector<uint64_t> m_positions;
 };
 
+// Splits the bit vector into chunks of kChunkSize bits and stores every chunk in the most
+// compact of three forms: sorted positions, a bitmap or runs of set bits. Such a vector takes
+// much less memory than both dense and sparse ones when its density varies a lot, e.g. for
+// features of a category in an mwm with several big cities. Set operations work chunk by chunk
+// and may be done in place.
+class ChunkedCBV : public CompressedBitVector
+{
+public:
+  static uint64_t const kChunkSize = 1 << 16;
+  static size_t const kBitGroupsPerChunk = kChunkSize / 64;
+  // Chunks with more set bits are never stored as sorted positions.
+  static uint32_t const kMaxArraySize = 4096;
+
+  struct Chunk
+  {
+    enum class Type : uint8_t
+    {
+      Array,
+      Bitmap,
+      Runs
+    };
+
+    // Index of the chunk, i.e. the high bits of positions.
+    uint32_t m_key = 0;
+    Type m_type = Type::Array;
+    uint32_t m_popCount = 0;
+    // Sorted low bits of positions for Array, pairs of the first and the last low bits of runs
+    // of set bits for Runs.
+    std::vector<uint16_t> m_values;
+    // kBitGroupsPerChunk bit groups for Bitmap.
+    std::vector<uint64_t> m_bitmap;
+  };
+
+  ChunkedCBV() = default;
+
+  // Builds a chunked CBV from a sorted list of positions of set bits.
+  explicit ChunkedCBV(std::vector<uint64_t> const & setBits);
+
+  static std::unique_ptr<ChunkedCBV> FromCBV(CompressedBitVector const & cbv);
+
+  size_t NumChunks() const { return m_chunks.size(); }
+
+  // Returns the number of bytes used by the set bits.
+  uint64_t DataSize() const;
+
+  // In-place versions of the CompressedBitVector operations.
+  void IntersectWith(ChunkedCBV const & rhs);
+  void SubtractWith(ChunkedCBV const & rhs);
+  void UniteWith(ChunkedCBV const & rhs);
+
+  template <typename Fn>
+  void ForEach(Fn && f) const
+  {
+    base::ControlFlowWrapper<Fn> wrapper(std::forward<Fn>(f));
+    for (auto const & chunk : m_chunks)
+    {
+      uint64_t const begin = static_cast<uint64_t>(chunk.m_key) * kChunkSize;
+      switch (chunk.m_type)
+      {
+      case Chunk::Type::Array:
+        for (auto const v : chunk.m_values)
+        {
+          if (wrapper(begin + v) == base::ControlFlow::Break)
+            return;
+        }
+        break;
+      case Chunk::Type::Bitmap:
+        for (size_t i = 0; i < chunk.m_bitmap.size(); ++i)
+        {
+          for (uint64_t group = chunk.m_bitmap[i]; group != 0; group &= group - 1)
+          {
+            uint64_t const j = bits::PopCount((group & (~group + 1)) - 1);
+            if (wrapper(begin + 64 * i + j) == base::ControlFlow::Break)
+              return;
+          }
+        }
+        break;
+      case Chunk::Type::Runs:
+        for (size_t i = 0; i < chunk.m_values.size(); i += 2)
+        {
+          for (uint64_t j = chunk.m_values[i]; j <= chunk.m_values[i + 1]; ++j)
+          {
+            if (wrapper(begin + j) == base::ControlFlow::Break)
+              return;
+          }
+        }
+        break;
+      }
+    }
+  }
+
+  // CompressedBitVector overrides:
+  uint64_t PopCount() const override;
+  bool GetBit(uint64_t pos) const override;
+  std::unique_ptr<CompressedBitVector> LeaveFirstSetNBits(uint64_t n) const override;
+  StorageStrategy GetStorageStrategy() const override;
+  void Serialize(Writer & writer) const override;
+  std::unique_ptr<CompressedBitVector> Clone() const override;
+
+private:
+  void UpdatePopCount();
+
+  // Sorted by keys, there are no empty chunks.
+  std::vector<Chunk> m_chunks;
+  uint64_t m_popCount = 0;
+};
+
 class CompressedBitVectorBuilder
 {
 public:
@@ -187,6 +298,13 @@ public:
       std::vector<uint64_t> const & setBits);
   static std::unique_ptr<CompressedBitVector> FromBitPositions(std::vector<uint64_t> && setBits);
 
+  // Same as FromBitPositions but never chooses the Chunked strategy. Use it for bit vectors
+  // which are written to mwms.
+  static std::unique_ptr<CompressedBitVector> FromBitPositionsDenseOrSparse(
+      std::vector<uint64_t> const & setBits);
+  static std::unique_ptr<CompressedBitVector> FromBitPositionsDenseOrSparse(
+      std::vector<uint64_t> && setBits);
+
   // Chooses a strategy to store the bit vector with bits from a bitmap obtained
   // by concatenating the elements of bitGroups.
   static std::unique_ptr<CompressedBitVector> FromBitGroups(std::vector<uint64_t> & bitGroups);
@@ -223,6 +341,7 @@ public:
       rw::ReadVectorOfPOD(src, setBits);
       return std::make_unique<SparseCBV>(std::move(setBits));
     }
+    case CompressedBitVector::StorageStrategy::Chunked: break;
     }
     return std::unique_ptr<CompressedBitVector>();
   }
@@ -252,6 +371,12 @@ public:
       sparseCBV.ForEach(f);
       return;
     }
+    case CompressedBitVector::StorageStrategy::Chunked:
+    {
+      ChunkedCBV const & chunkedCBV = static_cast<ChunkedCBV const &>(cbv);
+      chunkedCBV.ForEach(f);
+      return;
+    }
     }
   }
 };
@@ -101,6 +101,21 @@ std::pair<uint64_t, uint64_t> FilesContainerR::GetAbsoluteOffsetAndSize(Tag cons
   return std::make_pair(offset + p->m_offset, p->m_size);
 }
 
+std::shared_ptr<detail::MappedFile::Handle const> FilesContainerR::TryMap(Tag const & tag) const
+{
+  if (dynamic_cast<FileReader const *>(m_source.GetPtr()) == nullptr || !IsExist(tag))
+    return nullptr;
+
+  auto const [offset, size] = GetAbsoluteOffsetAndSize(tag);
+  if (size == 0)
+    return nullptr;
+
+  // The mapping stays valid after the file is closed.
+  detail::MappedFile file;
+  file.Open(GetFileName());
+  return std::make_shared<detail::MappedFile::Handle const>(file.Map(offset, size, tag));
+}
+
 FilesContainerBase::TagInfo const * FilesContainerBase::GetInfo(Tag const & tag) const
 {
   auto i = lower_bound(m_info.begin(), m_info.end(), tag, LessInfo());
@@ -111,34 +111,6 @@ protected:
 
 std::string DebugPrint(FilesContainerBase::TagInfo const & info);
 
-class FilesContainerR : public FilesContainerBase
-{
-public:
-  using TReader = ModelReaderPtr;
-
-  explicit FilesContainerR(std::string const & filePath,
-                           uint32_t logPageSize = 10,
-                           uint32_t logPageCount = 10);
-  explicit FilesContainerR(TReader const & file);
-
-  TReader GetReader(Tag const & tag) const;
-
-  template <typename F>
-  void ForEachTag(F && f) const
-  {
-    for (size_t i = 0; i < m_info.size(); ++i)
-      f(m_info[i].m_tag);
-  }
-
-  uint64_t GetFileSize() const { return m_source.Size(); }
-  std::string const & GetFileName() const { return m_source.GetName(); }
-
-  std::pair<uint64_t, uint64_t> GetAbsoluteOffsetAndSize(Tag const & tag) const;
-
-private:
-  TReader m_source;
-};
-
 namespace detail
 {
 class MappedFile
@@ -212,6 +184,40 @@ private:
 };
 } // namespace detail
 
+class FilesContainerR : public FilesContainerBase
+{
+public:
+  using TReader = ModelReaderPtr;
+
+  explicit FilesContainerR(std::string const & filePath,
+                           uint32_t logPageSize = 10,
+                           uint32_t logPageCount = 10);
+  explicit FilesContainerR(TReader const & file);
+
+  TReader GetReader(Tag const & tag) const;
+
+  template <typename F>
+  void ForEachTag(F && f) const
+  {
+    for (size_t i = 0; i < m_info.size(); ++i)
+      f(m_info[i].m_tag);
+  }
+
+  uint64_t GetFileSize() const { return m_source.Size(); }
+  std::string const & GetFileName() const { return m_source.GetName(); }
+
+  std::pair<uint64_t, uint64_t> GetAbsoluteOffsetAndSize(Tag const & tag) const;
+
+  /// Maps |tag| section into memory if the container is read from a plain file.
+  /// The mapping is shared, so the data it gives out may outlive the container and its readers.
+  /// @return nullptr if there is no such section or the container is over memory or
+  /// other readers that can't be mapped.
+  std::shared_ptr<detail::MappedFile::Handle const> TryMap(Tag const & tag) const;
+
+private:
+  TReader m_source;
+};
+
 class FilesMappingContainer : public FilesContainerBase
 {
 public:
@@ -5,7 +5,10 @@
 #include "geometry/mercator.hpp"
 
 #include "base/assert.hpp"
+#include "base/bits.hpp"
+#include "base/buffer_vector.hpp"
 
+#include <algorithm>
 #include <complex>
 #include <stack>
 
@@ -18,6 +21,19 @@ inline m2::PointU ClampPoint(m2::PointD const & maxPoint, m2::PointD const & poi
            static_cast<uvalue_t>(base::Clamp(point.y, 0.0, maxPoint.y)) };
 }
 
+// Same as ClampPoint for predictions which are exact in integers, i.e. made of sums and halves
+// of coordinates. |x2| and |y2| are the doubled coordinates of the prediction. It avoids
+// conversions to floating point in the decoding loops.
+inline m2::PointU ClampDoubledPoint(m2::PointD const & maxPoint, int64_t x2, int64_t y2)
+{
+  using uvalue_t = m2::PointU::value_type;
+  // Coordinates are not negative after clamping, so division truncates them as casts do.
+  return {static_cast<uvalue_t>(std::min(std::max(x2, int64_t{0}) / 2,
+                                         static_cast<int64_t>(maxPoint.x))),
+          static_cast<uvalue_t>(std::min(std::max(y2, int64_t{0}) / 2,
+                                         static_cast<int64_t>(maxPoint.y)))};
+}
+
 struct edge_less_p0
 {
   using edge_t = tesselator::Edge;
@@ -29,6 +45,41 @@ struct edge_less_p0
   bool operator()(edge_t const & e1, int e2) const { return e1.m_p[0] < e2; }
   bool operator()(int e1, edge_t const & e2) const { return e1 < e2.m_p[0]; }
 };
+
+// Point deltas split into coordinates and zigzag decoded all at once before decoding of points.
+// Iterations of this loop don't depend on predictions, so it's vectorized by compilers and
+// only predictions are left in the sequential decoding loops.
+class PointDeltas
+{
+public:
+  explicit PointDeltas(coding::InDeltasT const & deltas)
+  {
+    size_t const count = deltas.size();
+    m_x.resize(count);
+    m_y.resize(count);
+
+    uint64_t const * src = count == 0 ? nullptr : &deltas[0];
+    uint32_t * xs = m_x.data();
+    uint32_t * ys = m_y.data();
+    for (size_t i = 0; i < count; ++i)
+    {
+      uint32_t x, y;
+      bits::BitwiseSplit(src[i], x, y);
+      // Same unsigned wrapping as in DecodePointDeltaFromUint.
+      xs[i] = static_cast<uint32_t>(bits::ZigZagDecode(x));
+      ys[i] = static_cast<uint32_t>(bits::ZigZagDecode(y));
+    }
+  }
+
+  m2::PointU Apply(size_t i, m2::PointU const & prediction) const
+  {
+    return m2::PointU(prediction.x + m_x[i], prediction.y + m_y[i]);
+  }
+
+private:
+  buffer_vector<uint32_t, 64> m_x;
+  buffer_vector<uint32_t, 64> m_y;
+};
 }  // namespace
 
 namespace coding
@@ -54,7 +105,9 @@ bool TestDecoding(InPointsT const & points, m2::PointU const & basePoint,
 m2::PointU PredictPointInPolyline(m2::PointD const & maxPoint, m2::PointU const & p1,
                                   m2::PointU const & p2)
 {
-  return ClampPoint(maxPoint, m2::PointD(p1) + (m2::PointD(p1) - m2::PointD(p2)) / 2.0);
+  // p1 + (p1 - p2) / 2
+  return ClampDoubledPoint(maxPoint, 3 * int64_t{p1.x} - int64_t{p2.x},
+                           3 * int64_t{p1.y} - int64_t{p2.y});
 }
 
 uint64_t EncodePointDeltaAsUint(m2::PointU const & actual, m2::PointU const & prediction)
@@ -100,7 +153,9 @@ m2::PointU PredictPointInTriangle(m2::PointD const & maxPoint, m2::PointU const
                                   m2::PointU const & p2, m2::PointU const & p3)
 {
   // parallelogram prediction
-  return ClampPoint(maxPoint, m2::PointD(p1 + p2) - m2::PointD(p3));
+  m2::PointU const sum = p1 + p2;
+  return ClampDoubledPoint(maxPoint, 2 * (int64_t{sum.x} - int64_t{p3.x}),
+                           2 * (int64_t{sum.y} - int64_t{p3.y}));
 }
 
 void EncodePolylinePrev1(InPointsT const & points, m2::PointU const & basePoint,
@@ -123,9 +178,14 @@ void DecodePolylinePrev1(InDeltasT const & deltas, m2::PointU const & basePoint,
   size_t const count = deltas.size();
   if (count > 0)
   {
-    points.push_back(DecodePointDeltaFromUint(deltas[0], basePoint));
+    PointDeltas const pointDeltas(deltas);
+    m2::PointU pt = pointDeltas.Apply(0, basePoint);
+    points.push_back(pt);
     for (size_t i = 1; i < count; ++i)
-      points.push_back(DecodePointDeltaFromUint(deltas[i], points.back()));
+    {
+      pt = pointDeltas.Apply(i, pt);
+      points.push_back(pt);
+    }
   }
 }
 
@@ -155,16 +215,20 @@ void DecodePolylinePrev2(InDeltasT const & deltas, m2::PointU const & basePoint,
   size_t const count = deltas.size();
   if (count > 0)
   {
-    points.push_back(DecodePointDeltaFromUint(deltas[0], basePoint));
+    PointDeltas const pointDeltas(deltas);
+    m2::PointU p2 = pointDeltas.Apply(0, basePoint);
+    points.push_back(p2);
     if (count > 1)
     {
       m2::PointD const maxPointD(maxPoint);
-      points.push_back(DecodePointDeltaFromUint(deltas[1], points.back()));
+      m2::PointU p1 = pointDeltas.Apply(1, p2);
+      points.push_back(p1);
       for (size_t i = 2; i < count; ++i)
       {
-        size_t const n = points.size();
-        points.push_back(DecodePointDeltaFromUint(
-            deltas[i], PredictPointInPolyline(maxPointD, points[n - 1], points[n - 2])));
+        m2::PointU const pt = pointDeltas.Apply(i, PredictPointInPolyline(maxPointD, p1, p2));
+        points.push_back(pt);
+        p2 = p1;
+        p1 = pt;
       }
     }
   }
@@ -210,22 +274,26 @@ void DecodePolylinePrev3(InDeltasT const & deltas, m2::PointU const & basePoint,
   size_t const count = deltas.size();
   if (count > 0)
   {
-    points.push_back(DecodePointDeltaFromUint(deltas[0], basePoint));
+    PointDeltas const pointDeltas(deltas);
+    m2::PointU p3 = pointDeltas.Apply(0, basePoint);
+    points.push_back(p3);
     if (count > 1)
     {
-      m2::PointU const pt0 = points.back();
-      points.push_back(DecodePointDeltaFromUint(deltas[1], pt0));
+      m2::PointU p2 = pointDeltas.Apply(1, p3);
+      points.push_back(p2);
       if (count > 2)
       {
         m2::PointD const maxPointD(maxPoint);
-        points.push_back(DecodePointDeltaFromUint(
-            deltas[2], PredictPointInPolyline(maxPointD, points.back(), pt0)));
+        m2::PointU p1 = pointDeltas.Apply(2, PredictPointInPolyline(maxPointD, p2, p3));
+        points.push_back(p1);
         for (size_t i = 3; i < count; ++i)
         {
-          size_t const n = points.size();
-          m2::PointU const prediction = PredictPointInPolyline(
-                maxPointD, points[n - 1], points[n - 2], points[n - 3]);
-          points.push_back(DecodePointDeltaFromUint(deltas[i], prediction));
+          m2::PointU const prediction = PredictPointInPolyline(maxPointD, p1, p2, p3);
+          m2::PointU const pt = pointDeltas.Apply(i, prediction);
+          points.push_back(pt);
+          p3 = p2;
+          p2 = p1;
+          p1 = pt;
         }
       }
     }
@@ -274,17 +342,23 @@ void DecodeTriangleStrip(InDeltasT const & deltas, m2::PointU const & basePoint,
   {
     ASSERT_GREATER(count, 2, ());
 
-    points.push_back(DecodePointDeltaFromUint(deltas[0], basePoint));
-    points.push_back(DecodePointDeltaFromUint(deltas[1], points.back()));
-    points.push_back(DecodePointDeltaFromUint(deltas[2], points.back()));
+    PointDeltas const pointDeltas(deltas);
+    m2::PointU p3 = pointDeltas.Apply(0, basePoint);
+    m2::PointU p2 = pointDeltas.Apply(1, p3);
+    m2::PointU p1 = pointDeltas.Apply(2, p2);
+    points.push_back(p3);
+    points.push_back(p2);
+    points.push_back(p1);
 
     m2::PointD const maxPointD(maxPoint);
     for (size_t i = 3; i < count; ++i)
     {
-      size_t const n = points.size();
-      m2::PointU const prediction = PredictPointInTriangle(
-            maxPointD, points[n - 1], points[n - 2], points[n - 3]);
-      points.push_back(DecodePointDeltaFromUint(deltas[i], prediction));
+      m2::PointU const prediction = PredictPointInTriangle(maxPointD, p1, p2, p3);
+      m2::PointU const pt = pointDeltas.Apply(i, prediction);
+      points.push_back(pt);
+      p3 = p2;
+      p2 = p1;
+      p1 = pt;
     }
   }
 }
@@ -10,6 +10,7 @@
 
 #include <cstddef>
 #include <cstdint>
+#include <cstring>
 #include <type_traits>
 
 // Writes any unsigned integer type using optimal bytes count, platform-independent.
@@ -199,7 +200,14 @@ public:
     ASSERT_LESS_OR_EQUAL(reinterpret_cast<uintptr_t>(p), reinterpret_cast<uintptr_t>(m_pEnd), ());
     return p < m_pEnd;
   }
+  // Returns true if |n| bytes starting from |p| may be read.
+  bool CanReadBytes(void const * p, size_t n) const
+  {
+    return static_cast<size_t>(static_cast<uint8_t const *>(m_pEnd) -
+                               static_cast<uint8_t const *>(p)) >= n;
+  }
   void NextVarInt() {}
+  void NextVarInts(size_t) {}
 private:
   void const * m_pEnd;
 };
@@ -209,7 +217,10 @@ class ReadVarInt64ArrayGivenSize
 public:
   explicit ReadVarInt64ArrayGivenSize(size_t const count) : m_Remaining(count) {}
   bool Continue(void const *) const { return m_Remaining > 0; }
+  // Every varint takes at least one byte.
+  bool CanReadBytes(void const *, size_t n) const { return m_Remaining >= n; }
   void NextVarInt() { --m_Remaining; }
+  void NextVarInts(size_t n) { m_Remaining -= n; }
 private:
   size_t m_Remaining;
 };
@@ -226,6 +237,22 @@ void const * ReadVarInt64Array(void const * pBeg, WhileConditionT whileCondition
   uint8_t const * p = pBegChar;
   while (whileCondition.Continue(p))
   {
+    // Fast path for runs of one byte varints which are common for small deltas: eight bytes
+    // are checked for continuation bits at once and decoded without branches.
+    if (count32 == 0 && count64 == 0 && whileCondition.CanReadBytes(p, 8))
+    {
+      uint64_t word;
+      std::memcpy(&word, p, sizeof(word));
+      if ((word & 0x8080808080808080ULL) == 0)
+      {
+        for (size_t i = 0; i < 8; ++i)
+          f(converter(static_cast<uint64_t>(p[i])));
+        whileCondition.NextVarInts(8);
+        p += 8;
+        continue;
+      }
+    }
+
     uint8_t const t = *p++;
     res32 += (static_cast<uint32_t>(t & 127) << count32);
     count32 += 7;
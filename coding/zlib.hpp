@@ -5,6 +5,7 @@
 
 #include <algorithm>
 #include <cstddef>
+#include <limits>
 #include <string>
 
 #include "zlib.h"
@@ -34,11 +35,19 @@ public:
 
     template <typename OutIt>
     bool operator()(void const * data, size_t size, OutIt out) const
+    {
+      return (*this)(data, size, std::numeric_limits<size_t>::max() /* maxOutSize */, out);
+    }
+
+    // Returns false as soon as the inflated data exceeds |maxOutSize| bytes. It protects
+    // from the data which is inflated to a huge size.
+    template <typename OutIt>
+    bool operator()(void const * data, size_t size, size_t maxOutSize, OutIt out) const
     {
       if (data == nullptr)
         return false;
       InflateProcessor processor(m_format, data, size);
-      return Process(processor, out);
+      return Process(processor, maxOutSize, out);
     }
 
     template <typename OutIt>
@@ -76,7 +85,7 @@ public:
       if (data == nullptr)
         return false;
       DeflateProcessor processor(m_format, m_level, data, size);
-      return Process(processor, out);
+      return Process(processor, std::numeric_limits<size_t>::max() /* maxOutSize */, out);
     }
 
     template <typename OutIt>
@@ -102,14 +111,18 @@ private:
     inline bool IsInit() const noexcept { return m_init; }
     bool ConsumedAll() const;
     bool BufferIsFull() const;
+    size_t GetOutSize() const { return kBufferSize - m_stream.avail_out; }
 
+    // Returns the number of bytes moved to |out|.
     template <typename OutIt>
-    void MoveOut(OutIt out)
+    size_t MoveOut(OutIt out)
     {
       ASSERT(IsInit(), ());
-      std::copy(m_buffer, m_buffer + kBufferSize - m_stream.avail_out, out);
+      size_t const size = kBufferSize - m_stream.avail_out;
+      std::copy(m_buffer, m_buffer + size, out);
       m_stream.next_out = m_buffer;
       m_stream.avail_out = kBufferSize;
+      return size;
     }
 
   protected:
@@ -144,11 +157,21 @@ private:
   };
 
   template <typename Processor, typename OutIt>
-  static bool Process(Processor & processor, OutIt out)
+  static bool Process(Processor & processor, size_t maxOutSize, OutIt out)
   {
     if (!processor.IsInit())
       return false;
 
+    size_t outSize = 0;
+    auto const moveOut = [&]()
+    {
+      // The buffer is checked before it's moved, so no more than |maxOutSize| bytes are output.
+      if (processor.GetOutSize() > maxOutSize - outSize)
+        return false;
+      outSize += processor.MoveOut(out);
+      return true;
+    };
+
     int ret = Z_OK;
     while (true)
     {
@@ -163,14 +186,16 @@ private:
         if (!processor.BufferIsFull())
           break;
 
-        processor.MoveOut(out);
+        if (!moveOut())
+          return false;
       }
 
       if (flush == Z_FINISH && ret == Z_STREAM_END)
         break;
     }
 
-    processor.MoveOut(out);
+    if (!moveOut())
+      return false;
     return processor.ConsumedAll();
   }
 };
@@ -59,6 +59,7 @@
 #define DESCRIPTIONS_FILE_TAG "descriptions"
 #define MAXSPEEDS_FILE_TAG "maxspeeds"
 #define ROUTING_WORLD_FILE_TAG "routing_world"
+#define ROUTING_SHORTCUTS_FILE_TAG "routing_shortcuts"
 
 #define READY_FILE_EXTENSION ".ready"
 #define RESUME_FILE_EXTENSION ".resume"
@@ -0,0 +1,158 @@
+#include "testing/testing.hpp"
+
+#include "drape_frontend/map_shape.hpp"
+#include "drape_frontend/tile_key.hpp"
+#include "drape_frontend/tile_shapes_cache.hpp"
+
+#include <cstddef>
+#include <memory>
+
+namespace tile_shapes_cache_tests
+{
+using namespace df;
+
+class TestShape : public MapShape
+{
+public:
+  void Draw(ref_ptr<dp::GraphicsContext> /* context */, ref_ptr<dp::Batcher> /* batcher */,
+            ref_ptr<dp::TextureManager> /* textures */) const override
+  {
+  }
+};
+
+std::shared_ptr<TileShapes const> MakeShapes(size_t geometryCount, size_t overlaysCount)
+{
+  auto shapes = std::make_shared<TileShapes>();
+
+  TMapShapes geometry;
+  for (size_t i = 0; i < geometryCount; ++i)
+    geometry.push_back(make_unique_dp<TestShape>());
+  shapes->m_geometry.push_back(std::make_shared<TMapShapes const>(std::move(geometry)));
+
+  TMapShapes overlays;
+  for (size_t i = 0; i < overlaysCount; ++i)
+    overlays.push_back(make_unique_dp<TestShape>());
+  shapes->m_overlays.push_back(std::make_shared<TMapShapes const>(std::move(overlays)));
+  return shapes;
+}
+
+void Put(TileShapesCache & cache, TileKey const & tileKey,
+         std::shared_ptr<TileShapes const> const & shapes)
+{
+  cache.Put(tileKey, cache.GetEpoch(), TileShapesParams(), shapes);
+}
+
+bool Contains(TileShapesCache & cache, TileKey const & tileKey)
+{
+  return cache.Find(tileKey, TileShapesParams()) != nullptr;
+}
+
+UNIT_TEST(TileShapesCache_Find)
+{
+  TileShapesCache cache(10 /* maxShapesCount */);
+  TileKey const tileKey(1, 2, 10);
+  auto const shapes = MakeShapes(2, 1);
+
+  TEST(!Contains(cache, tileKey), ());
+  Put(cache, tileKey, shapes);
+  TEST_EQUAL(cache.Find(tileKey, TileShapesParams()), shapes, ());
+  TEST_EQUAL(cache.GetShapesCount(), 3, ());
+
+  // Shapes generated with other params are dropped.
+  TileShapesParams params;
+  params.m_trafficEnabled = true;
+  TEST(!cache.Find(tileKey, params), ());
+  TEST(!Contains(cache, tileKey), ());
+  TEST_EQUAL(cache.GetShapesCount(), 0, ());
+
+  // Too heavy tiles aren't cached.
+  Put(cache, tileKey, MakeShapes(5, 1));
+  TEST(!Contains(cache, tileKey), ());
+}
+
+UNIT_TEST(TileShapesCache_LruEviction)
+{
+  TileShapesCache cache(10 /* maxShapesCount */);
+  TileKey const tileKey1(1, 1, 10);
+  TileKey const tileKey2(2, 2, 10);
+  TileKey const tileKey3(3, 3, 10);
+  TileKey const tileKey4(4, 4, 10);
+
+  Put(cache, tileKey1, MakeShapes(2, 1));
+  Put(cache, tileKey2, MakeShapes(3, 0));
+  Put(cache, tileKey3, MakeShapes(0, 3));
+  TEST_EQUAL(cache.GetShapesCount(), 9, ());
+
+  // The second tile becomes the least recently used one.
+  TEST(Contains(cache, tileKey1), ());
+  Put(cache, tileKey4, MakeShapes(1, 2));
+  TEST_EQUAL(cache.GetShapesCount(), 9, ());
+  TEST(!Contains(cache, tileKey2), ());
+  TEST(Contains(cache, tileKey1), ());
+  TEST(Contains(cache, tileKey3), ());
+  TEST(Contains(cache, tileKey4), ());
+
+  // Put replaces the shapes of the tile.
+  Put(cache, tileKey4, MakeShapes(1, 0));
+  TEST_EQUAL(cache.GetShapesCount(), 7, ());
+
+  // The first tile is the least recently used one after the lookups above.
+  Put(cache, tileKey2, MakeShapes(5, 0));
+  TEST_EQUAL(cache.GetShapesCount(), 9, ());
+  TEST(!Contains(cache, tileKey1), ());
+  TEST(Contains(cache, tileKey2), ());
+  TEST(Contains(cache, tileKey3), ());
+  TEST(Contains(cache, tileKey4), ());
+}
+
+UNIT_TEST(TileShapesCache_InvalidateAndClear)
+{
+  TileShapesCache cache(100 /* maxShapesCount */);
+  TileKey const tileKey(10, 10, 10);
+  TileKey const childTileKey(21, 21, 11);
+  TileKey const parentTileKey(5, 5, 9);
+  TileKey const farTileKey(100, 100, 10);
+
+  for (auto const & key : {tileKey, childTileKey, parentTileKey, farTileKey})
+    Put(cache, key, MakeShapes(1, 1));
+  TEST_EQUAL(cache.GetShapesCount(), 8, ());
+
+  // Tiles of any zoom level which intersect the invalidated ones are removed.
+  cache.Invalidate({tileKey});
+  TEST(!Contains(cache, tileKey), ());
+  TEST(!Contains(cache, childTileKey), ());
+  TEST(!Contains(cache, parentTileKey), ());
+  TEST(Contains(cache, farTileKey), ());
+  TEST_EQUAL(cache.GetShapesCount(), 2, ());
+
+  Put(cache, tileKey, MakeShapes(1, 1));
+  cache.Clear();
+  TEST(!Contains(cache, tileKey), ());
+  TEST(!Contains(cache, farTileKey), ());
+  TEST_EQUAL(cache.GetShapesCount(), 0, ());
+}
+
+UNIT_TEST(TileShapesCache_Epoch)
+{
+  TileShapesCache cache(100 /* maxShapesCount */);
+  TileKey const tileKey(10, 10, 10);
+  TileKey const farTileKey(100, 100, 10);
+
+  // Shapes read before an invalidation aren't put even if the invalidated tiles are other ones.
+  auto epoch = cache.GetEpoch();
+  cache.Invalidate({farTileKey});
+  cache.Put(tileKey, epoch, TileShapesParams(), MakeShapes(1, 1));
+  TEST(!Contains(cache, tileKey), ());
+
+  epoch = cache.GetEpoch();
+  cache.Put(tileKey, epoch, TileShapesParams(), MakeShapes(1, 1));
+  TEST(Contains(cache, tileKey), ());
+
+  cache.Clear();
+  cache.Put(tileKey, epoch, TileShapesParams(), MakeShapes(1, 1));
+  TEST(!Contains(cache, tileKey), ());
+
+  cache.Put(tileKey, cache.GetEpoch(), TileShapesParams(), MakeShapes(1, 1));
+  TEST(Contains(cache, tileKey), ());
+}
+}  // namespace tile_shapes_cache_tests
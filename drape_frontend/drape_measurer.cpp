@@ -340,6 +340,8 @@ std::string DrapeMeasurer::TileStatistic::ToString() const
   std::ostringstream ss;
   ss << " ----- Tiles read statistic report ----- \n";
   ss << " Tile read time, ms = " << m_tileReadTimeInMs << "\n";
+  ss << " Tile index read time, ms = " << m_indexReadTimeInMs << "\n";
+  ss << " Tile shapes generation time, ms = " << m_shapesGenTimeInMs << "\n";
   ss << " Tiles count = " << m_totalTilesCount << "\n";
   ss << " ----- Tiles read statistic report ----- \n";
 
@@ -371,6 +373,27 @@ void DrapeMeasurer::StartTileReading()
   tileInfo->m_startTileReadTime = currentTime;
 }
 
+void DrapeMeasurer::EndTileIndexReading()
+{
+  if (!m_isEnabled)
+    return;
+
+  auto const currentTime = std::chrono::steady_clock::now();
+
+  threads::ThreadID tid = threads::GetCurrentThreadID();
+  std::shared_ptr<TileReadInfo> tileInfo;
+  {
+    std::lock_guard<std::mutex> lock(m_tilesMutex);
+    auto const it = m_tilesReadInfo.find(tid);
+    if (it != m_tilesReadInfo.end())
+      tileInfo = it->second;
+    else
+      return;
+  }
+
+  tileInfo->m_totalIndexReadTime += currentTime - tileInfo->m_startTileReadTime;
+}
+
 void DrapeMeasurer::EndTileReading()
 {
   if (!m_isEnabled)
@@ -404,11 +427,18 @@ DrapeMeasurer::TileStatistic DrapeMeasurer::GetTileStatistic()
     {
       statistic.m_tileReadTimeInMs +=
           static_cast<uint32_t>(duration_cast<milliseconds>(it.second->m_totalTileReadTime).count());
+      statistic.m_indexReadTimeInMs +=
+          static_cast<uint32_t>(duration_cast<milliseconds>(it.second->m_totalIndexReadTime).count());
       statistic.m_totalTilesCount += it.second->m_totalTilesCount;
     }
   }
   if (statistic.m_totalTilesCount > 0)
+  {
     statistic.m_tileReadTimeInMs /= statistic.m_totalTilesCount;
+    statistic.m_indexReadTimeInMs /= statistic.m_totalTilesCount;
+  }
+  if (statistic.m_tileReadTimeInMs > statistic.m_indexReadTimeInMs)
+    statistic.m_shapesGenTimeInMs = statistic.m_tileReadTimeInMs - statistic.m_indexReadTimeInMs;
 
   return statistic;
 }
@@ -55,9 +55,13 @@ public:
 
     uint32_t m_totalTilesCount = 0;
     uint32_t m_tileReadTimeInMs = 0;
+    uint32_t m_indexReadTimeInMs = 0;
+    uint32_t m_shapesGenTimeInMs = 0;
   };
 
   void StartTileReading();
+  // Called when features of the tile are found, the rest of the tile reading is shapes generation.
+  void EndTileIndexReading();
   void EndTileReading();
 
   TileStatistic GetTileStatistic();
@@ -158,6 +162,7 @@ private:
   {
     std::chrono::time_point<std::chrono::steady_clock> m_startTileReadTime;
     std::chrono::nanoseconds m_totalTileReadTime;
+    std::chrono::nanoseconds m_totalIndexReadTime;
     uint32_t m_totalTilesCount = 0;
   };
   std::map<threads::ThreadID, std::shared_ptr<TileReadInfo>> m_tilesReadInfo;
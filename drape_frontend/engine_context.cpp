@@ -42,16 +42,24 @@ void EngineContext::BeginReadTile()
 
 void EngineContext::Flush(TMapShapes && shapes)
 {
-  PostMessage(make_unique_dp<MapShapeReadedMessage>(m_tileKey, std::move(shapes)));
+  auto sharedShapes = std::make_shared<TMapShapes const>(std::move(shapes));
+  if (m_recordedShapes)
+    m_recordedShapes->m_geometry.push_back(sharedShapes);
+  PostMessage(make_unique_dp<MapShapeReadedMessage>(m_tileKey, sharedShapes));
 }
 
 void EngineContext::FlushOverlays(TMapShapes && shapes)
 {
-  PostMessage(make_unique_dp<OverlayMapShapeReadedMessage>(m_tileKey, std::move(shapes)));
+  auto sharedShapes = std::make_shared<TMapShapes const>(std::move(shapes));
+  if (m_recordedShapes)
+    m_recordedShapes->m_overlays.push_back(sharedShapes);
+  PostMessage(make_unique_dp<OverlayMapShapeReadedMessage>(m_tileKey, sharedShapes));
 }
 
 void EngineContext::FlushTrafficGeometry(TrafficSegmentsGeometry && geometry)
 {
+  if (m_recordedShapes)
+    m_recordedShapes->m_trafficGeometry.push_back(geometry);
   m_commutator->PostMessage(ThreadsCommutator::ResourceUploadThread,
                             make_unique_dp<FlushTrafficGeometryMessage>(m_tileKey, std::move(geometry)),
                             MessagePriority::Low);
@@ -62,6 +70,16 @@ void EngineContext::EndReadTile()
   PostMessage(make_unique_dp<TileReadEndMessage>(m_tileKey));
 }
 
+void EngineContext::FlushRecordedShapes(TileShapes const & shapes)
+{
+  for (auto const & s : shapes.m_geometry)
+    PostMessage(make_unique_dp<MapShapeReadedMessage>(m_tileKey, s));
+  for (auto const & s : shapes.m_overlays)
+    PostMessage(make_unique_dp<OverlayMapShapeReadedMessage>(m_tileKey, s));
+  for (auto const & geometry : shapes.m_trafficGeometry)
+    FlushTrafficGeometry(TrafficSegmentsGeometry(geometry));
+}
+
 void EngineContext::PostMessage(drape_ptr<Message> && message)
 {
   m_commutator->PostMessage(ThreadsCommutator::ResourceUploadThread, std::move(message),
@@ -2,6 +2,7 @@
 
 #include "drape_frontend/custom_features_context.hpp"
 #include "drape_frontend/map_shape.hpp"
+#include "drape_frontend/tile_shapes_cache.hpp"
 #include "drape_frontend/tile_utils.hpp"
 #include "drape_frontend/threads_commutator.hpp"
 #include "drape_frontend/traffic_generator.hpp"
@@ -10,6 +11,7 @@
 #include "drape/pointers.hpp"
 
 #include <functional>
+#include <memory>
 
 namespace dp
 {
@@ -47,6 +49,11 @@ public:
   void FlushTrafficGeometry(TrafficSegmentsGeometry && geometry);
   void EndReadTile();
 
+  // Makes the context keep everything flushed after the call in |shapes|.
+  void RecordShapes(std::shared_ptr<TileShapes> const & shapes) { m_recordedShapes = shapes; }
+  // Flushes shapes recorded for the same tile before.
+  void FlushRecordedShapes(TileShapes const & shapes);
+
 private:
   void PostMessage(drape_ptr<Message> && message);
 
@@ -58,5 +65,6 @@ private:
   bool m_3dBuildingsEnabled;
   bool m_trafficEnabled;
   bool m_isolinesEnabled;
+  std::shared_ptr<TileShapes> m_recordedShapes;
 };
 }  // namespace df
@@ -8,6 +8,7 @@
 
 #include "geometry/point2d.hpp"
 
+#include <memory>
 #include <vector>
 
 namespace dp
@@ -82,15 +83,20 @@ class MapShapeReadedMessage : public MapShapeMessage
 {
 public:
   MapShapeReadedMessage(TileKey const & key, TMapShapes && shapes)
-    : MapShapeMessage(key), m_shapes(std::move(shapes))
+    : MapShapeReadedMessage(key, std::make_shared<TMapShapes const>(std::move(shapes)))
+  {}
+
+  // Shapes may be shared with TileShapesCache, they are drawn again for the revisited tile.
+  MapShapeReadedMessage(TileKey const & key, std::shared_ptr<TMapShapes const> const & shapes)
+    : MapShapeMessage(key), m_shapes(shapes)
   {}
 
   Type GetType() const override { return Type::MapShapeReaded; }
   bool IsGraphicsContextDependent() const override { return true; }
-  TMapShapes const & GetShapes() { return m_shapes; }
+  TMapShapes const & GetShapes() { return *m_shapes; }
 
 private:
-  TMapShapes m_shapes;
+  std::shared_ptr<TMapShapes const> m_shapes;
 };
 
 class OverlayMapShapeReadedMessage : public MapShapeReadedMessage
@@ -100,6 +106,10 @@ public:
     : MapShapeReadedMessage(key, std::move(shapes))
   {}
 
+  OverlayMapShapeReadedMessage(TileKey const & key, std::shared_ptr<TMapShapes const> const & shapes)
+    : MapShapeReadedMessage(key, shapes)
+  {}
+
   Type GetType() const override { return Message::Type::OverlayMapShapeReaded; }
 };
 }  // namespace df
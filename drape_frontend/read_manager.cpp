@@ -3,6 +3,8 @@
 #include "drape_frontend/metaline_manager.hpp"
 #include "drape_frontend/visual_params.hpp"
 
+#include "platform/platform.hpp"
+
 #include "base/buffer_vector.hpp"
 #include "base/stl_helpers.hpp"
 
@@ -13,6 +15,12 @@ namespace df
 {
 namespace
 {
+size_t constexpr kMinReadingThreadsCount = 2;
+size_t constexpr kMaxReadingThreadsCount = 8;
+// Frontend and backend renderers.
+size_t constexpr kRenderThreadsCount = 2;
+size_t constexpr kMaxCachedShapesCount = 50000;
+
 struct LessCoverageCell
 {
   bool operator()(std::shared_ptr<TileInfo> const & l,
@@ -35,6 +43,13 @@ struct LessCoverageCell
 };
 }  // namespace
 
+size_t GetReadingThreadsCount()
+{
+  size_t const cores = GetPlatform().CpuCores();
+  size_t const freeCores = cores > kRenderThreadsCount ? cores - kRenderThreadsCount : 0;
+  return std::clamp(freeCores, kMinReadingThreadsCount, kMaxReadingThreadsCount);
+}
+
 bool ReadManager::LessByTileInfo::operator()(std::shared_ptr<TileInfo> const & l,
                                              std::shared_ptr<TileInfo> const & r) const
 {
@@ -45,6 +60,7 @@ ReadManager::ReadManager(ref_ptr<ThreadsCommutator> commutator, MapDataProvider
                          bool allow3dBuildings, bool trafficEnabled, bool isolinesEnabled)
   : m_commutator(commutator)
   , m_model(model)
+  , m_shapesCache(kMaxCachedShapesCount)
   , m_have3dBuildings(false)
   , m_allow3dBuildings(allow3dBuildings)
   , m_trafficEnabled(trafficEnabled)
@@ -65,7 +81,7 @@ void ReadManager::Start()
 
   ASSERT_EQUAL(m_counter, 0, ());
 
-  m_pool = make_unique_dp<base::thread_pool::routine::ThreadPool>(kReadingThreadsCount,
+  m_pool = make_unique_dp<base::thread_pool::routine::ThreadPool>(GetReadingThreadsCount(),
                               std::bind(&ReadManager::OnTaskFinished, this, std::placeholders::_1));
 }
 
@@ -135,6 +151,10 @@ void ReadManager::UpdateCoverage(ScreenBase const & screen, bool have3dBuildings
 
   if (m_modeChanged || forceUpdate || MustDropAllTiles(screen))
   {
+    // Forced updates re-read tiles because of the changed data the shapes cache isn't keyed on
+    // (e.g. loaded metalines or regenerated traffic), so the cached shapes are outdated.
+    if (m_modeChanged || forceUpdate)
+      m_shapesCache.Clear();
     m_modeChanged = false;
 
     for (auto const & info : m_tileInfos)
@@ -145,8 +165,7 @@ void ReadManager::UpdateCoverage(ScreenBase const & screen, bool have3dBuildings
     ++m_generationCounter;
     ++m_userMarksGenerationCounter;
 
-    for (auto const & tileKey : tiles)
-      PushTaskBackForTileKey(tileKey, texMng, metalineMng);
+    PushTasksForTiles(screen, tiles, texMng, metalineMng);
   }
   else
   {
@@ -177,8 +196,7 @@ void ReadManager::UpdateCoverage(ScreenBase const & screen, bool have3dBuildings
       ++m_userMarksGenerationCounter;
     CheckFinishedTiles(readyTiles, forceUpdateUserMarks);
 
-    for (auto const & tileKey : newTiles)
-      PushTaskBackForTileKey(tileKey, texMng, metalineMng);
+    PushTasksForTiles(screen, newTiles, texMng, metalineMng);
   }
 
   m_currentViewport = screen;
@@ -186,6 +204,8 @@ void ReadManager::UpdateCoverage(ScreenBase const & screen, bool have3dBuildings
 
 void ReadManager::Invalidate(TTilesCollection const & keyStorage)
 {
+  m_shapesCache.Invalidate(keyStorage);
+
   TTileSet tilesToErase;
   for (auto const & info : m_tileInfos)
   {
@@ -202,6 +222,9 @@ void ReadManager::Invalidate(TTilesCollection const & keyStorage)
 
 void ReadManager::InvalidateAll()
 {
+  // Textures or the map style may be changed.
+  m_shapesCache.Clear();
+
   for (auto const & info : m_tileInfos)
     CancelTileInfo(info);
   m_tileInfos.clear();
@@ -237,7 +260,8 @@ void ReadManager::PushTaskBackForTileKey(TileKey const & tileKey,
                                                m_customFeaturesContext,
                                                m_have3dBuildings && m_allow3dBuildings,
                                                m_trafficEnabled, m_isolinesEnabled);
-  std::shared_ptr<TileInfo> tileInfo = std::make_shared<TileInfo>(std::move(context));
+  std::shared_ptr<TileInfo> tileInfo = std::make_shared<TileInfo>(std::move(context),
+                                                                  make_ref(&m_shapesCache));
   m_tileInfos.insert(tileInfo);
 
   /// @todo Do we really need ReadMWMTask pool? Avoid "new" with hand-written bicycle? ;)
@@ -253,6 +277,29 @@ void ReadManager::PushTaskBackForTileKey(TileKey const & tileKey,
   m_pool->PushBack(task);
 }
 
+template <typename TTiles>
+void ReadManager::PushTasksForTiles(ScreenBase const & screen, TTiles const & tiles,
+                                    ref_ptr<dp::TextureManager> texMng,
+                                    ref_ptr<MetalineManager> metalineMng)
+{
+  // Tiles are read by the pool threads in the order of pushing, so the tiles in the middle
+  // of the screen are shown first, it matters when a lot of tiles are read after a zoom jump.
+  m2::PointD const center = screen.GlobalRect().GlobalCenter();
+  buffer_vector<std::pair<double, TileKey>, 8> orderedTiles;
+  orderedTiles.reserve(tiles.size());
+  for (auto const & tileKey : tiles)
+  {
+    m2::RectD const rect = tileKey.GetGlobalRect(false /* clipByDataMaxZoom */);
+    orderedTiles.emplace_back(rect.Center().SquaredLength(center), tileKey);
+  }
+
+  std::sort(orderedTiles.begin(), orderedTiles.end(),
+            base::LessBy(&std::pair<double, TileKey>::first));
+
+  for (auto const & tile : orderedTiles)
+    PushTaskBackForTileKey(tile.second, texMng, metalineMng);
+}
+
 void ReadManager::CheckFinishedTiles(TTileInfoCollection const & requestedTiles, bool forceUpdateUserMarks)
 {
   if (requestedTiles.empty())
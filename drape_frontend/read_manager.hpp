@@ -3,6 +3,7 @@
 #include "drape_frontend/engine_context.hpp"
 #include "drape_frontend/read_mwm_task.hpp"
 #include "drape_frontend/tile_info.hpp"
+#include "drape_frontend/tile_shapes_cache.hpp"
 #include "drape_frontend/tile_utils.hpp"
 
 #include "geometry/screenbase.hpp"
@@ -27,7 +28,9 @@ namespace df
 class MapDataProvider;
 class MetalineManager;
 
-uint8_t constexpr kReadingThreadsCount = 2;
+// Returns the number of tile reading threads for the current hardware: all the cores but
+// the ones of the render threads, at least kMinReadingThreadsCount.
+size_t GetReadingThreadsCount();
 
 class ReadManager
 {
@@ -69,11 +72,17 @@ private:
 
   void PushTaskBackForTileKey(TileKey const & tileKey, ref_ptr<dp::TextureManager> texMng,
                               ref_ptr<MetalineManager> metalineMng);
+  // Pushes tasks for |tiles| so that the tiles closer to the center of |screen| are read first.
+  template <typename TTiles>
+  void PushTasksForTiles(ScreenBase const & screen, TTiles const & tiles,
+                         ref_ptr<dp::TextureManager> texMng, ref_ptr<MetalineManager> metalineMng);
 
   ref_ptr<ThreadsCommutator> m_commutator;
 
   MapDataProvider & m_model;
 
+  // Must outlive the reading tasks.
+  TileShapesCache m_shapesCache;
   drape_ptr<base::thread_pool::routine::ThreadPool> m_pool;
 
   ScreenBase m_currentViewport;
@@ -20,8 +20,9 @@ using namespace std::placeholders;
 
 namespace df
 {
-TileInfo::TileInfo(drape_ptr<EngineContext> && engineContext)
+TileInfo::TileInfo(drape_ptr<EngineContext> && engineContext, ref_ptr<TileShapesCache> shapesCache)
   : m_context(std::move(engineContext))
+  , m_shapesCache(shapesCache)
   , m_isCanceled(false)
 {}
 
@@ -63,21 +64,45 @@ void TileInfo::ReadFeatures(MapDataProvider const & model)
   // Reading can be interrupted by exception throwing
   SCOPE_GUARD(ReleaseReadTile, std::bind(&EngineContext::EndReadTile, m_context.get()));
 
+  // Shapes read from the data which is invalidated during reading must not be cached.
+  auto const shapesCacheEpoch = m_shapesCache->GetEpoch();
   ReadFeatureIndex(model);
   ThrowIfCancelled();
+#if defined(DRAPE_MEASURER_BENCHMARK) && defined(TILES_STATISTIC)
+  DrapeMeasurer::Instance().EndTileIndexReading();
+#endif
 
   m_context->GetMetalineManager()->Update(m_mwms);
 
   if (!m_featureInfo.empty())
   {
-    std::sort(m_featureInfo.begin(), m_featureInfo.end());
     auto const deviceLang = StringUtf8Multilang::GetLangIndex(languages::GetCurrentNorm());
-    RuleDrawer drawer(std::bind(&TileInfo::IsCancelled, this), model.m_isCountryLoadedByName,
-                      make_ref(m_context), deviceLang);
-    model.ReadFeatures(std::bind<void>(std::ref(drawer), _1), m_featureInfo);
+    auto params = GetShapesParams(deviceLang);
+    if (auto const shapes = m_shapesCache->Find(GetTileKey(), params))
+    {
+      m_context->FlushRecordedShapes(*shapes);
+    }
+    else
+    {
+      auto recordedShapes = std::make_shared<TileShapes>();
+      m_context->RecordShapes(recordedShapes);
+
+      std::sort(m_featureInfo.begin(), m_featureInfo.end());
+      {
+        RuleDrawer drawer(std::bind(&TileInfo::IsCancelled, this), model.m_isCountryLoadedByName,
+                          make_ref(m_context), deviceLang);
+        model.ReadFeatures(std::bind<void>(std::ref(drawer), _1), m_featureInfo);
 #ifdef DRAW_TILE_NET
-    drawer.DrawTileNet();
+        drawer.DrawTileNet();
 #endif
+      }
+
+      m_context->RecordShapes(nullptr);
+      // Shapes of a cancelled tile may be incomplete.
+      if (!IsCancelled())
+        m_shapesCache->Put(GetTileKey(), shapesCacheEpoch, std::move(params),
+                           std::move(recordedShapes));
+    }
   }
 #if defined(DRAPE_MEASURER_BENCHMARK) && defined(TILES_STATISTIC)
   DrapeMeasurer::Instance().EndTileReading();
@@ -110,6 +135,18 @@ bool TileInfo::DoNeedReadIndex() const
   return m_featureInfo.empty();
 }
 
+TileShapesParams TileInfo::GetShapesParams(int8_t deviceLang) const
+{
+  TileShapesParams params;
+  params.m_mwms = m_mwms;
+  params.m_customFeaturesContext = m_context->GetCustomFeaturesContext().lock();
+  params.m_deviceLang = deviceLang;
+  params.m_3dBuildingsEnabled = m_context->Is3dBuildingsEnabled();
+  params.m_trafficEnabled = m_context->IsTrafficEnabled();
+  params.m_isolinesEnabled = m_context->IsolinesEnabled();
+  return params;
+}
+
 int TileInfo::GetZoomLevel() const
 {
   return ClipTileZoomByMaxDataZoom(m_context->GetTileKey().m_zoomLevel);
@@ -0,0 +1,120 @@
+#include "drape_frontend/tile_shapes_cache.hpp"
+
+#include "base/assert.hpp"
+
+#include <iterator>
+#include <utility>
+
+namespace df
+{
+bool TileShapesParams::operator==(TileShapesParams const & rhs) const
+{
+  return m_mwms == rhs.m_mwms && m_customFeaturesContext == rhs.m_customFeaturesContext &&
+         m_deviceLang == rhs.m_deviceLang && m_3dBuildingsEnabled == rhs.m_3dBuildingsEnabled &&
+         m_trafficEnabled == rhs.m_trafficEnabled && m_isolinesEnabled == rhs.m_isolinesEnabled;
+}
+
+TileShapesCache::TileShapesCache(size_t maxShapesCount) : m_maxShapesCount(maxShapesCount) {}
+
+uint64_t TileShapesCache::GetEpoch()
+{
+  std::lock_guard lock(m_mutex);
+  return m_epoch;
+}
+
+std::shared_ptr<TileShapes const> TileShapesCache::Find(TileKey const & tileKey,
+                                                        TileShapesParams const & params)
+{
+  std::lock_guard lock(m_mutex);
+  auto const it = m_tileToEntry.find(tileKey);
+  if (it == m_tileToEntry.end())
+    return nullptr;
+
+  if (!(it->second->m_params == params))
+  {
+    Erase(it->second);
+    return nullptr;
+  }
+
+  m_entries.splice(m_entries.begin(), m_entries, it->second);
+  return it->second->m_shapes;
+}
+
+void TileShapesCache::Put(TileKey const & tileKey, uint64_t epoch, TileShapesParams && params,
+                          std::shared_ptr<TileShapes const> shapes)
+{
+  CHECK(shapes, ());
+
+  size_t shapesCount = 0;
+  for (auto const & s : shapes->m_geometry)
+    shapesCount += s->size();
+  for (auto const & s : shapes->m_overlays)
+    shapesCount += s->size();
+
+  // Too heavy tiles would flush the whole cache.
+  if (shapesCount > m_maxShapesCount / 2)
+    return;
+
+  std::lock_guard lock(m_mutex);
+  if (epoch != m_epoch)
+    return;
+
+  auto const it = m_tileToEntry.find(tileKey);
+  if (it != m_tileToEntry.end())
+    Erase(it->second);
+
+  while (!m_entries.empty() && m_shapesCount + shapesCount > m_maxShapesCount)
+    Erase(std::prev(m_entries.end()));
+
+  m_entries.push_front({tileKey, std::move(params), std::move(shapes), shapesCount});
+  m_tileToEntry.emplace(tileKey, m_entries.begin());
+  m_shapesCount += shapesCount;
+}
+
+void TileShapesCache::Invalidate(TTilesCollection const & tiles)
+{
+  std::vector<m2::RectD> rects;
+  rects.reserve(tiles.size());
+  for (auto const & tileKey : tiles)
+    rects.push_back(tileKey.GetGlobalRect(false /* clipByDataMaxZoom */));
+
+  std::lock_guard lock(m_mutex);
+  ++m_epoch;
+  for (auto it = m_entries.begin(); it != m_entries.end();)
+  {
+    auto const current = it++;
+    m2::RectD const rect = current->m_tileKey.GetGlobalRect(false /* clipByDataMaxZoom */);
+    for (auto const & r : rects)
+    {
+      if (rect.IsIntersect(r))
+      {
+        Erase(current);
+        break;
+      }
+    }
+  }
+}
+
+void TileShapesCache::Clear()
+{
+  std::lock_guard lock(m_mutex);
+  ++m_epoch;
+  m_entries.clear();
+  m_tileToEntry.clear();
+  m_shapesCount = 0;
+}
+
+size_t TileShapesCache::GetShapesCount()
+{
+  std::lock_guard lock(m_mutex);
+  return m_shapesCount;
+}
+
+void TileShapesCache::Erase(Entries::iterator it)
+{
+  ASSERT_GREATER_OR_EQUAL(m_shapesCount, it->m_shapesCount, ());
+  m_shapesCount -= it->m_shapesCount;
+  m_tileToEntry.erase(it->m_tileKey);
+  m_entries.erase(it);
+}
+}  // namespace df
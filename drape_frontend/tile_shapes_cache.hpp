@@ -0,0 +1,91 @@
+#pragma once
+
+#include "drape_frontend/custom_features_context.hpp"
+#include "drape_frontend/map_shape.hpp"
+#include "drape_frontend/tile_key.hpp"
+#include "drape_frontend/tile_utils.hpp"
+#include "drape_frontend/traffic_generator.hpp"
+
+#include "indexer/mwm_set.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <vector>
+
+namespace df
+{
+// Shapes generated by RuleDrawer for a tile in the order of flushing.
+struct TileShapes
+{
+  std::vector<std::shared_ptr<TMapShapes const>> m_geometry;
+  std::vector<std::shared_ptr<TMapShapes const>> m_overlays;
+  std::vector<TrafficSegmentsGeometry> m_trafficGeometry;
+};
+
+// Everything but the tile key and the map style the shapes of a tile depend on.
+struct TileShapesParams
+{
+  bool operator==(TileShapesParams const & rhs) const;
+
+  // Mwm ids change when mwms are updated or (re)registered.
+  std::set<MwmSet::MwmId> m_mwms;
+  CustomFeaturesContextPtr m_customFeaturesContext;
+  int8_t m_deviceLang = 0;
+  bool m_3dBuildingsEnabled = false;
+  bool m_trafficEnabled = false;
+  bool m_isolinesEnabled = false;
+};
+
+// LRU cache of tile shapes. It lets revisited tiles skip features decoding and shapes
+// generation. The cache is used from the reading threads so it's thread-safe.
+// Shapes keep texture regions, so the cache must be cleared when textures or the map style
+// are changed.
+class TileShapesCache
+{
+public:
+  explicit TileShapesCache(size_t maxShapesCount);
+
+  // Returns the number of invalidations and clearings done so far. A reading thread gets it
+  // before reading a tile and passes it to Put.
+  uint64_t GetEpoch();
+
+  // Returns nullptr if there are no shapes for |tileKey| generated with |params|.
+  std::shared_ptr<TileShapes const> Find(TileKey const & tileKey, TileShapesParams const & params);
+  // Doesn't put the shapes if the cache was invalidated or cleared after |epoch| was got,
+  // because the shapes may be generated from the outdated data.
+  void Put(TileKey const & tileKey, uint64_t epoch, TileShapesParams && params,
+           std::shared_ptr<TileShapes const> shapes);
+
+  // Removes the shapes of all the tiles of any zoom level which intersect |tiles|.
+  void Invalidate(TTilesCollection const & tiles);
+  void Clear();
+
+  size_t GetShapesCount();
+
+private:
+  struct Entry
+  {
+    TileKey m_tileKey;
+    TileShapesParams m_params;
+    std::shared_ptr<TileShapes const> m_shapes;
+    size_t m_shapesCount = 0;
+  };
+  using Entries = std::list<Entry>;
+
+  void Erase(Entries::iterator it);
+
+  size_t const m_maxShapesCount;
+  size_t m_shapesCount = 0;
+  uint64_t m_epoch = 0;
+
+  // The most recently used entries are in the front.
+  Entries m_entries;
+  std::map<TileKey, Entries::iterator> m_tileToEntry;
+  std::mutex m_mutex;
+};
+}  // namespace df
@@ -45,7 +45,10 @@ using namespace routing;
 class SrtmGetter : public AltitudeGetter
 {
 public:
-  explicit SrtmGetter(std::string const & srtmDir) : m_srtmManager(srtmDir) {}
+  SrtmGetter(std::string const & srtmDir, std::string const & srtmCacheDir)
+    : m_srtmManager(srtmDir, generator::SrtmTileManager::kDefaultMaxTilesCount, srtmCacheDir)
+  {
+  }
 
   // AltitudeGetter overrides:
   geometry::Altitude GetAltitude(m2::PointD const & p) override
@@ -155,6 +158,12 @@ private:
 namespace routing
 {
 void BuildRoadAltitudes(std::string const & mwmPath, AltitudeGetter & altitudeGetter)
+{
+  BuildRoadAltitudes(mwmPath, mwmPath, altitudeGetter);
+}
+
+void BuildRoadAltitudes(std::string const & mwmPath, std::string const & sectionsPath,
+                        AltitudeGetter & altitudeGetter)
 {
   try
   {
@@ -170,7 +179,7 @@ void BuildRoadAltitudes(std::string const & mwmPath, AltitudeGetter & altitudeGe
 
     CHECK(processor.IsFeatureAltitudesSorted(), ());
 
-    FilesContainerW cont(mwmPath, FileWriter::OP_WRITE_EXISTING);
+    FilesContainerW cont(sectionsPath, FileWriter::OP_WRITE_EXISTING);
     auto w = cont.GetWriter(ALTITUDES_FILE_TAG);
 
     AltitudeHeader header;
@@ -235,8 +244,14 @@ void BuildRoadAltitudes(std::string const & mwmPath, AltitudeGetter & altitudeGe
 
 void BuildRoadAltitudes(std::string const & mwmPath, std::string const & srtmDir)
 {
-  LOG(LINFO, ("mwmPath =", mwmPath, "srtmDir =", srtmDir));
-  SrtmGetter srtmGetter(srtmDir);
-  BuildRoadAltitudes(mwmPath, srtmGetter);
+  BuildRoadAltitudes(mwmPath, mwmPath, srtmDir);
+}
+
+void BuildRoadAltitudes(std::string const & mwmPath, std::string const & sectionsPath,
+                        std::string const & srtmDir, std::string const & srtmCacheDir)
+{
+  LOG(LINFO, ("mwmPath =", mwmPath, "srtmDir =", srtmDir, "srtmCacheDir =", srtmCacheDir));
+  SrtmGetter srtmGetter(srtmDir, srtmCacheDir);
+  BuildRoadAltitudes(mwmPath, sectionsPath, srtmGetter);
 }
 }  // namespace routing
@@ -27,4 +27,11 @@ public:
 /// alt. info offset    altitude info         end of section - alt. info offset
 void BuildRoadAltitudes(std::string const & mwmPath, AltitudeGetter & altitudeGetter);
 void BuildRoadAltitudes(std::string const & mwmPath, std::string const & srtmDir);
+
+/// \brief Same as above but writes the section to the container at |sectionsPath|.
+void BuildRoadAltitudes(std::string const & mwmPath, std::string const & sectionsPath,
+                        AltitudeGetter & altitudeGetter);
+/// Zipped srtm tiles are decompressed into |srtmCacheDir| once if it's not empty.
+void BuildRoadAltitudes(std::string const & mwmPath, std::string const & sectionsPath,
+                        std::string const & srtmDir, std::string const & srtmCacheDir = {});
 }  // namespace routing
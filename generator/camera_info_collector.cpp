@@ -326,12 +326,18 @@ void CamerasInfoCollector::Camera::Serialize(FileWriter & writer,
 void BuildCamerasInfo(std::string const & dataFilePath,
                       std::string const & camerasInfoPath,
                       std::string const & osmIdsToFeatureIdsPath)
+{
+  BuildCamerasInfo(dataFilePath, dataFilePath, camerasInfoPath, osmIdsToFeatureIdsPath);
+}
+
+void BuildCamerasInfo(std::string const & dataFilePath, std::string const & sectionsPath,
+                      std::string const & camerasInfoPath, std::string const & osmIdsToFeatureIdsPath)
 {
   LOG(LINFO, ("Generating cameras info for", dataFilePath));
 
   generator::CamerasInfoCollector collector(dataFilePath, camerasInfoPath, osmIdsToFeatureIdsPath);
 
-  FilesContainerW cont(dataFilePath, FileWriter::OP_WRITE_EXISTING);
+  FilesContainerW cont(sectionsPath, FileWriter::OP_WRITE_EXISTING);
   auto writer = cont.GetWriter(CAMERAS_INFO_FILE_TAG);
 
   collector.Serialize(*writer);
@@ -82,4 +82,7 @@ private:
 // 5. BuildIndexFromDataFile() - for doing search in rect.
 void BuildCamerasInfo(std::string const & dataFilePath, std::string const & camerasInfoPath,
                       std::string const & osmIdsToFeatureIdsPath);
+// Same as above but writes the section to the container at |sectionsPath|.
+void BuildCamerasInfo(std::string const & dataFilePath, std::string const & sectionsPath,
+                      std::string const & camerasInfoPath, std::string const & osmIdsToFeatureIdsPath);
 }  // namespace generator
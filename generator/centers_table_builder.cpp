@@ -14,6 +14,12 @@
 namespace indexer
 {
 bool BuildCentersTableFromDataFile(std::string const & filename, bool forceRebuild)
+{
+  return BuildCentersTableFromDataFile(filename, filename, forceRebuild);
+}
+
+bool BuildCentersTableFromDataFile(std::string const & filename, std::string const & sectionsFile,
+                                   bool forceRebuild)
 {
   try
   {
@@ -42,7 +48,7 @@ bool BuildCentersTableFromDataFile(std::string const & filename, bool forceRebui
     }
 
     {
-      FilesContainerW writeContainer(filename, FileWriter::OP_WRITE_EXISTING);
+      FilesContainerW writeContainer(sectionsFile, FileWriter::OP_WRITE_EXISTING);
       auto writer = writeContainer.GetWriter(CENTERS_FILE_TAG);
       builder.Freeze(*writer);
     }
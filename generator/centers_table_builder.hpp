@@ -10,4 +10,8 @@ namespace indexer
 // Builds the latest version of the centers table section and writes
 // it to the mwm file.
 bool BuildCentersTableFromDataFile(std::string const & filename, bool forceRebuild = false);
+
+// Same as above but writes the section to the container at |sectionsFile|.
+bool BuildCentersTableFromDataFile(std::string const & filename, std::string const & sectionsFile,
+                                   bool forceRebuild = false);
 }  // namespace indexer
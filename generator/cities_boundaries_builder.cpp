@@ -31,7 +31,8 @@ namespace
 {
 
 template <class BoundariesTable, class MappingT>
-bool BuildCitiesBoundaries(string const & dataPath, BoundariesTable & table, MappingT const & mapping)
+bool BuildCitiesBoundaries(string const & dataPath, string const & sectionsPath, BoundariesTable & table,
+                           MappingT const & mapping)
 {
   auto const localities = GetLocalities(dataPath);
 
@@ -50,7 +51,7 @@ bool BuildCitiesBoundaries(string const & dataPath, BoundariesTable & table, Map
     all.emplace_back(std::move(bs));
   });
 
-  FilesContainerW container(dataPath, FileWriter::OP_WRITE_EXISTING);
+  FilesContainerW container(sectionsPath, FileWriter::OP_WRITE_EXISTING);
   auto sink = container.GetWriter(CITIES_BOUNDARIES_FILE_TAG);
   CitiesBoundariesSerDes::Serialize(*sink, all);
 
@@ -59,6 +60,12 @@ bool BuildCitiesBoundaries(string const & dataPath, BoundariesTable & table, Map
 }  // namespace
 
 bool BuildCitiesBoundaries(string const & dataPath, OsmIdToBoundariesTable & table)
+{
+  return BuildCitiesBoundaries(dataPath, dataPath, table);
+}
+
+bool BuildCitiesBoundaries(string const & dataPath, string const & sectionsPath,
+                           OsmIdToBoundariesTable & table)
 {
   std::unordered_map<uint32_t, base::GeoObjectId> mapping;
   if (!ParseFeatureIdToOsmIdMapping(dataPath + OSM2FEATURE_FILE_EXTENSION, mapping))
@@ -66,7 +73,7 @@ bool BuildCitiesBoundaries(string const & dataPath, OsmIdToBoundariesTable & tab
     LOG(LERROR, ("Can't parse feature id to osm id mapping."));
     return false;
   }
-  return BuildCitiesBoundaries(dataPath, table, mapping);
+  return BuildCitiesBoundaries(dataPath, sectionsPath, table, mapping);
 }
 
 bool BuildCitiesBoundariesForTesting(string const & dataPath, TestIdToBoundariesTable & table)
@@ -77,7 +84,7 @@ bool BuildCitiesBoundariesForTesting(string const & dataPath, TestIdToBoundaries
     LOG(LERROR, ("Can't parse feature id to test id mapping."));
     return false;
   }
-  return BuildCitiesBoundaries(dataPath, table, mapping);
+  return BuildCitiesBoundaries(dataPath, dataPath, table, mapping);
 }
 
 void SerializeBoundariesTable(std::string const & path, OsmIdToBoundariesTable & table)
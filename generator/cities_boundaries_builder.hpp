@@ -15,6 +15,9 @@ using OsmIdToBoundariesTable =
 using TestIdToBoundariesTable = base::ClusteringMap<uint64_t, indexer::CityBoundary>;
 
 bool BuildCitiesBoundaries(std::string const & dataPath, OsmIdToBoundariesTable & table);
+// Same as above but writes the section to the container at |sectionsPath|.
+bool BuildCitiesBoundaries(std::string const & dataPath, std::string const & sectionsPath,
+                           OsmIdToBoundariesTable & table);
 bool BuildCitiesBoundariesForTesting(std::string const & dataPath, TestIdToBoundariesTable & table);
 
 void SerializeBoundariesTable(std::string const & path, OsmIdToBoundariesTable & table);
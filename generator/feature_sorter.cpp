@@ -27,12 +27,16 @@
 #include "base/logging.hpp"
 #include "base/scope_guard.hpp"
 #include "base/string_utils.hpp"
+#include "base/thread_pool_computational.hpp"
 
 #include "defines.hpp"
 
+#include <algorithm>
+#include <future>
 #include <limits>
 #include <list>
 #include <memory>
+#include <numeric>
 #include <vector>
 
 
@@ -143,11 +147,106 @@ public:
 
   void SetBounds(m2::RectD const & bounds) { m_bounds = bounds; }
 
-  void operator()(FeatureBuilder & fb)
+  // Geometry of a feature serialized into memory.
+  struct FeatureGeometry
   {
-    GeometryHolder holder([this](int i) -> FileWriter & { return *m_geoFile[i]; },
-                          [this](int i) -> FileWriter & { return *m_trgFile[i]; }, fb, m_header);
+    FeatureBuilder::SupportingData m_data;
+    // Serialized outer points and triangles of every scale.
+    std::vector<std::vector<uint8_t>> m_points;
+    std::vector<std::vector<uint8_t>> m_triangles;
+  };
+
+  // Simplifies, tesselates and serializes geometry of |fb| into |geometry|.
+  // It's thread-safe, so geometry of different features may be processed concurrently.
+  void ProcessGeometry(FeatureBuilder & fb, FeatureGeometry & geometry) const
+  {
+    size_t const scalesCount = m_header.GetScalesCount();
+    geometry.m_points.assign(scalesCount, {});
+    geometry.m_triangles.assign(scalesCount, {});
+
+    std::vector<MemWriter<std::vector<uint8_t>>> pointsWriters;
+    std::vector<MemWriter<std::vector<uint8_t>>> trianglesWriters;
+    pointsWriters.reserve(scalesCount);
+    trianglesWriters.reserve(scalesCount);
+    for (size_t i = 0; i < scalesCount; ++i)
+    {
+      pointsWriters.emplace_back(geometry.m_points[i]);
+      trianglesWriters.emplace_back(geometry.m_triangles[i]);
+    }
+
+    GeometryHolder holder([&pointsWriters](int i) -> Writer & { return pointsWriters[i]; },
+                          [&trianglesWriters](int i) -> Writer & { return trianglesWriters[i]; },
+                          fb, m_header);
+    ProcessGeometry(fb, holder);
+    geometry.m_data = std::move(holder.GetBuffer());
+  }
+
+  // Writes the processed geometry of |fb| into the sections and saves the feature.
+  // Must be called in the order of features.
+  void operator()(FeatureBuilder & fb, FeatureGeometry & geometry)
+  {
+    auto & buffer = geometry.m_data;
+    WriteGeometry(geometry.m_points, buffer.m_ptsMask, m_geoFile, buffer.m_ptsOffset);
+    WriteGeometry(geometry.m_triangles, buffer.m_trgMask, m_trgFile, buffer.m_trgOffset);
+
+    // Override "alt_name" with synonym for Country or State for better search matching.
+    /// @todo Probably, we should store and index OSM's short_name tag.
+    if (indexer::SynonymsHolder::CanApply(fb.GetTypes()))
+    {
+      int8_t const langs[] = {
+        StringUtf8Multilang::kDefaultCode,
+        StringUtf8Multilang::kEnglishCode,
+        StringUtf8Multilang::kInternationalCode
+      };
+
+      bool added = false;
+      for (int8_t lang : langs)
+      {
+        m_synonyms.ForEach(std::string(fb.GetName(lang)), [&fb, &added](std::string const & synonym)
+        {
+          // Assign first synonym, skip others.
+          if (added)
+            return;
+
+          auto oldName = fb.GetName(StringUtf8Multilang::kAltNameCode);
+          if (!oldName.empty())
+            LOG(LWARNING, ("Replace", oldName, "with", synonym, "for", fb.GetMostGenericOsmId()));
+
+          fb.SetName(StringUtf8Multilang::kAltNameCode, synonym);
+          added = true;
+        });
+
+        if (added)
+          break;
+      }
+    }
 
+    if (fb.PreSerializeAndRemoveUselessNamesForMwm(buffer))
+    {
+      fb.SerializeForMwm(buffer, m_header.GetDefGeometryCodingParams());
+
+      uint32_t const featureId = WriteFeatureBase(buffer.m_buffer, fb);
+
+      // Order is important here:
+
+      // 1. Update postcode info.
+      m_boundaryPostcodesEnricher.Enrich(fb);
+
+      // 2. Write address to a file (with possible updated postcode above).
+      fb.GetParams().SerializeAddress(*m_addrFile);
+
+      // 3. Save metadata.
+      if (!fb.GetMetadata().Empty())
+        m_metadataBuilder.Put(featureId, fb.GetMetadata());
+
+      if (fb.HasOsmIds())
+        m_osm2ft.AddIds(generator::MakeCompositeId(fb), featureId);
+    }
+  }
+
+private:
+  void ProcessGeometry(FeatureBuilder & fb, GeometryHolder & holder) const
+  {
     if (!fb.IsPoint())
     {
       bool const isLine = fb.IsLine();
@@ -249,64 +348,8 @@ public:
         }
       }
     }
-
-    // Override "alt_name" with synonym for Country or State for better search matching.
-    /// @todo Probably, we should store and index OSM's short_name tag.
-    if (indexer::SynonymsHolder::CanApply(fb.GetTypes()))
-    {
-      int8_t const langs[] = {
-        StringUtf8Multilang::kDefaultCode,
-        StringUtf8Multilang::kEnglishCode,
-        StringUtf8Multilang::kInternationalCode
-      };
-
-      bool added = false;
-      for (int8_t lang : langs)
-      {
-        m_synonyms.ForEach(std::string(fb.GetName(lang)), [&fb, &added](std::string const & synonym)
-        {
-          // Assign first synonym, skip others.
-          if (added)
-            return;
-
-          auto oldName = fb.GetName(StringUtf8Multilang::kAltNameCode);
-          if (!oldName.empty())
-            LOG(LWARNING, ("Replace", oldName, "with", synonym, "for", fb.GetMostGenericOsmId()));
-
-          fb.SetName(StringUtf8Multilang::kAltNameCode, synonym);
-          added = true;
-        });
-
-        if (added)
-          break;
-      }
-    }
-
-    auto & buffer = holder.GetBuffer();
-    if (fb.PreSerializeAndRemoveUselessNamesForMwm(buffer))
-    {
-      fb.SerializeForMwm(buffer, m_header.GetDefGeometryCodingParams());
-
-      uint32_t const featureId = WriteFeatureBase(buffer.m_buffer, fb);
-
-      // Order is important here:
-
-      // 1. Update postcode info.
-      m_boundaryPostcodesEnricher.Enrich(fb);
-
-      // 2. Write address to a file (with possible updated postcode above).
-      fb.GetParams().SerializeAddress(*m_addrFile);
-
-      // 3. Save metadata.
-      if (!fb.GetMetadata().Empty())
-        m_metadataBuilder.Put(featureId, fb.GetMetadata());
-
-      if (fb.HasOsmIds())
-        m_osm2ft.AddIds(generator::MakeCompositeId(fb), featureId);
-    }
   }
 
-private:
   using Points = std::vector<m2::PointD>;
   using Polygons = std::list<Points>;
 
@@ -321,6 +364,36 @@ private:
 
   bool IsCountry() const { return m_header.GetType() == feature::DataHeader::MapType::Country; }
 
+  // Appends serialized geometry of every scale to |files| and turns offsets in the buffers
+  // into offsets in the files.
+  static void WriteGeometry(std::vector<std::vector<uint8_t>> const & buffers, uint8_t mask,
+                            TmpFiles & files, FeatureBuilder::Offsets & offsets)
+  {
+    // GeometryHolder adds an offset for every bit of |mask| from the upper scale to the lower one.
+    size_t offsetIndex = 0;
+    for (size_t i = buffers.size(); i > 0; --i)
+    {
+      size_t const scaleIndex = i - 1;
+      if ((mask & (1 << scaleIndex)) == 0)
+        continue;
+
+      CHECK_LESS(offsetIndex, offsets.size(), ());
+      auto & offset = offsets[offsetIndex++];
+      if (offset == feature::kGeomOffsetFallback)
+        continue;
+
+      uint64_t const pos = uint64_t{CheckedFilePosCast(*files[scaleIndex])} + offset;
+      CHECK_LESS_OR_EQUAL(pos, static_cast<uint64_t>(std::numeric_limits<uint32_t>::max()),
+                          ("Feature offset is out of 32bit boundary!"));
+      CHECK_NOT_EQUAL(pos, feature::kGeomOffsetFallback, ());
+      offset = static_cast<uint32_t>(pos);
+    }
+    CHECK_EQUAL(offsetIndex, offsets.size(), ());
+
+    for (size_t i = 0; i < buffers.size(); ++i)
+      files[i]->Write(buffers[i].data(), buffers[i].size());
+  }
+
   static void SimplifyPoints(int level, bool isCoast, m2::RectD const & rect, Points const & in, Points & out)
   {
     if (isCoast)
@@ -351,8 +424,98 @@ private:
   DISALLOW_COPY_AND_MOVE(FeaturesCollector2);
 };
 
+namespace
+{
+// Number of features read ahead while the previous ones are processed.
+size_t constexpr kFeaturesBatchSize = 16 * 1024;
+// Number of features processed by one task.
+size_t constexpr kFeaturesTaskSize = 64;
+
+// Reads features at |offsets| in order of offsets in the file.
+std::vector<FeatureBuilder> ReadFeatures(FileReader const & reader,
+                                         std::vector<CalculateMidPoints::CellAndOffset> const & offsets,
+                                         size_t begin, size_t end)
+{
+  std::vector<size_t> order(end - begin);
+  std::iota(order.begin(), order.end(), begin);
+  std::sort(order.begin(), order.end(), [&offsets](size_t lhs, size_t rhs) {
+    return offsets[lhs].second < offsets[rhs].second;
+  });
+
+  std::vector<FeatureBuilder> features(end - begin);
+  ReaderSource<FileReader> src(reader);
+  for (size_t i : order)
+  {
+    src.Skip(offsets[i].second - src.Pos());
+    ReadFromSourceRawFormat(src, features[i - begin]);
+  }
+  return features;
+}
+
+// Features pass a pipeline: the next batch is read sequentially while the current batch is
+// simplified, tesselated and serialized into memory concurrently and then written to the
+// sections in the order of |offsets|, so the result doesn't depend on |threadsCount|.
+template <typename Collector>
+void WriteFeatures(FileReader const & reader,
+                   std::vector<CalculateMidPoints::CellAndOffset> const & offsets,
+                   size_t threadsCount, Collector & collector)
+{
+  using FeatureGeometry = typename Collector::FeatureGeometry;
+
+  base::thread_pool::computational::ThreadPool pool(std::max(threadsCount, size_t(1)));
+
+  auto features = ReadFeatures(reader, offsets, 0, std::min(kFeaturesBatchSize, offsets.size()));
+  for (size_t batchBegin = 0; batchBegin < offsets.size(); batchBegin += kFeaturesBatchSize)
+  {
+    std::vector<FeatureGeometry> geometries(features.size());
+    std::vector<std::future<void>> results;
+    for (size_t taskBegin = 0; taskBegin < features.size(); taskBegin += kFeaturesTaskSize)
+    {
+      size_t const taskEnd = std::min(taskBegin + kFeaturesTaskSize, features.size());
+      results.emplace_back(pool.Submit([&, taskBegin, taskEnd]() {
+        for (size_t i = taskBegin; i < taskEnd; ++i)
+          collector.ProcessGeometry(features[i], geometries[i]);
+      }));
+    }
+
+    std::vector<FeatureBuilder> nextFeatures;
+    try
+    {
+      size_t const nextBegin = std::min(batchBegin + kFeaturesBatchSize, offsets.size());
+      nextFeatures = ReadFeatures(reader, offsets, nextBegin,
+                                  std::min(nextBegin + kFeaturesBatchSize, offsets.size()));
+
+      for (size_t task = 0; task < results.size(); ++task)
+      {
+        results[task].get();
+
+        size_t const taskBegin = task * kFeaturesTaskSize;
+        size_t const taskEnd = std::min(taskBegin + kFeaturesTaskSize, features.size());
+        for (size_t i = taskBegin; i < taskEnd; ++i)
+        {
+          collector(features[i], geometries[i]);
+          geometries[i] = {};
+        }
+      }
+    }
+    catch (...)
+    {
+      // Tasks use features and geometries of the batch.
+      for (auto & result : results)
+      {
+        if (result.valid())
+          result.wait();
+      }
+      throw;
+    }
+
+    features = std::move(nextFeatures);
+  }
+}
+}  // namespace
+
 bool GenerateFinalFeatures(feature::GenerateInfo const & info, std::string const & name,
-                           feature::DataHeader::MapType mapType)
+                           feature::DataHeader::MapType mapType, size_t threadsCount)
 {
   std::string const srcFilePath = info.GetTmpFileName(name);
   std::string const dataFilePath = info.GetTargetFileName(name);
@@ -399,15 +562,7 @@ bool GenerateFinalFeatures(feature::GenerateInfo const & info, std::string const
       LOG(LINFO, ("Simplifying and filtering geometry for all geom levels"));
 
       FeaturesCollector2 collector(name, info, header, regionData, info.m_versionDate);
-      for (auto const & point : midPoints.GetVector())
-      {
-        ReaderSource<FileReader> src(reader);
-        src.Skip(point.second);
-
-        FeatureBuilder fb;
-        ReadFromSourceRawFormat(src, fb);
-        collector(fb);
-      }
+      WriteFeatures(reader, midPoints.GetVector(), threadsCount, collector);
 
       LOG(LINFO, ("Writing features' data to", dataFilePath));
 
@@ -4,6 +4,7 @@
 #include "generator/affiliation.hpp"
 #include "generator/coastlines_generator.hpp"
 #include "generator/feature_builder.hpp"
+#include "generator/final_processor_pass.hpp"
 #include "generator/final_processor_utils.hpp"
 #include "generator/isolines_generator.hpp"
 #include "generator/mini_roundabout_transformer.hpp"
@@ -19,11 +20,124 @@
 #include "geometry/mercator.hpp"
 #include "geometry/region2d/binary_operators.hpp"
 
+#include <memory>
+#include <unordered_map>
+#include <utility>
+#include <vector>
 
 namespace generator
 {
 using namespace feature;
 
+namespace
+{
+// Appends features which were distributed among countries beforehand.
+class AppendFeaturesStage : public FinalProcessorStage
+{
+public:
+  AppendFeaturesStage(std::shared_ptr<std::vector<FeatureBuilder> const> fbs, std::vector<size_t> const & indexes)
+    : m_fbs(std::move(fbs)), m_indexes(indexes)
+  {
+  }
+
+  // FinalProcessorStage overrides:
+  bool IsAppendOnly() const override { return true; }
+  void Finish(EmitFn const & emit) override
+  {
+    for (auto const index : m_indexes)
+      emit(FeatureBuilder((*m_fbs)[index]));
+  }
+
+private:
+  std::shared_ptr<std::vector<FeatureBuilder> const> m_fbs;
+  std::vector<size_t> const & m_indexes;
+};
+
+class RoundaboutsStage : public FinalProcessorStage
+{
+public:
+  RoundaboutsStage(std::string const & country, MiniRoundaboutData const & roundabouts,
+                   AddressesHolder const & addresses, AffiliationInterface const & affiliations)
+    : m_roundabouts(roundabouts)
+    , m_addresses(addresses)
+    , m_transformer(roundabouts.GetData(), affiliations)
+  {
+    RegionData data;
+    if (ReadRegionData(country, data))
+      m_transformer.SetLeftHandTraffic(data.Get(RegionData::Type::RD_DRIVING) == "l");
+  }
+
+  // FinalProcessorStage overrides:
+  void Process(FeatureBuilder && fb, EmitFn const & emit) override
+  {
+    if (m_roundabouts.IsRoadExists(fb))
+    {
+      m_transformer.AddRoad(std::move(fb));
+      return;
+    }
+
+    auto const & checker = ftypes::IsAddressInterpolChecker::Instance();
+    if (fb.IsLine() && checker(fb.GetTypes()))
+    {
+      if (!m_addresses.Update(fb))
+      {
+        // Not only invalid interpolation ways, but fancy buildings with interpolation type like here:
+        // https://www.openstreetmap.org/#map=18/39.45672/-77.97516
+        if (fb.RemoveTypesIf(checker))
+          return;
+      }
+    }
+
+    emit(std::move(fb));
+  }
+
+  void Finish(EmitFn const & emit) override
+  {
+    // Adds new way features generated from mini-roundabout nodes with those nodes ids.
+    // Transforms points on roads to connect them with these new roundabout junctions.
+    m_transformer.ProcessRoundabouts([&emit](FeatureBuilder const & fb) { emit(FeatureBuilder(fb)); });
+  }
+
+private:
+  MiniRoundaboutData const & m_roundabouts;
+  AddressesHolder const & m_addresses;
+  MiniRoundaboutTransformer m_transformer;
+};
+
+class IsolinesStage : public FinalProcessorStage
+{
+public:
+  IsolinesStage(std::string const & country, IsolineFeaturesGenerator const & generator)
+    : m_country(country), m_generator(generator)
+  {
+  }
+
+  // FinalProcessorStage overrides:
+  bool IsAppendOnly() const override { return true; }
+  void Finish(EmitFn const & emit) override { m_generator.GenerateIsolines(m_country, emit); }
+
+private:
+  std::string m_country;
+  IsolineFeaturesGenerator const & m_generator;
+};
+
+class DropSpeedCamerasStage : public FinalProcessorStage
+{
+public:
+  // FinalProcessorStage overrides:
+  void Process(FeatureBuilder && fb, EmitFn const & emit) override
+  {
+    static auto const speedCameraType = classif().GetTypeByPath({"highway", "speed_camera"});
+
+    // Removing point features with speed cameras type from geometry index for some countries.
+    if (fb.IsPoint() && fb.HasType(speedCameraType))
+      return;
+
+    emit(std::move(fb));
+  }
+};
+}  // namespace
+
 CountryFinalProcessor::CountryFinalProcessor(AffiliationInterfacePtr affiliations,
                                              std::string const & temporaryMwmPath, size_t threadsCount)
   : FinalProcessorIntermediateMwmInterface(FinalProcessorPriority::CountriesOrWorld)
@@ -65,94 +179,54 @@ void CountryFinalProcessor::SetIsolinesDir(std::string const & dir) { m_isolines
 
 void CountryFinalProcessor::Process()
 {
-  //Order();
+  // All the per-country transforms are fused into one pass over mwm.tmp files, so every file
+  // is read and written once. The order of stages is the order of the former separate passes.
+  FinalProcessorPass pass;
 
   if (!m_coastlineGeomFilename.empty())
-    ProcessCoastline();
+    ProcessCoastline(pass);
 
-  // Add here all "straight-way" processing. There is no need to make many functions and
-  // many read-write FeatureBuilder ops here.
   if (!m_miniRoundaboutsFilename.empty() || !m_addrInterpolFilename.empty())
-    ProcessRoundabouts();
+    ProcessRoundabouts(pass);
 
   if (!m_fakeNodesFilename.empty())
-    AddFakeNodes();
+    AddFakeNodes(pass);
   if (!m_isolinesPath.empty())
-    AddIsolines();
+    AddIsolines(pass);
 
-  //DropProhibitedSpeedCameras();
-  ProcessBuildingParts();
+  //DropProhibitedSpeedCameras(pass);
+  ProcessBuildingParts(pass);
 
-  //Finish();
+  RunPass(pass);
 }
 
-/*
-void CountryFinalProcessor::Order()
+void CountryFinalProcessor::ProcessBuildingParts()
 {
-  ForEachMwmTmp(m_temporaryMwmPath, [&](auto const & country, auto const & path)
-  {
-    if (!IsCountry(country))
-      return;
-
-    auto fbs = ReadAllDatRawFormat<serialization_policy::MaxAccuracy>(path);
-    generator::Order(fbs);
-
-    FeatureBuilderWriter<serialization_policy::MaxAccuracy> writer(path);
-    for (auto const & fb : fbs)
-      writer.Write(fb);
-
-  }, m_threadsCount);
+  FinalProcessorPass pass;
+  ProcessBuildingParts(pass);
+  RunPass(pass);
 }
-*/
 
-void CountryFinalProcessor::ProcessRoundabouts()
+void CountryFinalProcessor::RunPass(FinalProcessorPass const & pass)
 {
-  auto const roundabouts = ReadMiniRoundabouts(m_miniRoundaboutsFilename);
-
-  AddressesHolder addresses;
-  addresses.Deserialize(m_addrInterpolFilename);
-
   ForEachMwmTmp(m_temporaryMwmPath, [&](auto const & name, auto const & path)
   {
-    if (!IsCountry(name))
-      return;
-
-    MiniRoundaboutTransformer transformer(roundabouts.GetData(), *m_affiliations);
-
-    RegionData data;
-    if (ReadRegionData(name, data))
-      transformer.SetLeftHandTraffic(data.Get(RegionData::Type::RD_DRIVING) == "l");
+    if (IsCountry(name))
+      pass.Run(name, path);
+  }, m_threadsCount);
+}
 
-    FeatureBuilderWriter<serialization_policy::MaxAccuracy> writer(path, true /* mangleName */);
-    ForEachFeatureRawFormat<serialization_policy::MaxAccuracy>(path, [&](FeatureBuilder && fb, uint64_t)
-    {
-      if (roundabouts.IsRoadExists(fb))
-        transformer.AddRoad(std::move(fb));
-      else
-      {
-        auto const & checker = ftypes::IsAddressInterpolChecker::Instance();
-        if (fb.IsLine() && checker(fb.GetTypes()))
-        {
-          if (!addresses.Update(fb))
-          {
-            // Not only invalid interpolation ways, but fancy buildings with interpolation type like here:
-            // https://www.openstreetmap.org/#map=18/39.45672/-77.97516
-            if (fb.RemoveTypesIf(checker))
-              return;
-          }
-        }
+void CountryFinalProcessor::ProcessRoundabouts(FinalProcessorPass & pass)
+{
+  auto const roundabouts = std::make_shared<MiniRoundaboutData>(ReadMiniRoundabouts(m_miniRoundaboutsFilename));
 
-        writer.Write(fb);
-      }
-    });
+  auto addresses = std::make_shared<AddressesHolder>();
+  addresses->Deserialize(m_addrInterpolFilename);
 
-    // Adds new way features generated from mini-roundabout nodes with those nodes ids.
-    // Transforms points on roads to connect them with these new roundabout junctions.
-    transformer.ProcessRoundabouts([&writer](FeatureBuilder const & fb)
-    {
-      writer.Write(fb);
-    });
-  }, m_threadsCount);
+  pass.AddStage([this, roundabouts, addresses = std::shared_ptr<AddressesHolder const>(addresses)](auto const & name)
+  {
+    return std::make_unique<RoundaboutsStage>(name, *roundabouts, *addresses, *m_affiliations);
+  });
 }
 
 bool DoesBuildingConsistOfParts(FeatureBuilder const & fbBuilding,
@@ -225,75 +299,76 @@ bool DoesBuildingConsistOfParts(FeatureBuilder const & fbBuilding,
   return isectArea >= 0.9 * buildingArea;
 }
 
-void CountryFinalProcessor::ProcessBuildingParts()
+namespace
 {
-  auto const & buildingChecker = ftypes::IsBuildingChecker::Instance();
-  auto const & buildingPartChecker = ftypes::IsBuildingPartChecker::Instance();
-  auto const & buildingHasPartsChecker = ftypes::IsBuildingHasPartsChecker::Instance();
-
-  ForEachMwmTmp(m_temporaryMwmPath, [&](auto const & name, auto const & path)
+class BuildingPartsStage : public FinalProcessorStage
+{
+public:
+  // FinalProcessorStage overrides:
+  bool NeedsPrepare() const override { return true; }
+  void Prepare(FeatureBuilder const & fb) override
   {
-    if (!IsCountry(name))
-      return;
-
-    // All "building:part" regions in MWM
-    m4::Tree<m2::RegionI> buildingPartsKDTree;
-
-    ForEachFeatureRawFormat<serialization_policy::MaxAccuracy>(path, [&](FeatureBuilder && fb, uint64_t)
+    if (fb.IsArea() && ftypes::IsBuildingPartChecker::Instance()(fb.GetTypes()))
     {
-      if (fb.IsArea() && buildingPartChecker(fb.GetTypes()))
-      {
-        // Important trick! Add region by FeatureBuilder's native rect, to make search queries also by FB rects.
-        buildingPartsKDTree.Add(coastlines_generator::CreateRegionI(fb.GetOuterGeometry()), fb.GetLimitRect());
-      }
-    });
+      // Important trick! Add region by FeatureBuilder's native rect, to make search queries also by FB rects.
+      m_buildingPartsKDTree.Add(coastlines_generator::CreateRegionI(fb.GetOuterGeometry()), fb.GetLimitRect());
+    }
+  }
 
-    FeatureBuilderWriter<serialization_policy::MaxAccuracy> writer(path, true /* mangleName */);
-    ForEachFeatureRawFormat<serialization_policy::MaxAccuracy>(path, [&](FeatureBuilder && fb, uint64_t)
+  void Process(FeatureBuilder && fb, EmitFn const & emit) override
+  {
+    if (fb.IsArea() &&
+        ftypes::IsBuildingChecker::Instance()(fb.GetTypes()) &&
+        DoesBuildingConsistOfParts(fb, m_buildingPartsKDTree))
     {
-      if (fb.IsArea() &&
-          buildingChecker(fb.GetTypes()) &&
-          DoesBuildingConsistOfParts(fb, buildingPartsKDTree))
-      {
-        fb.AddType(buildingHasPartsChecker.GetType());
-        fb.GetParams().FinishAddingTypes();
-      }
+      fb.AddType(ftypes::IsBuildingHasPartsChecker::Instance().GetType());
+      fb.GetParams().FinishAddingTypes();
+    }
 
-      writer.Write(fb);
-    });
-  }, m_threadsCount);
+    emit(std::move(fb));
+  }
+
+private:
+  // All "building:part" regions in MWM
+  m4::Tree<m2::RegionI> m_buildingPartsKDTree;
+};
+}  // namespace
+
+void CountryFinalProcessor::ProcessBuildingParts(FinalProcessorPass & pass)
+{
+  pass.AddStage([](auto const &) { return std::make_unique<BuildingPartsStage>(); });
 }
 
-void CountryFinalProcessor::AddIsolines()
+void CountryFinalProcessor::AddIsolines(FinalProcessorPass & pass)
 {
   // For generated isolines must be built isolines_info section based on the same
   // binary isolines file.
-  IsolineFeaturesGenerator isolineFeaturesGenerator(m_isolinesPath);
-  ForEachMwmTmp(m_temporaryMwmPath, [&](auto const & name, auto const & path)
+  auto const isolineFeaturesGenerator = std::make_shared<IsolineFeaturesGenerator>(m_isolinesPath);
+  pass.AddStage([isolineFeaturesGenerator](auto const & name)
   {
-    if (!IsCountry(name))
-      return;
-
-    FeatureBuilderWriter<serialization_policy::MaxAccuracy> writer(path, FileWriter::Op::OP_APPEND);
-    isolineFeaturesGenerator.GenerateIsolines(name, [&](auto const & fb) { writer.Write(fb); });
-  }, m_threadsCount);
+    return std::make_unique<IsolinesStage>(name, *isolineFeaturesGenerator);
+  });
 }
 
-void CountryFinalProcessor::ProcessCoastline()
+void CountryFinalProcessor::ProcessCoastline(FinalProcessorPass & pass)
 {
   /// @todo We can remove MinSize at all.
   auto fbs = ReadAllDatRawFormat<serialization_policy::MaxAccuracy>(m_coastlineGeomFilename);
 
-  auto const affiliations = AppendToMwmTmp(fbs, *m_affiliations, m_temporaryMwmPath, m_threadsCount);
+  auto const affiliations = GetAffiliations(fbs, *m_affiliations, m_threadsCount);
   FeatureBuilderWriter<> collector(m_worldCoastsFilename);
   for (size_t i = 0; i < fbs.size(); ++i)
   {
-    fbs[i].SetName(StringUtf8Multilang::kDefaultCode, strings::JoinStrings(affiliations[i], ';'));
-    collector.Write(fbs[i]);
+    // Coastlines are appended to countries without the names.
+    auto fb = fbs[i];
+    fb.SetName(StringUtf8Multilang::kDefaultCode, strings::JoinStrings(affiliations[i], ';'));
+    collector.Write(fb);
   }
+
+  AppendFeatures(pass, std::move(fbs), affiliations);
 }
 
-void CountryFinalProcessor::AddFakeNodes()
+void CountryFinalProcessor::AddFakeNodes(FinalProcessorPass & pass)
 {
   std::vector<FeatureBuilder> fbs;
   MixFakeNodes(m_fakeNodesFilename, [&](auto & element)
@@ -304,49 +379,42 @@ void CountryFinalProcessor::AddFakeNodes()
     ftype::GetNameAndType(&element, fb.GetParams());
     fbs.emplace_back(std::move(fb));
   });
-  AppendToMwmTmp(fbs, *m_affiliations, m_temporaryMwmPath, m_threadsCount);
+
+  auto const affiliations = GetAffiliations(fbs, *m_affiliations, m_threadsCount);
+  AppendFeatures(pass, std::move(fbs), affiliations);
 }
 
-void CountryFinalProcessor::DropProhibitedSpeedCameras()
+void CountryFinalProcessor::AppendFeatures(FinalProcessorPass & pass, std::vector<FeatureBuilder> && fbs,
+                                           std::vector<std::vector<std::string>> const & affiliations)
 {
-  static auto const speedCameraType = classif().GetTypeByPath({"highway", "speed_camera"});
-  ForEachMwmTmp(m_temporaryMwmPath, [&](auto const & country, auto const & path)
+  auto countryToFbsIndexes = std::make_shared<std::unordered_map<std::string, std::vector<size_t>>>();
+  for (size_t i = 0; i < fbs.size(); ++i)
   {
-    if (!IsCountry(country))
-      return;
-
-    if (!routing::AreSpeedCamerasProhibited(platform::CountryFile(country)))
-      return;
+    for (auto const & country : affiliations[i])
+      (*countryToFbsIndexes)[country].emplace_back(i);
+  }
 
-    FeatureBuilderWriter<serialization_policy::MaxAccuracy> writer(path, true /* mangleName */);
-    ForEachFeatureRawFormat<serialization_policy::MaxAccuracy>(path, [&](FeatureBuilder const & fb, uint64_t)
-    {
-      // Removing point features with speed cameras type from geometry index for some countries.
-      if (fb.IsPoint() && fb.HasType(speedCameraType))
-        return;
+  // Features may get into countries which don't have mwm.tmp files yet.
+  for (auto const & p : *countryToFbsIndexes)
+    FileWriter(base::JoinPath(m_temporaryMwmPath, p.first + DATA_FILE_EXTENSION_TMP), FileWriter::Op::OP_APPEND);
 
-      writer.Write(fb);
-    });
-  }, m_threadsCount);
+  auto const sharedFbs = std::make_shared<std::vector<FeatureBuilder> const>(std::move(fbs));
+  pass.AddStage([sharedFbs, countryToFbsIndexes](auto const & name) -> FinalProcessorStagePtr
+  {
+    auto const it = countryToFbsIndexes->find(name);
+    if (it == countryToFbsIndexes->cend())
+      return nullptr;
+    return std::make_unique<AppendFeaturesStage>(sharedFbs, it->second);
+  });
 }
 
-/*
-void CountryFinalProcessor::Finish()
+void CountryFinalProcessor::DropProhibitedSpeedCameras(FinalProcessorPass & pass)
 {
-  ForEachMwmTmp(m_temporaryMwmPath, [&](auto const & country, auto const & path)
+  pass.AddStage([](auto const & name) -> FinalProcessorStagePtr
   {
-    if (!IsCountry(country))
-      return;
-
-    auto fbs = ReadAllDatRawFormat<serialization_policy::MaxAccuracy>(path);
-    generator::Order(fbs);
-
-    FeatureBuilderWriter<> writer(path);
-    for (auto const & fb : fbs)
-      writer.Write(fb);
-
-  }, m_threadsCount);
+    if (!routing::AreSpeedCamerasProhibited(platform::CountryFile(name)))
+      return nullptr;
+    return std::make_unique<DropSpeedCamerasStage>();
+  });
 }
-*/
-
 }  // namespace generator
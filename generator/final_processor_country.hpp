@@ -1,9 +1,12 @@
 #pragma once
 
 #include "generator/affiliation.hpp"
+#include "generator/feature_builder.hpp"
 #include "generator/final_processor_interface.hpp"
+#include "generator/final_processor_pass.hpp"
 
 #include <string>
+#include <vector>
 
 namespace generator
 {
@@ -32,13 +35,19 @@ public:
   void ProcessBuildingParts();
 
 private:
-  //void Order();
-  void ProcessCoastline();
-  void ProcessRoundabouts();
-  void AddFakeNodes();
-  void AddIsolines();
-  void DropProhibitedSpeedCameras();
-  //void Finish();
+  // Add stages of the country transforms to |pass|.
+  void ProcessCoastline(FinalProcessorPass & pass);
+  void ProcessRoundabouts(FinalProcessorPass & pass);
+  void AddFakeNodes(FinalProcessorPass & pass);
+  void AddIsolines(FinalProcessorPass & pass);
+  void DropProhibitedSpeedCameras(FinalProcessorPass & pass);
+  void ProcessBuildingParts(FinalProcessorPass & pass);
+
+  // Appends |fbs| to the countries they belong to according to |affiliations|.
+  void AppendFeatures(FinalProcessorPass & pass, std::vector<feature::FeatureBuilder> && fbs,
+                      std::vector<std::vector<std::string>> const & affiliations);
+
+  void RunPass(FinalProcessorPass const & pass);
 
   bool IsCountry(std::string const & filename);
 
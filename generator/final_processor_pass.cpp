@@ -0,0 +1,65 @@
+#include "generator/final_processor_pass.hpp"
+
+#include <algorithm>
+#include <utility>
+
+namespace generator
+{
+using namespace feature;
+
+void FinalProcessorPass::Run(std::string const & country, std::string const & path) const
+{
+  std::vector<FinalProcessorStagePtr> stages;
+  for (auto const & makeStage : m_makeStages)
+  {
+    if (auto stage = makeStage(country))
+      stages.emplace_back(std::move(stage));
+  }
+
+  if (stages.empty())
+    return;
+
+  bool const appendOnly = std::all_of(stages.cbegin(), stages.cend(),
+                                      [](auto const & stage) { return stage->IsAppendOnly(); });
+  bool const needsPrepare = std::any_of(stages.cbegin(), stages.cend(),
+                                        [](auto const & stage) { return stage->NeedsPrepare(); });
+  if (needsPrepare)
+  {
+    ForEachFeatureRawFormat<serialization_policy::MaxAccuracy>(path, [&](FeatureBuilder const & fb, uint64_t)
+    {
+      for (auto & stage : stages)
+      {
+        if (stage->NeedsPrepare())
+          stage->Prepare(fb);
+      }
+    });
+  }
+
+  // Write to a temporary file and rename it on destruction, because the file is being read.
+  FeatureBuilderWriter<serialization_policy::MaxAccuracy> writer(
+      path, !appendOnly /* mangleName */,
+      appendOnly ? FileWriter::Op::OP_APPEND : FileWriter::Op::OP_WRITE_TRUNCATE);
+
+  // |emits[i]| passes features to the i-th stage, the last one writes them.
+  std::vector<FinalProcessorStage::EmitFn> emits(stages.size() + 1);
+  emits.back() = [&writer](FeatureBuilder && fb) { writer.Write(fb); };
+  for (size_t i = 0; i < stages.size(); ++i)
+  {
+    emits[i] = [&stage = *stages[i], &next = emits[i + 1]](FeatureBuilder && fb)
+    {
+      stage.Process(std::move(fb), next);
+    };
+  }
+
+  if (!appendOnly)
+  {
+    ForEachFeatureRawFormat<serialization_policy::MaxAccuracy>(path, [&](FeatureBuilder && fb, uint64_t)
+    {
+      emits.front()(std::move(fb));
+    });
+  }
+
+  for (size_t i = 0; i < stages.size(); ++i)
+    stages[i]->Finish(emits[i + 1]);
+}
+}  // namespace generator
@@ -0,0 +1,57 @@
+#pragma once
+
+#include "generator/feature_builder.hpp"
+
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace generator
+{
+// Streaming transform of the features of a country mwm.tmp file. Stages of a pass are chained:
+// features emitted by a stage are processed by the next one and the ones emitted by the last
+// stage are written back to the file.
+class FinalProcessorStage
+{
+public:
+  using EmitFn = std::function<void(feature::FeatureBuilder && fb)>;
+
+  virtual ~FinalProcessorStage() = default;
+
+  // Returns true if the stage needs to see all the features of the file before processing them.
+  virtual bool NeedsPrepare() const { return false; }
+  // Returns true if the stage only emits new features in Finish() and passes others as is.
+  virtual bool IsAppendOnly() const { return false; }
+
+  // Is called for every feature of the file before processing. Note that the stage sees
+  // the features as they are in the file, not as the previous stages emit them.
+  virtual void Prepare(feature::FeatureBuilder const & /* fb */) {}
+  virtual void Process(feature::FeatureBuilder && fb, EmitFn const & emit) { emit(std::move(fb)); }
+  // Is called after all the features of the file are processed.
+  virtual void Finish(EmitFn const & /* emit */) {}
+};
+
+using FinalProcessorStagePtr = std::unique_ptr<FinalProcessorStage>;
+
+// Stages fused into one read and one write of every country mwm.tmp file. Transforms which
+// need all the countries to be processed before them (like appending features to several
+// countries) should be run as separate passes.
+class FinalProcessorPass
+{
+public:
+  // Makes a stage for the country. Returns nullptr if the stage isn't needed for the country.
+  using MakeStageFn = std::function<FinalProcessorStagePtr(std::string const & country)>;
+
+  void AddStage(MakeStageFn && fn) { m_makeStages.emplace_back(std::move(fn)); }
+  bool IsEmpty() const { return m_makeStages.empty(); }
+
+  // Runs the stages over the mwm.tmp file of |country| at |path|. The file is only read
+  // once more beforehand if some stage needs preparation, and it's appended without being
+  // read if all the stages are append-only.
+  void Run(std::string const & country, std::string const & path) const;
+
+private:
+  std::vector<MakeStageFn> m_makeStages;
+};
+}  // namespace generator
@@ -19,13 +19,15 @@ struct GenerateInfo
   {
     Memory,
     Index,
-    File
+    File,
+    Sparse
   };
 
   enum class OsmSourceType
   {
     XML,
-    O5M
+    O5M,
+    PBF
   };
 
   // Directory for .mwm.tmp files.
@@ -48,6 +50,8 @@ struct GenerateInfo
   NodeStorageType m_nodeStorageType = NodeStorageType::Memory;
   OsmSourceType m_osmFileType = OsmSourceType::XML;
   std::string m_osmFileName;
+  // Count of threads to decode input blocks in parallel. Sequential reader is used if it is 1.
+  size_t m_osmReaderThreadsCount = 1;
 
   std::string m_brandsFilename;
   std::string m_brandsTranslationsFilename;
@@ -80,6 +84,8 @@ struct GenerateInfo
       m_osmFileType = OsmSourceType::XML;
     else if (type == "o5m")
       m_osmFileType = OsmSourceType::O5M;
+    else if (type == "pbf")
+      m_osmFileType = OsmSourceType::PBF;
     else
       LOG(LCRITICAL, ("Unknown source type:", type));
   }
@@ -92,6 +98,8 @@ struct GenerateInfo
       m_nodeStorageType = NodeStorageType::Index;
     else if (type == "mem")
       m_nodeStorageType = NodeStorageType::Memory;
+    else if (type == "sparse")
+      m_nodeStorageType = NodeStorageType::Sparse;
     else
       LOG(LCRITICAL, ("Incorrect node_storage type:", type));
   }
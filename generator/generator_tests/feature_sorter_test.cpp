@@ -0,0 +1,168 @@
+#include "testing/testing.hpp"
+
+#include "generator/generator_tests_support/test_feature.hpp"
+#include "generator/generator_tests_support/test_mwm_builder.hpp"
+#include "generator/generator_tests_support/test_with_classificator.hpp"
+
+#include "indexer/data_header.hpp"
+#include "indexer/feature_impl.hpp"
+
+#include "platform/platform_tests_support/scoped_dir.hpp"
+#include "platform/platform_tests_support/scoped_file.hpp"
+
+#include "platform/country_file.hpp"
+#include "platform/local_country_file.hpp"
+#include "platform/platform.hpp"
+
+#include "coding/file_reader.hpp"
+#include "coding/files_container.hpp"
+#include "coding/sha1.hpp"
+
+#include "geometry/point2d.hpp"
+
+#include "base/file_name_utils.hpp"
+
+#include <cstdint>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "defines.hpp"
+
+namespace feature_sorter_test
+{
+using namespace generator::tests_support;
+using namespace platform::tests_support;
+using namespace platform;
+using std::string, std::vector;
+
+string const kTestMwm = "test";
+uint32_t constexpr kVersion = 200101;
+
+// SHA1 of the sections written by GenerateFinalFeatures for TestFeatures. It's got from the
+// serial GenerateFinalFeatures which was used before the features were processed in a pipeline.
+string const kFeaturesSectionsHash = "2TTZnCQdRo0EYIpw4IyXouelrz0=";
+
+// Returns a value in [min, max). Distributions of <random> are implementation-defined, so they
+// aren't used to get the same features with every standard library.
+double GetUniform(std::mt19937 & rng, double min, double max)
+{
+  return min + (max - min) * static_cast<double>(rng()) /
+                   (static_cast<double>(std::mt19937::max()) + 1.0);
+}
+
+// Features of more than one batch of the feature sorter with geometry to simplify and tesselate.
+struct TestFeatures
+{
+  TestFeatures()
+  {
+    std::mt19937 rng(42 /* seed */);
+
+    for (size_t i = 0; i < 8000; ++i)
+    {
+      vector<m2::PointD> points = {{GetUniform(rng, -10.0, 10.0), GetUniform(rng, -10.0, 10.0)}};
+      for (size_t j = 0; j < 20; ++j)
+      {
+        points.emplace_back(points.back().x + GetUniform(rng, -0.01, 0.01),
+                            points.back().y + GetUniform(rng, -0.01, 0.01));
+      }
+      m_streets.emplace_back(points, "Street " + std::to_string(i), "en");
+    }
+
+    // Directions of the vertices of a closed star-shaped polygon.
+    vector<m2::PointD> const kDirections = {
+        {1.0, 0.0},     {0.924, 0.383},   {0.707, 0.707},   {0.383, 0.924},
+        {0.0, 1.0},     {-0.383, 0.924},  {-0.707, 0.707},  {-0.924, 0.383},
+        {-1.0, 0.0},    {-0.924, -0.383}, {-0.707, -0.707}, {-0.383, -0.924},
+        {0.0, -1.0},    {0.383, -0.924},  {0.707, -0.707},  {0.924, -0.383}};
+    for (size_t i = 0; i < 6000; ++i)
+    {
+      m2::PointD const center(GetUniform(rng, -10.0, 10.0), GetUniform(rng, -10.0, 10.0));
+      vector<m2::PointD> boundary;
+      for (auto const & direction : kDirections)
+        boundary.push_back(center + direction * GetUniform(rng, 0.001, 0.01));
+      boundary.push_back(boundary.front());
+      m_parks.emplace_back(boundary, "Park " + std::to_string(i), "en");
+    }
+
+    for (size_t i = 0; i < 4000; ++i)
+    {
+      m2::PointD const point(GetUniform(rng, -10.0, 10.0), GetUniform(rng, -10.0, 10.0));
+      m_pois.emplace_back(point, "Poi " + std::to_string(i), "en");
+    }
+  }
+
+  vector<TestStreet> m_streets;
+  vector<TestPark> m_parks;
+  vector<TestPOI> m_pois;
+};
+
+string BuildMwm(string const & dir, TestFeatures const & features, size_t threadsCount)
+{
+  LocalCountryFile country(base::JoinPath(GetPlatform().WritableDir(), dir), CountryFile(kTestMwm),
+                           0 /* version */);
+  {
+    TestMwmBuilder builder(country, feature::DataHeader::MapType::Country, kVersion);
+    builder.SetThreadsCount(threadsCount);
+    for (auto const & street : features.m_streets)
+      builder.Add(street);
+    for (auto const & park : features.m_parks)
+      builder.Add(park);
+    for (auto const & poi : features.m_pois)
+      builder.Add(poi);
+  }
+  return country.GetPath(MapFileType::Map);
+}
+
+// Other sections are built from the written features, so they are the same if these ones are.
+// The region info isn't hashed because it depends on the countries data.
+string GetFeaturesSectionsHash(string const & mwmPath)
+{
+  FilesContainerR const cont(mwmPath);
+  vector<string> tags = {VERSION_FILE_TAG, HEADER_FILE_TAG, FEATURES_FILE_TAG, METADATA_FILE_TAG};
+  size_t const scalesCount = feature::DataHeader(cont).GetScalesCount();
+  for (size_t i = 0; i < scalesCount; ++i)
+  {
+    tags.push_back(feature::GetTagForIndex(GEOMETRY_FILE_TAG, i));
+    tags.push_back(feature::GetTagForIndex(TRIANGLE_FILE_TAG, i));
+  }
+
+  string data;
+  for (auto const & tag : tags)
+  {
+    TEST(cont.IsExist(tag), (tag));
+    string section;
+    cont.GetReader(tag).ReadAsString(section);
+    data += tag;
+    data += section;
+  }
+  return coding::SHA1::CalculateBase64ForString(data);
+}
+
+UNIT_CLASS_TEST(TestWithClassificator, FeatureSorter_SameMwmForAnyThreadsCount)
+{
+  TestFeatures const features;
+
+  string const dir1 = "feature_sorter_test_1";
+  ScopedDir const scopedDir1(dir1);
+  ScopedFile const scopedMwm1(base::JoinPath(dir1, kTestMwm + DATA_FILE_EXTENSION),
+                              ScopedFile::Mode::Create);
+  string const mwmPath1 = BuildMwm(dir1, features, 1 /* threadsCount */);
+
+  string const dir4 = "feature_sorter_test_4";
+  ScopedDir const scopedDir4(dir4);
+  ScopedFile const scopedMwm4(base::JoinPath(dir4, kTestMwm + DATA_FILE_EXTENSION),
+                              ScopedFile::Mode::Create);
+  string const mwmPath4 = BuildMwm(dir4, features, 4 /* threadsCount */);
+
+  TEST_EQUAL(GetFeaturesSectionsHash(mwmPath1), kFeaturesSectionsHash, ());
+
+  string mwm1;
+  FileReader(mwmPath1).ReadAsString(mwm1);
+  string mwm4;
+  FileReader(mwmPath4).ReadAsString(mwm4);
+  TEST(!mwm1.empty(), ());
+  TEST_EQUAL(mwm1.size(), mwm4.size(), ());
+  TEST(mwm1 == mwm4, ("Mwms built with 1 and 4 threads differ."));
+}
+}  // namespace feature_sorter_test
@@ -0,0 +1,123 @@
+#include "testing/testing.hpp"
+
+#include "generator/feature_builder.hpp"
+#include "generator/final_processor_pass.hpp"
+#include "generator/generator_tests_support/test_with_classificator.hpp"
+
+#include "platform/platform_tests_support/scoped_file.hpp"
+
+#include "indexer/classificator.hpp"
+
+#include "base/geo_object_id.hpp"
+
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace final_processor_pass_tests
+{
+using namespace feature;
+using namespace generator;
+using generator::tests_support::TestWithClassificator;
+using platform::tests_support::ScopedFile;
+
+FeatureBuilder MakePoint(uint64_t id)
+{
+  FeatureBuilder fb;
+  fb.SetCenter({static_cast<double>(id), 0.0});
+  fb.SetOsmId(base::MakeOsmNode(id));
+  fb.AddType(classif().GetTypeByPath({"amenity", "cafe"}));
+  return fb;
+}
+
+std::vector<uint64_t> ReadIds(std::string const & path)
+{
+  std::vector<uint64_t> ids;
+  ForEachFeatureRawFormat<serialization_policy::MaxAccuracy>(path, [&](FeatureBuilder const & fb, uint64_t)
+  {
+    ids.push_back(fb.GetMostGenericOsmId().GetSerialId());
+  });
+  return ids;
+}
+
+// Drops odd features and appends a new one.
+class DropOddStage : public FinalProcessorStage
+{
+public:
+  void Process(FeatureBuilder && fb, EmitFn const & emit) override
+  {
+    if (fb.GetMostGenericOsmId().GetSerialId() % 2 == 0)
+      emit(std::move(fb));
+  }
+
+  void Finish(EmitFn const & emit) override { emit(MakePoint(100)); }
+};
+
+// Appends a feature with the id equal to the number of features in the file.
+class CountStage : public FinalProcessorStage
+{
+public:
+  bool NeedsPrepare() const override { return true; }
+  void Prepare(FeatureBuilder const &) override { ++m_count; }
+  void Finish(EmitFn const & emit) override { emit(MakePoint(m_count)); }
+
+private:
+  uint64_t m_count = 0;
+};
+
+class AppendStage : public FinalProcessorStage
+{
+public:
+  explicit AppendStage(uint64_t id) : m_id(id) {}
+
+  bool IsAppendOnly() const override { return true; }
+  void Finish(EmitFn const & emit) override { emit(MakePoint(m_id)); }
+
+private:
+  uint64_t m_id;
+};
+
+void WriteIds(std::string const & path, std::vector<uint64_t> const & ids)
+{
+  FeatureBuilderWriter<serialization_policy::MaxAccuracy> writer(path);
+  for (auto const id : ids)
+    writer.Write(MakePoint(id));
+}
+
+UNIT_CLASS_TEST(TestWithClassificator, FinalProcessorPass_Stages)
+{
+  ScopedFile file("final_processor_pass_test.mwm.tmp", ScopedFile::Mode::DoNotCreate);
+  std::string const path = file.GetFullPath();
+  WriteIds(path, {1, 2, 3, 4, 5});
+
+  FinalProcessorPass pass;
+  pass.AddStage([](std::string const & country) -> FinalProcessorStagePtr
+  {
+    if (country != "Country")
+      return nullptr;
+    return std::make_unique<AppendStage>(200);
+  });
+  pass.AddStage([](std::string const &) { return std::make_unique<DropOddStage>(); });
+  pass.AddStage([](std::string const &) { return std::make_unique<CountStage>(); });
+
+  // Features appended by a stage are processed by the next stages.
+  pass.Run("Country", path);
+  TEST_EQUAL(ReadIds(path), std::vector<uint64_t>({2, 4, 200, 100, 5}), ());
+
+  pass.Run("Other", path);
+  TEST_EQUAL(ReadIds(path), std::vector<uint64_t>({2, 4, 200, 100, 100, 5}), ());
+}
+
+UNIT_CLASS_TEST(TestWithClassificator, FinalProcessorPass_AppendOnly)
+{
+  ScopedFile file("final_processor_pass_test.mwm.tmp", ScopedFile::Mode::DoNotCreate);
+  std::string const path = file.GetFullPath();
+  WriteIds(path, {1, 2});
+
+  FinalProcessorPass pass;
+  pass.AddStage([](std::string const &) { return std::make_unique<AppendStage>(3); });
+  pass.AddStage([](std::string const &) { return std::make_unique<AppendStage>(4); });
+  pass.Run("Country", path);
+  TEST_EQUAL(ReadIds(path), std::vector<uint64_t>({1, 2, 3, 4}), ());
+}
+}  // namespace final_processor_pass_tests
@@ -8,13 +8,19 @@
 
 #include "testing/testing.hpp"
 
+#include "generator/intermediate_data.hpp"
 #include "generator/intermediate_elements.hpp"
 
+#include "platform/platform_tests_support/scoped_file.hpp"
+
 #include "coding/reader.hpp"
 #include "coding/writer.hpp"
 
+#include "base/math.hpp"
+
 #include <cstdint>
 #include <string>
+#include <tuple>
 #include <vector>
 
 namespace intermediate_data_test
@@ -109,4 +115,44 @@ UNIT_TEST(Intermediate_Data_relation_element_save_load_test)
   TEST_NOT_EQUAL(e2.m_tags["key1old"], "value1old", ());
   TEST_NOT_EQUAL(e2.m_tags["key2old"], "value2old", ());
 }
+
+UNIT_TEST(Intermediate_Data_sparse_point_storage_test)
+{
+  using generator::cache::CreatePointStorageReader;
+  using generator::cache::CreatePointStorageWriter;
+  using platform::tests_support::ScopedFile;
+  using Type = feature::GenerateInfo::NodeStorageType;
+
+  ScopedFile const file("sparse_nodes.sparse", ScopedFile::Mode::DoNotCreate);
+  auto const name = file.GetFullPath().substr(0, file.GetFullPath().size() - 7 /* ".sparse" */);
+
+  std::vector<std::tuple<uint64_t, double, double>> const points = {
+      {1, 55.7522200, 37.6155600},    {2, 55.7522201, 37.6155500},  {255, 55.7500000, 37.6100000},
+      {256, -33.8688197, 151.2092955}, {300, 0.0, 0.0},              {1000, 89.9999999, -179.9999999},
+      {1001, -89.9999999, 179.9999999}, {10000000000, 60.7196051, -135.0538199}};
+
+  {
+    auto writer = CreatePointStorageWriter(Type::Sparse, name);
+    for (auto const & [id, lat, lon] : points)
+      writer->AddPoint(id, lat, lon);
+    TEST_EQUAL(writer->GetNumProcessedPoints(), points.size(), ());
+  }
+
+  auto const reader = CreatePointStorageReader(Type::Sparse, name);
+  for (auto const & [id, lat, lon] : points)
+  {
+    double readLat = 0.0;
+    double readLon = 0.0;
+    TEST(reader->GetPoint(id, readLat, readLon), (id));
+    TEST(base::AlmostEqualAbs(readLat, lat, 1e-7), (id, lat, readLat));
+    TEST(base::AlmostEqualAbs(readLon, lon, 1e-7), (id, lon, readLon));
+  }
+
+  for (uint64_t const id : {0ULL, 3ULL, 254ULL, 257ULL, 999ULL, 5000ULL, 10000000001ULL, 20000000000ULL})
+  {
+    double lat = 0.0;
+    double lon = 0.0;
+    TEST(!reader->GetPoint(id, lat, lon), (id));
+  }
+}
 }  // namespace intermediate_data_test
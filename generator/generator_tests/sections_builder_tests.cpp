@@ -0,0 +1,88 @@
+#include "testing/testing.hpp"
+
+#include "generator/sections_builder.hpp"
+
+#include "platform/platform_tests_support/scoped_file.hpp"
+
+#include "platform/platform.hpp"
+
+#include "coding/files_container.hpp"
+#include "coding/reader.hpp"
+
+#include <atomic>
+#include <string>
+#include <vector>
+
+#include "defines.hpp"
+
+namespace sections_builder_tests
+{
+using platform::tests_support::ScopedFile;
+using std::string, std::vector;
+
+string ReadSection(string const & path, string const & tag)
+{
+  FilesContainerR container(path);
+  if (!container.IsExist(tag))
+    return {};
+
+  auto const reader = container.GetReader(tag);
+  string result(static_cast<size_t>(reader.Size()), '\0');
+  reader.Read(0, result.data(), result.size());
+  return result;
+}
+
+bool WriteSection(string const & sectionsPath, string const & tag, string const & contents)
+{
+  FilesContainerW(sectionsPath, FileWriter::OP_WRITE_EXISTING)
+      .Write(contents.data(), contents.size(), tag);
+  return true;
+}
+
+UNIT_TEST(SectionsBuilder_Dependencies)
+{
+  ScopedFile mwm("sections_builder_test" DATA_FILE_EXTENSION, ScopedFile::Mode::DoNotCreate);
+  string const mwmPath = mwm.GetFullPath();
+  FilesContainerW(mwmPath).Write(string("header").data(), 6, "header");
+
+  std::atomic<bool> dependentOfFailedCalled = false;
+
+  generator::SectionsBuilder builder(mwmPath, 4 /* threadsCount */);
+  builder.Add("b", [](string const & mwmPath, string const & sectionsPath)
+  {
+    // |a| is built before |b| and is already in the mwm.
+    return WriteSection(sectionsPath, "b", ReadSection(mwmPath, "a") + "b");
+  }, {"a"});
+  builder.Add("a", [](string const & mwmPath, string const & sectionsPath)
+  {
+    return WriteSection(sectionsPath, "a", ReadSection(mwmPath, "header") + "a");
+  });
+  builder.Add("c", [](string const & /* mwmPath */, string const & sectionsPath)
+  {
+    return WriteSection(sectionsPath, "c1", "c1") && WriteSection(sectionsPath, "c2", "c2");
+  }, {"built_before"});
+  builder.Add("failed", [](string const & /* mwmPath */, string const & sectionsPath)
+  {
+    WriteSection(sectionsPath, "failed", "failed");
+    return false;
+  });
+  builder.Add("dependent_of_failed", [&](string const & /* mwmPath */, string const & /* sectionsPath */)
+  {
+    dependentOfFailedCalled = true;
+    return true;
+  }, {"failed"});
+
+  TEST(!builder.Run(), ());
+  TEST(!dependentOfFailedCalled, ());
+
+  TEST_EQUAL(ReadSection(mwmPath, "header"), "header", ());
+  TEST_EQUAL(ReadSection(mwmPath, "a"), "headera", ());
+  TEST_EQUAL(ReadSection(mwmPath, "b"), "headerab", ());
+  TEST_EQUAL(ReadSection(mwmPath, "c1"), "c1", ());
+  TEST_EQUAL(ReadSection(mwmPath, "c2"), "c2", ());
+  TEST(!FilesContainerR(mwmPath).IsExist("failed"), ());
+
+  for (auto const & name : {"a", "b", "c", "failed"})
+    TEST(!Platform::IsFileExistsByFullPath(mwmPath + "." + name + EXTENSION_TMP), (name));
+}
+}  // namespace sections_builder_tests
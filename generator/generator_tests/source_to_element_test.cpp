@@ -2,19 +2,136 @@
 
 #include "generator/generator_tests/source_data.hpp"
 #include "generator/osm_element.hpp"
+#include "generator/osm_pbf_source.hpp"
 #include "generator/osm_source.hpp"
 
 #include "coding/parse_xml.hpp"
 
+#include <algorithm>
 #include <cstddef>
+#include <cstdint>
+#include <cstring>
 #include <iostream>
 #include <iterator>
+#include <memory>
 #include <sstream>
 #include <string>
 #include <vector>
 
 using namespace generator;
 
+namespace
+{
+uint64_t ReadVarint(std::string const & s, size_t & pos)
+{
+  uint64_t result = 0;
+  for (int shift = 0;; shift += 7)
+  {
+    auto const byte = static_cast<uint8_t>(s[pos++]);
+    result |= static_cast<uint64_t>(byte & 0x7F) << shift;
+    if ((byte & 0x80) == 0)
+      return result;
+  }
+}
+
+void WriteVarint(uint64_t value, std::string & s)
+{
+  for (; value >= 0x80; value >>= 7)
+    s.push_back(static_cast<char>((value & 0x7F) | 0x80));
+  s.push_back(static_cast<char>(value));
+}
+
+// Copies protobuf |message| without the varint field |skippedField|. Length-delimited fields are
+// copied as they are, the other wire types aren't used by PBF headers and blobs.
+std::string RemoveVarintField(std::string const & message, uint64_t skippedField,
+                              uint64_t changedField = 0, uint64_t changedValue = 0)
+{
+  std::string result;
+  for (size_t pos = 0; pos < message.size();)
+  {
+    uint64_t const key = ReadVarint(message, pos);
+    uint64_t const field = key >> 3;
+    if ((key & 7) == 0)
+    {
+      uint64_t value = ReadVarint(message, pos);
+      if (field == skippedField)
+        continue;
+      if (field == changedField)
+        value = changedValue;
+      WriteVarint(key, result);
+      WriteVarint(value, result);
+      continue;
+    }
+
+    TEST_EQUAL(key & 7, 2, ());
+    uint64_t const size = ReadVarint(message, pos);
+    WriteVarint(key, result);
+    WriteVarint(size, result);
+    result.append(message, pos, size);
+    pos += size;
+  }
+  return result;
+}
+
+// Removes the optional raw_size field of all the blobs of a PBF file.
+std::string RemoveBlobsRawSize(std::string const & pbf)
+{
+  uint64_t constexpr kBlobRawSize = 2;
+  uint64_t constexpr kHeaderDataSize = 3;
+
+  std::string result;
+  for (size_t pos = 0; pos < pbf.size();)
+  {
+    uint32_t headerSize = 0;
+    for (size_t i = 0; i < 4; ++i)
+      headerSize = (headerSize << 8) | static_cast<uint8_t>(pbf[pos++]);
+
+    std::string const header = pbf.substr(pos, headerSize);
+    pos += headerSize;
+
+    size_t headerPos = 0;
+    uint64_t blobSize = 0;
+    while (headerPos < header.size())
+    {
+      uint64_t const key = ReadVarint(header, headerPos);
+      if ((key >> 3) == kHeaderDataSize)
+        blobSize = ReadVarint(header, headerPos);
+      else
+        headerPos += ReadVarint(header, headerPos);
+    }
+
+    std::string const blob = RemoveVarintField(pbf.substr(pos, blobSize), kBlobRawSize);
+    pos += blobSize;
+
+    std::string const newHeader = RemoveVarintField(header, 0 /* skippedField */,
+                                                    kHeaderDataSize, blob.size());
+    for (int shift = 24; shift >= 0; shift -= 8)
+      result.push_back(static_cast<char>((newHeader.size() >> shift) & 0xFF));
+    result += newHeader;
+    result += blob;
+  }
+  return result;
+}
+
+size_t CountPBFEntities(std::string const & pbf)
+{
+  size_t pos = 0;
+  osm::PBFSource source([&](uint8_t * buffer, size_t size)
+  {
+    size = std::min(size, pbf.size() - pos);
+    std::memcpy(buffer, pbf.data() + pos, size);
+    pos += size;
+    return size;
+  });
+
+  size_t count = 0;
+  std::vector<uint8_t> blob;
+  while (source.ReadBlob(blob))
+    osm::PBFSource::DecodeBlob(blob, [&count](osm::PBFSource::Entity const &) { ++count; });
+  return count;
+}
+}  // namespace
+
 UNIT_TEST(Source_To_Element_create_from_xml_test)
 {
   std::istringstream ss(way_xml_data);
@@ -73,3 +190,125 @@ UNIT_TEST(Source_To_Element_check_equivalence)
     TEST_EQUAL(elementsXML[i], elementsO5M[i], ());
   }
 }
+
+std::vector<OsmElement> ReadO5M(std::string const & src)
+{
+  std::istringstream ss(src);
+  SourceReader reader(ss);
+  std::vector<OsmElement> elements;
+  ProcessOsmElementsFromO5M(reader, [&elements](OsmElement && e)
+  {
+    elements.push_back(std::move(e));
+  });
+  return elements;
+}
+
+std::vector<OsmElement> ReadO5MInBlocks(std::string const & src, size_t threadsCount,
+                                        size_t maxBlockSize = O5MBlocksReader::kMaxBlockSize)
+{
+  std::istringstream ss(src);
+  SourceReader reader(ss);
+  ProcessorOsmElementsInBlocks processor(std::make_unique<O5MBlocksReader>(reader, maxBlockSize),
+                                         threadsCount);
+
+  std::vector<OsmElement> elements;
+  OsmElement element;
+  while (processor.TryRead(element))
+  {
+    elements.push_back(std::move(element));
+    element.Clear();
+  }
+  return elements;
+}
+
+UNIT_TEST(Source_To_Element_o5m_blocks_test)
+{
+  // Two datasets glued by a reset point.
+  std::string src(std::begin(way_o5m_data), std::prev(std::end(way_o5m_data)));
+  src.append(std::next(std::begin(relation_o5m_data), 7), std::end(relation_o5m_data));
+
+  auto const expected = ReadO5M(src);
+  TEST_EQUAL(expected.size(), 21, ());
+
+  // Small blocks make the reader switch to sequential reading in the first or the second part.
+  for (size_t maxBlockSize : {size_t(1), size_t(100), size_t(200), O5MBlocksReader::kMaxBlockSize})
+  {
+    for (size_t threadsCount : {1, 2, 4})
+    {
+      TEST_EQUAL(ReadO5MInBlocks(src, threadsCount, maxBlockSize), expected,
+                 (threadsCount, maxBlockSize));
+    }
+  }
+}
+
+UNIT_TEST(Source_To_Element_o5m_blocks_long_run_test)
+{
+  // Nodes with delta coded ids and coordinates: a short part, a reset and a long part.
+  auto const appendNodes = [](size_t count, std::string & src)
+  {
+    for (size_t i = 0; i < count; ++i)
+    {
+      // Node, length 4, id +1, no version, lon +1, lat +1.
+      src.append({'\x10', '\x04', '\x02', '\x00', '\x02', '\x02'});
+    }
+  };
+
+  std::string src = {'\xff', '\xe0', '\x04', 'o', '5', 'm', '2'};
+  appendNodes(100, src);
+  src.push_back('\xff');
+  appendNodes(10000, src);
+  src.push_back('\xfe');
+
+  auto const expected = ReadO5M(src);
+  TEST_EQUAL(expected.size(), 10100, ());
+  TEST_EQUAL(expected[99].m_id, 100, ());
+  TEST_EQUAL(expected[100].m_id, 1, ());
+  TEST_EQUAL(expected.back().m_id, 10000, ());
+
+  for (size_t threadsCount : {1, 2, 4})
+  {
+    TEST_EQUAL(ReadO5MInBlocks(src, threadsCount, 4096 /* maxBlockSize */), expected,
+               (threadsCount));
+  }
+}
+
+UNIT_TEST(Source_To_Element_pbf_check_equivalence)
+{
+  std::istringstream ss1(relation_xml_data);
+  SourceReader readerXML(ss1);
+
+  std::vector<OsmElement> elementsXML;
+  ProcessOsmElementsFromXML(readerXML, [&elementsXML](OsmElement && e)
+  {
+    elementsXML.push_back(std::move(e));
+  });
+
+  std::string src(std::begin(relation_pbf_data), std::end(relation_pbf_data));
+  std::istringstream ss2(src);
+  SourceReader readerPBF(ss2);
+  ProcessorOsmElementsInBlocks processor(std::make_unique<PBFBlocksReader>(readerPBF),
+                                         2 /* threadsCount */);
+
+  std::vector<OsmElement> elementsPBF;
+  OsmElement element;
+  while (processor.TryRead(element))
+  {
+    elementsPBF.push_back(std::move(element));
+    element.Clear();
+  }
+
+  TEST_EQUAL(elementsXML.size(), elementsPBF.size(), ());
+  for (size_t i = 0; i < elementsPBF.size(); ++i)
+    TEST_EQUAL(elementsXML[i], elementsPBF[i], ());
+}
+
+UNIT_TEST(Source_To_Element_pbf_without_raw_size)
+{
+  std::string const src(std::begin(relation_pbf_data), std::end(relation_pbf_data));
+  std::string const withoutRawSize = RemoveBlobsRawSize(src);
+  TEST_LESS(withoutRawSize.size(), src.size(), ());
+
+  size_t const count = CountPBFEntities(src);
+  TEST_GREATER(count, 0, ());
+  TEST_EQUAL(CountPBFEntities(withoutRawSize), count, ());
+}
@@ -2,12 +2,46 @@
 
 #include "generator/srtm_parser.hpp"
 
+#include "platform/platform_tests_support/scoped_dir.hpp"
+
+#include "platform/platform.hpp"
+
+#include "coding/endianness.hpp"
+#include "coding/file_writer.hpp"
+#include "coding/zip_creator.hpp"
+
+#include "base/file_name_utils.hpp"
+
+#include <vector>
+
 using namespace generator;
 
 namespace
 {
+using platform::tests_support::ScopedDir;
+
+size_t constexpr kTileSide = 3601;
+
 inline std::string GetBase(ms::LatLon const & coord) { return SrtmTile::GetBase(coord); }
 
+geometry::Altitude GetTestHeight(size_t row, size_t col)
+{
+  return static_cast<geometry::Altitude>((row * 7 + col) % 1000);
+}
+
+void WriteTestTile(std::string const & path)
+{
+  std::vector<geometry::Altitude> data(kTileSide * kTileSide);
+  for (size_t row = 0; row < kTileSide; ++row)
+  {
+    for (size_t col = 0; col < kTileSide; ++col)
+      data[row * kTileSide + col] = ReverseByteOrder(GetTestHeight(row, col));
+  }
+
+  FileWriter writer(path);
+  writer.Write(data.data(), data.size() * sizeof(geometry::Altitude));
+}
+
 UNIT_TEST(FilenameTests)
 {
   auto name = GetBase({56.4566, 37.3467});
@@ -25,4 +59,57 @@ UNIT_TEST(FilenameTests)
   name = GetBase({-34.622358, -58.383654});
   TEST_EQUAL(name, "S35W059", ());
 }
+
+UNIT_TEST(SrtmTileManager_Uncompressed)
+{
+  ScopedDir srtmDir("srtm_parser_test_uncompressed");
+  WriteTestTile(base::JoinPath(srtmDir.GetFullPath(), "N00E000.hgt"));
+  WriteTestTile(base::JoinPath(srtmDir.GetFullPath(), "N00E001.hgt"));
+
+  SrtmTileManager manager(srtmDir.GetFullPath(), 1 /* maxTilesCount */);
+  auto const tile = manager.GetTile({0.5, 0.25});
+  TEST(tile->IsValid(), ());
+  TEST_EQUAL(tile->GetHeight({0.5, 0.25}), GetTestHeight(1800, 900), ());
+
+  // The first tile is evicted but it's still alive.
+  TEST_EQUAL(manager.GetHeight({0.75, 1.5}), GetTestHeight(900, 1800), ());
+  TEST_EQUAL(tile->GetHeight({0.0, 0.0}), GetTestHeight(3600, 0), ());
+  TEST_EQUAL(manager.GetHeight({0.5, 0.25}), GetTestHeight(1800, 900), ());
+
+  // Missing tiles are invalid.
+  TEST_EQUAL(manager.GetHeight({10.5, 10.5}), geometry::kInvalidAltitude, ());
+
+  for (auto const & name : {"N00E000.hgt", "N00E001.hgt"})
+    Platform::RemoveFileIfExists(base::JoinPath(srtmDir.GetFullPath(), name));
+}
+
+UNIT_TEST(SrtmTileManager_ZipCache)
+{
+  ScopedDir srtmDir("srtm_parser_test_zip");
+  ScopedDir cacheDir("srtm_parser_test_cache");
+  auto const srtmPath = srtmDir.GetFullPath();
+  auto const cachePath = cacheDir.GetFullPath();
+
+  // Zipped files are named like "N00E000.hgt" inside the archive.
+  auto const hgtPath = base::JoinPath(cachePath, "N00E000.hgt");
+  auto const zipPath = base::JoinPath(srtmPath, "N00E000.SRTMGL1.hgt.zip");
+  WriteTestTile(hgtPath);
+  TEST(CreateZipFromPathDeflatedAndDefaultCompression(hgtPath, zipPath), ());
+  Platform::RemoveFileIfExists(hgtPath);
+
+  {
+    SrtmTileManager manager(srtmPath, 1 /* maxTilesCount */, cachePath);
+    TEST_EQUAL(manager.GetHeight({0.5, 0.25}), GetTestHeight(1800, 900), ());
+    TEST(Platform::IsFileExistsByFullPath(hgtPath), ());
+  }
+
+  // Tiles are decompressed into the memory without a cache directory.
+  {
+    SrtmTileManager manager(srtmPath);
+    TEST_EQUAL(manager.GetHeight({0.25, 0.5}), GetTestHeight(2700, 1800), ());
+  }
+
+  Platform::RemoveFileIfExists(hgtPath);
+  Platform::RemoveFileIfExists(zipPath);
+}
 }  // namespace
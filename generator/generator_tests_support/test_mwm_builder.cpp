@@ -142,6 +142,11 @@ void TestMwmBuilder::SetMwmLanguages(vector<string> const & languages)
   m_languages = languages;
 }
 
+void TestMwmBuilder::SetThreadsCount(size_t threadsCount)
+{
+  m_threadsCount = threadsCount;
+}
+
 void TestMwmBuilder::Finish()
 {
   CHECK(m_collector, ("Finish() already was called."));
@@ -154,7 +159,7 @@ void TestMwmBuilder::Finish()
   info.m_tmpDir = m_file.GetDirectory();
   info.m_intermediateDir = m_file.GetDirectory();
   info.m_versionDate = static_cast<uint32_t>(base::YYMMDDToSecondsSinceEpoch(m_version));
-  CHECK(GenerateFinalFeatures(info, m_file.GetCountryFile().GetName(), m_type),
+  CHECK(GenerateFinalFeatures(info, m_file.GetCountryFile().GetName(), m_type, m_threadsCount),
         ("Can't sort features."));
 
   CHECK(base::DeleteFileX(tmpFilePath), ());
@@ -25,6 +25,7 @@
 #include "generator/routing_index_generator.hpp"
 #include "generator/routing_world_roads_generator.hpp"
 #include "generator/search_index_builder.hpp"
+#include "generator/sections_builder.hpp"
 #include "generator/statistics.hpp"
 #include "generator/traffic_generator.hpp"
 #include "generator/transit_generator.hpp"
@@ -55,6 +56,7 @@
 
 #include "defines.hpp"
 
+#include <algorithm>
 #include <csignal>
 #include <cstdlib>
 #include <fstream>
@@ -85,7 +87,10 @@ DEFINE_bool(emit_coasts, false,
 
 // Generator settings and paths.
 DEFINE_string(osm_file_name, "", "Input osm area file.");
-DEFINE_string(osm_file_type, "xml", "Input osm area file type [xml, o5m].");
+DEFINE_string(osm_file_type, "xml", "Input osm area file type [xml, o5m, pbf].");
+DEFINE_uint64(osm_reader_threads_count, 1,
+              "Count of threads to decode input osm file blocks in parallel (o5m, pbf). "
+              "O5M input is read sequentially if it equals one.");
 DEFINE_string(data_path, "", GetDataPathHelp());
 DEFINE_string(user_resource_path, "", "User defined resource path for classificator.txt and etc.");
 DEFINE_string(intermediate_data_path, "", "Path to stored intermediate data.");
@@ -95,7 +100,8 @@ DEFINE_string(cache_path, "",
 DEFINE_string(output, "", "File name for process (without 'mwm' ext).");
 DEFINE_bool(preload_cache, false, "Preload all ways and relations cache.");
 DEFINE_string(node_storage, "map",
-              "Type of storage for intermediate points representation. Available: raw, map, mem.");
+              "Type of storage for intermediate points representation. Available: raw, map, mem, "
+              "sparse (requires nodes sorted by id).");
 DEFINE_uint64(planet_version, base::SecondsSinceEpoch(),
               "Version as seconds since epoch, by default - now.");
 
@@ -128,6 +134,8 @@ DEFINE_string(isolines_path, "",
 DEFINE_bool(make_routing_index, false, "Make sections with the routing information.");
 DEFINE_bool(make_cross_mwm, false,
             "Make section for cross mwm routing (for dynamic indexed routing).");
+DEFINE_bool(make_routing_shortcuts, false,
+            "Make section with the contraction hierarchy for single mwm car routing.");
 DEFINE_bool(make_transit_cross_mwm, false, "Make section for cross mwm transit routing.");
 DEFINE_bool(make_transit_cross_mwm_experimental, false,
             "Experimental parameter. If set the new version of transit cross-mwm section will be "
@@ -135,6 +143,9 @@ DEFINE_bool(make_transit_cross_mwm_experimental, false,
 DEFINE_string(srtm_path, "",
               "Path to srtm directory. If set, generates a section with altitude information "
               "about roads.");
+DEFINE_string(srtm_cache_path, "",
+              "Path to directory to decompress zipped srtm tiles once. If empty, the tiles are "
+              "decompressed to the 'srtm' subdirectory of 'cache_path'.");
 DEFINE_string(world_roads_path, "",
               "Path to a file with roads that should end up on the world map. If set, generates a "
               "section with these roads in World.mwm. The roads may be used to identify which mwm "
@@ -249,6 +260,7 @@ MAIN_WITH_ERROR_HANDLING([](int argc, char ** argv)
     genInfo.SetOsmFileType(FLAGS_osm_file_type);
 
   genInfo.m_osmFileName = FLAGS_osm_file_name;
+  genInfo.m_osmReaderThreadsCount = std::max<size_t>(FLAGS_osm_reader_threads_count, 1);
   genInfo.m_failOnCoasts = FLAGS_fail_on_coasts;
   genInfo.m_preloadCache = FLAGS_preload_cache;
   genInfo.m_popularPlacesFilename = FLAGS_popular_places_data;
@@ -306,9 +318,9 @@ MAIN_WITH_ERROR_HANDLING([](int argc, char ** argv)
 
   // Load mwm tree only if we need it
   std::unique_ptr<storage::CountryParentGetter> countryParentGetter;
-  if (FLAGS_make_routing_index || FLAGS_make_cross_mwm || FLAGS_make_transit_cross_mwm ||
-      FLAGS_make_transit_cross_mwm_experimental || !FLAGS_uk_postcodes_dataset.empty() ||
-      !FLAGS_us_postcodes_dataset.empty())
+  if (FLAGS_make_routing_index || FLAGS_make_cross_mwm || FLAGS_make_routing_shortcuts ||
+      FLAGS_make_transit_cross_mwm || FLAGS_make_transit_cross_mwm_experimental ||
+      !FLAGS_uk_postcodes_dataset.empty() || !FLAGS_us_postcodes_dataset.empty())
   {
     countryParentGetter = std::make_unique<storage::CountryParentGetter>();
   }
@@ -349,7 +361,7 @@ MAIN_WITH_ERROR_HANDLING([](int argc, char ** argv)
       // On error move to the next bucket without index generation.
 
       LOG(LINFO, ("Generating result features for", country));
-      if (!feature::GenerateFinalFeatures(genInfo, country, mapType))
+      if (!feature::GenerateFinalFeatures(genInfo, country, mapType, threadsCount))
         continue;
 
       LOG(LINFO, ("Generating offsets table for", dataFile));
@@ -366,14 +378,87 @@ MAIN_WITH_ERROR_HANDLING([](int argc, char ** argv)
       }
     }
 
+    // These sections only read features and the geometry index, so they are built concurrently.
+    generator::SectionsBuilder sectionsBuilder(dataFile, threadsCount);
+
     if (FLAGS_generate_index)
     {
-      LOG(LINFO, ("Generating index for", dataFile));
+      sectionsBuilder.Add("index", [&](string const & mwmPath, string const & sectionsPath)
+      {
+        LOG(LINFO, ("Generating index for", mwmPath));
+        return indexer::BuildIndexFromDataFile(mwmPath, FLAGS_intermediate_data_path + country,
+                                               sectionsPath);
+      });
+    }
 
-      if (!indexer::BuildIndexFromDataFile(dataFile, FLAGS_intermediate_data_path + country))
-        LOG(LCRITICAL, ("Error generating index."));
+    if (FLAGS_generate_search_index)
+    {
+      sectionsBuilder.Add("centers", [](string const & mwmPath, string const & sectionsPath)
+      {
+        LOG(LINFO, ("Generating centers table for", mwmPath));
+        return indexer::BuildCentersTableFromDataFile(mwmPath, sectionsPath, true /* forceRebuild */);
+      });
     }
 
+    if (FLAGS_generate_cities_boundaries)
+    {
+      CHECK(!FLAGS_cities_boundaries_data.empty(), ());
+      sectionsBuilder.Add("cities_boundaries", [](string const & mwmPath, string const & sectionsPath)
+      {
+        LOG(LINFO, ("Generating cities boundaries for", mwmPath));
+        generator::OsmIdToBoundariesTable table;
+        if (!generator::DeserializeBoundariesTable(FLAGS_cities_boundaries_data, table))
+        {
+          LOG(LERROR, ("Error deserializing boundaries table"));
+          return false;
+        }
+        return generator::BuildCitiesBoundaries(mwmPath, sectionsPath, table);
+      });
+    }
+
+    if (!FLAGS_srtm_path.empty())
+    {
+      // Zipped tiles evicted from the tiles cache are read again from the decompressed files.
+      string const srtmCachePath = FLAGS_srtm_cache_path.empty()
+                                       ? base::JoinPath(genInfo.m_cacheDir, "srtm")
+                                       : FLAGS_srtm_cache_path;
+      if (!Platform::MkDirRecursively(srtmCachePath))
+        LOG(LCRITICAL, ("Can't create directory", srtmCachePath));
+
+      sectionsBuilder.Add("altitudes", [srtmCachePath](string const & mwmPath,
+                                                       string const & sectionsPath)
+      {
+        routing::BuildRoadAltitudes(mwmPath, sectionsPath, FLAGS_srtm_path, srtmCachePath);
+        return true;
+      });
+    }
+
+    if (FLAGS_generate_cameras)
+    {
+//      if (routing::AreSpeedCamerasProhibited(platform::CountryFile(country)))
+//      {
+//        LOG(LINFO,
+//            ("Cameras info is prohibited for", country, "and speedcams section is not generated."));
+//      }
+//      else
+//      {
+      string const camerasFilename = genInfo.GetIntermediateFileName(CAMERAS_TO_WAYS_FILENAME);
+
+      // Cameras are matched to roads with the geometry index.
+      sectionsBuilder.Add(
+          "cameras",
+          [camerasFilename, &osmToFeatureFilename](string const & mwmPath, string const & sectionsPath)
+          {
+            BuildCamerasInfo(mwmPath, sectionsPath, camerasFilename, osmToFeatureFilename);
+            return true;
+          },
+          {"index"});
+//      }
+    }
+
+    if (!sectionsBuilder.Run())
+      LOG(LCRITICAL, ("Error generating sections for", dataFile));
+
     if (FLAGS_generate_search_index)
     {
       LOG(LINFO, ("Generating search index for", dataFile));
@@ -416,21 +501,6 @@ MAIN_WITH_ERROR_HANDLING([](int argc, char ** argv)
       LOG(LINFO, ("Generating rank table for", dataFile));
       if (!search::SearchRankTableBuilder::CreateIfNotExists(dataFile))
         LOG(LCRITICAL, ("Error generating rank table."));
-
-      LOG(LINFO, ("Generating centers table for", dataFile));
-      if (!indexer::BuildCentersTableFromDataFile(dataFile, true /* forceRebuild */))
-        LOG(LCRITICAL, ("Error generating centers table."));
-    }
-
-    if (FLAGS_generate_cities_boundaries)
-    {
-      CHECK(!FLAGS_cities_boundaries_data.empty(), ());
-      LOG(LINFO, ("Generating cities boundaries for", dataFile));
-      generator::OsmIdToBoundariesTable table;
-      if (!generator::DeserializeBoundariesTable(FLAGS_cities_boundaries_data, table))
-        LOG(LCRITICAL, ("Error deserializing boundaries table"));
-      if (!generator::BuildCitiesBoundaries(dataFile, table))
-        LOG(LCRITICAL, ("Error generating cities boundaries."));
     }
 
     if (FLAGS_generate_cities_ids)
@@ -440,9 +510,6 @@ MAIN_WITH_ERROR_HANDLING([](int argc, char ** argv)
         LOG(LCRITICAL, ("Error generating cities ids."));
     }
 
-    if (!FLAGS_srtm_path.empty())
-      routing::BuildRoadAltitudes(dataFile, FLAGS_srtm_path);
-
     transit::experimental::EdgeIdToFeatureId transitEdgeFeatureIds;
 
     if (!FLAGS_transit_path_experimental.empty())
@@ -455,21 +522,6 @@ MAIN_WITH_ERROR_HANDLING([](int argc, char ** argv)
       routing::transit::BuildTransit(path, country, osmToFeatureFilename, FLAGS_transit_path);
     }
 
-    if (FLAGS_generate_cameras)
-    {
-//      if (routing::AreSpeedCamerasProhibited(platform::CountryFile(country)))
-//      {
-//        LOG(LINFO,
-//            ("Cameras info is prohibited for", country, "and speedcams section is not generated."));
-//      }
-//      else
-//      {
-        string const camerasFilename = genInfo.GetIntermediateFileName(CAMERAS_TO_WAYS_FILENAME);
-
-        BuildCamerasInfo(dataFile, camerasFilename, osmToFeatureFilename);
-//      }
-    }
-
     if (country == WORLD_FILE_NAME && !FLAGS_world_roads_path.empty())
     {
       LOG(LINFO, ("Generating routing section for World."));
@@ -540,7 +592,7 @@ MAIN_WITH_ERROR_HANDLING([](int argc, char ** argv)
       if (FLAGS_make_cross_mwm)
       {
         BuildRoutingCrossMwmSection(path, dataFile, country, genInfo.m_intermediateDir,
-                                    *countryParentGetter, osmToFeatureFilename);
+                                    *countryParentGetter, osmToFeatureFilename, threadsCount);
       }
 
       if (FLAGS_make_transit_cross_mwm_experimental)
@@ -560,6 +612,20 @@ MAIN_WITH_ERROR_HANDLING([](int argc, char ** argv)
       }
     }
 
+    if (FLAGS_make_routing_shortcuts)
+    {
+      if (!countryParentGetter)
+      {
+        // All the mwms should use proper VehicleModels.
+        LOG(LCRITICAL,
+            ("Countries file is needed. Please set countries file name (countries.txt). "
+             "File must be located in data directory."));
+        return EXIT_FAILURE;
+      }
+
+      BuildRoutingShortcutsSection(path, dataFile, country, *countryParentGetter);
+    }
+
     // Check !generate_popular_places to avoid mixing, generate_popular_places stage uses the same wiki flags.
     if (!FLAGS_generate_popular_places && !FLAGS_wikipedia_pages.empty())
     {
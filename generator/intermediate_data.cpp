@@ -1,10 +1,14 @@
 #include "generator/intermediate_data.hpp"
 
+#include <algorithm>
+#include <cstring>
+#include <limits>
 #include <new>
 #include <set>
 #include <string>
 
 #include "base/assert.hpp"
+#include "base/bits.hpp"
 #include "base/checked_cast.hpp"
 #include "base/logging.hpp"
 
@@ -19,6 +23,7 @@ namespace
 size_t const kFlushCount = 1024;
 double const kValueOrder = 1e7;
 string const kShortExtension = ".short";
+string const kSparseExtension = ".sparse";
 
 // An estimation.
 // OSM had around 4.1 billion nodes on 2017-11-08,
@@ -254,6 +259,218 @@ private:
   FileWriter m_fileWriter;
   uint64_t m_numProcessedPoints = 0;
 };
+// Sparse file storage ------------------------------------------------------------------------------
+// Nodes are grouped into blocks of kSparseBlockSize consecutive ids. A block is stored as:
+// presence bitmap of kSparseBlockSize bits, minimal latitude and longitude of the block nodes,
+// bit widths of latitude and longitude deltas, and then bit-packed deltas from the minimal values
+// for all present nodes in id order. Nodes with close ids are usually close to each other, so the
+// deltas are short. Offsets of all blocks (including empty ones) follow the blocks, so a point is
+// found by its block in O(1) and by the rank of its bit in the block bitmap.
+uint8_t constexpr kSparseBlockBits = 8;
+uint64_t constexpr kSparseBlockSize = uint64_t{1} << kSparseBlockBits;
+size_t constexpr kSparseBitmapWords = kSparseBlockSize / 64;
+size_t constexpr kSparseBlockHeaderSize =
+    kSparseBitmapWords * sizeof(uint64_t) + 2 * sizeof(int32_t) + 2 * sizeof(uint8_t);
+
+template <typename T>
+T ReadUnaligned(uint8_t const * p)
+{
+  T value;
+  std::memcpy(&value, p, sizeof(value));
+  return value;
+}
+
+uint8_t BitsForValue(uint32_t value)
+{
+  uint8_t bits = 0;
+  for (; value != 0; value >>= 1)
+    ++bits;
+  return bits;
+}
+
+class SparseFilePointStorageReader : public PointStorageReaderInterface
+{
+public:
+  explicit SparseFilePointStorageReader(string const & name)
+    : m_mmapReader(name + kSparseExtension, MmapReader::Advice::Random)
+  {
+    uint64_t const size = m_mmapReader.Size();
+    CHECK_GREATER_OR_EQUAL(size, sizeof(uint64_t), ("Damaged file."));
+    m_data = m_mmapReader.Data();
+    m_blocksCount = ReadUnaligned<uint64_t>(m_data + size - sizeof(uint64_t));
+    uint64_t const offsetsSize = (m_blocksCount + 1) * sizeof(uint64_t);
+    CHECK_LESS_OR_EQUAL(offsetsSize + sizeof(uint64_t), size, ("Damaged file."));
+    m_offsets = m_data + size - sizeof(uint64_t) - offsetsSize;
+  }
+
+  // PointStorageReaderInterface overrides:
+  bool GetPoint(uint64_t id, double & lat, double & lon) const override
+  {
+    uint64_t const blockIdx = id >> kSparseBlockBits;
+    if (blockIdx >= m_blocksCount)
+      return false;
+
+    uint64_t const begin = ReadUnaligned<uint64_t>(m_offsets + blockIdx * sizeof(uint64_t));
+    uint64_t const end = ReadUnaligned<uint64_t>(m_offsets + (blockIdx + 1) * sizeof(uint64_t));
+    if (begin == end)
+      return false;
+
+    uint8_t const * block = m_data + begin;
+    auto const bit = static_cast<size_t>(id & (kSparseBlockSize - 1));
+    size_t const wordIdx = bit / 64;
+    uint64_t const mask = uint64_t{1} << (bit % 64);
+    uint64_t rank = 0;
+    for (size_t i = 0; i < wordIdx; ++i)
+      rank += bits::PopCount(ReadUnaligned<uint64_t>(block + i * sizeof(uint64_t)));
+
+    auto const word = ReadUnaligned<uint64_t>(block + wordIdx * sizeof(uint64_t));
+    if ((word & mask) == 0)
+      return false;
+    rank += bits::PopCount(word & (mask - 1));
+
+    uint8_t const * header = block + kSparseBitmapWords * sizeof(uint64_t);
+    LatLon ll;
+    ll.m_lat = ReadUnaligned<int32_t>(header);
+    ll.m_lon = ReadUnaligned<int32_t>(header + sizeof(int32_t));
+    uint8_t const latBits = header[2 * sizeof(int32_t)];
+    uint8_t const lonBits = header[2 * sizeof(int32_t) + 1];
+
+    uint8_t const * packed = block + kSparseBlockHeaderSize;
+    uint64_t const pos = rank * (latBits + lonBits);
+    ll.m_lat = static_cast<int32_t>(static_cast<int64_t>(ll.m_lat) + ReadBits(packed, pos, latBits));
+    ll.m_lon = static_cast<int32_t>(static_cast<int64_t>(ll.m_lon) +
+                                    ReadBits(packed, pos + latBits, lonBits));
+
+    lat = static_cast<double>(ll.m_lat) / kValueOrder;
+    lon = static_cast<double>(ll.m_lon) / kValueOrder;
+    return true;
+  }
+
+private:
+  static uint32_t ReadBits(uint8_t const * data, uint64_t pos, uint8_t count)
+  {
+    uint64_t value = 0;
+    uint8_t read = 0;
+    while (read < count)
+    {
+      uint8_t const shift = pos % 8;
+      uint8_t const n = std::min<uint8_t>(8 - shift, count - read);
+      value |= static_cast<uint64_t>((data[pos / 8] >> shift) & ((1u << n) - 1)) << read;
+      read += n;
+      pos += n;
+    }
+    return static_cast<uint32_t>(value);
+  }
+
+  MmapReader m_mmapReader;
+  uint8_t const * m_data = nullptr;
+  uint8_t const * m_offsets = nullptr;
+  uint64_t m_blocksCount = 0;
+};
+
+class SparseFilePointStorageWriter : public PointStorageWriterBase
+{
+public:
+  explicit SparseFilePointStorageWriter(string const & name)
+    : m_fileWriter(name + kSparseExtension)
+  {
+  }
+
+  ~SparseFilePointStorageWriter() noexcept(false) override
+  {
+    FlushBlock();
+    uint64_t const blocksCount = m_offsets.size();
+    m_offsets.push_back(m_fileWriter.Pos());
+    m_fileWriter.Write(m_offsets.data(), m_offsets.size() * sizeof(uint64_t));
+    m_fileWriter.Write(&blocksCount, sizeof(blocksCount));
+  }
+
+  // PointStorageWriterInterface overrides:
+  void AddPoint(uint64_t id, double lat, double lon) override
+  {
+    CHECK(m_numProcessedPoints == 0 || id > m_lastId,
+          ("Sparse node storage requires nodes sorted by id. Node", id, "follows", m_lastId));
+
+    LatLon ll;
+    ToLatLon(lat, lon, ll);
+
+    uint64_t const blockIdx = id >> kSparseBlockBits;
+    if (blockIdx != m_blockIdx)
+      FlushBlock();
+
+    m_blockIdx = blockIdx;
+    m_block.emplace_back(static_cast<uint8_t>(id & (kSparseBlockSize - 1)), ll);
+    m_lastId = id;
+    ++m_numProcessedPoints;
+  }
+
+  uint64_t GetNumProcessedPoints() const override { return m_numProcessedPoints; }
+
+private:
+  void FlushBlock()
+  {
+    if (m_block.empty())
+      return;
+
+    // Empty blocks before the current one share its offset.
+    while (m_offsets.size() <= m_blockIdx)
+      m_offsets.push_back(m_fileWriter.Pos());
+
+    uint64_t bitmap[kSparseBitmapWords] = {};
+    int32_t minLat = std::numeric_limits<int32_t>::max();
+    int32_t minLon = std::numeric_limits<int32_t>::max();
+    int32_t maxLat = std::numeric_limits<int32_t>::min();
+    int32_t maxLon = std::numeric_limits<int32_t>::min();
+    for (auto const & [bit, ll] : m_block)
+    {
+      bitmap[bit / 64] |= uint64_t{1} << (bit % 64);
+      minLat = std::min(minLat, ll.m_lat);
+      minLon = std::min(minLon, ll.m_lon);
+      maxLat = std::max(maxLat, ll.m_lat);
+      maxLon = std::max(maxLon, ll.m_lon);
+    }
+
+    uint8_t const latBits =
+        BitsForValue(static_cast<uint32_t>(static_cast<int64_t>(maxLat) - minLat));
+    uint8_t const lonBits =
+        BitsForValue(static_cast<uint32_t>(static_cast<int64_t>(maxLon) - minLon));
+
+    m_packed.assign((m_block.size() * (latBits + lonBits) + 7) / 8, 0);
+    uint64_t pos = 0;
+    for (auto const & [bit, ll] : m_block)
+    {
+      WriteBits(static_cast<uint32_t>(static_cast<int64_t>(ll.m_lat) - minLat), latBits, pos);
+      WriteBits(static_cast<uint32_t>(static_cast<int64_t>(ll.m_lon) - minLon), lonBits, pos);
+    }
+
+    m_fileWriter.Write(bitmap, sizeof(bitmap));
+    m_fileWriter.Write(&minLat, sizeof(minLat));
+    m_fileWriter.Write(&minLon, sizeof(minLon));
+    m_fileWriter.Write(&latBits, sizeof(latBits));
+    m_fileWriter.Write(&lonBits, sizeof(lonBits));
+    m_fileWriter.Write(m_packed.data(), m_packed.size());
+
+    m_block.clear();
+  }
+
+  void WriteBits(uint32_t value, uint8_t count, uint64_t & pos)
+  {
+    for (uint8_t i = 0; i < count; ++i, ++pos)
+    {
+      if ((value >> i) & 1)
+        m_packed[pos / 8] |= static_cast<uint8_t>(1u << (pos % 8));
+    }
+  }
+
+  FileWriter m_fileWriter;
+  // Offsets of all blocks up to the last non-empty one. It's 8 bytes per kSparseBlockSize ids.
+  std::vector<uint64_t> m_offsets;
+  std::vector<std::pair<uint8_t, LatLon>> m_block;
+  std::vector<uint8_t> m_packed;
+  uint64_t m_blockIdx = 0;
+  uint64_t m_lastId = 0;
+  uint64_t m_numProcessedPoints = 0;
+};
 }  // namespace
 
 // IndexFileReader ---------------------------------------------------------------------------------
@@ -431,6 +648,8 @@ CreatePointStorageReader(feature::GenerateInfo::NodeStorageType type, string con
     return std::make_unique<MapFilePointStorageReader>(name);
   case feature::GenerateInfo::NodeStorageType::Memory:
     return std::make_unique<RawMemPointStorageReader>(name);
+  case feature::GenerateInfo::NodeStorageType::Sparse:
+    return std::make_unique<SparseFilePointStorageReader>(name);
   }
   UNREACHABLE();
 }
@@ -446,6 +665,8 @@ CreatePointStorageWriter(feature::GenerateInfo::NodeStorageType type, string con
     return std::make_unique<MapFilePointStorageWriter>(name);
   case feature::GenerateInfo::NodeStorageType::Memory:
     return std::make_unique<RawMemPointStorageWriter>(name);
+  case feature::GenerateInfo::NodeStorageType::Sparse:
+    return std::make_unique<SparseFilePointStorageWriter>(name);
   }
   UNREACHABLE();
 }
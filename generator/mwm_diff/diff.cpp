@@ -3,7 +3,9 @@
 #include "coding/buffered_file_writer.hpp"
 #include "coding/file_reader.hpp"
 #include "coding/file_writer.hpp"
+#include "coding/files_container.hpp"
 #include "coding/reader.hpp"
+#include "coding/varint.hpp"
 #include "coding/write_to_sink.hpp"
 #include "coding/writer.hpp"
 #include "coding/zlib.hpp"
@@ -12,9 +14,16 @@
 #include "base/cancellable.hpp"
 #include "base/checked_cast.hpp"
 #include "base/logging.hpp"
+#include "base/thread_pool_computational.hpp"
 
+#include <algorithm>
 #include <cstdint>
+#include <exception>
+#include <future>
 #include <iterator>
+#include <limits>
+#include <map>
+#include <string>
 #include <vector>
 
 #include "3party/bsdiff-courgette/bsdiff/bsdiff.h"
@@ -25,9 +34,249 @@ enum Version
 {
   // Format Version 0: bsdiff+gzip.
   VERSION_V0 = 0,
+  // Format Version 1: the new mwm is split into chunks by its sections, every chunk is
+  // either copied from the old mwm, or bsdiff+gzip of an old mwm section, or gzipped bytes.
+  // Such diffs are made only when requested explicitly until clients which apply them are
+  // released.
+  VERSION_V1 = 1,
   VERSION_LATEST = VERSION_V0
 };
 
+enum class ChunkType : uint8_t
+{
+  // Bytes of the old mwm.
+  Copy = 0,
+  // Bytes of the old mwm patched with bsdiff.
+  Patch = 1,
+  // Bytes stored in the diff.
+  Raw = 2,
+};
+
+// A range of the new mwm. Ranges of all chunks cover the new mwm without gaps.
+struct Chunk
+{
+  ChunkType m_type = ChunkType::Raw;
+  uint64_t m_oldOffset = 0;
+  uint64_t m_oldSize = 0;
+  uint64_t m_newOffset = 0;
+  uint64_t m_newSize = 0;
+  // Deflated bsdiff patch or bytes for Patch and Raw chunks.
+  std::vector<uint8_t> m_payload;
+};
+
+// Size of the buffer used to copy chunks from the old mwm.
+size_t constexpr kCopyBufferSize = 1024 * 1024;
+
+std::vector<uint8_t> ReadRange(FileReader const & reader, uint64_t offset, uint64_t size)
+{
+  std::vector<uint8_t> buffer(base::checked_cast<size_t>(size));
+  reader.Read(offset, buffer.data(), buffer.size());
+  return buffer;
+}
+
+std::vector<uint8_t> DeflateBuffer(std::vector<uint8_t> const & data)
+{
+  using Deflate = coding::ZLib::Deflate;
+  Deflate deflate(Deflate::Format::ZLib, Deflate::Level::BestCompression);
+
+  std::vector<uint8_t> deflated;
+  CHECK(deflate(data.data(), data.size(), back_inserter(deflated)), ());
+  return deflated;
+}
+
+// Returns sections of the container at |path| sorted by offsets or nothing if the file
+// is not a valid container.
+std::vector<FilesContainerBase::TagInfo> ReadSections(std::string const & path, uint64_t fileSize)
+{
+  std::vector<FilesContainerBase::TagInfo> sections;
+  try
+  {
+    // A container starts with the offset of its sections table.
+    if (fileSize < sizeof(uint64_t))
+      return {};
+    auto const infoOffset = ReadPrimitiveFromPos<uint64_t>(FileReader(path), 0);
+    if (infoOffset < sizeof(uint64_t) || infoOffset >= fileSize)
+      return {};
+
+    FilesContainerR container(path);
+    container.ForEachTagInfo([&](FilesContainerBase::TagInfo const & info) {
+      if (info.m_size != 0)
+        sections.push_back(info);
+    });
+  }
+  catch (std::exception const & e)
+  {
+    LOG(LINFO, ("Can't read sections of", path, e.what()));
+    return {};
+  }
+
+  std::sort(sections.begin(), sections.end(), [](auto const & lhs, auto const & rhs) {
+    return lhs.m_offset < rhs.m_offset;
+  });
+
+  uint64_t end = 0;
+  for (auto const & section : sections)
+  {
+    if (section.m_offset < end || section.m_offset > fileSize ||
+        section.m_size > fileSize - section.m_offset)
+    {
+      LOG(LINFO, ("Wrong section", section, "of", path));
+      return {};
+    }
+    end = section.m_offset + section.m_size;
+  }
+  return sections;
+}
+
+// Splits the new mwm into chunks: sections of the new mwm which are present in the old one
+// are patched, the rest of bytes are stored. If any of mwms is not a valid container
+// the whole new mwm is patched.
+std::vector<Chunk> MakeChunks(std::string const & oldMwmPath, uint64_t oldSize,
+                              std::string const & newMwmPath, uint64_t newSize)
+{
+  std::vector<Chunk> chunks;
+  if (newSize == 0)
+    return chunks;
+
+  auto const oldSections = ReadSections(oldMwmPath, oldSize);
+  auto const newSections = ReadSections(newMwmPath, newSize);
+  if (oldSections.empty() || newSections.empty())
+  {
+    Chunk chunk;
+    chunk.m_type = oldSize == 0 ? ChunkType::Raw : ChunkType::Patch;
+    chunk.m_oldSize = oldSize;
+    chunk.m_newSize = newSize;
+    chunks.push_back(std::move(chunk));
+    return chunks;
+  }
+
+  std::map<std::string, FilesContainerBase::TagInfo const *> tagToOldSection;
+  for (auto const & section : oldSections)
+    tagToOldSection.emplace(section.m_tag, &section);
+
+  auto const addRaw = [&chunks](uint64_t offset, uint64_t size) {
+    if (size == 0)
+      return;
+    Chunk chunk;
+    chunk.m_newOffset = offset;
+    chunk.m_newSize = size;
+    chunks.push_back(std::move(chunk));
+  };
+
+  uint64_t end = 0;
+  for (auto const & section : newSections)
+  {
+    addRaw(end, section.m_offset - end);
+    end = section.m_offset + section.m_size;
+
+    auto const it = tagToOldSection.find(section.m_tag);
+    if (it == tagToOldSection.end())
+    {
+      addRaw(section.m_offset, section.m_size);
+      continue;
+    }
+
+    Chunk chunk;
+    chunk.m_type = ChunkType::Patch;
+    chunk.m_oldOffset = it->second->m_offset;
+    chunk.m_oldSize = it->second->m_size;
+    chunk.m_newOffset = section.m_offset;
+    chunk.m_newSize = section.m_size;
+    chunks.push_back(std::move(chunk));
+  }
+  addRaw(end, newSize - end);
+  return chunks;
+}
+
+// Fills the payload of |chunk|. Patch chunks of equal ranges become Copy chunks.
+bool MakeChunkPayload(std::string const & oldMwmPath, std::string const & newMwmPath, Chunk & chunk)
+{
+  FileReader newReader(newMwmPath);
+  auto newBuf = ReadRange(newReader, chunk.m_newOffset, chunk.m_newSize);
+  if (chunk.m_type == ChunkType::Raw)
+  {
+    chunk.m_payload = DeflateBuffer(newBuf);
+    return true;
+  }
+
+  FileReader oldReader(oldMwmPath);
+  if (chunk.m_oldSize == chunk.m_newSize &&
+      ReadRange(oldReader, chunk.m_oldOffset, chunk.m_oldSize) == newBuf)
+  {
+    chunk.m_type = ChunkType::Copy;
+    return true;
+  }
+
+  auto oldSection = oldReader.SubReader(chunk.m_oldOffset, chunk.m_oldSize);
+  MemReader newSection(newBuf.data(), newBuf.size());
+  std::vector<uint8_t> diffBuf;
+  MemWriter<std::vector<uint8_t>> diffMemWriter(diffBuf);
+
+  auto const status = bsdiff::CreateBinaryPatch(oldSection, newSection, diffMemWriter);
+  if (status != bsdiff::BSDiffStatus::OK)
+  {
+    LOG(LERROR, ("Could not create patch with bsdiff:", status));
+    return false;
+  }
+
+  // The payload of any chunk isn't larger than the chunk, so the inflated size can be limited
+  // when the diff is applied.
+  if (diffBuf.size() > newBuf.size())
+  {
+    chunk.m_type = ChunkType::Raw;
+    chunk.m_payload = DeflateBuffer(newBuf);
+    return true;
+  }
+
+  chunk.m_payload = DeflateBuffer(diffBuf);
+  return true;
+}
+
+bool MakeDiffVersion1(std::string const & oldMwmPath, std::string const & newMwmPath,
+                      FileWriter & diffFileWriter, size_t threadsCount)
+{
+  auto const oldSize = FileReader(oldMwmPath).Size();
+  auto const newSize = FileReader(newMwmPath).Size();
+  auto chunks = MakeChunks(oldMwmPath, oldSize, newMwmPath, newSize);
+
+  WriteToSink(diffFileWriter, static_cast<uint32_t>(VERSION_V1));
+  WriteVarUint(diffFileWriter, static_cast<uint64_t>(chunks.size()));
+  if (chunks.empty())
+    return true;
+
+  // Chunks are made concurrently and are written as soon as all the previous ones are written.
+  base::thread_pool::computational::ThreadPool pool(
+      std::min(std::max(threadsCount, size_t(1)), chunks.size()));
+  std::vector<std::future<bool>> results;
+  results.reserve(chunks.size());
+  for (auto & chunk : chunks)
+  {
+    results.emplace_back(pool.Submit([&oldMwmPath, &newMwmPath, &chunk]() {
+      return MakeChunkPayload(oldMwmPath, newMwmPath, chunk);
+    }));
+  }
+
+  for (size_t i = 0; i < chunks.size(); ++i)
+  {
+    if (!results[i].get())
+    {
+      pool.Stop();
+      return false;
+    }
+
+    auto & chunk = chunks[i];
+    WriteToSink(diffFileWriter, static_cast<uint8_t>(chunk.m_type));
+    WriteVarUint(diffFileWriter, chunk.m_oldOffset);
+    WriteVarUint(diffFileWriter, chunk.m_oldSize);
+    WriteVarUint(diffFileWriter, chunk.m_newSize);
+    WriteVarUint(diffFileWriter, static_cast<uint64_t>(chunk.m_payload.size()));
+    diffFileWriter.Write(chunk.m_payload.data(), chunk.m_payload.size());
+    chunk.m_payload = {};
+  }
+
+  return true;
+}
+
 bool MakeDiffVersion0(FileReader & oldReader, FileReader & newReader, FileWriter & diffFileWriter)
 {
   std::vector<uint8_t> diffBuf;
@@ -91,13 +340,124 @@ generator::mwm_diff::DiffApplicationResult ApplyDiffVersion0(
   LOG(LERROR, ("Could not apply patch with bsdiff:", status));
   return DiffApplicationResult::Failed;
 }
+
+// Applies chunks one by one, so only one section of the old mwm and one chunk of the diff
+// are held in memory.
+generator::mwm_diff::DiffApplicationResult ApplyDiffVersion1(
+    FileReader & oldReader, FileWriter & newWriter, ReaderSource<FileReader> & diffFileSource,
+    base::Cancellable const & cancellable)
+{
+  using generator::mwm_diff::DiffApplicationResult;
+
+  auto const chunksCount = ReadVarUint<uint64_t>(diffFileSource);
+  auto const oldSize = oldReader.Size();
+
+  std::vector<uint8_t> deflated;
+  std::vector<uint8_t> payload;
+  for (uint64_t i = 0; i < chunksCount; ++i)
+  {
+    if (cancellable.IsCancelled())
+      return DiffApplicationResult::Cancelled;
+
+    auto const type = static_cast<ChunkType>(ReadPrimitiveFromSource<uint8_t>(diffFileSource));
+    auto const oldOffset = ReadVarUint<uint64_t>(diffFileSource);
+    auto const oldChunkSize = ReadVarUint<uint64_t>(diffFileSource);
+    auto const newChunkSize = ReadVarUint<uint64_t>(diffFileSource);
+    auto const payloadSize = ReadVarUint<uint64_t>(diffFileSource);
+    if (oldOffset > oldSize || oldChunkSize > oldSize - oldOffset ||
+        payloadSize > diffFileSource.Size())
+    {
+      LOG(LERROR, ("Wrong chunk", i, "of mwm diff."));
+      return DiffApplicationResult::Failed;
+    }
+
+    deflated.resize(base::checked_cast<size_t>(payloadSize));
+    diffFileSource.Read(deflated.data(), deflated.size());
+
+    payload.clear();
+    if (type != ChunkType::Copy)
+    {
+      using Inflate = coding::ZLib::Inflate;
+      Inflate inflate(Inflate::Format::ZLib);
+      // Neither a patch nor raw bytes are larger than the chunk, see MakeChunkPayload.
+      auto const maxPayloadSize =
+          static_cast<size_t>(std::min<uint64_t>(newChunkSize, std::numeric_limits<size_t>::max()));
+      if (!inflate(deflated.data(), deflated.size(), maxPayloadSize, back_inserter(payload)))
+      {
+        LOG(LERROR, ("Could not inflate chunk", i, "of mwm diff or it's larger than the chunk."));
+        return DiffApplicationResult::Failed;
+      }
+    }
+
+    auto const chunkBegin = newWriter.Pos();
+    switch (type)
+    {
+    case ChunkType::Copy:
+    {
+      if (oldChunkSize != newChunkSize)
+        return DiffApplicationResult::Failed;
+
+      payload.resize(kCopyBufferSize);
+      for (uint64_t pos = 0; pos < oldChunkSize; pos += payload.size())
+      {
+        if (cancellable.IsCancelled())
+          return DiffApplicationResult::Cancelled;
+
+        auto const size = static_cast<size_t>(std::min<uint64_t>(payload.size(), oldChunkSize - pos));
+        oldReader.Read(oldOffset + pos, payload.data(), size);
+        newWriter.Write(payload.data(), size);
+      }
+      break;
+    }
+    case ChunkType::Patch:
+    {
+      auto oldSection = oldReader.SubReader(oldOffset, oldChunkSize);
+      // See the comment in ApplyDiffVersion0.
+      MemReaderWithExceptions diffMemReader(payload.data(), payload.size());
+
+      auto const status = bsdiff::ApplyBinaryPatch(oldSection, newWriter, diffMemReader, cancellable);
+      if (status == bsdiff::BSDiffStatus::CANCELLED)
+      {
+        LOG(LDEBUG, ("Diff application has been cancelled"));
+        return DiffApplicationResult::Cancelled;
+      }
+
+      if (status != bsdiff::BSDiffStatus::OK)
+      {
+        LOG(LERROR, ("Could not apply patch with bsdiff:", status));
+        return DiffApplicationResult::Failed;
+      }
+      break;
+    }
+    case ChunkType::Raw: newWriter.Write(payload.data(), payload.size()); break;
+    default:
+      LOG(LERROR, ("Unknown type of chunk", i, "of mwm diff."));
+      return DiffApplicationResult::Failed;
+    }
+
+    if (newWriter.Pos() - chunkBegin != newChunkSize)
+    {
+      LOG(LERROR, ("Wrong size of chunk", i, "of mwm diff."));
+      return DiffApplicationResult::Failed;
+    }
+  }
+
+  if (diffFileSource.Size() != 0)
+  {
+    LOG(LERROR, ("Unexpected data at the end of mwm diff."));
+    return DiffApplicationResult::Failed;
+  }
+
+  return DiffApplicationResult::Ok;
+}
 }  // namespace
 
 namespace generator
 {
 namespace mwm_diff
 {
-bool MakeDiff(std::string const & oldMwmPath, std::string const & newMwmPath, std::string const & diffPath)
+bool MakeDiff(std::string const & oldMwmPath, std::string const & newMwmPath,
+              std::string const & diffPath, DiffFormat format, size_t threadsCount)
 {
   try
   {
@@ -105,12 +465,11 @@ bool MakeDiff(std::string const & oldMwmPath, std::string const & newMwmPath, st
     FileReader newReader(newMwmPath);
     FileWriter diffFileWriter(diffPath);
 
-    switch (VERSION_LATEST)
+    switch (format)
     {
-    case VERSION_V0: return MakeDiffVersion0(oldReader, newReader, diffFileWriter);
-    default:
-      LOG(LERROR,
-          ("Making mwm diffs with diff format version", VERSION_LATEST, "is not implemented"));
+    case DiffFormat::V0: return MakeDiffVersion0(oldReader, newReader, diffFileWriter);
+    case DiffFormat::V1:
+      return MakeDiffVersion1(oldMwmPath, newMwmPath, diffFileWriter, threadsCount);
     }
   }
   catch (Reader::Exception const & e)
@@ -143,6 +502,8 @@ DiffApplicationResult ApplyDiff(std::string const & oldMwmPath, std::string cons
     {
     case VERSION_V0:
       return ApplyDiffVersion0(oldReader, newWriter, diffFileSource, cancellable);
+    case VERSION_V1:
+      return ApplyDiffVersion1(oldReader, newWriter, diffFileSource, cancellable);
     default:
       LOG(LERROR, ("Unknown version format of mwm diff:", version));
       return DiffApplicationResult::Failed;
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <cstddef>
 #include <string>
 
 namespace base
@@ -18,17 +19,29 @@ enum class DiffApplicationResult
   Cancelled,
 };
 
+enum class DiffFormat
+{
+  // bsdiff+gzip of the whole mwm. All the released clients apply it.
+  V0,
+  // Sections of the new mwm are diffed with the same sections of the old mwm.
+  // The clients released before it can't apply it.
+  V1,
+};
+
 // Makes a diff that, when applied to the mwm at |oldMwmPath|, will
 // result in the mwm at |newMwmPath|. The diff is stored at |diffPath|.
 // It is assumed that the files at |oldMwmPath| and |newMwmPath| are valid mwms.
+// DiffFormat::V1 diffs are made using up to |threadsCount| threads.
 // Returns true on success and false on failure.
 bool MakeDiff(std::string const & oldMwmPath, std::string const & newMwmPath,
-              std::string const & diffPath);
+              std::string const & diffPath, DiffFormat format = DiffFormat::V0,
+              size_t threadsCount = 1);
 
 // Applies the diff at |diffPath| to the mwm at |oldMwmPath|. The resulting
 // mwm is stored at |newMwmPath|.
 // It is assumed that the file at |oldMwmPath| is a valid mwm and the file
-// at |diffPath| is a valid mwmdiff.
+// at |diffPath| is a valid mwmdiff. Diffs are applied section by section, so
+// only one section of the old mwm is held in memory.
 // The application process can be stopped via |cancellable| in which case
 // it is up to the caller to clean the partially written file at |diffPath|.
 DiffApplicationResult ApplyDiff(std::string const & oldMwmPath, std::string const & newMwmPath,
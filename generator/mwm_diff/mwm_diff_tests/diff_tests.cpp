@@ -5,12 +5,19 @@
 #include "platform/platform.hpp"
 
 #include "coding/file_writer.hpp"
+#include "coding/files_container.hpp"
 #include "coding/internal/file_data.hpp"
+#include "coding/varint.hpp"
+#include "coding/write_to_sink.hpp"
+#include "coding/zlib.hpp"
 
 #include "base/file_name_utils.hpp"
 #include "base/logging.hpp"
 #include "base/scope_guard.hpp"
 
+#include <cstdint>
+#include <iterator>
+#include <string>
 #include <vector>
 
 namespace generator::diff_tests
@@ -60,6 +67,9 @@ UNIT_TEST(IncrementalUpdates_Smoke)
 
   TEST(base::IsEqualFiles(newMwmPath1, newMwmPath2), ());
 
+  // Diffs are made in the format of version 0 by default, the released clients apply only it.
+  TEST_EQUAL(base::ReadFile(diffPath).at(0), 0, ());
+
   cancellable.Cancel();
   TEST_EQUAL(ApplyDiff(oldMwmPath, newMwmPath2, diffPath, cancellable),
              DiffApplicationResult::Cancelled, ());
@@ -88,4 +98,100 @@ UNIT_TEST(IncrementalUpdates_Smoke)
   TEST_EQUAL(ApplyDiff(oldMwmPath, newMwmPath2, diffPath, cancellable),
              DiffApplicationResult::Failed, ());
 }
+
+UNIT_TEST(IncrementalUpdates_Sections)
+{
+  base::ScopedLogAbortLevelChanger ignoreLogError(base::LogLevel::LCRITICAL);
+
+  string const oldMwmPath = base::JoinPath(GetPlatform().WritableDir(), "minsk-pass.mwm");
+  string const newMwmPath1 = base::JoinPath(GetPlatform().WritableDir(), "minsk-pass-new1.mwm");
+  string const newMwmPath2 = base::JoinPath(GetPlatform().WritableDir(), "minsk-pass-new2.mwm");
+  string const diffPath1 = base::JoinPath(GetPlatform().WritableDir(), "minsk-pass1.mwmdiff");
+  string const diffPath2 = base::JoinPath(GetPlatform().WritableDir(), "minsk-pass2.mwmdiff");
+
+  SCOPE_GUARD(cleanup, [&] {
+    FileWriter::DeleteFileX(newMwmPath1);
+    FileWriter::DeleteFileX(newMwmPath2);
+    FileWriter::DeleteFileX(diffPath1);
+    FileWriter::DeleteFileX(diffPath2);
+  });
+
+  {
+    // Remove a section, shift the rest ones and add a new section.
+    TEST(base::CopyFileX(oldMwmPath, newMwmPath1), ());
+    string firstTag;
+    FilesContainerR(oldMwmPath).ForEachTag([&firstTag](string const & tag) {
+      if (firstTag.empty())
+        firstTag = tag;
+    });
+
+    FilesContainerW container(newMwmPath1, FileWriter::OP_WRITE_EXISTING);
+    container.DeleteSection(firstTag);
+    vector<uint8_t> const section(1000, 42);
+    container.Write(section, "new_section");
+  }
+
+  base::Cancellable cancellable;
+  TEST(MakeDiff(oldMwmPath, newMwmPath1, diffPath1, DiffFormat::V1, 4 /* threadsCount */), ());
+  TEST(MakeDiff(oldMwmPath, newMwmPath1, diffPath2, DiffFormat::V1, 1 /* threadsCount */), ());
+  TEST(base::IsEqualFiles(diffPath1, diffPath2), ());
+  TEST_EQUAL(base::ReadFile(diffPath1).at(0), 1, ());
+  TEST_LESS(base::ReadFile(diffPath1).size(), base::ReadFile(newMwmPath1).size() / 10, ());
+
+  TEST_EQUAL(ApplyDiff(oldMwmPath, newMwmPath2, diffPath1, cancellable), DiffApplicationResult::Ok,
+             ());
+  TEST(base::IsEqualFiles(newMwmPath1, newMwmPath2), ());
+
+  // Diffs are made for any files, not only for mwms.
+  {
+    FileWriter writer(newMwmPath1);
+    writer.Write("abcdefgh", 8);
+  }
+  TEST(MakeDiff(oldMwmPath, newMwmPath1, diffPath1, DiffFormat::V1, 4 /* threadsCount */), ());
+  TEST_EQUAL(ApplyDiff(oldMwmPath, newMwmPath2, diffPath1, cancellable), DiffApplicationResult::Ok,
+             ());
+  TEST(base::IsEqualFiles(newMwmPath1, newMwmPath2), ());
+}
+
+UNIT_TEST(IncrementalUpdates_ChunkLargerThanDeclared)
+{
+  base::ScopedLogAbortLevelChanger ignoreLogError(base::LogLevel::LCRITICAL);
+
+  string const oldMwmPath = base::JoinPath(GetPlatform().WritableDir(), "minsk-pass.mwm");
+  string const newMwmPath = base::JoinPath(GetPlatform().WritableDir(), "minsk-pass-new.mwm");
+  string const diffPath = base::JoinPath(GetPlatform().WritableDir(), "minsk-pass.mwmdiff");
+
+  SCOPE_GUARD(cleanup, [&] {
+    FileWriter::DeleteFileX(newMwmPath);
+    FileWriter::DeleteFileX(diffPath);
+  });
+
+  // A diff of version 1 with a raw chunk of 8 bytes which is inflated to 1 MB.
+  {
+    vector<uint8_t> const bytes(1024 * 1024, 42);
+    vector<uint8_t> payload;
+    using Deflate = coding::ZLib::Deflate;
+    Deflate deflate(Deflate::Format::ZLib, Deflate::Level::BestCompression);
+    TEST(deflate(bytes.data(), bytes.size(), back_inserter(payload)), ());
+
+    FileWriter writer(diffPath);
+    WriteToSink(writer, static_cast<uint32_t>(1) /* version */);
+    WriteVarUint(writer, static_cast<uint64_t>(1) /* chunks count */);
+    WriteToSink(writer, static_cast<uint8_t>(2) /* raw chunk */);
+    WriteVarUint(writer, static_cast<uint64_t>(0) /* old offset */);
+    WriteVarUint(writer, static_cast<uint64_t>(0) /* old size */);
+    WriteVarUint(writer, static_cast<uint64_t>(8) /* new size */);
+    WriteVarUint(writer, static_cast<uint64_t>(payload.size()));
+    writer.Write(payload.data(), payload.size());
+  }
+
+  base::Cancellable cancellable;
+  TEST_EQUAL(ApplyDiff(oldMwmPath, newMwmPath, diffPath, cancellable),
+             DiffApplicationResult::Failed, ());
+
+  // The chunk is rejected while it's inflated, before any of its bytes are written.
+  uint64_t newMwmSize = 0;
+  TEST(base::GetFileSize(newMwmPath, newMwmSize), ());
+  TEST_EQUAL(newMwmSize, 0, ());
+}
 }  // namespace generator::diff_tests
@@ -2,17 +2,21 @@
 
 #include "base/cancellable.hpp"
 
-#include <iostream>
+#include <algorithm>
 #include <cstring>
+#include <iostream>
+#include <thread>
 
 int main(int argc, char ** argv)
 {
   if (argc < 5)
   {
     std::cout <<
-        "Usage: " << argv[0] << " make|apply olderMWMDir newerMWMDir diffDir\n"
+        "Usage: " << argv[0] << " make|apply olderMWMDir newerMWMDir diffDir [--v1]\n"
         "make\n"
         "  Creates the diff between newer and older MWM versions at `diffDir`\n"
+        "  --v1 makes the diff section by section in parallel. Such diffs are applied only by\n"
+        "  the clients which support diff format version 1.\n"
         "apply\n"
         "  Applies the diff at `diffDir` to the mwm at `olderMWMDir` and stores result at `newerMWMDir`.\n"
         "WARNING: THERE IS NO MWM VALIDITY CHECK!\n";
@@ -20,7 +24,13 @@ int main(int argc, char ** argv)
   }
   char const * olderMWMDir{argv[2]}, * newerMWMDir{argv[3]}, * diffDir{argv[4]};
   if (0 == std::strcmp(argv[1], "make"))
-    return generator::mwm_diff::MakeDiff(olderMWMDir, newerMWMDir, diffDir);
+  {
+    using generator::mwm_diff::DiffFormat;
+    bool const v1 = argc > 5 && 0 == std::strcmp(argv[5], "--v1");
+    auto const threadsCount = std::max(std::thread::hardware_concurrency(), 1U);
+    return generator::mwm_diff::MakeDiff(olderMWMDir, newerMWMDir, diffDir,
+                                         v1 ? DiffFormat::V1 : DiffFormat::V0, threadsCount);
+  }
 
   // apply
   base::Cancellable cancellable;
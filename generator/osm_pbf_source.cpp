@@ -0,0 +1,503 @@
+#include "generator/osm_pbf_source.hpp"
+
+#include "coding/zlib.hpp"
+
+#include "base/assert.hpp"
+
+#include <iterator>
+#include <optional>
+#include <utility>
+
+namespace osm
+{
+namespace
+{
+// Limits from the format definition.
+uint32_t constexpr kMaxBlobHeaderSize = 64 * 1024;
+uint32_t constexpr kMaxBlobSize = 32 * 1024 * 1024;
+
+// Blob header fields.
+uint32_t constexpr kBlobHeaderType = 1;
+uint32_t constexpr kBlobHeaderDataSize = 3;
+// Blob fields.
+uint32_t constexpr kBlobRaw = 1;
+uint32_t constexpr kBlobRawSize = 2;
+uint32_t constexpr kBlobZlibData = 3;
+// HeaderBlock fields.
+uint32_t constexpr kHeaderRequiredFeatures = 4;
+// PrimitiveBlock fields.
+uint32_t constexpr kBlockStringTable = 1;
+uint32_t constexpr kBlockPrimitiveGroup = 2;
+uint32_t constexpr kBlockGranularity = 17;
+uint32_t constexpr kBlockLatOffset = 19;
+uint32_t constexpr kBlockLonOffset = 20;
+uint32_t constexpr kStringTableString = 1;
+// PrimitiveGroup fields.
+uint32_t constexpr kGroupNodes = 1;
+uint32_t constexpr kGroupDenseNodes = 2;
+uint32_t constexpr kGroupWays = 3;
+uint32_t constexpr kGroupRelations = 4;
+// Node, Way, Relation and DenseNodes fields.
+uint32_t constexpr kId = 1;
+uint32_t constexpr kKeys = 2;
+uint32_t constexpr kVals = 3;
+uint32_t constexpr kLat = 8;
+uint32_t constexpr kLon = 9;
+uint32_t constexpr kWayRefs = 8;
+uint32_t constexpr kRelationRoles = 8;
+uint32_t constexpr kRelationMemberIds = 9;
+uint32_t constexpr kRelationMemberTypes = 10;
+uint32_t constexpr kDenseKeysVals = 10;
+
+int64_t DecodeZigZag(uint64_t value)
+{
+  return static_cast<int64_t>(value >> 1) ^ -static_cast<int64_t>(value & 1);
+}
+
+// Reader of the protocol buffers wire format, see
+// https://developers.google.com/protocol-buffers/docs/encoding
+class ProtobufReader
+{
+public:
+  enum WireType : uint8_t
+  {
+    Varint = 0,
+    Fixed64 = 1,
+    LengthDelimited = 2,
+    Fixed32 = 5
+  };
+
+  explicit ProtobufReader(std::string_view data)
+    : m_data(reinterpret_cast<uint8_t const *>(data.data())), m_end(m_data + data.size())
+  {
+  }
+
+  // Moves to the next field. Returns false when the message is over.
+  bool Next()
+  {
+    if (m_data == m_end)
+      return false;
+
+    auto const key = ReadVarint();
+    m_tag = static_cast<uint32_t>(key >> 3);
+    m_wireType = static_cast<uint8_t>(key & 0x7);
+    return true;
+  }
+
+  uint32_t GetTag() const { return m_tag; }
+
+  uint64_t ReadVarint()
+  {
+    uint64_t result = 0;
+    for (uint8_t shift = 0;; shift += 7)
+    {
+      CHECK(m_data != m_end && shift < 64, ("Corrupted protobuf varint."));
+      uint8_t const b = *m_data++;
+      result |= static_cast<uint64_t>(b & 0x7f) << shift;
+      if ((b & 0x80) == 0)
+        return result;
+    }
+  }
+
+  int64_t ReadSVarint() { return DecodeZigZag(ReadVarint()); }
+
+  std::string_view ReadBytes()
+  {
+    CHECK_EQUAL(m_wireType, LengthDelimited, (m_tag));
+    auto const size = ReadVarint();
+    CHECK_LESS_OR_EQUAL(size, static_cast<uint64_t>(m_end - m_data), ("Corrupted protobuf field."));
+    std::string_view const bytes(reinterpret_cast<char const *>(m_data), size);
+    m_data += size;
+    return bytes;
+  }
+
+  // Calls |fn| for every value of a repeated varint field, either packed or not.
+  template <typename Fn>
+  void ForEachVarint(Fn && fn)
+  {
+    if (m_wireType != LengthDelimited)
+    {
+      fn(ReadVarint());
+      return;
+    }
+
+    ProtobufReader packed(ReadBytes());
+    while (packed.m_data != packed.m_end)
+      fn(packed.ReadVarint());
+  }
+
+  void Skip()
+  {
+    switch (m_wireType)
+    {
+    case Varint: ReadVarint(); break;
+    case Fixed64: Advance(8); break;
+    case LengthDelimited: ReadBytes(); break;
+    case Fixed32: Advance(4); break;
+    default: CHECK(false, ("Unsupported protobuf wire type:", m_wireType));
+    }
+  }
+
+private:
+  void Advance(size_t size)
+  {
+    CHECK_LESS_OR_EQUAL(size, static_cast<size_t>(m_end - m_data), ("Corrupted protobuf field."));
+    m_data += size;
+  }
+
+  uint8_t const * m_data;
+  uint8_t const * m_end;
+  uint32_t m_tag = 0;
+  uint8_t m_wireType = Varint;
+};
+
+// Returns the uncompressed content of a blob. |buffer| is used as a storage if the blob is
+// compressed.
+std::string_view UnpackBlob(std::vector<uint8_t> const & blob, std::string & buffer)
+{
+  std::string_view zlibData;
+  std::optional<uint64_t> rawSize;
+  ProtobufReader reader(
+      std::string_view(reinterpret_cast<char const *>(blob.data()), blob.size()));
+  while (reader.Next())
+  {
+    switch (reader.GetTag())
+    {
+    case kBlobRaw: return reader.ReadBytes();
+    case kBlobRawSize: rawSize = reader.ReadVarint(); break;
+    case kBlobZlibData: zlibData = reader.ReadBytes(); break;
+    default: reader.Skip(); break;
+    }
+  }
+
+  CHECK(!zlibData.empty(), ("Unsupported PBF blob compression."));
+
+  // |raw_size| is optional, so it's only a hint and the inflated size is limited anyway.
+  buffer.clear();
+  if (rawSize)
+  {
+    CHECK_LESS_OR_EQUAL(*rawSize, kMaxBlobSize, ());
+    buffer.reserve(static_cast<size_t>(*rawSize));
+  }
+  coding::ZLib::Inflate const inflate(coding::ZLib::Inflate::Format::ZLib);
+  CHECK(inflate(zlibData.data(), zlibData.size(), kMaxBlobSize, std::back_inserter(buffer)),
+        ("Can't inflate PBF blob."));
+  if (rawSize)
+    CHECK_EQUAL(buffer.size(), *rawSize, ());
+  return buffer;
+}
+
+void CheckHeaderBlock(std::string_view data)
+{
+  ProtobufReader reader(data);
+  while (reader.Next())
+  {
+    if (reader.GetTag() != kHeaderRequiredFeatures)
+    {
+      reader.Skip();
+      continue;
+    }
+
+    auto const feature = reader.ReadBytes();
+    CHECK(feature == "OsmSchema-V0.6" || feature == "DenseNodes",
+          ("Unsupported PBF feature:", std::string(feature)));
+  }
+}
+
+class PrimitiveBlockDecoder
+{
+public:
+  using Entity = PBFSource::Entity;
+  using EntityType = PBFSource::EntityType;
+
+  explicit PrimitiveBlockDecoder(std::function<void(Entity const &)> const & fn) : m_fn(fn) {}
+
+  void Decode(std::string_view data)
+  {
+    // Granularity and offsets may follow the groups, so groups are decoded after the whole block
+    // is read.
+    std::vector<std::string_view> groups;
+    ProtobufReader reader(data);
+    while (reader.Next())
+    {
+      switch (reader.GetTag())
+      {
+      case kBlockStringTable:
+      {
+        ProtobufReader table(reader.ReadBytes());
+        while (table.Next())
+        {
+          if (table.GetTag() == kStringTableString)
+            m_strings.emplace_back(table.ReadBytes());
+          else
+            table.Skip();
+        }
+        break;
+      }
+      case kBlockPrimitiveGroup: groups.emplace_back(reader.ReadBytes()); break;
+      case kBlockGranularity: m_granularity = static_cast<int64_t>(reader.ReadVarint()); break;
+      case kBlockLatOffset: m_latOffset = static_cast<int64_t>(reader.ReadVarint()); break;
+      case kBlockLonOffset: m_lonOffset = static_cast<int64_t>(reader.ReadVarint()); break;
+      default: reader.Skip(); break;
+      }
+    }
+
+    for (auto const & group : groups)
+      DecodeGroup(group);
+  }
+
+private:
+  void DecodeGroup(std::string_view data)
+  {
+    ProtobufReader reader(data);
+    while (reader.Next())
+    {
+      switch (reader.GetTag())
+      {
+      case kGroupNodes: DecodeNode(reader.ReadBytes()); break;
+      case kGroupDenseNodes: DecodeDenseNodes(reader.ReadBytes()); break;
+      case kGroupWays: DecodeWay(reader.ReadBytes()); break;
+      case kGroupRelations: DecodeRelation(reader.ReadBytes()); break;
+      default: reader.Skip(); break;
+      }
+    }
+  }
+
+  void DecodeNode(std::string_view data)
+  {
+    m_entity.Clear();
+    m_entity.m_type = EntityType::Node;
+    ProtobufReader reader(data);
+    while (reader.Next())
+    {
+      switch (reader.GetTag())
+      {
+      case kId: m_entity.m_id = reader.ReadSVarint(); break;
+      case kKeys: reader.ForEachVarint([&](uint64_t v) { m_keys.emplace_back(v); }); break;
+      case kVals: reader.ForEachVarint([&](uint64_t v) { m_vals.emplace_back(v); }); break;
+      case kLat: m_entity.m_lat = ToDegrees(m_latOffset, reader.ReadSVarint()); break;
+      case kLon: m_entity.m_lon = ToDegrees(m_lonOffset, reader.ReadSVarint()); break;
+      default: reader.Skip(); break;
+      }
+    }
+    FlushTags();
+    m_fn(m_entity);
+  }
+
+  void DecodeDenseNodes(std::string_view data)
+  {
+    std::vector<int64_t> ids;
+    std::vector<int64_t> lats;
+    std::vector<int64_t> lons;
+    std::vector<uint64_t> keysVals;
+    ProtobufReader reader(data);
+    while (reader.Next())
+    {
+      switch (reader.GetTag())
+      {
+      case kId: reader.ForEachVarint([&](uint64_t v) { ids.emplace_back(DecodeZigZag(v)); }); break;
+      case kLat: reader.ForEachVarint([&](uint64_t v) { lats.emplace_back(DecodeZigZag(v)); }); break;
+      case kLon: reader.ForEachVarint([&](uint64_t v) { lons.emplace_back(DecodeZigZag(v)); }); break;
+      case kDenseKeysVals: reader.ForEachVarint([&](uint64_t v) { keysVals.emplace_back(v); }); break;
+      default: reader.Skip(); break;
+      }
+    }
+
+    CHECK_EQUAL(ids.size(), lats.size(), ());
+    CHECK_EQUAL(ids.size(), lons.size(), ());
+
+    int64_t id = 0;
+    int64_t lat = 0;
+    int64_t lon = 0;
+    size_t kvIdx = 0;
+    for (size_t i = 0; i < ids.size(); ++i)
+    {
+      m_entity.Clear();
+      m_entity.m_type = EntityType::Node;
+      m_entity.m_id = (id += ids[i]);
+      m_entity.m_lat = ToDegrees(m_latOffset, lat += lats[i]);
+      m_entity.m_lon = ToDegrees(m_lonOffset, lon += lons[i]);
+
+      // Tags of all nodes are packed into one array, each node's part is terminated by zero.
+      while (kvIdx < keysVals.size() && keysVals[kvIdx] != 0)
+      {
+        CHECK_LESS(kvIdx + 1, keysVals.size(), ());
+        m_entity.m_tags.emplace_back(GetString(keysVals[kvIdx]), GetString(keysVals[kvIdx + 1]));
+        kvIdx += 2;
+      }
+      ++kvIdx;
+
+      m_fn(m_entity);
+    }
+  }
+
+  void DecodeWay(std::string_view data)
+  {
+    m_entity.Clear();
+    m_entity.m_type = EntityType::Way;
+    int64_t ref = 0;
+    ProtobufReader reader(data);
+    while (reader.Next())
+    {
+      switch (reader.GetTag())
+      {
+      case kId: m_entity.m_id = static_cast<int64_t>(reader.ReadVarint()); break;
+      case kKeys: reader.ForEachVarint([&](uint64_t v) { m_keys.emplace_back(v); }); break;
+      case kVals: reader.ForEachVarint([&](uint64_t v) { m_vals.emplace_back(v); }); break;
+      case kWayRefs:
+        reader.ForEachVarint([&](uint64_t v) { m_entity.m_nodes.emplace_back(ref += DecodeZigZag(v)); });
+        break;
+      default: reader.Skip(); break;
+      }
+    }
+    FlushTags();
+    m_fn(m_entity);
+  }
+
+  void DecodeRelation(std::string_view data)
+  {
+    m_entity.Clear();
+    m_entity.m_type = EntityType::Relation;
+    std::vector<uint64_t> roles;
+    std::vector<int64_t> ids;
+    std::vector<uint64_t> types;
+    int64_t ref = 0;
+    ProtobufReader reader(data);
+    while (reader.Next())
+    {
+      switch (reader.GetTag())
+      {
+      case kId: m_entity.m_id = static_cast<int64_t>(reader.ReadVarint()); break;
+      case kKeys: reader.ForEachVarint([&](uint64_t v) { m_keys.emplace_back(v); }); break;
+      case kVals: reader.ForEachVarint([&](uint64_t v) { m_vals.emplace_back(v); }); break;
+      case kRelationRoles: reader.ForEachVarint([&](uint64_t v) { roles.emplace_back(v); }); break;
+      case kRelationMemberIds:
+        reader.ForEachVarint([&](uint64_t v) { ids.emplace_back(ref += DecodeZigZag(v)); });
+        break;
+      case kRelationMemberTypes: reader.ForEachVarint([&](uint64_t v) { types.emplace_back(v); }); break;
+      default: reader.Skip(); break;
+      }
+    }
+
+    CHECK_EQUAL(ids.size(), roles.size(), ());
+    CHECK_EQUAL(ids.size(), types.size(), ());
+    for (size_t i = 0; i < ids.size(); ++i)
+    {
+      CHECK_LESS_OR_EQUAL(types[i], static_cast<uint64_t>(EntityType::Relation), ());
+      m_entity.m_members.push_back({ids[i], static_cast<EntityType>(types[i]), GetString(roles[i])});
+    }
+    FlushTags();
+    m_fn(m_entity);
+  }
+
+  void FlushTags()
+  {
+    CHECK_EQUAL(m_keys.size(), m_vals.size(), ());
+    for (size_t i = 0; i < m_keys.size(); ++i)
+      m_entity.m_tags.emplace_back(GetString(m_keys[i]), GetString(m_vals[i]));
+    m_keys.clear();
+    m_vals.clear();
+  }
+
+  std::string_view GetString(uint64_t index) const
+  {
+    CHECK_LESS(index, m_strings.size(), ("Corrupted PBF string table index."));
+    return m_strings[index];
+  }
+
+  double ToDegrees(int64_t offset, int64_t value) const
+  {
+    return static_cast<double>(offset + m_granularity * value) / 1e9;
+  }
+
+  std::function<void(Entity const &)> const & m_fn;
+  std::vector<std::string_view> m_strings;
+  int64_t m_granularity = 100;
+  int64_t m_latOffset = 0;
+  int64_t m_lonOffset = 0;
+  Entity m_entity;
+  std::vector<uint64_t> m_keys;
+  std::vector<uint64_t> m_vals;
+};
+}  // namespace
+
+void PBFSource::Entity::Clear()
+{
+  m_id = 0;
+  m_lat = 0.0;
+  m_lon = 0.0;
+  m_nodes.clear();
+  m_members.clear();
+  m_tags.clear();
+}
+
+PBFSource::PBFSource(ReadFunc reader) : m_reader(std::move(reader)) {}
+
+bool PBFSource::ReadExactly(uint8_t * buffer, size_t size)
+{
+  while (size != 0)
+  {
+    auto const readBytes = m_reader(buffer, size);
+    if (readBytes == 0)
+      return false;
+    buffer += readBytes;
+    size -= readBytes;
+  }
+  return true;
+}
+
+bool PBFSource::ReadBlob(std::vector<uint8_t> & blob)
+{
+  while (true)
+  {
+    uint8_t sizeBuffer[4];
+    if (m_reader(sizeBuffer, 1) == 0)
+      return false;
+    CHECK(ReadExactly(sizeBuffer + 1, 3), ("Unexpected end of PBF input."));
+
+    // The size of a blob header is stored in network byte order.
+    uint32_t const headerSize = (uint32_t(sizeBuffer[0]) << 24) | (uint32_t(sizeBuffer[1]) << 16) |
+                                (uint32_t(sizeBuffer[2]) << 8) | uint32_t(sizeBuffer[3]);
+    CHECK_LESS_OR_EQUAL(headerSize, kMaxBlobHeaderSize, ());
+
+    std::vector<uint8_t> header(headerSize);
+    CHECK(ReadExactly(header.data(), header.size()), ("Unexpected end of PBF input."));
+
+    std::string_view type;
+    uint64_t dataSize = 0;
+    ProtobufReader reader(std::string_view(reinterpret_cast<char const *>(header.data()), header.size()));
+    while (reader.Next())
+    {
+      switch (reader.GetTag())
+      {
+      case kBlobHeaderType: type = reader.ReadBytes(); break;
+      case kBlobHeaderDataSize: dataSize = reader.ReadVarint(); break;
+      default: reader.Skip(); break;
+      }
+    }
+    CHECK_LESS_OR_EQUAL(dataSize, kMaxBlobSize, ());
+
+    blob.resize(static_cast<size_t>(dataSize));
+    CHECK(ReadExactly(blob.data(), blob.size()), ("Unexpected end of PBF input."));
+
+    if (type == "OSMData")
+      return true;
+
+    if (type == "OSMHeader")
+    {
+      std::string buffer;
+      CheckHeaderBlock(UnpackBlob(blob, buffer));
+    }
+    // Blobs of unknown types must be skipped.
+  }
+}
+
+// static
+void PBFSource::DecodeBlob(std::vector<uint8_t> const & blob,
+                           std::function<void(Entity const &)> const & fn)
+{
+  std::string buffer;
+  PrimitiveBlockDecoder decoder(fn);
+  decoder.Decode(UnpackBlob(blob, buffer));
+}
+}  // namespace osm
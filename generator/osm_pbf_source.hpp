@@ -0,0 +1,66 @@
+// See PBF Format definition at https://wiki.openstreetmap.org/wiki/PBF_Format
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace osm
+{
+// Reads OSM PBF files. The file is a sequence of blobs, and each OSMData blob is compressed and
+// decoded independently of the others. So reading of raw blobs is separated from decoding:
+// ReadBlob() is sequential while DecodeBlob() may be called for different blobs on different
+// threads.
+class PBFSource
+{
+public:
+  using ReadFunc = std::function<size_t(uint8_t *, size_t)>;
+
+  enum class EntityType
+  {
+    Node,
+    Way,
+    Relation
+  };
+
+  struct Member
+  {
+    int64_t m_ref = 0;
+    EntityType m_type = EntityType::Node;
+    std::string_view m_role;
+  };
+
+  // Strings are valid only inside the DecodeBlob() callback.
+  struct Entity
+  {
+    void Clear();
+
+    EntityType m_type = EntityType::Node;
+    int64_t m_id = 0;
+    double m_lat = 0.0;
+    double m_lon = 0.0;
+    std::vector<int64_t> m_nodes;
+    std::vector<Member> m_members;
+    std::vector<std::pair<std::string_view, std::string_view>> m_tags;
+  };
+
+  explicit PBFSource(ReadFunc reader);
+
+  // Reads the next raw OSMData blob. Header blobs are checked and skipped.
+  // Returns false when the input is over.
+  bool ReadBlob(std::vector<uint8_t> & blob);
+
+  // Decompresses and decodes a blob returned by ReadBlob().
+  static void DecodeBlob(std::vector<uint8_t> const & blob,
+                         std::function<void(Entity const &)> const & fn);
+
+private:
+  bool ReadExactly(uint8_t * buffer, size_t size);
+
+  ReadFunc m_reader;
+};
+}  // namespace osm
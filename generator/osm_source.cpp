@@ -10,7 +10,10 @@
 #include "base/assert.hpp"
 #include "base/stl_helpers.hpp"
 
+#include <algorithm>
+#include <cstring>
 #include <fstream>
+#include <iterator>
 #include <memory>
 
 #include "defines.hpp"
@@ -125,19 +128,21 @@ void ProcessOsmElementsFromO5M(SourceReader & stream, std::function<void(OsmElem
 }
 
 ProcessorOsmElementsFromO5M::ProcessorOsmElementsFromO5M(SourceReader & stream)
-  : m_stream(stream)
-  , m_dataset([&](uint8_t * buffer, size_t size) {
-      return m_stream.Read(reinterpret_cast<char *>(buffer), size);
+  : ProcessorOsmElementsFromO5M([&stream](uint8_t * buffer, size_t size) {
+      return stream.Read(reinterpret_cast<char *>(buffer), size);
   })
-  , m_pos(m_dataset.begin())
 {
 }
 
-bool ProcessorOsmElementsFromO5M::TryRead(OsmElement & element)
+ProcessorOsmElementsFromO5M::ProcessorOsmElementsFromO5M(osm::TReadFunc reader)
+  : m_dataset(std::move(reader)), m_pos(m_dataset.begin())
 {
-  if (m_pos == m_dataset.end())
-    return false;
+}
 
+namespace
+{
+void O5MEntityToOsmElement(osm::O5MSource::Entity const & entity, OsmElement & element)
+{
   using Type = osm::O5MSource::EntityType;
   auto const translate = [](Type t) -> OsmElement::EntityType {
     switch (t)
@@ -154,7 +159,6 @@ bool ProcessorOsmElementsFromO5M::TryRead(OsmElement & element)
   // iterating in loop. Furthermore, into Tags() method calls Nodes.Skip() and Members.Skip(),
   // thus first call of Nodes (Members) after Tags() will not return any results.
   // So don not reorder the "for" loops (!).
-  auto const & entity = *m_pos;
   element.m_id = entity.id;
   switch (entity.type)
   {
@@ -186,6 +190,15 @@ bool ProcessorOsmElementsFromO5M::TryRead(OsmElement & element)
     element.AddTag(tag.key, tag.value);
 
   element.Validate();
+}
+}  // namespace
+
+bool ProcessorOsmElementsFromO5M::TryRead(OsmElement & element)
+{
+  if (m_pos == m_dataset.end())
+    return false;
+
+  O5MEntityToOsmElement(*m_pos, element);
   ++m_pos;
   return true;
 }
@@ -222,6 +235,295 @@ bool ProcessorOsmElementsFromXml::TryRead(OsmElement & element)
   return TryReadFromQueue(element);
 }
 
+// O5MBlocksReader ---------------------------------------------------------------------------------
+namespace
+{
+using O5MType = osm::O5MSource::EntityType;
+
+// Reset and header datasets which every decoded block starts with.
+uint8_t const kO5MBlockPrefix[] = {0xff, 0xe0, 0x04, 'o', '5', 'm', '2'};
+size_t constexpr kO5MReadBufferSize = 1 << 20;
+}  // namespace
+
+O5MBlocksReader::O5MBlocksReader(SourceReader & stream, size_t maxBlockSize)
+  : m_stream(stream), m_maxBlockSize(maxBlockSize)
+{
+  uint8_t byte = 0;
+  CHECK(ReadByte(byte) && O5MType(byte) == O5MType::Reset, ("Incorrect o5m start"));
+}
+
+bool O5MBlocksReader::ReadByte(uint8_t & byte)
+{
+  if (m_bufferPos == m_buffer.size())
+  {
+    m_buffer.resize(kO5MReadBufferSize);
+    auto const readBytes = m_stream.Read(reinterpret_cast<char *>(m_buffer.data()), m_buffer.size());
+    m_buffer.resize(static_cast<size_t>(readBytes));
+    m_bufferPos = 0;
+    if (m_buffer.empty())
+      return false;
+  }
+
+  byte = m_buffer[m_bufferPos++];
+  return true;
+}
+
+bool O5MBlocksReader::ReadBytes(size_t size, std::vector<uint8_t> & dest)
+{
+  while (size != 0)
+  {
+    uint8_t byte = 0;
+    if (!ReadByte(byte))
+      return false;
+    dest.push_back(byte);
+    --size;
+
+    auto const count = std::min(size, m_buffer.size() - m_bufferPos);
+    dest.insert(dest.end(), m_buffer.begin() + m_bufferPos, m_buffer.begin() + m_bufferPos + count);
+    m_bufferPos += count;
+    size -= count;
+  }
+  return true;
+}
+
+bool O5MBlocksReader::ReadBlock(std::vector<uint8_t> & block)
+{
+  block.clear();
+  while (!m_isEnd)
+  {
+    uint8_t type = 0;
+    if (!ReadByte(type) || O5MType(type) == O5MType::End)
+    {
+      m_isEnd = true;
+      break;
+    }
+
+    if (O5MType(type) == O5MType::Reset)
+    {
+      if (block.empty())
+        continue;
+      return true;
+    }
+
+    // Datasets 0xf0..0xff have neither length nor payload.
+    if (type >= 0xf0)
+      continue;
+
+    // Length of the dataset.
+    size_t const blockSize = block.size();
+    uint64_t length = 0;
+    uint8_t byte = 0;
+    uint8_t shift = 0;
+    do
+    {
+      CHECK(ReadByte(byte), ("Unexpected end of o5m input."));
+      block.push_back(byte);
+      length |= static_cast<uint64_t>(byte & 0x7f) << shift;
+      shift += 7;
+    } while (byte & 0x80);
+
+    bool const isElement = O5MType(type) == O5MType::Node || O5MType(type) == O5MType::Way ||
+                           O5MType(type) == O5MType::Relation;
+    if (!isElement)
+    {
+      // Header, bounding box, timestamp and other service datasets are not needed for decoding.
+      block.resize(blockSize);
+      std::vector<uint8_t> skipped;
+      CHECK(ReadBytes(static_cast<size_t>(length), skipped), ("Unexpected end of o5m input."));
+      continue;
+    }
+
+    block.insert(block.begin() + blockSize, type);
+    CHECK(ReadBytes(static_cast<size_t>(length), block), ("Unexpected end of o5m input."));
+
+    if (block.size() > m_maxBlockSize)
+    {
+      LOG(LWARNING, ("No o5m reset point in", block.size(),
+                     "bytes, the rest of the input is read sequentially."));
+      m_rest.assign(std::begin(kO5MBlockPrefix), std::end(kO5MBlockPrefix));
+      m_rest.insert(m_rest.end(), block.begin(), block.end());
+      block.clear();
+      m_isSequential = true;
+      m_isEnd = true;
+    }
+  }
+  return !block.empty();
+}
+
+size_t O5MBlocksReader::ReadRest(uint8_t * buffer, size_t size)
+{
+  if (m_restPos != m_rest.size())
+  {
+    size = std::min(size, m_rest.size() - m_restPos);
+    memcpy(buffer, m_rest.data() + m_restPos, size);
+    m_restPos += size;
+    if (m_restPos == m_rest.size())
+    {
+      std::vector<uint8_t>().swap(m_rest);
+      m_restPos = 0;
+    }
+    return size;
+  }
+
+  if (m_bufferPos != m_buffer.size())
+  {
+    size = std::min(size, m_buffer.size() - m_bufferPos);
+    memcpy(buffer, m_buffer.data() + m_bufferPos, size);
+    m_bufferPos += size;
+    return size;
+  }
+
+  return static_cast<size_t>(m_stream.Read(reinterpret_cast<char *>(buffer), size));
+}
+
+std::unique_ptr<ProcessorOsmElementsInterface> O5MBlocksReader::GetRestProcessor()
+{
+  if (!m_isSequential)
+    return nullptr;
+
+  m_isSequential = false;
+  return std::make_unique<ProcessorOsmElementsFromO5M>(
+      [this](uint8_t * buffer, size_t size) { return ReadRest(buffer, size); });
+}
+
+void O5MBlocksReader::DecodeBlock(std::vector<uint8_t> const & block,
+                                  std::vector<OsmElement> & elements) const
+{
+  std::vector<uint8_t> data;
+  data.reserve(std::size(kO5MBlockPrefix) + block.size() + 1);
+  data.insert(data.end(), std::begin(kO5MBlockPrefix), std::end(kO5MBlockPrefix));
+  data.insert(data.end(), block.begin(), block.end());
+  data.push_back(base::Underlying(O5MType::End));
+
+  size_t pos = 0;
+  osm::O5MSource dataset([&data, &pos](uint8_t * buffer, size_t size) {
+    size = std::min(size, data.size() - pos);
+    memcpy(buffer, data.data() + pos, size);
+    pos += size;
+    return size;
+  });
+
+  for (auto const & entity : dataset)
+  {
+    elements.emplace_back();
+    O5MEntityToOsmElement(entity, elements.back());
+  }
+}
+
+// PBFBlocksReader ---------------------------------------------------------------------------------
+PBFBlocksReader::PBFBlocksReader(SourceReader & stream)
+  : m_source([&stream](uint8_t * buffer, size_t size) {
+      return stream.Read(reinterpret_cast<char *>(buffer), size);
+    })
+{
+}
+
+bool PBFBlocksReader::ReadBlock(std::vector<uint8_t> & block) { return m_source.ReadBlob(block); }
+
+void PBFBlocksReader::DecodeBlock(std::vector<uint8_t> const & block,
+                                  std::vector<OsmElement> & elements) const
+{
+  using Type = osm::PBFSource::EntityType;
+  auto const translate = [](Type t) -> OsmElement::EntityType {
+    switch (t)
+    {
+    case Type::Node: return OsmElement::EntityType::Node;
+    case Type::Way: return OsmElement::EntityType::Way;
+    case Type::Relation: return OsmElement::EntityType::Relation;
+    }
+    UNREACHABLE();
+  };
+
+  osm::PBFSource::DecodeBlob(block, [&](osm::PBFSource::Entity const & entity) {
+    auto & element = elements.emplace_back();
+    element.m_id = entity.m_id;
+    element.m_type = translate(entity.m_type);
+    element.m_lat = entity.m_lat;
+    element.m_lon = entity.m_lon;
+    for (auto const nd : entity.m_nodes)
+      element.AddNd(nd);
+    for (auto const & member : entity.m_members)
+      element.AddMember(member.m_ref, translate(member.m_type), std::string(member.m_role));
+    for (auto const & [key, value] : entity.m_tags)
+      element.AddTag(std::string(key), std::string(value));
+
+    element.Validate();
+  });
+}
+
+// ProcessorOsmElementsInBlocks --------------------------------------------------------------------
+ProcessorOsmElementsInBlocks::ProcessorOsmElementsInBlocks(
+    std::unique_ptr<OsmBlocksReaderInterface> blocksReader, size_t threadsCount)
+  : m_blocksReader(std::move(blocksReader))
+  , m_maxPendingBlocks(2 * threadsCount)
+  , m_threadPool(threadsCount)
+{
+  CHECK(m_blocksReader, ());
+}
+
+void ProcessorOsmElementsInBlocks::SubmitBlocks()
+{
+  while (!m_noMoreBlocks && m_pendingBlocks.size() < m_maxPendingBlocks)
+  {
+    std::vector<uint8_t> block;
+    if (!m_blocksReader->ReadBlock(block))
+    {
+      m_noMoreBlocks = true;
+      break;
+    }
+
+    m_pendingBlocks.emplace(m_threadPool.Submit([this, block = std::move(block)]() {
+      std::vector<OsmElement> elements;
+      m_blocksReader->DecodeBlock(block, elements);
+      return elements;
+    }));
+  }
+}
+
+bool ProcessorOsmElementsInBlocks::TryRead(OsmElement & element)
+{
+  if (m_restProcessor)
+    return m_restProcessor->TryRead(element);
+
+  while (m_elementIdx == m_elements.size())
+  {
+    SubmitBlocks();
+    if (m_pendingBlocks.empty())
+    {
+      m_restProcessor = m_blocksReader->GetRestProcessor();
+      return m_restProcessor && m_restProcessor->TryRead(element);
+    }
+
+    m_elements = m_pendingBlocks.front().get();
+    m_pendingBlocks.pop();
+    m_elementIdx = 0;
+  }
+
+  element = std::move(m_elements[m_elementIdx++]);
+  return true;
+}
+
+std::unique_ptr<ProcessorOsmElementsInterface> CreateProcessorOsmElements(
+    SourceReader & stream, feature::GenerateInfo const & info)
+{
+  switch (info.m_osmFileType)
+  {
+  case feature::GenerateInfo::OsmSourceType::O5M:
+    if (info.m_osmReaderThreadsCount > 1)
+    {
+      return std::make_unique<ProcessorOsmElementsInBlocks>(
+          std::make_unique<O5MBlocksReader>(stream), info.m_osmReaderThreadsCount);
+    }
+    return std::make_unique<ProcessorOsmElementsFromO5M>(stream);
+  case feature::GenerateInfo::OsmSourceType::PBF:
+    return std::make_unique<ProcessorOsmElementsInBlocks>(std::make_unique<PBFBlocksReader>(stream),
+                                                          info.m_osmReaderThreadsCount);
+  case feature::GenerateInfo::OsmSourceType::XML:
+    return std::make_unique<ProcessorOsmElementsFromXml>(stream);
+  }
+  UNREACHABLE();
+}
+
 ///////////////////////////////////////////////////////////////////////////////////////////////////
 // Generate functions implementations.
 ///////////////////////////////////////////////////////////////////////////////////////////////////
@@ -236,20 +538,14 @@ bool GenerateIntermediateData(feature::GenerateInfo & info)
 
   LOG(LINFO, ("Data source:", info.m_osmFileName));
 
-  auto const processor = [&](OsmElement && element)
+  auto const sourceProcessor = CreateProcessorOsmElements(reader, info);
+  OsmElement element;
+  while (sourceProcessor->TryRead(element))
   {
     towns.CheckElement(element);
     AddElementToCache(cache, std::move(element));
-  };
-
-  switch (info.m_osmFileType)
-  {
-  case feature::GenerateInfo::OsmSourceType::XML:
-    ProcessOsmElementsFromXML(reader, processor);
-    break;
-  case feature::GenerateInfo::OsmSourceType::O5M:
-    ProcessOsmElementsFromO5M(reader, processor);
-    break;
+    // It is safe to use `element` here as `Clear` will restore the state after the move.
+    element.Clear();
   }
 
   cache.SaveIndex();
@@ -3,17 +3,23 @@
 #include "generator/generate_info.hpp"
 #include "generator/intermediate_data.hpp"
 #include "generator/osm_o5m_source.hpp"
+#include "generator/osm_pbf_source.hpp"
 #include "generator/osm_xml_source.hpp"
 #include "generator/translator_interface.hpp"
 
 #include "coding/parse_xml.hpp"
 
+#include "base/thread_pool_computational.hpp"
+
+#include <cstdint>
 #include <functional>
+#include <future>
 #include <iostream>
 #include <memory>
 #include <queue>
 #include <sstream>
 #include <string>
+#include <vector>
 
 struct OsmElement;
 class FeatureParams;
@@ -62,12 +68,12 @@ class ProcessorOsmElementsFromO5M : public ProcessorOsmElementsInterface
 {
 public:
   explicit ProcessorOsmElementsFromO5M(SourceReader & stream);
+  explicit ProcessorOsmElementsFromO5M(osm::TReadFunc reader);
 
   // ProcessorOsmElementsInterface overrides:
   bool TryRead(OsmElement & element) override;
 
 private:
-  SourceReader & m_stream;
   osm::O5MSource m_dataset;
   osm::O5MSource::Iterator m_pos;
 };
@@ -87,4 +93,99 @@ private:
   XMLSequenceParser<SourceReader, XMLSource> m_parser;
   std::queue<OsmElement> m_queue;
 };
+
+// Splits an input stream into blocks which can be decoded independently of each other.
+class OsmBlocksReaderInterface
+{
+public:
+  virtual ~OsmBlocksReaderInterface() = default;
+
+  // Reads the next raw block. Returns false when the input is over.
+  virtual bool ReadBlock(std::vector<uint8_t> & block) = 0;
+  // Decodes a block returned by ReadBlock(). May be called from several threads simultaneously.
+  virtual void DecodeBlock(std::vector<uint8_t> const & block,
+                           std::vector<OsmElement> & elements) const = 0;
+  // Returns a processor of the rest of the input which can't be split into blocks, it's called
+  // after ReadBlock() returned false. Returns nullptr when the input is over.
+  virtual std::unique_ptr<ProcessorOsmElementsInterface> GetRestProcessor() { return nullptr; }
+};
+
+// Splits o5m input by reset points: all delta coding counters are reset to zero there, so
+// each part between two resets is decodable on its own.
+// Note. The granularity depends on the input. A part which grows over |maxBlockSize| can't be
+// cut elsewhere since elements refer to delta counters and strings of the previous ones, so the
+// input is read sequentially from the start of that part on.
+class O5MBlocksReader : public OsmBlocksReaderInterface
+{
+public:
+  static size_t constexpr kMaxBlockSize = 32 * 1024 * 1024;
+
+  explicit O5MBlocksReader(SourceReader & stream, size_t maxBlockSize = kMaxBlockSize);
+
+  // OsmBlocksReaderInterface overrides:
+  bool ReadBlock(std::vector<uint8_t> & block) override;
+  void DecodeBlock(std::vector<uint8_t> const & block,
+                   std::vector<OsmElement> & elements) const override;
+  std::unique_ptr<ProcessorOsmElementsInterface> GetRestProcessor() override;
+
+private:
+  bool ReadByte(uint8_t & byte);
+  bool ReadBytes(size_t size, std::vector<uint8_t> & dest);
+  // Reads the part which is too big for a block, then the rest of the input.
+  size_t ReadRest(uint8_t * buffer, size_t size);
+
+  SourceReader & m_stream;
+  size_t const m_maxBlockSize;
+  std::vector<uint8_t> m_buffer;
+  size_t m_bufferPos = 0;
+  bool m_isEnd = false;
+  bool m_isSequential = false;
+  std::vector<uint8_t> m_rest;
+  size_t m_restPos = 0;
+};
+
+// Splits PBF input by blobs, each OSMData blob is compressed and decoded on its own.
+class PBFBlocksReader : public OsmBlocksReaderInterface
+{
+public:
+  explicit PBFBlocksReader(SourceReader & stream);
+
+  // OsmBlocksReaderInterface overrides:
+  bool ReadBlock(std::vector<uint8_t> & block) override;
+  void DecodeBlock(std::vector<uint8_t> const & block,
+                   std::vector<OsmElement> & elements) const override;
+
+private:
+  osm::PBFSource m_source;
+};
+
+// Reads raw blocks on the calling thread, decodes them on |threadsCount| threads and returns
+// elements in the same order as a sequential reader does.
+class ProcessorOsmElementsInBlocks : public ProcessorOsmElementsInterface
+{
+public:
+  ProcessorOsmElementsInBlocks(std::unique_ptr<OsmBlocksReaderInterface> blocksReader,
+                               size_t threadsCount);
+
+  // ProcessorOsmElementsInterface overrides:
+  bool TryRead(OsmElement & element) override;
+
+private:
+  void SubmitBlocks();
+
+  std::unique_ptr<OsmBlocksReaderInterface> m_blocksReader;
+  std::unique_ptr<ProcessorOsmElementsInterface> m_restProcessor;
+  size_t const m_maxPendingBlocks;
+  bool m_noMoreBlocks = false;
+  std::queue<std::future<std::vector<OsmElement>>> m_pendingBlocks;
+  std::vector<OsmElement> m_elements;
+  size_t m_elementIdx = 0;
+  base::thread_pool::computational::ThreadPool m_threadPool;
+};
+
+// Creates a reader of |info.m_osmFileType| format. Blocks are decoded in parallel when
+// |info.m_osmReaderThreadsCount| is greater than one and the format supports it.
+// PBF input is always decoded apart from reading.
+std::unique_ptr<ProcessorOsmElementsInterface> CreateProcessorOsmElements(
+    SourceReader & stream, feature::GenerateInfo const & info);
 }  // namespace generator
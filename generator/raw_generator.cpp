@@ -231,17 +231,7 @@ bool RawGenerator::GenerateFilteredFeatures()
   SourceReader reader =
       m_genInfo.m_osmFileName.empty() ? SourceReader() : SourceReader(m_genInfo.m_osmFileName);
 
-  std::unique_ptr<ProcessorOsmElementsInterface> sourceProcessor;
-  switch (m_genInfo.m_osmFileType)
-  {
-  case feature::GenerateInfo::OsmSourceType::O5M:
-    sourceProcessor = std::make_unique<ProcessorOsmElementsFromO5M>(reader);
-    break;
-  case feature::GenerateInfo::OsmSourceType::XML:
-    sourceProcessor = std::make_unique<ProcessorOsmElementsFromXml>(reader);
-    break;
-  }
-  CHECK(sourceProcessor, ());
+  auto const sourceProcessor = CreateProcessorOsmElements(reader, m_genInfo);
 
   TranslatorsPool translators(m_translators, m_threadsCount);
   RawGeneratorWriter rawGeneratorWriter(m_queue, m_genInfo.m_tmpDir);
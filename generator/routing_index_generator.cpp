@@ -14,6 +14,7 @@
 #include "routing/index_graph_serialization.hpp"
 #include "routing/index_graph_starter_joints.hpp"
 #include "routing/joint_segment.hpp"
+#include "routing/routing_shortcuts.hpp"
 #include "routing/vehicle_mask.hpp"
 #include "routing/world_graph.hpp"
 
@@ -38,9 +39,12 @@
 #include "base/file_name_utils.hpp"
 #include "base/geo_object_id.hpp"
 #include "base/logging.hpp"
+#include "base/thread_pool_computational.hpp"
 #include "base/timer.hpp"
 
 #include <algorithm>
+#include <atomic>
+#include <future>
 #include <map>
 #include <memory>
 #include <unordered_map>
@@ -498,9 +502,98 @@ void CalcCrossMwmConnectors(
   LOG(LINFO, ("Transitions count =", builder.GetTransitionsCount(), "elapsed:", timer.ElapsedSeconds(), "seconds"));
 }
 
+/// \brief Calculates weights from |enter| to all the exits of |connector| with one wave of
+/// |graph| and writes them to |enter|'s row of |weights| matrix.
+/// \returns Number of exits the route was found to.
+template <typename ConnectorT>
+size_t CalcEnterWeights(IndexGraph & graph, ConnectorT const & connector, uint32_t enterIdx,
+                        Segment const & enter, vector<double> & weights)
+{
+  using Algorithm =
+      AStarAlgorithm<JointSegment, JointEdge, RouteWeight>;
+
+  Algorithm astar;
+  IndexGraphWrapper indexGraphWrapper(graph, enter);
+  DijkstraWrapperJoints wrapper(indexGraphWrapper, enter);
+  Algorithm::Context context(wrapper);
+
+  std::unordered_map<uint32_t, vector<JointSegment>> visitedVertexes;
+  astar.PropagateWave(
+      wrapper, wrapper.GetStartJoint(),
+      [&](JointSegment const & vertex)
+      {
+        if (vertex.IsFake())
+        {
+          auto const & start = wrapper.GetSegmentOfFakeJoint(vertex, true /* start */);
+          auto const & end = wrapper.GetSegmentOfFakeJoint(vertex, false /* start */);
+          if (start.IsForward() != end.IsForward())
+            return true;
+
+          visitedVertexes[end.GetFeatureId()].emplace_back(start, end);
+        }
+        else
+        {
+          visitedVertexes[vertex.GetFeatureId()].emplace_back(vertex);
+        }
+
+        return true;
+      } /* visitVertex */,
+      context);
+
+  size_t foundCount = 0;
+  connector.ForEachExit([&](uint32_t exitIdx, Segment const & exit)
+  {
+    auto const it = visitedVertexes.find(exit.GetFeatureId());
+    if (it == visitedVertexes.cend())
+      return;
+
+    uint32_t const id = exit.GetSegmentIdx();
+    bool const forward = exit.IsForward();
+    for (auto const & jointSegment : it->second)
+    {
+      if (jointSegment.IsForward() != forward)
+        continue;
+
+      if ((jointSegment.GetStartSegmentId() <= id && id <= jointSegment.GetEndSegmentId()) ||
+          (jointSegment.GetEndSegmentId() <= id && id <= jointSegment.GetStartSegmentId()))
+      {
+        RouteWeight weight;
+        Segment parentSegment;
+        if (context.HasParent(jointSegment))
+        {
+          JointSegment const & parent = context.GetParent(jointSegment);
+          parentSegment = wrapper.GetSegmentFromJoint(parent, false /* start */);
+          weight = context.GetDistance(parent);
+        }
+        else
+        {
+          parentSegment = enter;
+        }
+
+        Segment const & firstChild = jointSegment.GetSegment(true /* start */);
+        uint32_t const lastPoint = exit.GetPointId(true /* front */);
+
+        auto optionalEdge =  graph.GetJointEdgeByLastPoint(parentSegment, firstChild,
+                                                           true /* isOutgoing */, lastPoint);
+
+        if (!optionalEdge)
+          continue;
+
+        weight += (*optionalEdge).GetWeight();
+        weights[connector.GetWeightIndex(enterIdx, exitIdx)] = weight.ToCrossMwmWeight();
+
+        ++foundCount;
+        break;
+      }
+    }
+  });
+
+  return foundCount;
+}
+
 template <typename CrossMwmId>
 void FillWeights(string const & path, string const & mwmFile, string const & country,
-                 CountryParentNameGetterFn const & countryParentNameGetterFn,
+                 CountryParentNameGetterFn const & countryParentNameGetterFn, size_t threadsCount,
                  CrossMwmConnectorBuilderEx<CrossMwmId> & builder)
 {
   base::Timer timer;
@@ -511,125 +604,70 @@ void FillWeights(string const & path, string const & mwmFile, string const & cou
   std::shared_ptr<VehicleModelInterface> vehicleModel =
       CarModelFactory(countryParentNameGetterFn).GetVehicleModelForCountry(country);
 
-  MwmValue mwmValue(LocalCountryFile(path, platform::CountryFile(country), 0 /* version */));
-  uint32_t mwmNumRoads = DeserializeIndexGraphNumRoads(mwmValue, vhType);
-  IndexGraph graph(std::make_shared<Geometry>(GeometryLoader::CreateFromFile(mwmFile, vehicleModel), mwmNumRoads),
-                                              EdgeEstimator::Create(vhType, *vehicleModel,
-                                                                    nullptr /* trafficStash */,
-                                                                    nullptr /* dataSource */,
-                                                                    nullptr /* numMvmIds */));
-  graph.SetCurrentTimeGetter([time = GetCurrentTimestamp()] { return time; });
-  DeserializeIndexGraph(mwmValue, vhType, graph);
-
-  std::map<Segment, std::map<Segment, RouteWeight>> weights;
-  size_t foundCount = 0;
-  size_t notFoundCount = 0;
+  LocalCountryFile const localFile(path, platform::CountryFile(country), 0 /* version */);
+  uint32_t const mwmNumRoads = DeserializeIndexGraphNumRoads(MwmValue(localFile), vhType);
+  auto const currentTime = GetCurrentTimestamp();
+
+  // IndexGraph and Geometry cache loaded roads and are not thread-safe,
+  // so every worker thread makes its own instances.
+  auto const createGraph = [&]()
+  {
+    auto graph = std::make_unique<IndexGraph>(
+        std::make_shared<Geometry>(GeometryLoader::CreateFromFile(mwmFile, vehicleModel), mwmNumRoads),
+        EdgeEstimator::Create(vhType, *vehicleModel, nullptr /* trafficStash */,
+                              nullptr /* dataSource */, nullptr /* numMvmIds */));
+    graph->SetCurrentTimeGetter([currentTime] { return currentTime; });
+    DeserializeIndexGraph(MwmValue(localFile), vhType, *graph);
+    return graph;
+  };
 
   auto const & connector = builder.PrepareConnector(vhType);
   uint32_t const numEnters = connector.GetNumEnters();
-  uint32_t i = 0;
-  connector.ForEachEnter([&](uint32_t, Segment const & enter)
-  {
-    if (i % 10 == 0)
-      LOG(LINFO, ("Building leaps:", i, "/", numEnters, "waves passed"));
+  uint32_t const numExits = connector.GetNumExits();
 
-    i++;
-    using Algorithm =
-        AStarAlgorithm<JointSegment, JointEdge, RouteWeight>;
+  vector<std::pair<uint32_t, Segment>> enters;
+  enters.reserve(numEnters);
+  connector.ForEachEnter([&](uint32_t enterIdx, Segment const & enter)
+  {
+    enters.emplace_back(enterIdx, enter);
+  });
 
-    Algorithm astar;
-    IndexGraphWrapper indexGraphWrapper(graph, enter);
-    DijkstraWrapperJoints wrapper(indexGraphWrapper, enter);
-    Algorithm::Context context(wrapper);
+  // Every row of the matrix is written by one wave only, so no synchronization is needed.
+  vector<double> weights(size_t(numEnters) * numExits, connector::kNoRoute);
+  std::atomic<size_t> nextEnter = 0;
+  std::atomic<size_t> foundCount = 0;
 
-    std::unordered_map<uint32_t, vector<JointSegment>> visitedVertexes;
-    astar.PropagateWave(
-        wrapper, wrapper.GetStartJoint(),
-        [&](JointSegment const & vertex)
-        {
-          if (vertex.IsFake())
-          {
-            auto const & start = wrapper.GetSegmentOfFakeJoint(vertex, true /* start */);
-            auto const & end = wrapper.GetSegmentOfFakeJoint(vertex, false /* start */);
-            if (start.IsForward() != end.IsForward())
-              return true;
-
-            visitedVertexes[end.GetFeatureId()].emplace_back(start, end);
-          }
-          else
-          {
-            visitedVertexes[vertex.GetFeatureId()].emplace_back(vertex);
-          }
-
-          return true;
-        } /* visitVertex */,
-        context);
-
-    connector.ForEachExit([&](uint32_t, Segment const & exit)
+  threadsCount = std::max<size_t>(1, std::min<size_t>(threadsCount, enters.size()));
+  {
+    base::thread_pool::computational::ThreadPool pool(threadsCount);
+    vector<std::future<void>> results;
+    results.reserve(threadsCount);
+    for (size_t i = 0; i < threadsCount; ++i)
     {
-      auto const it = visitedVertexes.find(exit.GetFeatureId());
-      if (it == visitedVertexes.cend())
-      {
-        ++notFoundCount;
-        return;
-      }
-
-      uint32_t const id = exit.GetSegmentIdx();
-      bool const forward = exit.IsForward();
-      for (auto const & jointSegment : it->second)
+      // Enters are taken one by one because the wave time varies a lot from enter to enter.
+      results.emplace_back(pool.Submit([&]()
       {
-        if (jointSegment.IsForward() != forward)
-          continue;
-
-        if ((jointSegment.GetStartSegmentId() <= id && id <= jointSegment.GetEndSegmentId()) ||
-            (jointSegment.GetEndSegmentId() <= id && id <= jointSegment.GetStartSegmentId()))
+        auto graph = createGraph();
+        for (size_t j = nextEnter++; j < enters.size(); j = nextEnter++)
         {
-          RouteWeight weight;
-          Segment parentSegment;
-          if (context.HasParent(jointSegment))
-          {
-            JointSegment const & parent = context.GetParent(jointSegment);
-            parentSegment = wrapper.GetSegmentFromJoint(parent, false /* start */);
-            weight = context.GetDistance(parent);
-          }
-          else
-          {
-            parentSegment = enter;
-          }
-
-          Segment const & firstChild = jointSegment.GetSegment(true /* start */);
-          uint32_t const lastPoint = exit.GetPointId(true /* front */);
-
-          auto optionalEdge =  graph.GetJointEdgeByLastPoint(parentSegment, firstChild,
-                                                             true /* isOutgoing */, lastPoint);
-
-          if (!optionalEdge)
-            continue;
-
-          weight += (*optionalEdge).GetWeight();
-          weights[enter][exit] = weight;
-
-          ++foundCount;
-          break;
+          if (j % 10 == 0)
+            LOG(LINFO, ("Building leaps:", j, "/", numEnters, "waves passed"));
+
+          auto const & [enterIdx, enter] = enters[j];
+          foundCount += CalcEnterWeights(*graph, connector, enterIdx, enter, weights);
         }
-      }
-    });
-  });
+      }));
+    }
 
-  builder.FillWeights([&](Segment const & enter, Segment const & exit) {
-    auto it0 = weights.find(enter);
-    if (it0 == weights.end())
-      return connector::kNoRoute;
+    for (auto & result : results)
+      result.get();
+  }
 
-    auto it1 = it0->second.find(exit);
-    if (it1 == it0->second.end())
-      return connector::kNoRoute;
-
-    return it1->second.ToCrossMwmWeight();
-  });
+  builder.FillWeightsFromMatrix(weights);
 
   LOG(LINFO, ("Leaps finished, elapsed:", timer.ElapsedSeconds(), "seconds, routes found:",
-              foundCount, ", not found:", notFoundCount));
+              foundCount.load(), ", not found:", weights.size() - foundCount.load(),
+              ", threads:", threadsCount));
 }
 
 bool BuildRoutingIndex(string const & filename, string const & country,
@@ -682,7 +720,7 @@ void SerializeCrossMwm(string const & mwmFile, string const & sectionName,
 void BuildRoutingCrossMwmSection(string const & path, string const & mwmFile,
                                  string const & country, string const & intermediateDir,
                                  CountryParentNameGetterFn const & countryParentNameGetterFn,
-                                 string const & osmToFeatureFile)
+                                 string const & osmToFeatureFile, size_t threadsCount)
 {
   LOG(LINFO, ("Building cross mwm section for", country));
   CrossMwmConnectorBuilderEx<base::GeoObjectId> builder;
@@ -692,7 +730,7 @@ void BuildRoutingCrossMwmSection(string const & path, string const & mwmFile,
 
   // We use leaps for cars only. To use leaps for other vehicle types add weights generation
   // here and change WorldGraph mode selection rule in IndexRouter::CalculateSubroute.
-  FillWeights(path, mwmFile, country, countryParentNameGetterFn, builder);
+  FillWeights(path, mwmFile, country, countryParentNameGetterFn, threadsCount, builder);
 
   SerializeCrossMwm(mwmFile, CROSS_MWM_FILE_TAG, builder);
 }
@@ -711,4 +749,41 @@ void BuildTransitCrossMwmSection(
 
   SerializeCrossMwm(mwmFile, TRANSIT_CROSS_MWM_FILE_TAG, builder);
 }
+
+void BuildRoutingShortcutsSection(string const & path, string const & mwmFile,
+                                  string const & country,
+                                  CountryParentNameGetterFn const & countryParentNameGetterFn)
+{
+  LOG(LINFO, ("Building routing shortcuts section for", country));
+  base::Timer timer;
+
+  // Routing shortcuts are used for cars only, see IndexRouter::CalculateSubrouteShortcutsMode.
+  VehicleType const vhType = VehicleType::Car;
+  std::shared_ptr<VehicleModelInterface> vehicleModel =
+      CarModelFactory(countryParentNameGetterFn).GetVehicleModelForCountry(country);
+
+  LocalCountryFile const localFile(path, platform::CountryFile(country), 0 /* version */);
+  uint32_t const mwmNumRoads = DeserializeIndexGraphNumRoads(MwmValue(localFile), vhType);
+
+  // All the roads are visited several times, so the geometry cache keeps them all.
+  IndexGraph graph(
+      std::make_shared<Geometry>(GeometryLoader::CreateFromFile(mwmFile, vehicleModel), mwmNumRoads),
+      EdgeEstimator::Create(vhType, *vehicleModel, nullptr /* trafficStash */,
+                            nullptr /* dataSource */, nullptr /* numMvmIds */));
+  auto const currentTime = GetCurrentTimestamp();
+  graph.SetCurrentTimeGetter([currentTime] { return currentTime; });
+  DeserializeIndexGraph(MwmValue(localFile), vhType, graph);
+
+  auto const shortcuts = RoutingShortcuts::Build(graph);
+
+  FilesContainerW cont(mwmFile, FileWriter::OP_WRITE_EXISTING);
+  auto writer = cont.GetWriter(ROUTING_SHORTCUTS_FILE_TAG);
+  auto const startPos = writer->Pos();
+  shortcuts.Serialize(*writer);
+  auto const sectionSize = writer->Pos() - startPos;
+
+  LOG(LINFO, ("Routing shortcuts section generated, spans:", shortcuts.GetNumSpans(), ", arcs:",
+              shortcuts.GetHierarchy().GetNumArcs(), ", size:", sectionSize, "bytes, elapsed:",
+              timer.ElapsedSeconds(), "seconds"));
+}
 }  // namespace routing_builder
@@ -2,6 +2,7 @@
 
 #include "transit/experimental/transit_data.hpp"
 
+#include <cstddef>
 #include <cstdint>
 #include <functional>
 #include <string>
@@ -17,10 +18,18 @@ bool BuildRoutingIndex(std::string const & filename, std::string const & country
 /// \note Before call of this method
 /// * all features and feature geometry should be generated
 /// * city_roads section should be generated
+/// \param threadsCount Number of threads used to calculate leaps weights.
 void BuildRoutingCrossMwmSection(std::string const & path, std::string const & mwmFile,
                                  std::string const & country, std::string const & intermediateDir,
                                  CountryParentNameGetterFn const & countryParentNameGetterFn,
-                                 std::string const & osmToFeatureFile);
+                                 std::string const & osmToFeatureFile, size_t threadsCount = 1);
+
+/// \brief Builds ROUTING_SHORTCUTS_FILE_TAG section with the contraction hierarchy of car roads.
+/// \note Before call of this method ROUTING_FILE_TAG, RESTRICTIONS_FILE_TAG and
+/// ROAD_ACCESS_FILE_TAG sections should be generated.
+void BuildRoutingShortcutsSection(std::string const & path, std::string const & mwmFile,
+                                  std::string const & country,
+                                  CountryParentNameGetterFn const & countryParentNameGetterFn);
 
 /// \brief Builds TRANSIT_CROSS_MWM_FILE_TAG section.
 /// \note Before a call of this method TRANSIT_FILE_TAG should be built.
@@ -0,0 +1,162 @@
+#include "generator/sections_builder.hpp"
+
+#include "coding/file_writer.hpp"
+#include "coding/files_container.hpp"
+#include "coding/internal/file_data.hpp"
+
+#include "base/assert.hpp"
+#include "base/exception.hpp"
+#include "base/logging.hpp"
+#include "base/thread_pool_computational.hpp"
+#include "base/timer.hpp"
+
+#include <algorithm>
+#include <future>
+#include <set>
+#include <utility>
+
+#include "defines.hpp"
+
+namespace generator
+{
+SectionsBuilder::SectionsBuilder(std::string const & mwmPath, size_t threadsCount)
+  : m_mwmPath(mwmPath), m_threadsCount(std::max(threadsCount, size_t(1)))
+{
+}
+
+void SectionsBuilder::Add(std::string const & name, BuildFn && fn,
+                          std::vector<std::string> const & dependencies)
+{
+  CHECK(std::none_of(m_tasks.cbegin(), m_tasks.cend(),
+                     [&name](Task const & task) { return task.m_name == name; }),
+        (name));
+  m_tasks.push_back({name, std::move(fn), dependencies});
+}
+
+bool SectionsBuilder::Run()
+{
+  std::set<std::string> names;
+  for (auto const & task : m_tasks)
+    names.insert(task.m_name);
+
+  std::set<std::string> built;
+  std::set<std::string> failed;
+  std::vector<Task const *> pending;
+  for (auto const & task : m_tasks)
+    pending.push_back(&task);
+
+  while (!pending.empty())
+  {
+    std::vector<Task const *> wave;
+    std::vector<Task const *> rest;
+    for (auto const * task : pending)
+    {
+      bool ready = true;
+      bool skip = false;
+      for (auto const & dependency : task->m_dependencies)
+      {
+        if (failed.count(dependency) != 0)
+          skip = true;
+        else if (names.count(dependency) != 0 && built.count(dependency) == 0)
+          ready = false;
+      }
+
+      if (skip)
+      {
+        LOG(LWARNING, ("Skipping", task->m_name, "section builder for", m_mwmPath,
+                       "because of its failed dependencies."));
+        failed.insert(task->m_name);
+      }
+      else if (ready)
+      {
+        wave.push_back(task);
+      }
+      else
+      {
+        rest.push_back(task);
+      }
+    }
+
+    // Skipped tasks may fail dependent ones at the next iteration.
+    CHECK(!wave.empty() || rest.size() < pending.size(),
+          ("Cyclic dependencies of section builders for", m_mwmPath));
+
+    if (!wave.empty())
+    {
+      for (auto const & name : RunWave(wave))
+        failed.insert(name);
+
+      for (auto const * task : wave)
+      {
+        if (failed.count(task->m_name) == 0)
+          built.insert(task->m_name);
+      }
+    }
+
+    pending = std::move(rest);
+  }
+
+  return failed.empty();
+}
+
+std::vector<std::string> SectionsBuilder::RunWave(std::vector<Task const *> const & wave) const
+{
+  base::Timer timer;
+
+  std::vector<std::string> sectionsPaths;
+  for (auto const * task : wave)
+  {
+    sectionsPaths.push_back(m_mwmPath + "." + task->m_name + EXTENSION_TMP);
+    // Creates an empty container.
+    FilesContainerW(sectionsPaths.back(), FileWriter::OP_WRITE_TRUNCATE);
+  }
+
+  std::vector<bool> succeeded(wave.size(), false);
+  {
+    base::thread_pool::computational::ThreadPool pool(std::min(m_threadsCount, wave.size()));
+    std::vector<std::future<bool>> results;
+    for (size_t i = 0; i < wave.size(); ++i)
+    {
+      results.emplace_back(pool.Submit([this, &wave, &sectionsPaths, i]() {
+        try
+        {
+          return wave[i]->m_fn(m_mwmPath, sectionsPaths[i]);
+        }
+        catch (RootException const & e)
+        {
+          LOG(LERROR, ("Error building", wave[i]->m_name, "sections:", e.Msg()));
+          return false;
+        }
+      }));
+    }
+
+    for (size_t i = 0; i < results.size(); ++i)
+      succeeded[i] = results[i].get();
+  }
+
+  std::vector<std::string> failedNames;
+  {
+    FilesContainerW container(m_mwmPath, FileWriter::OP_WRITE_EXISTING);
+    for (size_t i = 0; i < wave.size(); ++i)
+    {
+      if (!succeeded[i])
+      {
+        failedNames.push_back(wave[i]->m_name);
+        continue;
+      }
+
+      FilesContainerR sections(sectionsPaths[i]);
+      sections.ForEachTag([&](FilesContainerR::Tag const & tag) {
+        container.Write(sections.GetReader(tag), tag);
+      });
+    }
+  }
+
+  for (auto const & path : sectionsPaths)
+    base::DeleteFileX(path);
+
+  LOG(LINFO, (wave.size(), "section builders for", m_mwmPath, "finished in", timer.ElapsedSeconds(),
+              "seconds."));
+  return failedNames;
+}
+}  // namespace generator
@@ -0,0 +1,48 @@
+#pragma once
+
+#include <cstddef>
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace generator
+{
+// Schedules builders of mwm sections which don't write anything but their own sections.
+// Builders run in waves: all the builders whose dependencies are already built run
+// concurrently, every one of them writes its sections into its own temporary container,
+// and then the sections of the whole wave are copied into the mwm in one pass. So the mwm
+// is never written while builders read it and a builder sees the sections of its dependencies.
+class SectionsBuilder
+{
+public:
+  // Reads the mwm at |mwmPath| and writes sections into the container at |sectionsPath|.
+  // Returns false on failure.
+  using BuildFn = std::function<bool(std::string const & mwmPath, std::string const & sectionsPath)>;
+
+  SectionsBuilder(std::string const & mwmPath, size_t threadsCount);
+
+  // Adds a builder with a unique |name|. Dependencies which are not added to the builder
+  // are considered to be built already.
+  void Add(std::string const & name, BuildFn && fn, std::vector<std::string> const & dependencies = {});
+
+  // Runs all the added builders. Builders which depend on failed ones are skipped.
+  // Returns false if some builder failed or was skipped.
+  bool Run();
+
+private:
+  struct Task
+  {
+    std::string m_name;
+    BuildFn m_fn;
+    std::vector<std::string> m_dependencies;
+  };
+
+  // Runs |wave| concurrently and copies sections of succeeded tasks into the mwm.
+  // Returns names of the failed tasks.
+  std::vector<std::string> RunWave(std::vector<Task const *> const & wave) const;
+
+  std::string m_mwmPath;
+  size_t m_threadsCount;
+  std::vector<Task> m_tasks;
+};
+}  // namespace generator
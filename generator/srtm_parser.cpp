@@ -3,14 +3,18 @@
 #include "platform/platform.hpp"
 
 #include "coding/endianness.hpp"
+#include "coding/internal/file_data.hpp"
 #include "coding/zip_reader.hpp"
 
 #include "base/file_name_utils.hpp"
 #include "base/logging.hpp"
 
-#include <fstream>
+#include <algorithm>
 #include <iomanip>
 #include <sstream>
+#include <thread>
+
+#include <unistd.h>
 
 namespace generator
 {
@@ -42,6 +46,20 @@ std::string GetSrtmContFileName(std::string const & dir, std::string const & bas
 {
   return base::JoinPath(dir, base + ".SRTMGL1.hgt.zip");
 }
+
+template <typename Destination>
+void UnzipSrtmFile(std::string const & cont, std::string const & base, Destination & dest)
+{
+  try
+  {
+    ZipFileReader::UnzipFile(cont, base + ".hgt", dest);
+  }
+  catch (ZipFileReader::LocateZipException const &)
+  {
+    // Sometimes packed file has different name. See N39E051 measure.
+    ZipFileReader::UnzipFile(cont, base + ".SRTMGL1.hgt", dest);
+  }
+}
 }  // namespace
 
 // SrtmTile ----------------------------------------------------------------------------------------
@@ -50,42 +68,65 @@ SrtmTile::SrtmTile()
   Invalidate();
 }
 
-SrtmTile::SrtmTile(SrtmTile && rhs) : m_data(std::move(rhs.m_data)), m_valid(rhs.m_valid)
+SrtmTile::SrtmTile(SrtmTile && rhs)
+  : m_data(std::move(rhs.m_data)), m_mmap(std::move(rhs.m_mmap)), m_valid(rhs.m_valid)
 {
   rhs.Invalidate();
 }
 
-void SrtmTile::Init(std::string const & dir, ms::LatLon const & coord)
+void SrtmTile::Init(std::string const & dir, ms::LatLon const & coord,
+                    std::string const & cacheDir)
 {
   Invalidate();
 
   std::string const base = GetBase(coord);
   std::string const cont = GetSrtmContFileName(dir, base);
-  std::string file = base + ".hgt";
+  std::string const file = base + ".hgt";
+  std::string const uncompressed = base::JoinPath(dir, file);
+  std::string const cached = cacheDir.empty() ? std::string() : base::JoinPath(cacheDir, file);
 
   // Original files are stored in zip archives. Alternatively, they can be loaded
-  // from uncompressed files like "N34E012.hgt".
-  static bool const loadFromZip = static_cast<bool>(std::ifstream(cont));
-  if (loadFromZip)
+  // from uncompressed files like "N34E012.hgt". Uncompressed files are memory-mapped
+  // so only the touched pages of a tile are resident.
+  auto const & platform = GetPlatform();
+  if (platform.IsFileExistsByFullPath(uncompressed))
   {
-    UnzipMemDelegate delegate(m_data);
-    try
-    {
-      ZipFileReader::UnzipFile(cont, file, delegate);
-    }
-    catch (ZipFileReader::LocateZipException const &)
+    m_mmap = std::make_unique<MmapReader>(uncompressed);
+  }
+  else if (!cached.empty() && platform.IsFileExistsByFullPath(cached))
+  {
+    m_mmap = std::make_unique<MmapReader>(cached);
+  }
+  else if (platform.IsFileExistsByFullPath(cont))
+  {
+    if (!cached.empty())
     {
-      // Sometimes packed file has different name. See N39E051 measure.
-      file = base + ".SRTMGL1.hgt";
-
-      ZipFileReader::UnzipFile(cont, file, delegate);
+      // Other generators may read and write the cache directory simultaneously, so the file
+      // is decompressed under a name unique for the process and the thread and appears
+      // there only when it's complete.
+      std::ostringstream tmpName;
+      tmpName << cached << '.' << getpid() << '.' << std::this_thread::get_id() << ".tmp";
+      std::string const tmp = tmpName.str();
+      UnzipSrtmFile(cont, base, tmp);
+      if (!base::RenameFileX(tmp, cached))
+      {
+        LOG(LWARNING, ("Can't move decompressed SRTM file to:", cached));
+        base::DeleteFileX(tmp);
+        Invalidate();
+        return;
+      }
+      m_mmap = std::make_unique<MmapReader>(cached);
     }
-
-    if (!delegate.m_completed)
+    else
     {
-      LOG(LWARNING, ("Can't decompress SRTM file:", cont));
-      Invalidate();
-      return;
+      UnzipMemDelegate delegate(m_data);
+      UnzipSrtmFile(cont, base, delegate);
+      if (!delegate.m_completed)
+      {
+        LOG(LWARNING, ("Can't decompress SRTM file:", cont));
+        Invalidate();
+        return;
+      }
     }
   }
   else
@@ -93,9 +134,9 @@ void SrtmTile::Init(std::string const & dir, ms::LatLon const & coord)
     GetPlatform().GetReader(file)->ReadAsString(m_data);
   }
 
-  if (m_data.size() != kSrtmTileSize)
+  if (Size() * sizeof(geometry::Altitude) != kSrtmTileSize)
   {
-    LOG(LWARNING, ("Bad decompressed SRTM file size:", cont, m_data.size()));
+    LOG(LWARNING, ("Bad decompressed SRTM file size:", cont, Size() * sizeof(geometry::Altitude)));
     Invalidate();
     return;
   }
@@ -172,22 +213,63 @@ void SrtmTile::Invalidate()
 {
   m_data.clear();
   m_data.shrink_to_fit();
+  m_mmap.reset();
   m_valid = false;
 }
 
 // SrtmTileManager ---------------------------------------------------------------------------------
-SrtmTileManager::SrtmTileManager(std::string const & dir) : m_dir(dir) {}
+SrtmTileManager::SrtmTileManager(std::string const & dir, size_t maxTilesCount,
+                                 std::string const & cacheDir)
+  : m_dir(dir), m_cacheDir(cacheDir), m_maxTilesCount(std::max(maxTilesCount, size_t(1)))
+{
+}
+
 geometry::Altitude SrtmTileManager::GetHeight(ms::LatLon const & coord)
+{
+  return GetTile(coord)->GetHeight(coord);
+}
+
+// static
+SrtmTileManager::LatLonKey SrtmTileManager::GetKey(ms::LatLon const & coord)
+{
+  auto const tileCenter = SrtmTile::GetCenter(coord);
+  return {static_cast<int32_t>(tileCenter.m_lat), static_cast<int32_t>(tileCenter.m_lon)};
+}
+
+std::shared_ptr<SrtmTile const> SrtmTileManager::GetTile(ms::LatLon const & coord)
 {
   auto const key = GetKey(coord);
 
-  auto it = m_tiles.find(key);
-  if (it == m_tiles.end())
+  std::shared_ptr<Entry> entry;
   {
-    SrtmTile tile;
+    std::lock_guard lock(m_mutex);
+    auto const it = m_tiles.find(key);
+    if (it != m_tiles.end())
+    {
+      m_entries.splice(m_entries.begin(), m_entries, it->second);
+      entry = *it->second;
+    }
+    else
+    {
+      while (m_entries.size() >= m_maxTilesCount)
+      {
+        m_tiles.erase(m_entries.back()->m_key);
+        m_entries.pop_back();
+      }
+
+      entry = std::make_shared<Entry>();
+      entry->m_key = key;
+      m_entries.push_front(entry);
+      m_tiles.emplace(key, m_entries.begin());
+    }
+  }
+
+  // Tiles are loaded outside of the lock, so different tiles are loaded concurrently.
+  std::call_once(entry->m_loaded, [&]() {
+    auto tile = std::make_shared<SrtmTile>();
     try
     {
-      tile.Init(m_dir, coord);
+      tile->Init(m_dir, coord, m_cacheDir);
     }
     catch (RootException const & e)
     {
@@ -197,26 +279,9 @@ geometry::Altitude SrtmTileManager::GetHeight(ms::LatLon const & coord)
 
     // It's OK to store even invalid tiles and return invalid height
     // for them later.
-    it = m_tiles.emplace(key, std::move(tile)).first;
-  }
-
-  return it->second.GetHeight(coord);
-}
-
-// static
-SrtmTileManager::LatLonKey SrtmTileManager::GetKey(ms::LatLon const & coord)
-{
-  auto const tileCenter = SrtmTile::GetCenter(coord);
-  return {static_cast<int32_t>(tileCenter.m_lat), static_cast<int32_t>(tileCenter.m_lon)};
-}
+    entry->m_tile = std::move(tile);
+  });
 
-SrtmTile const & SrtmTileManager::GetTile(ms::LatLon const & coord)
-{
-  // Touch the tile to force its loading.
-  GetHeight(coord);
-  auto const key = GetKey(coord);
-  auto const it = m_tiles.find(key);
-  CHECK(it != m_tiles.end(), (coord));
-  return it->second;
+  return entry->m_tile;
 }
 }  // namespace generator
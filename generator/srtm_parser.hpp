@@ -6,9 +6,14 @@
 
 #include "geometry/point_with_altitude.hpp"
 
+#include "coding/mmap_reader.hpp"
+
 #include "base/macros.hpp"
 
 #include <cstdint>
+#include <list>
+#include <memory>
+#include <mutex>
 #include <string>
 #include <unordered_map>
 
@@ -20,7 +25,9 @@ public:
   SrtmTile();
   SrtmTile(SrtmTile && rhs);
 
-  void Init(std::string const & dir, ms::LatLon const & coord);
+  // Uncompressed tiles are memory-mapped. Zipped tiles are decompressed into memory or,
+  // if |cacheDir| is not empty, into |cacheDir| once and memory-mapped from there.
+  void Init(std::string const & dir, ms::LatLon const & coord, std::string const & cacheDir = {});
 
   inline bool IsValid() const { return m_valid; }
   // Returns height in meters at |coord| or kInvalidAltitude.
@@ -33,32 +40,56 @@ public:
 private:
   inline geometry::Altitude const * Data() const
   {
+    if (m_mmap)
+      return reinterpret_cast<geometry::Altitude const *>(m_mmap->Data());
     return reinterpret_cast<geometry::Altitude const *>(m_data.data());
   };
 
-  inline size_t Size() const { return m_data.size() / sizeof(geometry::Altitude); }
+  inline size_t Size() const
+  {
+    return (m_mmap ? m_mmap->Size() : m_data.size()) / sizeof(geometry::Altitude);
+  }
   void Invalidate();
 
   std::string m_data;
+  std::unique_ptr<MmapReader> m_mmap;
   bool m_valid;
 
   DISALLOW_COPY(SrtmTile);
 };
 
+// Keeps at most |maxTilesCount| recently used tiles. The manager is thread-safe, so one
+// manager may be shared by all the threads which need altitudes. Every tile is loaded once
+// even if it's requested by several threads simultaneously.
 class SrtmTileManager
 {
 public:
-  explicit SrtmTileManager(std::string const & dir);
+  static size_t constexpr kDefaultMaxTilesCount = 64;
+
+  explicit SrtmTileManager(std::string const & dir, size_t maxTilesCount = kDefaultMaxTilesCount,
+                           std::string const & cacheDir = {});
 
   geometry::Altitude GetHeight(ms::LatLon const & coord);
 
-  SrtmTile const & GetTile(ms::LatLon const & coord);
+  // The returned tile stays alive after it's evicted from the manager.
+  std::shared_ptr<SrtmTile const> GetTile(ms::LatLon const & coord);
 
 private:
   using LatLonKey = std::pair<int32_t, int32_t>;
   static LatLonKey GetKey(ms::LatLon const & coord);
 
+  struct Entry
+  {
+    LatLonKey m_key;
+    std::once_flag m_loaded;
+    std::shared_ptr<SrtmTile const> m_tile;
+  };
+  // The most recently used entries are in the front.
+  using Entries = std::list<std::shared_ptr<Entry>>;
+
   std::string m_dir;
+  std::string m_cacheDir;
+  size_t m_maxTilesCount;
 
   struct Hash
   {
@@ -68,7 +99,9 @@ private:
     }
   };
 
-  std::unordered_map<LatLonKey, SrtmTile, Hash> m_tiles;
+  Entries m_entries;
+  std::unordered_map<LatLonKey, Entries::iterator, Hash> m_tiles;
+  std::mutex m_mutex;
 
   DISALLOW_COPY(SrtmTileManager);
 };
@@ -117,9 +117,9 @@ uint32_t CalcOffset(ArrayByteSource const & source, uint8_t const * start)
   return static_cast<uint32_t>(distance(start, source.PtrUint8()));
 }
 
-uint8_t Header(vector<uint8_t> const & data)
+uint8_t Header(uint8_t const * data)
 {
- CHECK(!data.empty(), ());
+ CHECK(data, ());
  return data[0];
 }
 
@@ -190,10 +190,25 @@ uint8_t ReadByte(TSource & src)
 FeatureType::FeatureType(SharedLoadInfo const * loadInfo, vector<uint8_t> && buffer,
                          indexer::MetadataDeserializer * metadataDeserializer)
   : m_loadInfo(loadInfo)
-  , m_data(std::move(buffer))
+  , m_buffer(std::move(buffer))
   , m_metadataDeserializer(metadataDeserializer)
 {
   CHECK(m_loadInfo, ());
+  CHECK(!m_buffer.empty(), ());
+
+  m_data = m_buffer.data();
+  m_header = Header(m_data); // Parse the header and optional name/layer/addinfo.
+}
+
+FeatureType::FeatureType(SharedLoadInfo const * loadInfo, shared_ptr<uint8_t const> record,
+                         size_t size, indexer::MetadataDeserializer * metadataDeserializer)
+  : m_loadInfo(loadInfo)
+  , m_data(record.get())
+  , m_record(std::move(record))
+  , m_metadataDeserializer(metadataDeserializer)
+{
+  CHECK(m_loadInfo, ());
+  CHECK_GREATER(size, 0, ());
 
   m_header = Header(m_data); // Parse the header and optional name/layer/addinfo.
 }
@@ -274,7 +289,7 @@ void FeatureType::ParseTypes()
 
   auto const typesOffset = sizeof(m_header);
   Classificator & c = classif();
-  ArrayByteSource source(m_data.data() + typesOffset);
+  ArrayByteSource source(m_data + typesOffset);
 
   size_t const count = GetTypesCount();
   for (size_t i = 0; i < count; ++i)
@@ -293,7 +308,7 @@ void FeatureType::ParseTypes()
     }
   }
 
-  m_offsets.m_common = CalcOffset(source, m_data.data());
+  m_offsets.m_common = CalcOffset(source, m_data);
   m_parsed.m_types = true;
 }
 
@@ -305,7 +320,7 @@ void FeatureType::ParseCommon()
   CHECK(m_loadInfo, ());
   ParseTypes();
 
-  ArrayByteSource source(m_data.data() + m_offsets.m_common);
+  ArrayByteSource source(m_data + m_offsets.m_common);
   uint8_t const h = Header(m_data);
   m_params.Read(source, h);
 
@@ -315,7 +330,7 @@ void FeatureType::ParseCommon()
     m_limitRect.Add(m_center);
   }
 
-  m_offsets.m_header2 = CalcOffset(source, m_data.data());
+  m_offsets.m_header2 = CalcOffset(source, m_data);
   m_parsed.m_common = true;
 }
 
@@ -351,7 +366,7 @@ void FeatureType::ParseHeader2()
   ParseCommon();
 
   uint8_t elemsCount = 0, geomScalesMask = 0;
-  BitSource bitSource(m_data.data() + m_offsets.m_header2);
+  BitSource bitSource(m_data + m_offsets.m_header2);
   auto const headerGeomType = static_cast<HeaderGeomType>(Header(m_data) & HEADER_MASK_GEOMTYPE);
 
   if (headerGeomType == HeaderGeomType::Line || headerGeomType == HeaderGeomType::Area)
@@ -420,7 +435,7 @@ void FeatureType::ParseHeader2()
     }
   }
   // Size of the whole header incl. inner geometry / triangles.
-  m_innerStats.m_size = CalcOffset(src, m_data.data());
+  m_innerStats.m_size = CalcOffset(src, m_data);
   m_parsed.m_header2 = true;
 }
 
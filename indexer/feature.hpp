@@ -8,6 +8,7 @@
 #include "base/macros.hpp"
 
 #include <array>
+#include <memory>
 #include <string>
 #include <vector>
 
@@ -36,6 +37,11 @@ public:
 
   FeatureType(feature::SharedLoadInfo const * loadInfo, std::vector<uint8_t> && buffer,
               indexer::MetadataDeserializer * metadataDeserializer);
+  /// Parses feature straight from |record| without a copy, e.g. from mapped mwm memory.
+  /// |record| shares the ownership of the memory, so the feature stays valid when
+  /// the FeaturesVector it was got from is destroyed.
+  FeatureType(feature::SharedLoadInfo const * loadInfo, std::shared_ptr<uint8_t const> record,
+              size_t size, indexer::MetadataDeserializer * metadataDeserializer);
 
   static std::unique_ptr<FeatureType> CreateFromMapObject(osm::MapObject const & emo);
 
@@ -245,7 +251,10 @@ private:
 
   // Non-owning pointer to shared load info. SharedLoadInfo created once per FeaturesVector.
   feature::SharedLoadInfo const * m_loadInfo = nullptr;
-  std::vector<uint8_t> m_data;
+  // Feature's record, points to |m_buffer| or to the external (mapped) memory of |m_record|.
+  uint8_t const * m_data = nullptr;
+  std::vector<uint8_t> m_buffer;
+  std::shared_ptr<uint8_t const> m_record;
 
   // Pointer to shared metedata deserializer. Must be set for mwm format >= Format::v11
   indexer::MetadataDeserializer * m_metadataDeserializer = nullptr;
@@ -20,7 +20,7 @@ FeatureSource::FeatureSource(MwmSet::MwmHandle const & handle) : m_handle(handle
 
   auto const & value = *m_handle.GetValue();
   m_vector = std::make_unique<FeaturesVector>(value.m_cont, value.GetHeader(), value.m_table.get(),
-                                              value.m_metaDeserializer.get());
+                                              value.m_metaDeserializer.get(), value.m_features);
 }
 
 size_t FeatureSource::GetNumFeatures() const
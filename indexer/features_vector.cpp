@@ -5,16 +5,19 @@
 
 #include "platform/constants.hpp"
 
+#include "defines.hpp"
+
 
 FeaturesVector::FeaturesVector(FilesContainerR const & cont, feature::DataHeader const & header,
                                feature::FeaturesOffsetsTable const * table,
-                               indexer::MetadataDeserializer * metaDeserializer)
-: m_loadInfo(cont, header), m_table(table), m_metaDeserializer(metaDeserializer)
+                               indexer::MetadataDeserializer * metaDeserializer,
+                               std::shared_ptr<detail::MappedFile::Handle const> records)
+: m_loadInfo(cont, header), m_records(std::move(records)), m_table(table), m_metaDeserializer(metaDeserializer)
 {
-  InitRecordsReader();
+  InitRecordsReader(cont);
 }
 
-void FeaturesVector::InitRecordsReader()
+void FeaturesVector::InitRecordsReader(FilesContainerR const & cont)
 {
   FilesContainerR::TReader reader = m_loadInfo.GetDataReader();
 
@@ -24,11 +27,29 @@ void FeaturesVector::InitRecordsReader()
           (base::Underlying(header.m_version)));
   m_recordReader = std::make_unique<RecordReader>(
         reader.SubReader(header.m_featuresOffset, header.m_featuresSize));
+
+  if (!m_records)
+    m_records = cont.TryMap(FEATURES_FILE_TAG);
+  if (m_records)
+  {
+    CHECK_LESS_OR_EQUAL(uint64_t(header.m_featuresOffset) + header.m_featuresSize, m_records->GetSize(), ());
+    m_recordsOffset = header.m_featuresOffset;
+    m_recordsSize = header.m_featuresSize;
+  }
 }
 
 std::unique_ptr<FeatureType> FeaturesVector::GetByIndex(uint32_t index) const
 {
   auto const ftOffset = m_table ? m_table->GetFeatureOffset(index) : index;
+  if (m_records)
+  {
+    ASSERT_LESS(ftOffset, m_recordsSize, ());
+    ArrayByteSource source(m_records->GetData<uint8_t>() + m_recordsOffset + ftOffset);
+    uint32_t const recordSize = ReadVarUint<uint32_t>(source);
+    std::shared_ptr<uint8_t const> record(m_records, source.PtrUint8());
+    return std::make_unique<FeatureType>(&m_loadInfo, std::move(record), recordSize, m_metaDeserializer);
+  }
+
   return std::make_unique<FeatureType>(&m_loadInfo, m_recordReader->ReadRecord(ftOffset), m_metaDeserializer);
 }
 
@@ -4,7 +4,10 @@
 #include "indexer/metadata_serdes.hpp"
 #include "indexer/shared_load_info.hpp"
 
+#include "coding/byte_stream.hpp"
+#include "coding/files_container.hpp"
 #include "coding/var_record_reader.hpp"
+#include "coding/varint.hpp"
 
 #include <cstdint>
 #include <memory>
@@ -19,9 +22,12 @@ class FeaturesVector
   DISALLOW_COPY(FeaturesVector);
 
 public:
+  /// @param records Mapped features section of |cont| shared by all the vectors of an mwm,
+  /// see MwmValue. The section is mapped by this vector if it's nullptr.
   FeaturesVector(FilesContainerR const & cont, feature::DataHeader const & header,
                  feature::FeaturesOffsetsTable const * table,
-                 indexer::MetadataDeserializer * metaDeserializer);
+                 indexer::MetadataDeserializer * metaDeserializer,
+                 std::shared_ptr<detail::MappedFile::Handle const> records = nullptr);
 
   std::unique_ptr<FeatureType> GetByIndex(uint32_t index) const;
 
@@ -30,16 +36,31 @@ public:
   template <class ToDo> void ForEach(ToDo && toDo) const
   {
     uint32_t index = 0;
-    m_recordReader->ForEachRecord([&](uint32_t pos, std::vector<uint8_t> && data)
+    auto const process = [&](uint32_t pos, FeatureType & ft)
     {
-      FeatureType ft(&m_loadInfo, std::move(data), m_metaDeserializer);
-
       // We can't properly set MwmId here, because FeaturesVector
       // works with FileContainerR, not with MwmId/MwmHandle/MwmValue.
       // But it's OK to set at least feature's index, because it can
       // be used later for Metadata loading.
       ft.SetID(FeatureID(MwmSet::MwmId(), index));
       toDo(ft, m_table ? index++ : pos);
+    };
+
+    if (m_records)
+    {
+      ForEachMappedRecord([&](uint32_t pos, uint8_t const * data, uint32_t size)
+      {
+        FeatureType ft(&m_loadInfo, std::shared_ptr<uint8_t const>(m_records, data), size,
+                       m_metaDeserializer);
+        process(pos, ft);
+      });
+      return;
+    }
+
+    m_recordReader->ForEachRecord([&](uint32_t pos, std::vector<uint8_t> && data)
+    {
+      FeatureType ft(&m_loadInfo, std::move(data), m_metaDeserializer);
+      process(pos, ft);
     });
   }
 
@@ -47,6 +68,12 @@ public:
   {
     feature::DataHeader header(cont);
     FeaturesVector vec(cont, header);
+    if (vec.m_records)
+    {
+      vec.ForEachMappedRecord([&](uint32_t pos, uint8_t const * /* data */, uint32_t /* size */) { toDo(pos); });
+      return;
+    }
+
     vec.m_recordReader->ForEachRecord(
         [&](uint32_t pos, std::vector<uint8_t> && /* data */) { toDo(pos); });
   }
@@ -57,16 +84,39 @@ private:
   FeaturesVector(FilesContainerR const & cont, feature::DataHeader const & header)
     : m_loadInfo(cont, header)
   {
-    InitRecordsReader();
+    InitRecordsReader(cont);
   }
 
-  void InitRecordsReader();
+  void InitRecordsReader(FilesContainerR const & cont);
+
+  /// Reads records, encoded as [VarUint size] [Data], straight from the mapped memory.
+  template <class FnT> void ForEachMappedRecord(FnT && fn) const
+  {
+    uint8_t const * const begin = m_records->GetData<uint8_t>() + m_recordsOffset;
+    uint8_t const * const end = begin + m_recordsSize;
+
+    ArrayByteSource source(begin);
+    while (source.PtrUint8() < end)
+    {
+      auto const pos = static_cast<uint32_t>(source.PtrUint8() - begin);
+      uint32_t const recordSize = ReadVarUint<uint32_t>(source);
+      fn(pos, source.PtrUint8(), recordSize);
+      source.Advance(recordSize);
+    }
+  }
 
   friend class FeaturesVectorTest;
   using RecordReader = VarRecordReader<FilesContainerR::TReader>;
 
   feature::SharedLoadInfo m_loadInfo;
   std::unique_ptr<RecordReader> m_recordReader;
+
+  // Features section mapped into memory. Features parsed from it share the mapping.
+  // When the container can't be mapped, records are copied out with |m_recordReader|.
+  std::shared_ptr<detail::MappedFile::Handle const> m_records;
+  uint32_t m_recordsOffset = 0;
+  uint32_t m_recordsSize = 0;
+
   feature::FeaturesOffsetsTable const * m_table;
   indexer::MetadataDeserializer * m_metaDeserializer;
 };
@@ -9,6 +9,12 @@
 namespace indexer
 {
 bool BuildIndexFromDataFile(std::string const & dataFile, std::string const & tmpFile)
+{
+  return BuildIndexFromDataFile(dataFile, tmpFile, dataFile);
+}
+
+bool BuildIndexFromDataFile(std::string const & dataFile, std::string const & tmpFile,
+                            std::string const & sectionsFile)
 {
   try
   {
@@ -20,7 +26,7 @@ bool BuildIndexFromDataFile(std::string const & dataFile, std::string const & tm
       BuildIndex(features.GetHeader(), features.GetVector(), writer, tmpFile);
     }
 
-    FilesContainerW(dataFile, FileWriter::OP_WRITE_EXISTING).Write(idxFileName, INDEX_FILE_TAG);
+    FilesContainerW(sectionsFile, FileWriter::OP_WRITE_EXISTING).Write(idxFileName, INDEX_FILE_TAG);
     FileWriter::DeleteFileX(idxFileName);
   }
   catch (Reader::Exception const & e)
@@ -23,4 +23,7 @@ void BuildIndex(feature::DataHeader const & header, TFeaturesVector const & feat
 
   // doesn't throw exceptions
   bool BuildIndexFromDataFile(std::string const & dataFile, std::string const & tmpFile);
+  // Same as above but writes the section to the container at |sectionsFile|.
+  bool BuildIndexFromDataFile(std::string const & dataFile, std::string const & tmpFile,
+                              std::string const & sectionsFile);
 }  // namespace indexer
@@ -1,12 +1,18 @@
 #include "testing/testing.hpp"
 
+#include "indexer/classificator_loader.hpp"
 #include "indexer/data_source.hpp"
 #include "indexer/features_vector.hpp"
 #include "indexer/mwm_set.hpp"
 
 #include "platform/local_country_file.hpp"
 
+#include "coding/mmap_reader.hpp"
+
+#include "defines.hpp"
+
 #include <map>
+#include <memory>
 #include <string>
 #include <vector>
 
@@ -46,6 +52,13 @@ vector<pair<int, int>> kCodeFreq = {
   {721816, 1}
 };
 
+vector<uint32_t> GetTypes(FeatureType & ft)
+{
+  vector<uint32_t> types;
+  ft.ForEachType([&types](uint32_t type) { types.push_back(type); });
+  return types;
+}
+
 UNIT_TEST(FeaturesVectorTest_ParseMetadata)
 {
   string const kCountryName = "minsk-pass";
@@ -76,4 +89,84 @@ UNIT_TEST(FeaturesVectorTest_ParseMetadata)
   });
   TEST_EQUAL(expected, actual, ());
 }
+
+// Features of a file container are parsed from the mapped memory and features of a container
+// over MmapReader are copied out to buffers. Both ways should give the same features.
+UNIT_TEST(FeaturesVectorTest_MappedAndCopiedRecords)
+{
+  classificator::Load();
+
+  auto const path = LocalCountryFile::MakeForTesting("minsk-pass").GetPath(MapFileType::Map);
+
+  FeaturesVectorTest mapped(path);
+  FeaturesVectorTest copied((FilesContainerR(std::make_unique<MmapReader>(path))));
+
+  TEST(mapped.GetContainer().TryMap(FEATURES_FILE_TAG), ());
+  TEST(!copied.GetContainer().TryMap(FEATURES_FILE_TAG), ());
+
+  auto const & mappedVector = mapped.GetVector();
+  auto const & copiedVector = copied.GetVector();
+  TEST_GREATER(mappedVector.GetNumFeatures(), 0, ());
+  TEST_EQUAL(mappedVector.GetNumFeatures(), copiedVector.GetNumFeatures(), ());
+
+  vector<string> features;
+  mappedVector.ForEach([&](FeatureType & ft, uint32_t index)
+  {
+    TEST_EQUAL(index, features.size(), ());
+    features.push_back(ft.DebugString());
+  });
+  TEST_EQUAL(features.size(), mappedVector.GetNumFeatures(), ());
+
+  size_t count = 0;
+  copiedVector.ForEach([&](FeatureType & ft, uint32_t index)
+  {
+    TEST_LESS(index, features.size(), ());
+    TEST_EQUAL(ft.DebugString(), features[index], ());
+    ++count;
+  });
+  TEST_EQUAL(count, features.size(), ());
+
+  for (uint32_t i = 0; i < features.size(); i += 100)
+    TEST_EQUAL(mappedVector.GetByIndex(i)->DebugString(), copiedVector.GetByIndex(i)->DebugString(), ());
+}
+
+// Features parsed from the mapped memory share the mapping with the mwm and its loaders,
+// so they may be read after the guard they were loaded with is gone.
+UNIT_TEST(FeaturesVectorTest_ReadFeatureAfterGuard)
+{
+  classificator::Load();
+
+  LocalCountryFile const localFile = LocalCountryFile::MakeForTesting("minsk-pass");
+  FrozenDataSource dataSource;
+  auto const result = dataSource.RegisterMap(localFile);
+  TEST_EQUAL(result.second, MwmSet::RegResult::Success, ());
+
+  vector<unique_ptr<FeatureType>> features;
+  vector<vector<uint32_t>> expected;
+  {
+    FeaturesLoaderGuard guard(dataSource, result.first);
+    TEST_GREATER(guard.GetNumFeatures(), 0, ());
+    for (uint32_t i = 0; i < guard.GetNumFeatures(); i += 100)
+    {
+      expected.push_back(GetTypes(*guard.GetFeatureByIndex(i)));
+      features.push_back(guard.GetFeatureByIndex(i));
+    }
+
+    // The second guard loads features from the same mapping.
+    FeaturesLoaderGuard other(dataSource, result.first);
+    features.push_back(other.GetFeatureByIndex(0));
+    expected.push_back(expected.front());
+  }
+  // Drops the mwm value with its mapping of the features section.
+  dataSource.ClearCache();
+
+  {
+    FeaturesVectorTest fv(localFile.GetPath(MapFileType::Map));
+    features.push_back(fv.GetVector().GetByIndex(0));
+    expected.push_back(expected.front());
+  }
+
+  for (size_t i = 0; i < features.size(); ++i)
+    TEST_EQUAL(GetTypes(*features[i]), expected[i], (i));
+}
 } // namespace features_vector_test
@@ -409,6 +409,7 @@ MwmValue::MwmValue(LocalCountryFile const & localFile)
   : m_cont(platform::GetCountryReader(localFile, MapFileType::Map)), m_file(localFile)
 {
   m_factory.Load(m_cont);
+  m_features = m_cont.TryMap(FEATURES_FILE_TAG);
 }
 
 void MwmValue::SetTable(MwmInfoEx & info)
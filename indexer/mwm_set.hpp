@@ -381,6 +381,8 @@ public:
   std::shared_ptr<feature::FeaturesOffsetsTable> m_table;
   std::unique_ptr<indexer::MetadataDeserializer> m_metaDeserializer;
   std::unique_ptr<HouseToStreetTable> m_house2street, m_house2place;
+  // Features section mapped once for all the FeaturesVectors of the mwm.
+  std::shared_ptr<detail::MappedFile::Handle const> m_features;
 
   explicit MwmValue(platform::LocalCountryFile const & localFile);
   void SetTable(MwmInfoEx & info);
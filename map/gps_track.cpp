@@ -180,33 +180,16 @@ void GpsTrack::InitCollection(hours duration)
     // All origin points have been written in the storage,
     // and filtered points are inserted in the runtime collection.
 
-    vector<location::GpsInfo> originPoints;
-    originPoints.reserve(gps_track::kItemBlockSize);
-
-    m_storage->ForEach([this, &originPoints](location::GpsInfo const & originPoint)->bool
-    {
-      originPoints.emplace_back(originPoint);
-      if (originPoints.size() == originPoints.capacity())
-      {
-        vector<location::GpsTrackInfo> points;
-        m_filter->Process(originPoints, points);
-
-        pair<size_t, size_t> evictedIds;
-        m_collection->Add(points, evictedIds);
-
-        originPoints.clear();
-      }
-      return true;
-    });
-
-    if (!originPoints.empty())
+    m_storage->ForEachBlock(gps_track::kItemBlockSize,
+                            [this](vector<location::GpsInfo> const & originPoints)->bool
     {
       vector<location::GpsTrackInfo> points;
       m_filter->Process(originPoints, points);
 
       pair<size_t, size_t> evictedIds;
       m_collection->Add(points, evictedIds);
-    }
+      return true;
+    });
   }
   catch (RootException const & e)
   {
@@ -1,9 +1,10 @@
 #include "map/gps_track_storage.hpp"
 
 #include "coding/endianness.hpp"
-#include "coding/internal/file_data.hpp"
+#include "coding/mmap_reader.hpp"
 
 #include "base/assert.hpp"
+#include "base/checked_cast.hpp"
 #include "base/logging.hpp"
 
 #include <algorithm>
@@ -15,14 +16,23 @@ namespace
 {
 
 // Current file format version
-uint32_t constexpr kCurrentVersion = 1;
+uint32_t constexpr kCurrentVersion = 2;
 
-// Header size in bytes, header consists of uint32_t 'version' only
-uint32_t constexpr kHeaderSize = sizeof(uint32_t);
+// The previous file format version, items are appended to the end of file, which is rewritten
+// on truncation. Header consists of uint32_t 'version' only.
+uint32_t constexpr kLegacyVersion = 1;
+uint32_t constexpr kLegacyHeaderSize = sizeof(uint32_t);
+
+// Header size in bytes, header consists of uint32_t 'version', uint32_t 'segment item count',
+// uint32_t 'segments count', uint32_t reserved, uint64_t 'begin item' and uint64_t 'end item'.
+uint32_t constexpr kHeaderSize = 4 * sizeof(uint32_t) + 2 * sizeof(uint64_t);
 
 // Number of items for batch processing
 size_t constexpr kItemBlockSize = 1000;
 
+// Max number of items in a segment of the ring
+size_t constexpr kMaxSegmentItemCount = 4096;
+
 // TODO
 // Now GpsInfo written as plain values, but values can be compressed.
 
@@ -75,31 +85,127 @@ void Unpack(char const * p, location::GpsInfo & info)
   info.m_source = static_cast<location::TLocationSource>(source);
 }
 
-inline size_t GetItemOffset(size_t itemIndex)
+// Placement of items in a file of any version.
+struct Layout
+{
+  uint64_t GetItemOffset(uint64_t itemIndex) const
+  {
+    return m_headerSize + (itemIndex % m_capacity) * kPointSize;
+  }
+
+  // Min size of the file which contains items [m_beginItem, m_endItem).
+  uint64_t GetMinFileSize() const
+  {
+    return m_headerSize + min(m_endItem, m_capacity) * kPointSize;
+  }
+
+  uint64_t m_headerSize = kHeaderSize;
+  uint64_t m_capacity = 1;
+  uint64_t m_beginItem = 0;
+  uint64_t m_endItem = 0;
+};
+
+struct Header
+{
+  uint32_t m_version = 0;
+  uint32_t m_segmentItemCount = 0;
+  uint32_t m_segmentsCount = 0;
+  uint64_t m_beginItem = 0;
+  uint64_t m_endItem = 0;
+};
+
+uint32_t GetSegmentItemCount(size_t maxItemCount)
 {
-  return kHeaderSize + itemIndex * kPointSize;
+  return static_cast<uint32_t>(min(maxItemCount, kMaxSegmentItemCount));
 }
 
-inline size_t GetItemCount(size_t fileSize)
+// A spare segment lets the ring keep m_maxItemCount items when the oldest segment is dropped.
+uint32_t GetSegmentsCount(size_t maxItemCount)
 {
-  ASSERT_GREATER_OR_EQUAL(fileSize, kHeaderSize, ());
-  return (fileSize - kHeaderSize) / kPointSize;
+  size_t const segmentItemCount = GetSegmentItemCount(maxItemCount);
+  return base::checked_cast<uint32_t>((maxItemCount + segmentItemCount - 1) / segmentItemCount + 1);
 }
 
-inline bool WriteVersion(fstream & f, uint32_t version)
+inline bool WriteFileHeader(fstream & f, Header const & header)
 {
-  static_assert(kHeaderSize == sizeof(version), "");
-  version = SwapIfBigEndianMacroBased(version);
-  f.write(reinterpret_cast<char const *>(&version), kHeaderSize);
+  char buff[kHeaderSize] = {};
+  MemWrite<uint32_t>(buff, header.m_version);
+  MemWrite<uint32_t>(buff + sizeof(uint32_t), header.m_segmentItemCount);
+  MemWrite<uint32_t>(buff + 2 * sizeof(uint32_t), header.m_segmentsCount);
+  MemWrite<uint64_t>(buff + 4 * sizeof(uint32_t), header.m_beginItem);
+  MemWrite<uint64_t>(buff + 4 * sizeof(uint32_t) + sizeof(uint64_t), header.m_endItem);
+
+  f.seekp(0, ios::beg);
+  f.write(buff, kHeaderSize);
   return f.good();
 }
 
-inline bool ReadVersion(fstream & f, uint32_t & version)
+// Reads the header of a file of any version. Only version is read for the legacy files.
+inline bool ReadFileHeader(fstream & f, uint64_t fileSize, Header & header)
 {
-  static_assert(kHeaderSize == sizeof(version), "");
-  f.read(reinterpret_cast<char *>(&version), kHeaderSize);
-  version = SwapIfBigEndianMacroBased(version);
-  return f.good();
+  char buff[kHeaderSize] = {};
+  f.seekg(0, ios::beg);
+  f.read(buff, static_cast<streamsize>(min<uint64_t>(fileSize, kHeaderSize)));
+  if (!f.good() || fileSize < kLegacyHeaderSize)
+    return false;
+
+  header.m_version = MemRead<uint32_t>(buff);
+  if (header.m_version != kCurrentVersion || fileSize < kHeaderSize)
+    return true;
+
+  header.m_segmentItemCount = MemRead<uint32_t>(buff + sizeof(uint32_t));
+  header.m_segmentsCount = MemRead<uint32_t>(buff + 2 * sizeof(uint32_t));
+  header.m_beginItem = MemRead<uint64_t>(buff + 4 * sizeof(uint32_t));
+  header.m_endItem = MemRead<uint64_t>(buff + 4 * sizeof(uint32_t) + sizeof(uint64_t));
+  return true;
+}
+
+// Returns false if the file of |header| is corrupted or has unknown version.
+bool GetLayout(Header const & header, uint64_t fileSize, Layout & layout)
+{
+  if (header.m_version == kLegacyVersion)
+  {
+    layout.m_headerSize = kLegacyHeaderSize;
+    layout.m_endItem = (fileSize - kLegacyHeaderSize) / kPointSize;
+    layout.m_capacity = max(layout.m_endItem, uint64_t{1});
+    return true;
+  }
+
+  if (header.m_version != kCurrentVersion || header.m_segmentItemCount == 0 ||
+      header.m_segmentsCount == 0)
+  {
+    return false;
+  }
+
+  layout.m_headerSize = kHeaderSize;
+  layout.m_capacity = uint64_t{header.m_segmentItemCount} * header.m_segmentsCount;
+  layout.m_beginItem = header.m_beginItem;
+  layout.m_endItem = header.m_endItem;
+  return layout.m_beginItem <= layout.m_endItem &&
+         layout.m_endItem - layout.m_beginItem <= layout.m_capacity &&
+         layout.GetMinFileSize() <= fileSize;
+}
+
+// Maps the file and calls |fn| for the packed items [firstItem, layout.m_endItem).
+// Returns false if |fn| stops the iteration.
+// @exceptions Reader::Exception if read fails.
+template <typename Fn>
+bool ForEachPackedInFile(string const & filePath, Layout const & layout, uint64_t firstItem, Fn && fn)
+{
+  if (firstItem >= layout.m_endItem)
+    return true;
+
+  MmapReader reader(filePath, MmapReader::Advice::Sequential);
+  if (reader.Size() < layout.GetMinFileSize())
+    MYTHROW(Reader::SizeException, ("File is too small:", reader.Size(), layout.GetMinFileSize()));
+
+  auto const * data = reinterpret_cast<char const *>(reader.Data());
+  for (uint64_t i = firstItem; i < layout.m_endItem; ++i)
+  {
+    if (!fn(data + layout.GetItemOffset(i)))
+      return false;
+  }
+  return true;
 }
 
 } // namespace
@@ -107,57 +213,69 @@ inline bool ReadVersion(fstream & f, uint32_t & version)
 GpsTrackStorage::GpsTrackStorage(string const & filePath, size_t maxItemCount)
   : m_filePath(filePath)
   , m_maxItemCount(maxItemCount)
-  , m_itemCount(0)
+  , m_segmentItemCount(GetSegmentItemCount(maxItemCount))
+  , m_segmentsCount(GetSegmentsCount(maxItemCount))
+  , m_beginItem(0)
+  , m_endItem(0)
 {
   ASSERT_GREATER(m_maxItemCount, 0, ());
 
+  // Items of a file of the previous version or with other segments.
+  vector<TItem> itemsToMigrate;
+
   // Open existing file
   m_stream.open(m_filePath, ios::in | ios::out | ios::binary);
 
   if (m_stream)
   {
-    uint32_t version = 0;
-    if (!ReadVersion(m_stream, version))
-      MYTHROW(OpenException, ("Read version error.", m_filePath));
-
-    if (version == kCurrentVersion)
-    {
-      // Seek to end to get file size
-      m_stream.seekp(0, ios::end);
-      if (!m_stream.good())
-        MYTHROW(OpenException, ("Seek to the end error.", m_filePath));
-
-      auto const fileSize = static_cast<size_t>(m_stream.tellp());
+    // Seek to end to get file size
+    m_stream.seekg(0, ios::end);
+    if (!m_stream.good())
+      MYTHROW(OpenException, ("Seek to the end error.", m_filePath));
+    auto const fileSize = static_cast<uint64_t>(m_stream.tellg());
 
-      m_itemCount = GetItemCount(fileSize);
+    Header header;
+    if (!ReadFileHeader(m_stream, fileSize, header))
+      MYTHROW(OpenException, ("Read version error.", m_filePath));
 
-      // Set write position after last item position
-      size_t const offset = GetItemOffset(m_itemCount);
-      m_stream.seekp(offset, ios::beg);
-      if (!m_stream.good())
-        MYTHROW(OpenException, ("Seek to the offset error:", offset, m_filePath));
-    }
-    else
+    Layout layout;
+    if (GetLayout(header, fileSize, layout))
     {
-      m_stream.close();
-      // TODO: migration for file m_filePath from version 'version' to version 'kCurrentVersion'
-      // TODO: For now we support only one version, but in future migration may be needed.
+      if (header.m_version == kCurrentVersion && header.m_segmentItemCount == m_segmentItemCount &&
+          header.m_segmentsCount == m_segmentsCount)
+      {
+        m_beginItem = header.m_beginItem;
+        m_endItem = header.m_endItem;
+        return;
+      }
+
+      uint64_t const firstItem =
+          max(layout.m_beginItem, layout.m_endItem - min<uint64_t>(layout.m_endItem, m_maxItemCount));
+      try
+      {
+        ForEachPackedInFile(m_filePath, layout, firstItem, [&itemsToMigrate](char const * p)
+        {
+          itemsToMigrate.emplace_back();
+          Unpack(p, itemsToMigrate.back());
+          return true;
+        });
+      }
+      catch (Reader::Exception const & e)
+      {
+        LOG(LWARNING, ("Can't migrate the track from", m_filePath, e.Msg()));
+        itemsToMigrate.clear();
+      }
     }
-  }
 
-  if (!m_stream)
-  {
-    // Create new file
-    m_stream.open(m_filePath, ios::in | ios::out | ios::binary | ios::trunc);
-
-    if (!m_stream)
-      MYTHROW(OpenException, ("Open file error.", m_filePath));
+    m_stream.close();
+  }
 
-    if (!WriteVersion(m_stream, kCurrentVersion))
-      MYTHROW(OpenException, ("Write version error.", m_filePath));
+  // Create new file
+  if (!CreateFile())
+    MYTHROW(OpenException, ("Open file error.", m_filePath));
 
-    m_itemCount = 0;
-  }
+  if (!itemsToMigrate.empty())
+    Append(itemsToMigrate);
 }
 
 void GpsTrackStorage::Append(vector<TItem> const & items)
@@ -167,156 +285,152 @@ void GpsTrackStorage::Append(vector<TItem> const & items)
   if (items.empty())
     return;
 
-  bool const needTrunc = (m_itemCount + items.size()) > (m_maxItemCount * 2); // see NOTE in declaration
+  TItem const * first = items.data();
+  size_t count = items.size();
 
-  if (needTrunc)
-    TruncFile();
-
-  // Write position must be after last item position
-  ASSERT_EQUAL(m_stream.tellp(), static_cast<typename fstream::pos_type>(
-                   GetItemOffset(m_itemCount)), ());
-
-  vector<char> buff(min(kItemBlockSize, items.size()) * kPointSize);
-  for (size_t i = 0; i < items.size();)
+  // Items which don't fit in the ring are dropped before new items are written to their slots,
+  // see NOTE in declaration.
+  if (count >= m_maxItemCount)
   {
-    size_t const n = min(items.size() - i, kItemBlockSize);
-
-    for (size_t j = 0; j < n; ++j)
-      Pack(&buff[0] + j * kPointSize, items[i + j]);
-
-    m_stream.write(&buff[0], n * kPointSize);
-    if (!m_stream.good())
+    first += count - m_maxItemCount;
+    count = m_maxItemCount;
+    m_beginItem = m_endItem = 0;
+    if (!WriteHeader())
+      MYTHROW(WriteException, ("File:", m_filePath));
+  }
+  else if (m_endItem + count - m_beginItem > GetCapacity())
+  {
+    uint64_t const excess = m_endItem + count - m_beginItem - GetCapacity();
+    m_beginItem += (excess + m_segmentItemCount - 1) / m_segmentItemCount * m_segmentItemCount;
+    ASSERT_LESS_OR_EQUAL(m_beginItem, m_endItem, ());
+    if (!WriteHeader())
       MYTHROW(WriteException, ("File:", m_filePath));
-
-    i += n;
   }
 
-  m_stream.flush();
-  if (!m_stream.good())
-    MYTHROW(WriteException, ("File:", m_filePath));
+  WriteItems(first, count);
+  m_endItem += count;
 
-  m_itemCount += items.size();
+  if (!WriteHeader())
+    MYTHROW(WriteException, ("File:", m_filePath));
+  Flush();
 }
 
 void GpsTrackStorage::Clear()
 {
   ASSERT(m_stream.is_open(), ());
 
-  m_itemCount = 0;
-
   m_stream.close();
 
-  m_stream.open(m_filePath, ios::in | ios::out | ios::binary | ios::trunc);
-
-  if (!m_stream)
-    MYTHROW(WriteException, ("File:", m_filePath));
-
-  if (!WriteVersion(m_stream, kCurrentVersion))
+  if (!CreateFile())
     MYTHROW(WriteException, ("File:", m_filePath));
-
-  // Write position is set to the first item in the file
-  ASSERT_EQUAL(m_stream.tellp(), static_cast<typename fstream::pos_type>(
-                   GetItemOffset(0)), ());
 }
 
 void GpsTrackStorage::ForEach(std::function<bool(TItem const & item)> const & fn)
 {
-  ASSERT(m_stream.is_open(), ());
-
-  size_t i = GetFirstItemIndex();
-
-  // Set read position to the first item
-  m_stream.seekg(GetItemOffset(i), ios::beg);
-  if (!m_stream.good())
-    MYTHROW(ReadException, ("File:", m_filePath));
-
-  vector<char> buff(min(kItemBlockSize, m_itemCount) * kPointSize);
-  for (; i < m_itemCount;)
+  ForEachPacked([&fn](char const * p)
   {
-    size_t const n = min(m_itemCount - i, kItemBlockSize);
-
-    m_stream.read(&buff[0], n * kPointSize);
-    if (!m_stream.good())
-      MYTHROW(ReadException, ("File:", m_filePath));
-
-    for (size_t j = 0; j < n; ++j)
-    {      
-      TItem item;
-      Unpack(&buff[0] + j * kPointSize, item);
-      if (!fn(item))
-        return;
-    }
-
-    i += n;
-  }
+    TItem item;
+    Unpack(p, item);
+    return fn(item);
+  });
 }
 
-void GpsTrackStorage::TruncFile()
+void GpsTrackStorage::ForEachBlock(size_t maxBlockSize,
+                                   std::function<bool(std::vector<TItem> const & items)> const & fn)
 {
-  string const tmpFilePath = m_filePath + ".tmp";
+  ASSERT_GREATER(maxBlockSize, 0, ());
 
-  // Create a tmp file
-  fstream tmp(tmpFilePath, ios::in | ios::out | ios::binary | ios::trunc);
-
-  if (!tmp)
-    MYTHROW(WriteException, ("Unable to create temporary file:", tmpFilePath));
+  vector<TItem> items;
+  items.reserve(static_cast<size_t>(min<uint64_t>(maxBlockSize, m_endItem - GetFirstItemIndex())));
+  bool const finished = ForEachPacked([&](char const * p)
+  {
+    items.emplace_back();
+    Unpack(p, items.back());
+    if (items.size() < maxBlockSize)
+      return true;
+
+    bool const next = fn(items);
+    items.clear();
+    return next;
+  });
+
+  if (finished && !items.empty())
+    fn(items);
+}
 
-  if (!WriteVersion(tmp, kCurrentVersion))
-    MYTHROW(WriteException, ("File:", tmpFilePath));
+bool GpsTrackStorage::CreateFile()
+{
+  m_beginItem = m_endItem = 0;
 
-  size_t i = GetFirstItemIndex();
+  m_stream.open(m_filePath, ios::in | ios::out | ios::binary | ios::trunc);
+  return m_stream && WriteHeader();
+}
 
-  // Set read position to the first item
-  m_stream.seekg(GetItemOffset(i), ios::beg);
-  if (!m_stream.good())
-    MYTHROW(ReadException, ("File:", m_filePath));
+bool GpsTrackStorage::WriteHeader()
+{
+  Header header;
+  header.m_version = kCurrentVersion;
+  header.m_segmentItemCount = m_segmentItemCount;
+  header.m_segmentsCount = m_segmentsCount;
+  header.m_beginItem = m_beginItem;
+  header.m_endItem = m_endItem;
+  return WriteFileHeader(m_stream, header);
+}
 
-  size_t newItemCount = 0;
+void GpsTrackStorage::WriteItems(TItem const * items, size_t count)
+{
+  Layout layout;
+  layout.m_capacity = GetCapacity();
 
-  // Copy items
-  vector<char> buff(min(kItemBlockSize, m_itemCount) * kPointSize);
-  for (; i < m_itemCount;)
+  vector<char> buff(min(kItemBlockSize, count) * kPointSize);
+  for (size_t i = 0; i < count;)
   {
-    size_t const n = min(m_itemCount - i, kItemBlockSize);
+    // Items of a block are written to the consecutive slots.
+    uint64_t const slot = (m_endItem + i) % layout.m_capacity;
+    size_t const n = static_cast<size_t>(
+        min<uint64_t>(min(count - i, kItemBlockSize), layout.m_capacity - slot));
 
-    m_stream.read(&buff[0], n * kPointSize);
-    if (!m_stream.good())
-      MYTHROW(ReadException, ("File:", m_filePath));
+    for (size_t j = 0; j < n; ++j)
+      Pack(&buff[0] + j * kPointSize, items[i + j]);
 
-    tmp.write(&buff[0], n * kPointSize);
-    if (!tmp.good())
-      MYTHROW(WriteException, ("File:", tmpFilePath));
+    m_stream.seekp(static_cast<streamoff>(layout.GetItemOffset(m_endItem + i)), ios::beg);
+    m_stream.write(&buff[0], n * kPointSize);
+    if (!m_stream.good())
+      MYTHROW(WriteException, ("File:", m_filePath));
 
     i += n;
-    newItemCount += n;
   }
-  buff.clear();
-  buff.shrink_to_fit();
-
-  tmp.close();
-  m_stream.close();
+}
 
-  // Replace file
-  if (!base::DeleteFileX(m_filePath) ||
-      !base::RenameFileX(tmpFilePath, m_filePath))
-  {
+void GpsTrackStorage::Flush()
+{
+  m_stream.flush();
+  if (!m_stream.good())
     MYTHROW(WriteException, ("File:", m_filePath));
-  }
-
-  // Reopen stream
-  m_stream.open(m_filePath, ios::in | ios::out | ios::binary | ios::ate);
+}
 
-  if (!m_stream)
-    MYTHROW(WriteException, ("File:", m_filePath));
+template <typename Fn>
+bool GpsTrackStorage::ForEachPacked(Fn && fn)
+{
+  ASSERT(m_stream.is_open(), ());
 
-  m_itemCount = newItemCount;
+  Layout layout;
+  layout.m_capacity = GetCapacity();
+  layout.m_beginItem = m_beginItem;
+  layout.m_endItem = m_endItem;
 
-  // Write position must be after last item position (end of file)
-  ASSERT_EQUAL(m_stream.tellp(), static_cast<typename fstream::pos_type>(
-                   GetItemOffset(m_itemCount)), ());
+  try
+  {
+    return ForEachPackedInFile(m_filePath, layout, GetFirstItemIndex(), std::forward<Fn>(fn));
+  }
+  catch (Reader::Exception const & e)
+  {
+    MYTHROW(ReadException, ("File:", m_filePath, e.Msg()));
+  }
 }
 
-size_t GpsTrackStorage::GetFirstItemIndex() const
+uint64_t GpsTrackStorage::GetFirstItemIndex() const
 {
-  return (m_itemCount > m_maxItemCount) ? (m_itemCount - m_maxItemCount) : 0; // see NOTE in declaration
+  // see NOTE in declaration
+  return max(m_beginItem, m_endItem - min<uint64_t>(m_endItem, m_maxItemCount));
 }
@@ -5,6 +5,7 @@
 #include "base/exception.hpp"
 #include "base/macros.hpp"
 
+#include <cstdint>
 #include <fstream>
 #include <functional>
 #include <string>
@@ -39,26 +40,41 @@ public:
   /// @exceptions ReadException if read fails.
   void ForEach(std::function<bool(TItem const & item)> const & fn);
 
+  /// Reads the storage and calls functor for blocks of at most |maxBlockSize| items
+  /// @param fn - callable function, return false to stop ForEachBlock
+  /// @exceptions ReadException if read fails.
+  void ForEachBlock(size_t maxBlockSize, std::function<bool(std::vector<TItem> const & items)> const & fn);
+
 private:
   DISALLOW_COPY_AND_MOVE(GpsTrackStorage);
 
-  void TruncFile();
-  size_t GetFirstItemIndex() const;
+  bool CreateFile();
+  bool WriteHeader();
+  void WriteItems(TItem const * items, size_t count);
+  void Flush();
+
+  // Calls |fn| for the packed items which are not truncated.
+  // Returns false if |fn| stops the iteration.
+  template <typename Fn>
+  bool ForEachPacked(Fn && fn);
+
+  uint64_t GetFirstItemIndex() const;
+  uint64_t GetCapacity() const { return uint64_t{m_segmentItemCount} * m_segmentsCount; }
 
   std::string const m_filePath;
   size_t const m_maxItemCount;
+  uint32_t const m_segmentItemCount;
+  uint32_t const m_segmentsCount;
   std::fstream m_stream;
-  size_t m_itemCount; // current number of items in file, read note
+  // Items are numbered from the creation of the file, the item with number |i| is stored in
+  // the slot |i| % capacity. Items [m_beginItem, m_endItem) are stored in the file.
+  uint64_t m_beginItem;
+  uint64_t m_endItem;
 
   // NOTE
-  // New items append to the end of file, when file become too big, it is truncated.
-  // Here 'silly window sindrome' is possible: for example max file size is 100k items,
-  // and 99k items are filled, when 2k items is coming, then 98k items is copying to the tmp file
-  // which replaces origin file, and 2k added to the new file. Next time, when 1k items
-  // is comming, then again file truncated. That means that trunc will happens every time.
-  // Similar problem in TCP called 'silly window sindrome'.
-  // To prevent that problem, max file size can be 2 x m_maxItemCount items, when current number of items m_itemCount
-  // exceed 2 x m_maxItemCount, then second half of file - m_maxItemCount items is copying to the tmp file,
-  // which replaces origin file. That means that trunc will happens only then new m_maxItemCount items will be
-  // added but not every time.
+  // The file is a ring of segments which holds the last m_maxItemCount items at least.
+  // Items are appended at the end of the ring, and when the ring is full the oldest segments
+  // are dropped by advancing m_beginItem in the header, so the file is never rewritten.
+  // A new point may be written to the slot of a dropped point only after the header which
+  // drops it is written, so the file is consistent after any interrupted append.
 };
@@ -0,0 +1,81 @@
+#include "map/gps_track_storage.hpp"
+
+#include "platform/location.hpp"
+
+#include "coding/file_writer.hpp"
+
+#include "base/logging.hpp"
+#include "base/timer.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include <gflags/gflags.h>
+
+// This tool is written to measure GpsTrackStorage on long recording sessions: appending of
+// small batches of points with truncation of the oldest points and reloading of the track.
+// To compare storage formats run the tool built from the different revisions. The tool uses only
+// Append and ForEach, which all the storage versions have, so it may be copied to an older revision.
+// For example: gps_track_storage_benchmark -file_path=/tmp/gpstrack.bin -points=1000000
+
+DEFINE_string(file_path, "gps_track_storage_benchmark.bin", "Path to the temporary track file.");
+DEFINE_uint64(max_items, 100000, "Max number of points in the track.");
+DEFINE_uint64(points, 1000000, "Number of points to append.");
+DEFINE_uint64(batch_size, 10, "Number of points in an append.");
+DEFINE_uint64(reloads, 10, "Number of track reloads.");
+
+using namespace std;
+
+int main(int argc, char * argv[])
+{
+  gflags::SetUsageMessage("GpsTrackStorage benchmark.");
+  gflags::ParseCommandLineFlags(&argc, &argv, true);
+
+  if (FLAGS_max_items == 0 || FLAGS_batch_size == 0)
+  {
+    LOG(LERROR, ("max_items and batch_size should be positive."));
+    return -1;
+  }
+
+  FileWriter::DeleteFileX(FLAGS_file_path);
+
+  vector<location::GpsInfo> points(FLAGS_batch_size);
+  double maxAppendS = 0.0;
+  base::Timer timer;
+  {
+    GpsTrackStorage storage(FLAGS_file_path, FLAGS_max_items);
+    for (uint64_t i = 0; i < FLAGS_points; i += points.size())
+    {
+      for (size_t j = 0; j < points.size(); ++j)
+      {
+        points[j].m_timestamp = static_cast<double>(i + j);
+        points[j].m_latitude = 55.0 + (i + j) * 1e-6;
+        points[j].m_longitude = 37.0 + (i + j) * 1e-6;
+      }
+
+      base::Timer appendTimer;
+      storage.Append(points);
+      maxAppendS = max(maxAppendS, appendTimer.ElapsedSeconds());
+    }
+  }
+  LOG(LINFO, ("Appending of", FLAGS_points, "points by", FLAGS_batch_size, "took",
+              timer.ElapsedSeconds(), "seconds, the longest append took", maxAppendS, "seconds."));
+
+  timer.Reset();
+  uint64_t count = 0;
+  for (uint64_t i = 0; i < FLAGS_reloads; ++i)
+  {
+    GpsTrackStorage storage(FLAGS_file_path, FLAGS_max_items);
+    storage.ForEach([&count](location::GpsInfo const &) {
+      ++count;
+      return true;
+    });
+  }
+  LOG(LINFO, (FLAGS_reloads, "reloads of", count, "points by ForEach took", timer.ElapsedSeconds(),
+              "seconds."));
+
+  FileWriter::DeleteFileX(FLAGS_file_path);
+  return 0;
+}
@@ -5,6 +5,8 @@
 #include "platform/platform.hpp"
 
 #include "coding/file_writer.hpp"
+#include "coding/internal/file_data.hpp"
+#include "coding/write_to_sink.hpp"
 
 #include "geometry/latlon.hpp"
 
@@ -13,6 +15,8 @@
 #include "base/scope_guard.hpp"
 
 #include <chrono>
+#include <cstdint>
+#include <cstring>
 #include <string>
 #include <vector>
 
@@ -186,4 +190,133 @@ UNIT_TEST(GpsTrackStorage_WriteReadWithTrunc)
     TEST_EQUAL(i, 0, ());
   }
 }
+
+vector<location::GpsInfo> ReadAll(GpsTrackStorage & stg)
+{
+  vector<location::GpsInfo> points;
+  stg.ForEach([&points](location::GpsInfo const & point)->bool
+  {
+    points.push_back(point);
+    return true;
+  });
+  return points;
+}
+
+void TestEqual(vector<location::GpsInfo> const & points, vector<location::GpsInfo> const & expected)
+{
+  TEST_EQUAL(points.size(), expected.size(), ());
+  for (size_t i = 0; i < points.size(); ++i)
+  {
+    TEST_EQUAL(points[i].m_latitude, expected[i].m_latitude, (i));
+    TEST_EQUAL(points[i].m_longitude, expected[i].m_longitude, (i));
+    TEST_EQUAL(points[i].m_timestamp, expected[i].m_timestamp, (i));
+    TEST_EQUAL(points[i].m_speedMpS, expected[i].m_speedMpS, (i));
+    TEST_EQUAL(points[i].m_source, expected[i].m_source, (i));
+  }
+}
+
+UNIT_TEST(GpsTrackStorage_Ring)
+{
+  string const filePath = GetGpsTrackFilePath();
+  SCOPE_GUARD(gpsTestFileDeleter, bind(FileWriter::DeleteFileX, filePath));
+  FileWriter::DeleteFileX(filePath);
+
+  size_t const fileMaxItemCount = 100;
+
+  vector<location::GpsInfo> points;
+  for (size_t i = 0; i < 20 * fileMaxItemCount; ++i)
+    points.emplace_back(Make(i, ms::LatLon(-90 + i * 0.01, -180 + i * 0.01), i));
+
+  uint64_t maxFileSize = 0;
+  for (size_t begin = 0; begin < points.size();)
+  {
+    // Reopen storage sometimes.
+    GpsTrackStorage stg(filePath, fileMaxItemCount);
+    for (size_t j = 0; j < 10 && begin < points.size(); ++j)
+    {
+      size_t const end = min(points.size(), begin + 7 + j);
+      stg.Append(vector<location::GpsInfo>(points.begin() + begin, points.begin() + end));
+      begin = end;
+
+      size_t const first = end > fileMaxItemCount ? end - fileMaxItemCount : 0;
+      TestEqual(ReadAll(stg), vector<location::GpsInfo>(points.begin() + first, points.begin() + end));
+
+      uint64_t fileSize = 0;
+      TEST(base::GetFileSize(filePath, fileSize), ());
+      maxFileSize = max(maxFileSize, fileSize);
+    }
+  }
+
+  // The file is not growing after the ring is filled.
+  uint64_t fileSize = 0;
+  TEST(base::GetFileSize(filePath, fileSize), ());
+  TEST_EQUAL(fileSize, maxFileSize, ());
+
+  {
+    // Storage keeps the last items when it's opened with other max item count.
+    GpsTrackStorage stg(filePath, fileMaxItemCount / 2);
+    TestEqual(ReadAll(stg), vector<location::GpsInfo>(points.end() - fileMaxItemCount / 2, points.end()));
+
+    size_t blocksCount = 0;
+    vector<location::GpsInfo> blocksPoints;
+    stg.ForEachBlock(7, [&](vector<location::GpsInfo> const & block)->bool
+    {
+      TEST_LESS_OR_EQUAL(block.size(), 7, ());
+      blocksPoints.insert(blocksPoints.end(), block.begin(), block.end());
+      ++blocksCount;
+      return true;
+    });
+    TEST_EQUAL(blocksCount, 8, ());
+    TestEqual(blocksPoints, vector<location::GpsInfo>(points.end() - fileMaxItemCount / 2, points.end()));
+
+    blocksCount = 0;
+    stg.ForEachBlock(7, [&](vector<location::GpsInfo> const &)->bool
+    {
+      ++blocksCount;
+      return false;
+    });
+    TEST_EQUAL(blocksCount, 1, ());
+  }
+}
+
+UNIT_TEST(GpsTrackStorage_MigrateLegacyFile)
+{
+  string const filePath = GetGpsTrackFilePath();
+  SCOPE_GUARD(gpsTestFileDeleter, bind(FileWriter::DeleteFileX, filePath));
+  FileWriter::DeleteFileX(filePath);
+
+  size_t const fileMaxItemCount = 100;
+
+  vector<location::GpsInfo> points;
+  for (size_t i = 0; i < 150; ++i)
+    points.emplace_back(Make(i, ms::LatLon(-90 + i * 0.01, -180 + i * 0.01), i));
+
+  {
+    // Version 1 file, it holds the last items of a file which is twice as large as max item count.
+    FileWriter writer(filePath);
+    WriteToSink(writer, uint32_t{1});
+    for (auto const & point : points)
+    {
+      for (double const value : {point.m_timestamp, point.m_latitude, point.m_longitude, point.m_altitude,
+                                 point.m_speedMpS, point.m_bearing, point.m_horizontalAccuracy,
+                                 point.m_verticalAccuracy})
+      {
+        uint64_t bits;
+        memcpy(&bits, &value, sizeof(bits));
+        WriteToSink(writer, bits);
+      }
+      WriteToSink(writer, static_cast<uint8_t>(point.m_source));
+    }
+  }
+
+  {
+    GpsTrackStorage stg(filePath, fileMaxItemCount);
+    TestEqual(ReadAll(stg), vector<location::GpsInfo>(points.end() - fileMaxItemCount, points.end()));
+  }
+
+  {
+    GpsTrackStorage stg(filePath, fileMaxItemCount);
+    TestEqual(ReadAll(stg), vector<location::GpsInfo>(points.end() - fileMaxItemCount, points.end()));
+  }
+}
 } // namespace gps_track_storage_test
@@ -115,6 +115,7 @@ void TrafficManager::Clear()
   m_activeRoutingMwms.clear();
   m_requestedMwms.clear();
   m_trafficETags.clear();
+  m_trafficInfos.clear();
 }
 
 void TrafficManager::SetDrapeEngine(ref_ptr<df::DrapeEngine> engine)
@@ -236,14 +237,23 @@ void TrafficManager::ThreadRoutine()
       if (!mwm.IsAlive())
         continue;
 
-      traffic::TrafficInfo info(mwm, m_currentDataVersion);
-
+      traffic::TrafficInfo info;
       std::string tag;
       {
         std::lock_guard<std::mutex> lock(m_mutex);
         tag = m_trafficETags[mwm];
+
+        auto const it = m_trafficInfos.find(mwm);
+        if (it != m_trafficInfos.end())
+        {
+          info = std::move(it->second);
+          m_trafficInfos.erase(it);
+        }
       }
 
+      if (!info.GetMwmId().IsAlive())
+        info = traffic::TrafficInfo(mwm, m_currentDataVersion);
+
       if (info.ReceiveTrafficData(tag))
       {
         OnTrafficDataResponse(std::move(info));
@@ -361,6 +371,10 @@ void TrafficManager::OnTrafficRequestFailed(traffic::TrafficInfo && info)
 
 void TrafficManager::OnTrafficDataResponse(traffic::TrafficInfo && info)
 {
+  // The info is kept to apply the next response to its coloring in place, so the drape engine
+  // and the observer get a copy. It's only made when the coloring is changed.
+  bool const isChanged = info.GetChangedSegmentsCount() != 0 && !info.GetColoring().empty();
+  std::optional<traffic::TrafficInfo> changedInfo;
   {
     std::lock_guard<std::mutex> lock(m_mutex);
 
@@ -373,26 +387,32 @@ void TrafficManager::OnTrafficDataResponse(traffic::TrafficInfo && info)
     it->second.m_isWaitingForResponse = false;
     it->second.m_lastAvailability = info.GetAvailability();
 
-    if (!info.GetColoring().empty())
+    if (isChanged)
     {
       // Update cache.
       size_t constexpr kElementSize = sizeof(traffic::TrafficInfo::RoadSegmentId) + sizeof(traffic::SpeedGroup);
       size_t const dataSize = info.GetColoring().size() * kElementSize;
       m_currentCacheSizeBytes += (dataSize - it->second.m_dataSize);
       it->second.m_dataSize = dataSize;
-      ShrinkCacheToAllowableSize();
+      changedInfo = info;
     }
 
+    auto const mwmId = info.GetMwmId();
+    m_trafficInfos[mwmId] = std::move(info);
+
+    if (isChanged)
+      ShrinkCacheToAllowableSize();
+
     UpdateState();
   }
 
-  if (!info.GetColoring().empty())
+  if (changedInfo)
   {
     m_drapeEngine.SafeCall(&df::DrapeEngine::UpdateTraffic,
-                           static_cast<traffic::TrafficInfo const &>(info));
+                           static_cast<traffic::TrafficInfo const &>(*changedInfo));
 
     // Update traffic colors for routing.
-    m_observer.OnTrafficInfoAdded(std::move(info));
+    m_observer.OnTrafficInfoAdded(std::move(*changedInfo));
   }
 }
 
@@ -444,6 +464,7 @@ void TrafficManager::ClearCache(MwmSet::MwmId const & mwmId)
   }
   m_mwmCache.erase(it);
   m_trafficETags.erase(mwmId);
+  m_trafficInfos.erase(mwmId);
   m_activeDrapeMwms.erase(mwmId);
   m_activeRoutingMwms.erase(mwmId);
   m_lastDrapeMwmsByRect.clear();
@@ -180,6 +180,9 @@ private:
   // which allows a client to make conditional requests.
   std::map<MwmSet::MwmId, std::string> m_trafficETags;
 
+  // Traffic of the loaded mwms. It's kept between the requests to update the coloring in place.
+  std::map<MwmSet::MwmId, traffic::TrafficInfo> m_trafficInfos;
+
   std::atomic<bool> m_isPaused;
 
   std::vector<MwmSet::MwmId> m_requestedMwms;
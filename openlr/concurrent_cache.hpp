@@ -0,0 +1,60 @@
+#pragma once
+
+#include "openlr/cache_line_size.hpp"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <shared_mutex>
+#include <unordered_map>
+#include <utility>
+
+namespace openlr
+{
+// Insert-only cache shared by decoding threads. Values are never changed or removed after
+// insertion, so references to them stay valid while the cache is alive. Keys are spread over
+// shards, so lookups of different threads almost never wait for each other.
+template <typename Key, typename Value, typename Hash = std::hash<Key>>
+class ConcurrentCache
+{
+public:
+  // Returns the value of |key|. If there is none it's made by |makeValue| out of any lock.
+  // Threads which make a value of the same key at once get the value of the first one.
+  template <typename MakeValue>
+  Value const & GetOrMake(Key const & key, MakeValue && makeValue)
+  {
+    auto & shard = GetShard(key);
+    {
+      std::shared_lock lock(shard.m_mutex);
+      auto const it = shard.m_values.find(key);
+      if (it != shard.m_values.end())
+        return it->second;
+    }
+
+    Value value = makeValue();
+    std::unique_lock lock(shard.m_mutex);
+    return shard.m_values.try_emplace(key, std::move(value)).first->second;
+  }
+
+private:
+  static size_t constexpr kShardsCount = 64;
+
+  struct alignas(kCacheLineSize) Shard
+  {
+    std::shared_mutex m_mutex;
+    std::unordered_map<Key, Value, Hash> m_values;
+  };
+
+  Shard & GetShard(Key const & key)
+  {
+    // Buckets of the shard maps are chosen by the low bits of the hash too, so the shard is
+    // chosen by the high bits of the mixed hash.
+    uint64_t const h = static_cast<uint64_t>(Hash{}(key)) * 0x9E3779B97F4A7C15ULL;
+    return m_shards[(h >> 32) % kShardsCount];
+  }
+
+  std::array<Shard, kShardsCount> m_shards;
+};
+}  // namespace openlr
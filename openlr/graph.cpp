@@ -3,7 +3,6 @@
 #include "geometry/mercator.hpp"
 #include "geometry/point_with_altitude.hpp"
 
-#include <map>
 #include <memory>
 #include <utility>
 #include <vector>
@@ -20,26 +19,24 @@ using EdgeGetter = void (IRoadGraph::*)(geometry::PointWithAltitude const &,
 
 void GetRegularEdges(geometry::PointWithAltitude const & junction, IRoadGraph const & graph,
                      EdgeGetter const edgeGetter,
-                     Graph::EdgeCacheT & cache,
+                     ConcurrentCache<Graph::Junction, Graph::EdgeListT> & cache,
                      Graph::EdgeListT & edges)
 {
-  auto const it = cache.find(junction);
-  if (it == end(cache))
+  auto const & es = cache.GetOrMake(junction, [&]()
   {
-    auto & es = cache[junction];
-    (graph.*edgeGetter)(junction, es);
-    edges.append(begin(es), end(es));
-  }
-  else
-  {
-    auto const & es = it->second;
-    edges.append(begin(es), end(es));
-  }
+    Graph::EdgeListT res;
+    (graph.*edgeGetter)(junction, res);
+    return res;
+  });
+  edges.append(begin(es), end(es));
 }
 }  // namespace
 
-Graph::Graph(DataSource & dataSource, shared_ptr<CarModelFactory> carModelFactory)
-  : m_dataSource(dataSource, nullptr /* numMwmIDs */), m_graph(m_dataSource, IRoadGraph::Mode::ObeyOnewayTag, carModelFactory)
+Graph::Graph(DataSource & dataSource, shared_ptr<CarModelFactory> carModelFactory,
+             EdgesCache & edgesCache)
+  : m_dataSource(dataSource, nullptr /* numMwmIDs */)
+  , m_graph(m_dataSource, IRoadGraph::Mode::ObeyOnewayTag, carModelFactory)
+  , m_edgesCache(edgesCache)
 {
 }
 
@@ -57,12 +54,14 @@ void Graph::GetIngoingEdges(Junction const & junction, EdgeListT & edges)
 
 void Graph::GetRegularOutgoingEdges(Junction const & junction, EdgeListT & edges)
 {
-  GetRegularEdges(junction, m_graph, &IRoadGraph::GetRegularOutgoingEdges, m_outgoingCache, edges);
+  GetRegularEdges(junction, m_graph, &IRoadGraph::GetRegularOutgoingEdges, m_edgesCache.m_outgoing,
+                  edges);
 }
 
 void Graph::GetRegularIngoingEdges(Junction const & junction, EdgeListT & edges)
 {
-  GetRegularEdges(junction, m_graph, &IRoadGraph::GetRegularIngoingEdges, m_ingoingCache, edges);
+  GetRegularEdges(junction, m_graph, &IRoadGraph::GetRegularIngoingEdges, m_edgesCache.m_ingoing,
+                  edges);
 }
 
 void Graph::FindClosestEdges(m2::PointD const & point, uint32_t const count,
@@ -1,5 +1,7 @@
 #pragma once
 
+#include "openlr/concurrent_cache.hpp"
+
 #include "routing/data_source.hpp"
 #include "routing/features_road_graph.hpp"
 #include "routing/road_graph.hpp"
@@ -11,7 +13,6 @@
 #include "geometry/point2d.hpp"
 
 #include <cstddef>
-#include <map>
 #include <memory>
 #include <string>
 #include <utility>
@@ -28,7 +29,16 @@ public:
   using EdgeVector = routing::FeaturesRoadGraph::EdgeVector;
   using Junction = geometry::PointWithAltitude;
 
-  Graph(DataSource & dataSource, std::shared_ptr<routing::CarModelFactory> carModelFactory);
+  // Regular edges depend on the map data and the car model only, so the cache may be shared by
+  // graphs of different threads which work over the same data source.
+  struct EdgesCache
+  {
+    ConcurrentCache<Junction, EdgeListT> m_outgoing;
+    ConcurrentCache<Junction, EdgeListT> m_ingoing;
+  };
+
+  Graph(DataSource & dataSource, std::shared_ptr<routing::CarModelFactory> carModelFactory,
+        EdgesCache & edgesCache);
 
   // Appends edges such as that edge.GetStartJunction() == junction to the |edges|.
   void GetOutgoingEdges(geometry::PointWithAltitude const & junction, EdgeListT & edges);
@@ -52,10 +62,9 @@ public:
 
   void GetFeatureTypes(FeatureID const & featureId, feature::TypesHolder & types) const;
 
-  using EdgeCacheT = std::map<Junction, EdgeListT>;
 private:
   routing::MwmDataSource m_dataSource;
   routing::FeaturesRoadGraph m_graph;
-  EdgeCacheT m_outgoingCache, m_ingoingCache;
+  EdgesCache & m_edgesCache;
 };
 }  // namespace openlr
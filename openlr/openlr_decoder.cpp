@@ -39,6 +39,7 @@
 #include "base/timer.hpp"
 
 #include <algorithm>
+#include <atomic>
 #include <chrono>
 #include <fstream>
 #include <functional>
@@ -220,8 +221,9 @@ void CopyWithoutOffsets(InputIterator start, InputIterator stop, OutputIterator
 class SegmentsDecoderV2
 {
 public:
-  SegmentsDecoderV2(DataSource & dataSource, unique_ptr<CarModelFactory> cmf)
-    : m_dataSource(dataSource), m_graph(dataSource, std::move(cmf)), m_infoGetter(dataSource)
+  SegmentsDecoderV2(DataSource & dataSource, shared_ptr<CarModelFactory> cmf,
+                    Graph::EdgesCache & edgesCache, RoadInfoGetter & infoGetter)
+    : m_dataSource(dataSource), m_graph(dataSource, std::move(cmf), edgesCache), m_infoGetter(infoGetter)
   {
   }
 
@@ -300,7 +302,7 @@ public:
 private:
   DataSource const & m_dataSource;
   Graph m_graph;
-  RoadInfoGetter m_infoGetter;
+  RoadInfoGetter & m_infoGetter;
 };
 
 // The idea behind the third version of matching algorithm is to collect a lot of candidates (paths)
@@ -309,8 +311,11 @@ private:
 class SegmentsDecoderV3
 {
 public:
-  SegmentsDecoderV3(DataSource & dataSource, unique_ptr<CarModelFactory> carModelFactory)
-      : m_dataSource(dataSource), m_graph(dataSource, std::move(carModelFactory)), m_infoGetter(dataSource)
+  SegmentsDecoderV3(DataSource & dataSource, shared_ptr<CarModelFactory> carModelFactory,
+                    Graph::EdgesCache & edgesCache, RoadInfoGetter & infoGetter)
+      : m_dataSource(dataSource)
+      , m_graph(dataSource, std::move(carModelFactory), edgesCache)
+      , m_infoGetter(infoGetter)
   {
   }
 
@@ -395,7 +400,7 @@ public:
 private:
   DataSource const & m_dataSource;
   Graph m_graph;
-  RoadInfoGetter m_infoGetter;
+  RoadInfoGetter & m_infoGetter;
 };
 
 size_t constexpr GetOptimalBatchSize()
@@ -435,9 +440,9 @@ bool OpenLRDecoder::SegmentsFilter::Matches(LinearSegment const & segment) const
 }
 
 // OpenLRDecoder -----------------------------------------------------------------------------
-OpenLRDecoder::OpenLRDecoder(vector<FrozenDataSource> & dataSources,
+OpenLRDecoder::OpenLRDecoder(DataSource & dataSource,
                              CountryParentNameGetter const & countryParentNameGetter)
-  : m_dataSources(dataSources), m_countryParentNameGetter(countryParentNameGetter)
+  : m_dataSource(dataSource), m_countryParentNameGetter(countryParentNameGetter)
 {
 }
 
@@ -457,16 +462,25 @@ template <typename Decoder, typename Stats>
 void OpenLRDecoder::Decode(vector<LinearSegment> const & segments,
                            uint32_t const numThreads, vector<DecodedPath> & paths)
 {
-  auto const worker = [&](size_t threadNum, DataSource & dataSource, Stats & stat)
-  {
-    size_t constexpr kBatchSize = GetOptimalBatchSize();
-    size_t constexpr kProgressFrequency = 100;
+  size_t constexpr kBatchSize = GetOptimalBatchSize();
+  size_t constexpr kProgressFrequency = 100;
+
+  size_t const numSegments = segments.size();
 
-    size_t const numSegments = segments.size();
+  // All the threads share the data source and the caches, so memory and warm-up time don't
+  // grow with the number of threads. Segments are taken by batches as threads become free,
+  // because decoding time of segments differs a lot.
+  auto const carModelFactory = make_shared<CarModelFactory>(m_countryParentNameGetter);
+  Graph::EdgesCache edgesCache;
+  RoadInfoGetter infoGetter(m_dataSource);
+  atomic<size_t> nextBatch(0);
 
-    Decoder decoder(dataSource, make_unique<CarModelFactory>(m_countryParentNameGetter));
+  auto const worker = [&](size_t threadNum, Stats & stat)
+  {
+    Decoder decoder(m_dataSource, carModelFactory, edgesCache, infoGetter);
     base::Timer timer;
-    for (size_t i = threadNum * kBatchSize; i < numSegments; i += numThreads * kBatchSize)
+    for (size_t i = nextBatch.fetch_add(kBatchSize); i < numSegments;
+         i = nextBatch.fetch_add(kBatchSize))
     {
       for (size_t j = i; j < numSegments && j < i + kBatchSize; ++j)
       {
@@ -474,7 +488,7 @@ void OpenLRDecoder::Decode(vector<LinearSegment> const & segments,
           ++stat.m_routesFailed;
         ++stat.m_routesHandled;
 
-        if (stat.m_routesHandled % kProgressFrequency == 0 || i == segments.size() - 1)
+        if (stat.m_routesHandled % kProgressFrequency == 0 || j == numSegments - 1)
         {
           LOG(LINFO, ("Thread", threadNum, "processed", stat.m_routesHandled,
                       "failed:", stat.m_routesFailed));
@@ -488,9 +502,9 @@ void OpenLRDecoder::Decode(vector<LinearSegment> const & segments,
   vector<Stats> stats(numThreads);
   vector<thread> workers;
   for (size_t i = 1; i < numThreads; ++i)
-    workers.emplace_back(worker, i, ref(m_dataSources[i]), ref(stats[i]));
+    workers.emplace_back(worker, i, ref(stats[i]));
 
-  worker(0 /* threadNum */, m_dataSources[0], stats[0]);
+  worker(0 /* threadNum */, stats[0]);
   for (auto & worker : workers)
     worker.join();
 
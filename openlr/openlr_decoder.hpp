@@ -40,8 +40,8 @@ public:
     bool const m_multipointsOnly;
   };
 
-  OpenLRDecoder(std::vector<FrozenDataSource> & dataSources,
-                CountryParentNameGetter const & countryParentNameGetter);
+  // |dataSource| is shared by all the decoding threads.
+  OpenLRDecoder(DataSource & dataSource, CountryParentNameGetter const & countryParentNameGetter);
 
   // Maps partner segments to mwm paths. |segments| should be sorted by partner id.
   void DecodeV2(std::vector<LinearSegment> const & segments, uint32_t const numThreads,
@@ -55,7 +55,7 @@ private:
   void Decode(std::vector<LinearSegment> const & segments, uint32_t const numThreads,
               std::vector<DecodedPath> & paths);
 
-  std::vector<FrozenDataSource> & m_dataSources;
+  DataSource & m_dataSource;
   CountryParentNameGetter m_countryParentNameGetter;
 };
 }  // namespace openlr
@@ -0,0 +1,68 @@
+#include "testing/testing.hpp"
+
+#include "openlr/concurrent_cache.hpp"
+
+#include <atomic>
+#include <cstddef>
+#include <thread>
+#include <vector>
+
+namespace concurrent_cache_test
+{
+using namespace openlr;
+using namespace std;
+
+UNIT_TEST(ConcurrentCache_Smoke)
+{
+  ConcurrentCache<int, int> cache;
+  TEST_EQUAL(cache.GetOrMake(1, []() { return 10; }), 10, ());
+  // The value is made once.
+  TEST_EQUAL(cache.GetOrMake(1, []() { return 20; }), 10, ());
+  TEST_EQUAL(cache.GetOrMake(2, []() { return 20; }), 20, ());
+}
+
+UNIT_TEST(ConcurrentCache_Threads)
+{
+  size_t constexpr kThreadsCount = 8;
+  int constexpr kKeysCount = 10000;
+
+  ConcurrentCache<int, int> cache;
+  atomic<size_t> madeCount(0);
+  vector<vector<int const *>> values(kThreadsCount);
+
+  auto const worker = [&](size_t threadNum)
+  {
+    for (int i = 0; i < kKeysCount; ++i)
+    {
+      int const key = (i + static_cast<int>(threadNum) * 97) % kKeysCount;
+      auto const & value = cache.GetOrMake(key, [&]()
+      {
+        ++madeCount;
+        return key * 2;
+      });
+      TEST_EQUAL(value, key * 2, ());
+      values[threadNum].push_back(&value);
+    }
+  };
+
+  vector<thread> threads;
+  for (size_t i = 0; i < kThreadsCount; ++i)
+    threads.emplace_back(worker, i);
+  for (auto & t : threads)
+    t.join();
+
+  TEST_GREATER_OR_EQUAL(madeCount.load(), static_cast<size_t>(kKeysCount), ());
+
+  // All the threads get the same value of a key.
+  for (int key = 0; key < kKeysCount; ++key)
+    TEST_EQUAL(cache.GetOrMake(key, []() { return -1; }), key * 2, ());
+  for (size_t t = 1; t < kThreadsCount; ++t)
+  {
+    for (int i = 0; i < kKeysCount; ++i)
+    {
+      int const key = (i + static_cast<int>(t) * 97) % kKeysCount;
+      TEST_EQUAL(values[t][i], values[0][key], ());
+    }
+  }
+}
+}  // namespace concurrent_cache_test
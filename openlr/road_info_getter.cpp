@@ -25,17 +25,12 @@ RoadInfoGetter::RoadInfoGetter(DataSource const & dataSource)
 
 RoadInfoGetter::RoadInfo RoadInfoGetter::Get(FeatureID const & fid)
 {
-  auto it = m_cache.find(fid);
-  if (it != end(m_cache))
-    return it->second;
-
-  FeaturesLoaderGuard g(m_dataSource, fid.m_mwmId);
-  auto ft = g.GetOriginalFeatureByIndex(fid.m_index);
-  CHECK(ft, ());
-
-  RoadInfo info(*ft);
-  it = m_cache.emplace(fid, info).first;
-
-  return it->second;
+  return m_cache.GetOrMake(fid, [&]()
+  {
+    FeaturesLoaderGuard g(m_dataSource, fid.m_mwmId);
+    auto ft = g.GetOriginalFeatureByIndex(fid.m_index);
+    CHECK(ft, ());
+    return RoadInfo(*ft);
+  });
 }
 }  // namespace openlr
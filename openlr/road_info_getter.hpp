@@ -1,12 +1,12 @@
 #pragma once
 
+#include "openlr/concurrent_cache.hpp"
 #include "openlr/openlr_model.hpp"
 
 #include "indexer/feature_data.hpp"
+#include "indexer/feature_decl.hpp"
 #include "indexer/ftypes_matcher.hpp"
 
-#include <map>
-
 class Classificator;
 class DataSource;
 
@@ -17,6 +17,7 @@ class TypesHolder;
 
 namespace openlr
 {
+// Thread-safe, so one getter may be shared by all the decoding threads.
 class RoadInfoGetter final
 {
 public:
@@ -37,6 +38,6 @@ public:
  private:
 
   DataSource const & m_dataSource;
-  std::map<FeatureID, RoadInfo> m_cache;
+  ConcurrentCache<FeatureID, RoadInfo> m_cache;
 };
 }  // namespace openlr
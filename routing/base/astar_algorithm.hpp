@@ -1,6 +1,7 @@
 #pragma once
 
 #include "routing/base/astar_graph.hpp"
+#include "routing/base/astar_queue.hpp"
 #include "routing/base/astar_vertex_data.hpp"
 #include "routing/base/astar_weight.hpp"
 #include "routing/base/routing_result.hpp"
@@ -14,7 +15,6 @@
 #include <iostream>
 #include <map>
 #include <optional>
-#include <queue>
 #include <type_traits>
 #include <utility>
 #include <vector>
@@ -37,7 +37,9 @@ struct DefaultLengthChecker
 };
 }  // namespace astar
 
-template <typename Vertex, typename Edge, typename Weight>
+// |QueuePolicy| chooses the priority queue of the waves, see astar_queue.hpp.
+template <typename Vertex, typename Edge, typename Weight,
+          typename QueuePolicy = astar::DefaultQueuePolicy>
 class AStarAlgorithm
 {
 public:
@@ -225,7 +227,7 @@ public:
   // Adjust route to the previous one.
   // Expects |params.m_checkLengthCallback| to check wave propagation limit.
   template <typename P>
-  typename AStarAlgorithm<Vertex, Edge, Weight>::Result AdjustRoute(P & params,
+  typename AStarAlgorithm<Vertex, Edge, Weight, QueuePolicy>::Result AdjustRoute(P & params,
                                                                     std::vector<Edge> const & prevRoute,
                                                                     RoutingResult<Vertex, Weight> & result) const;
 
@@ -274,6 +276,8 @@ private:
   // BidirectionalStepContext keeps all the information that is needed to
   // search starting from one of the two directions. Its main
   // purpose is to make the code that changes directions more readable.
+  using Queue = typename QueuePolicy::template Queue<State, Vertex>;
+
   struct BidirectionalStepContext
   {
     using Parents = typename Graph::Parents;
@@ -297,8 +301,8 @@ private:
 
     Weight TopDistance() const
     {
-      ASSERT(!queue.empty(), ());
-      return bestDistance.at(queue.top().vertex);
+      ASSERT(!queue.Empty(), ());
+      return bestDistance.at(queue.Top().vertex);
     }
 
     // p_f(v) = 0.5*(π_f(v) - π_r(v))
@@ -375,7 +379,7 @@ private:
     Vertex const & finalVertex;
     Graph & graph;
 
-    std::priority_queue<State, std::vector<State>, std::greater<State>> queue;
+    Queue queue;
     ska::bytell_hash_map<Vertex, Weight> bestDistance;
     Parents parent;
     Vertex bestVertex;
@@ -392,36 +396,36 @@ private:
       typename BidirectionalStepContext::Parents const & parentW, std::vector<Vertex> & path);
 };
 
-template <typename Vertex, typename Edge, typename Weight>
-constexpr Weight AStarAlgorithm<Vertex, Edge, Weight>::kInfiniteDistance;
-template <typename Vertex, typename Edge, typename Weight>
-constexpr Weight AStarAlgorithm<Vertex, Edge, Weight>::kZeroDistance;
+template <typename Vertex, typename Edge, typename Weight, typename QueuePolicy>
+constexpr Weight AStarAlgorithm<Vertex, Edge, Weight, QueuePolicy>::kInfiniteDistance;
+template <typename Vertex, typename Edge, typename Weight, typename QueuePolicy>
+constexpr Weight AStarAlgorithm<Vertex, Edge, Weight, QueuePolicy>::kZeroDistance;
 
-template <typename Vertex, typename Edge, typename Weight>
+template <typename Vertex, typename Edge, typename Weight, typename QueuePolicy>
 template <typename VisitVertex, typename AdjustEdgeWeight, typename FilterStates, typename ReducedToFullLength>
-void AStarAlgorithm<Vertex, Edge, Weight>::PropagateWave(
+void AStarAlgorithm<Vertex, Edge, Weight, QueuePolicy>::PropagateWave(
     Graph & graph, Vertex const & startVertex,
     VisitVertex && visitVertex,
     AdjustEdgeWeight && adjustEdgeWeight,
     FilterStates && filterStates,
     ReducedToFullLength && reducedToFullLength,
-    AStarAlgorithm<Vertex, Edge, Weight>::Context & context) const
+    AStarAlgorithm<Vertex, Edge, Weight, QueuePolicy>::Context & context) const
 {
   auto const epsilon = graph.GetAStarWeightEpsilon();
 
   context.Clear();
 
-  std::priority_queue<State, std::vector<State>, std::greater<State>> queue;
+  Queue queue;
 
   context.SetDistance(startVertex, kZeroDistance);
-  queue.push(State(startVertex, kZeroDistance));
+  queue.Push(State(startVertex, kZeroDistance));
 
   typename Graph::EdgeListT adj;
 
-  while (!queue.empty())
+  while (!queue.Empty())
   {
-    State const stateV = queue.top();
-    queue.pop();
+    State const stateV = queue.Top();
+    queue.Pop();
 
     if (stateV.distance > context.GetDistance(stateV.vertex))
       continue;
@@ -450,16 +454,16 @@ void AStarAlgorithm<Vertex, Edge, Weight>::PropagateWave(
 
       context.SetDistance(stateW.vertex, newReducedDist);
       context.SetParent(stateW.vertex, stateV.vertex);
-      queue.push(stateW);
+      queue.Push(stateW);
     }
   }
 }
 
-template <typename Vertex, typename Edge, typename Weight>
+template <typename Vertex, typename Edge, typename Weight, typename QueuePolicy>
 template <typename VisitVertex>
-void AStarAlgorithm<Vertex, Edge, Weight>::PropagateWave(
+void AStarAlgorithm<Vertex, Edge, Weight, QueuePolicy>::PropagateWave(
     Graph & graph, Vertex const & startVertex, VisitVertex && visitVertex,
-    AStarAlgorithm<Vertex, Edge, Weight>::Context & context) const
+    AStarAlgorithm<Vertex, Edge, Weight, QueuePolicy>::Context & context) const
 {
   auto const adjustEdgeWeight = [](Vertex const & /* vertex */, Edge const & edge) {
     return edge.GetWeight();
@@ -486,10 +490,10 @@ void AStarAlgorithm<Vertex, Edge, Weight>::PropagateWave(
 // http://research.microsoft.com/pubs/154937/soda05.pdf
 // http://www.cs.princeton.edu/courses/archive/spr06/cos423/Handouts/EPP%20shortest%20path%20algorithms.pdf
 
-template <typename Vertex, typename Edge, typename Weight>
+template <typename Vertex, typename Edge, typename Weight, typename QueuePolicy>
 template <typename P>
-typename AStarAlgorithm<Vertex, Edge, Weight>::Result
-AStarAlgorithm<Vertex, Edge, Weight>::FindPath(P & params, RoutingResult<Vertex, Weight> & result) const
+typename AStarAlgorithm<Vertex, Edge, Weight, QueuePolicy>::Result
+AStarAlgorithm<Vertex, Edge, Weight, QueuePolicy>::FindPath(P & params, RoutingResult<Vertex, Weight> & result) const
 {
   auto const epsilon = params.m_weightEpsilon;
 
@@ -568,10 +572,10 @@ AStarAlgorithm<Vertex, Edge, Weight>::FindPath(P & params, RoutingResult<Vertex,
   return resultCode;
 }
 
-template <typename Vertex, typename Edge, typename Weight>
+template <typename Vertex, typename Edge, typename Weight, typename QueuePolicy>
 template <class P, class Emitter>
-typename AStarAlgorithm<Vertex, Edge, Weight>::Result
-AStarAlgorithm<Vertex, Edge, Weight>::FindPathBidirectionalEx(P & params, Emitter && emitter) const
+typename AStarAlgorithm<Vertex, Edge, Weight, QueuePolicy>::Result
+AStarAlgorithm<Vertex, Edge, Weight, QueuePolicy>::FindPathBidirectionalEx(P & params, Emitter && emitter) const
 {
   auto const epsilon = params.m_weightEpsilon;
   auto & graph = params.m_graph;
@@ -589,10 +593,10 @@ AStarAlgorithm<Vertex, Edge, Weight>::FindPathBidirectionalEx(P & params, Emitte
   Weight bestPathRealLength = kZeroDistance;
 
   forward.UpdateDistance(State(startVertex, kZeroDistance));
-  forward.queue.push(State(startVertex, kZeroDistance, forward.ConsistentHeuristic(startVertex)));
+  forward.queue.Push(State(startVertex, kZeroDistance, forward.ConsistentHeuristic(startVertex)));
 
   backward.UpdateDistance(State(finalVertex, kZeroDistance));
-  backward.queue.push(State(finalVertex, kZeroDistance, backward.ConsistentHeuristic(finalVertex)));
+  backward.queue.Push(State(finalVertex, kZeroDistance, backward.ConsistentHeuristic(finalVertex)));
 
   // To use the search code both for backward and forward directions
   // we keep the pointers to everything related to the search in the
@@ -624,7 +628,7 @@ AStarAlgorithm<Vertex, Edge, Weight>::FindPathBidirectionalEx(P & params, Emitte
   uint32_t steps = 0;
   PeriodicPollCancellable periodicCancellable(params.m_cancellable);
 
-  while (!cur->queue.empty() && !nxt->queue.empty())
+  while (!cur->queue.Empty() && !nxt->queue.Empty())
   {
     ++steps;
 
@@ -659,8 +663,8 @@ AStarAlgorithm<Vertex, Edge, Weight>::FindPathBidirectionalEx(P & params, Emitte
       }
     }
 
-    State const stateV = cur->queue.top();
-    cur->queue.pop();
+    State const stateV = cur->queue.Top();
+    cur->queue.Pop();
 
     if (cur->ExistsStateWithBetterDistance(stateV))
       continue;
@@ -724,7 +728,7 @@ AStarAlgorithm<Vertex, Edge, Weight>::FindPathBidirectionalEx(P & params, Emitte
       }
 
       if (stateW.vertex != endV)
-        cur->queue.push(stateW);
+        cur->queue.Push(stateW);
     }
   }
 
@@ -737,10 +741,10 @@ AStarAlgorithm<Vertex, Edge, Weight>::FindPathBidirectionalEx(P & params, Emitte
   return Result::NoPath;
 }
 
-template <typename Vertex, typename Edge, typename Weight>
+template <typename Vertex, typename Edge, typename Weight, typename QueuePolicy>
 template <typename P>
-typename AStarAlgorithm<Vertex, Edge, Weight>::Result
-AStarAlgorithm<Vertex, Edge, Weight>::AdjustRoute(P & params,
+typename AStarAlgorithm<Vertex, Edge, Weight, QueuePolicy>::Result
+AStarAlgorithm<Vertex, Edge, Weight, QueuePolicy>::AdjustRoute(P & params,
                                                   std::vector<Edge> const & prevRoute,
                                                   RoutingResult<Vertex, Weight> & result) const
 {
@@ -834,8 +838,8 @@ AStarAlgorithm<Vertex, Edge, Weight>::AdjustRoute(P & params,
 }
 
 // static
-template <typename Vertex, typename Edge, typename Weight>
-void AStarAlgorithm<Vertex, Edge, Weight>::ReconstructPath(
+template <typename Vertex, typename Edge, typename Weight, typename QueuePolicy>
+void AStarAlgorithm<Vertex, Edge, Weight, QueuePolicy>::ReconstructPath(
     Vertex const & v, typename BidirectionalStepContext::Parents const & parent,
     std::vector<Vertex> & path)
 {
@@ -854,8 +858,8 @@ void AStarAlgorithm<Vertex, Edge, Weight>::ReconstructPath(
 }
 
 // static
-template <typename Vertex, typename Edge, typename Weight>
-void AStarAlgorithm<Vertex, Edge, Weight>::ReconstructPathBidirectional(
+template <typename Vertex, typename Edge, typename Weight, typename QueuePolicy>
+void AStarAlgorithm<Vertex, Edge, Weight, QueuePolicy>::ReconstructPathBidirectional(
     Vertex const & v, Vertex const & w, typename BidirectionalStepContext::Parents const & parentV,
     typename BidirectionalStepContext::Parents const & parentW, std::vector<Vertex> & path)
 {
@@ -869,11 +873,11 @@ void AStarAlgorithm<Vertex, Edge, Weight>::ReconstructPathBidirectional(
   path.insert(path.end(), pathW.rbegin(), pathW.rend());
 }
 
-template <typename Vertex, typename Edge, typename Weight>
+template <typename Vertex, typename Edge, typename Weight, typename QueuePolicy>
 void
-AStarAlgorithm<Vertex, Edge, Weight>::Context::ReconstructPath(Vertex const & v,
+AStarAlgorithm<Vertex, Edge, Weight, QueuePolicy>::Context::ReconstructPath(Vertex const & v,
                                                                std::vector<Vertex> & path) const
 {
-  AStarAlgorithm<Vertex, Edge, Weight>::ReconstructPath(v, m_parents, path);
+  AStarAlgorithm<Vertex, Edge, Weight, QueuePolicy>::ReconstructPath(v, m_parents, path);
 }
 }  // namespace routing
@@ -0,0 +1,164 @@
+#pragma once
+
+#include "base/assert.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <functional>
+#include <queue>
+#include <utility>
+#include <vector>
+
+#include "3party/skarupke/bytell_hash_map.hpp"
+
+namespace routing
+{
+namespace astar
+{
+// Priority queues of AStarAlgorithm states. A state has public |vertex| field and
+// operator> which compares states by distance.
+
+// Binary heap with lazy deletion: every relaxation pushes a new state and the algorithm
+// skips stale states when they are popped.
+template <typename State, typename Vertex>
+class LazyQueue
+{
+public:
+  void Push(State const & state) { m_queue.push(state); }
+  State const & Top() const { return m_queue.top(); }
+  void Pop() { m_queue.pop(); }
+  bool Empty() const { return m_queue.empty(); }
+  size_t Size() const { return m_queue.size(); }
+
+private:
+  std::priority_queue<State, std::vector<State>, std::greater<State>> m_queue;
+};
+
+// D-ary heap with decrease-key: it keeps at most one state for every vertex and a push of
+// a better state for the vertex updates the state in place.
+template <typename State, typename Vertex, size_t kArity = 4>
+class IndexedHeap
+{
+public:
+  static_assert(kArity >= 2, "");
+
+  void Push(State const & state)
+  {
+    auto const it = m_positions.find(state.vertex);
+    if (it == m_positions.end())
+    {
+      m_heap.push_back(state);
+      m_positions.emplace(state.vertex, m_heap.size() - 1);
+      SiftUp(m_heap.size() - 1);
+      return;
+    }
+
+    size_t const pos = it->second;
+    if (!(m_heap[pos] > state))
+      return;
+
+    m_heap[pos] = state;
+    SiftUp(pos);
+  }
+
+  State const & Top() const
+  {
+    ASSERT(!m_heap.empty(), ());
+    return m_heap.front();
+  }
+
+  void Pop()
+  {
+    ASSERT(!m_heap.empty(), ());
+    m_positions.erase(m_heap.front().vertex);
+    if (m_heap.size() > 1)
+    {
+      m_heap.front() = std::move(m_heap.back());
+      m_heap.pop_back();
+      m_positions[m_heap.front().vertex] = 0;
+      SiftDown(0);
+    }
+    else
+    {
+      m_heap.pop_back();
+    }
+  }
+
+  bool Empty() const { return m_heap.empty(); }
+  size_t Size() const { return m_heap.size(); }
+
+private:
+  void SiftUp(size_t pos)
+  {
+    State state = std::move(m_heap[pos]);
+    while (pos != 0)
+    {
+      size_t const parent = (pos - 1) / kArity;
+      if (!(m_heap[parent] > state))
+        break;
+
+      Place(pos, std::move(m_heap[parent]));
+      pos = parent;
+    }
+    Place(pos, std::move(state));
+  }
+
+  void SiftDown(size_t pos)
+  {
+    State state = std::move(m_heap[pos]);
+    size_t const size = m_heap.size();
+    while (true)
+    {
+      size_t const first = pos * kArity + 1;
+      if (first >= size)
+        break;
+
+      size_t best = first;
+      size_t const last = std::min(first + kArity, size);
+      for (size_t child = first + 1; child < last; ++child)
+      {
+        if (m_heap[best] > m_heap[child])
+          best = child;
+      }
+
+      if (!(state > m_heap[best]))
+        break;
+
+      Place(pos, std::move(m_heap[best]));
+      pos = best;
+    }
+    Place(pos, std::move(state));
+  }
+
+  void Place(size_t pos, State && state)
+  {
+    m_positions[state.vertex] = pos;
+    m_heap[pos] = std::move(state);
+  }
+
+  std::vector<State> m_heap;
+  ska::bytell_hash_map<Vertex, size_t> m_positions;
+};
+
+// Queue policies of AStarAlgorithm.
+struct LazyQueuePolicy
+{
+  template <typename State, typename Vertex>
+  using Queue = LazyQueue<State, Vertex>;
+};
+
+struct IndexedHeapPolicy
+{
+  template <typename State, typename Vertex>
+  using Queue = IndexedHeap<State, Vertex>;
+};
+
+// The policy is chosen at build time with ASTAR_QUEUE cmake option to compare them with
+// tools/python/routing/run_heap_comparison_benchmark.py.
+#ifdef ASTAR_QUEUE_INDEXED_HEAP
+using DefaultQueuePolicy = IndexedHeapPolicy;
+#else
+using DefaultQueuePolicy = LazyQueuePolicy;
+#endif
+}  // namespace astar
+}  // namespace routing
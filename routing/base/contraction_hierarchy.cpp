@@ -0,0 +1,419 @@
+#include "routing/base/contraction_hierarchy.hpp"
+
+#include "base/logging.hpp"
+#include "base/timer.hpp"
+
+#include <algorithm>
+#include <functional>
+#include <queue>
+#include <unordered_map>
+#include <utility>
+
+namespace routing
+{
+namespace
+{
+double constexpr kInf = std::numeric_limits<double>::max();
+
+// Witness search stops after this number of settled vertices. Smaller values make the
+// preprocessing faster at the price of some redundant shortcuts.
+size_t constexpr kMaxWitnessSettled = 500;
+}  // namespace
+
+// ContractionHierarchy::Builder -------------------------------------------------------------------
+class ContractionHierarchy::Builder
+{
+public:
+  Builder(uint32_t numVertices, std::vector<Edge> const & edges)
+    : m_out(numVertices)
+    , m_in(numVertices)
+    , m_contractedNeighbours(numVertices, 0)
+    , m_witnessWeights(numVertices, kInf)
+  {
+    for (auto const & edge : edges)
+    {
+      CHECK_LESS(edge.m_from, numVertices, ());
+      CHECK_LESS(edge.m_to, numVertices, ());
+      CHECK_GREATER_OR_EQUAL(edge.m_weight, 0.0, ());
+      // Loops never make a path shorter.
+      if (edge.m_from != edge.m_to)
+        AddEdge(edge.m_from, edge.m_to, kInvalidVertex, edge.m_weight);
+    }
+  }
+
+  ContractionHierarchy Build()
+  {
+    uint32_t const numVertices = base::asserted_cast<uint32_t>(m_out.size());
+    std::vector<std::vector<Arc>> up(numVertices);
+    std::vector<std::vector<Arc>> down(numVertices);
+
+    using QueueEntry = std::pair<int64_t, Vertex>;
+    std::priority_queue<QueueEntry, std::vector<QueueEntry>, std::greater<QueueEntry>> queue;
+    for (Vertex v = 0; v < numVertices; ++v)
+      queue.emplace(GetPriority(v), v);
+
+    uint32_t numContracted = 0;
+    std::vector<Shortcut> shortcuts;
+    while (!queue.empty())
+    {
+      Vertex const v = queue.top().second;
+      queue.pop();
+
+      // Priorities of the vertices are updated lazily: |v| is contracted only if it is
+      // still not more important than the next vertex in the queue.
+      auto const priority = GetPriority(v);
+      if (!queue.empty() && priority > queue.top().first)
+      {
+        queue.emplace(priority, v);
+        continue;
+      }
+
+      shortcuts.clear();
+      CollectShortcuts(v, shortcuts);
+      Contract(v);
+      for (auto const & s : shortcuts)
+        AddEdge(s.m_from, s.m_to, v, s.m_weight);
+
+      // All remaining neighbours of |v| are contracted later, so they have higher ranks.
+      up[v] = std::move(m_out[v]);
+      down[v] = std::move(m_in[v]);
+      m_out[v] = {};
+      m_in[v] = {};
+
+      ++numContracted;
+      if (numContracted % 100000 == 0)
+        LOG(LINFO, ("Contracted", numContracted, "/", numVertices, "vertices"));
+    }
+
+    ContractionHierarchy ch;
+    ch.m_upOffsets.reserve(numVertices + 1);
+    ch.m_downOffsets.reserve(numVertices + 1);
+    ch.m_upOffsets.push_back(0);
+    ch.m_downOffsets.push_back(0);
+    for (Vertex v = 0; v < numVertices; ++v)
+    {
+      ch.m_up.insert(ch.m_up.end(), up[v].begin(), up[v].end());
+      ch.m_down.insert(ch.m_down.end(), down[v].begin(), down[v].end());
+      ch.m_upOffsets.push_back(base::asserted_cast<uint32_t>(ch.m_up.size()));
+      ch.m_downOffsets.push_back(base::asserted_cast<uint32_t>(ch.m_down.size()));
+    }
+    return ch;
+  }
+
+private:
+  struct Shortcut
+  {
+    Vertex m_from;
+    Vertex m_to;
+    double m_weight;
+  };
+
+  static void AddArc(std::vector<Arc> & arcs, Vertex vertex, Vertex middle, double weight)
+  {
+    auto const it = std::find_if(arcs.begin(), arcs.end(),
+                                 [vertex](Arc const & arc) { return arc.m_vertex == vertex; });
+    if (it == arcs.end())
+    {
+      arcs.emplace_back(vertex, middle, weight);
+    }
+    else if (weight < it->m_weight)
+    {
+      it->m_middle = middle;
+      it->m_weight = weight;
+    }
+  }
+
+  static void RemoveArc(std::vector<Arc> & arcs, Vertex vertex)
+  {
+    auto const it = std::find_if(arcs.begin(), arcs.end(),
+                                 [vertex](Arc const & arc) { return arc.m_vertex == vertex; });
+    if (it != arcs.end())
+    {
+      *it = arcs.back();
+      arcs.pop_back();
+    }
+  }
+
+  void AddEdge(Vertex from, Vertex to, Vertex middle, double weight)
+  {
+    AddArc(m_out[from], to, middle, weight);
+    AddArc(m_in[to], from, middle, weight);
+  }
+
+  void Contract(Vertex v)
+  {
+    for (auto const & arc : m_out[v])
+    {
+      RemoveArc(m_in[arc.m_vertex], v);
+      ++m_contractedNeighbours[arc.m_vertex];
+    }
+    for (auto const & arc : m_in[v])
+    {
+      RemoveArc(m_out[arc.m_vertex], v);
+      ++m_contractedNeighbours[arc.m_vertex];
+    }
+  }
+
+  // Runs Dijkstra from |source| over not contracted vertices except |excluded| and fills
+  // |m_witnessWeights| for settled and reached vertices.
+  void RunWitnessSearch(Vertex source, Vertex excluded, double maxWeight)
+  {
+    for (auto const v : m_touched)
+      m_witnessWeights[v] = kInf;
+    m_touched.clear();
+
+    using QueueEntry = std::pair<double, Vertex>;
+    std::priority_queue<QueueEntry, std::vector<QueueEntry>, std::greater<QueueEntry>> queue;
+    m_witnessWeights[source] = 0.0;
+    m_touched.push_back(source);
+    queue.emplace(0.0, source);
+
+    size_t settled = 0;
+    while (!queue.empty() && settled < kMaxWitnessSettled)
+    {
+      auto const [weight, v] = queue.top();
+      queue.pop();
+      if (weight > m_witnessWeights[v])
+        continue;
+      if (weight > maxWeight)
+        break;
+
+      ++settled;
+      for (auto const & arc : m_out[v])
+      {
+        if (arc.m_vertex == excluded)
+          continue;
+
+        double const newWeight = weight + arc.m_weight;
+        auto & current = m_witnessWeights[arc.m_vertex];
+        if (newWeight < current)
+        {
+          if (current == kInf)
+            m_touched.push_back(arc.m_vertex);
+          current = newWeight;
+          queue.emplace(newWeight, arc.m_vertex);
+        }
+      }
+    }
+  }
+
+  // Fills |shortcuts| needed to keep shortest paths when |v| is contracted.
+  void CollectShortcuts(Vertex v, std::vector<Shortcut> & shortcuts)
+  {
+    for (auto const & in : m_in[v])
+    {
+      double maxWeight = 0.0;
+      for (auto const & out : m_out[v])
+      {
+        if (out.m_vertex != in.m_vertex)
+          maxWeight = std::max(maxWeight, in.m_weight + out.m_weight);
+      }
+
+      RunWitnessSearch(in.m_vertex, v, maxWeight);
+
+      for (auto const & out : m_out[v])
+      {
+        if (out.m_vertex == in.m_vertex)
+          continue;
+
+        double const weight = in.m_weight + out.m_weight;
+        if (m_witnessWeights[out.m_vertex] > weight)
+          shortcuts.push_back({in.m_vertex, out.m_vertex, weight});
+      }
+    }
+  }
+
+  // The vertices which add less shortcuts than they remove edges are contracted first.
+  // The number of contracted neighbours spreads contraction uniformly over the graph.
+  int64_t GetPriority(Vertex v)
+  {
+    std::vector<Shortcut> shortcuts;
+    CollectShortcuts(v, shortcuts);
+    return static_cast<int64_t>(shortcuts.size()) - static_cast<int64_t>(m_out[v].size()) -
+           static_cast<int64_t>(m_in[v].size()) + m_contractedNeighbours[v];
+  }
+
+  std::vector<std::vector<Arc>> m_out;
+  std::vector<std::vector<Arc>> m_in;
+  std::vector<uint32_t> m_contractedNeighbours;
+
+  std::vector<double> m_witnessWeights;
+  std::vector<Vertex> m_touched;
+};
+
+// ContractionHierarchy ----------------------------------------------------------------------------
+// static
+ContractionHierarchy ContractionHierarchy::Build(uint32_t numVertices, std::vector<Edge> const & edges)
+{
+  base::Timer timer;
+  auto ch = Builder(numVertices, edges).Build();
+  LOG(LINFO, ("Contraction hierarchy of", numVertices, "vertices and", edges.size(),
+              "edges is built in", timer.ElapsedSeconds(), "seconds,", ch.GetNumArcs(), "arcs"));
+  return ch;
+}
+
+std::optional<double> ContractionHierarchy::FindPath(std::vector<Terminal> const & sources,
+                                                     std::vector<Terminal> const & targets,
+                                                     std::vector<Vertex> & path) const
+{
+  path.clear();
+  if (sources.empty() || targets.empty())
+    return {};
+
+  struct Label
+  {
+    double m_weight = kInf;
+    Vertex m_parent = kInvalidVertex;
+    Vertex m_middle = kInvalidVertex;
+  };
+
+  using QueueEntry = std::pair<double, Vertex>;
+  using Queue = std::priority_queue<QueueEntry, std::vector<QueueEntry>, std::greater<QueueEntry>>;
+
+  struct Wave
+  {
+    std::unordered_map<Vertex, Label> m_labels;
+    Queue m_queue;
+    // Added to the weights of all terminals to make them non-negative. Then a wave may stop
+    // as soon as its weights reach the best found path weight.
+    double m_shift = 0.0;
+  };
+
+  auto const initWave = [this](std::vector<Terminal> const & terminals, Wave & wave)
+  {
+    double minWeight = 0.0;
+    for (auto const & t : terminals)
+      minWeight = std::min(minWeight, t.m_weight);
+    wave.m_shift = -minWeight;
+
+    for (auto const & t : terminals)
+    {
+      CHECK_LESS(t.m_vertex, GetNumVertices(), ());
+      auto & label = wave.m_labels[t.m_vertex];
+      double const weight = t.m_weight + wave.m_shift;
+      if (weight < label.m_weight)
+      {
+        label.m_weight = weight;
+        wave.m_queue.emplace(weight, t.m_vertex);
+      }
+    }
+  };
+
+  Wave forward;
+  Wave backward;
+  initWave(sources, forward);
+  initWave(targets, backward);
+
+  double best = kInf;
+  Vertex meeting = kInvalidVertex;
+
+  auto const updateBest = [&](Vertex v, double weight, Wave const & other)
+  {
+    auto const it = other.m_labels.find(v);
+    if (it != other.m_labels.cend() && weight + it->second.m_weight < best)
+    {
+      best = weight + it->second.m_weight;
+      meeting = v;
+    }
+  };
+
+  for (auto const & [v, label] : forward.m_labels)
+    updateBest(v, label.m_weight, backward);
+
+  // Settles one vertex of |wave|. Returns false when the wave is over.
+  auto const step = [&](Wave & wave, Wave const & other, bool isForward)
+  {
+    while (!wave.m_queue.empty())
+    {
+      auto const [weight, v] = wave.m_queue.top();
+      if (weight >= best)
+        return false;
+
+      wave.m_queue.pop();
+      if (weight > wave.m_labels[v].m_weight)
+        continue;
+
+      auto const & arcs = isForward ? m_up : m_down;
+      auto const & offsets = isForward ? m_upOffsets : m_downOffsets;
+      for (uint32_t i = offsets[v]; i < offsets[v + 1]; ++i)
+      {
+        auto const & arc = arcs[i];
+        double const newWeight = weight + arc.m_weight;
+        auto & label = wave.m_labels[arc.m_vertex];
+        if (newWeight < label.m_weight)
+        {
+          label = {newWeight, v, arc.m_middle};
+          wave.m_queue.emplace(newWeight, arc.m_vertex);
+          updateBest(arc.m_vertex, newWeight, other);
+        }
+      }
+      return true;
+    }
+    return false;
+  };
+
+  bool forwardActive = true;
+  bool backwardActive = true;
+  while (forwardActive || backwardActive)
+  {
+    if (forwardActive)
+      forwardActive = step(forward, backward, true /* isForward */);
+    if (backwardActive)
+      backwardActive = step(backward, forward, false /* isForward */);
+  }
+
+  if (meeting == kInvalidVertex)
+    return {};
+
+  // Arcs from a source to |meeting|.
+  std::vector<std::pair<Vertex, Vertex>> forwardArcs;
+  for (Vertex v = meeting; forward.m_labels[v].m_parent != kInvalidVertex;
+       v = forward.m_labels[v].m_parent)
+  {
+    forwardArcs.emplace_back(v, forward.m_labels[v].m_middle);
+  }
+
+  Vertex const source = forwardArcs.empty() ? meeting
+                                            : forward.m_labels[forwardArcs.back().first].m_parent;
+  path.push_back(source);
+  for (auto it = forwardArcs.rbegin(); it != forwardArcs.rend(); ++it)
+    UnpackArc(forward.m_labels[it->first].m_parent, it->first, it->second, path);
+
+  for (Vertex v = meeting; backward.m_labels[v].m_parent != kInvalidVertex;
+       v = backward.m_labels[v].m_parent)
+  {
+    auto const & label = backward.m_labels[v];
+    UnpackArc(v, label.m_parent, label.m_middle, path);
+  }
+
+  return best - forward.m_shift - backward.m_shift;
+}
+
+void ContractionHierarchy::UnpackArc(Vertex from, Vertex to, Vertex middle,
+                                     std::vector<Vertex> & path) const
+{
+  if (middle == kInvalidVertex)
+  {
+    path.push_back(to);
+    return;
+  }
+
+  // |middle| is contracted before |from| and |to|, so |from| -> |middle| is a down arc and
+  // |middle| -> |to| is an up arc of |middle|.
+  auto const findMiddle = [](std::vector<Arc> const & arcs, uint32_t begin, uint32_t end,
+                             Vertex vertex)
+  {
+    for (uint32_t i = begin; i < end; ++i)
+    {
+      if (arcs[i].m_vertex == vertex)
+        return arcs[i].m_middle;
+    }
+    CHECK(false, ("Broken shortcut to", vertex));
+    return kInvalidVertex;
+  };
+
+  UnpackArc(from, middle,
+            findMiddle(m_down, m_downOffsets[middle], m_downOffsets[middle + 1], from), path);
+  UnpackArc(middle, to, findMiddle(m_up, m_upOffsets[middle], m_upOffsets[middle + 1], to), path);
+}
+}  // namespace routing
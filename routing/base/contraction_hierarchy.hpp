@@ -0,0 +1,161 @@
+#pragma once
+
+#include "coding/varint.hpp"
+#include "coding/write_to_sink.hpp"
+
+#include "base/assert.hpp"
+#include "base/checked_cast.hpp"
+
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <optional>
+#include <vector>
+
+namespace routing
+{
+// Contraction hierarchy over a directed graph with non-negative edge weights.
+//
+// Vertices are contracted one by one from the least important ones, and every contraction
+// adds shortcuts between the remaining neighbours of the vertex when the path through it
+// is the only shortest one. The order of contraction is the rank of a vertex. A query runs
+// two Dijkstra waves (forward from sources and backward from targets) which only go up
+// by rank, so they settle a tiny part of the graph.
+class ContractionHierarchy
+{
+public:
+  using Vertex = uint32_t;
+
+  static Vertex constexpr kInvalidVertex = std::numeric_limits<Vertex>::max();
+
+  struct Edge
+  {
+    Edge() = default;
+    Edge(Vertex from, Vertex to, double weight) : m_from(from), m_to(to), m_weight(weight) {}
+
+    Vertex m_from = kInvalidVertex;
+    Vertex m_to = kInvalidVertex;
+    double m_weight = 0.0;
+  };
+
+  // A source or a target of a query. |m_weight| is the weight of the path from the query
+  // start to the source or from the target to the query finish. It may be negative.
+  struct Terminal
+  {
+    Terminal() = default;
+    Terminal(Vertex vertex, double weight) : m_vertex(vertex), m_weight(weight) {}
+
+    Vertex m_vertex = kInvalidVertex;
+    double m_weight = 0.0;
+  };
+
+  ContractionHierarchy() = default;
+
+  // Contracts the graph of |numVertices| vertices and |edges|.
+  static ContractionHierarchy Build(uint32_t numVertices, std::vector<Edge> const & edges);
+
+  // Finds the shortest path from one of |sources| to one of |targets| and returns its
+  // weight, including the weights of the terminals. |path| is filled with all the vertices
+  // of the path, shortcuts are unpacked. Returns std::nullopt if there is no path.
+  std::optional<double> FindPath(std::vector<Terminal> const & sources,
+                                 std::vector<Terminal> const & targets,
+                                 std::vector<Vertex> & path) const;
+
+  uint32_t GetNumVertices() const
+  {
+    return m_upOffsets.empty() ? 0 : base::asserted_cast<uint32_t>(m_upOffsets.size() - 1);
+  }
+
+  size_t GetNumArcs() const { return m_up.size() + m_down.size(); }
+
+  template <typename Sink>
+  void Serialize(Sink & sink) const
+  {
+    uint32_t const numVertices = GetNumVertices();
+    WriteVarUint(sink, numVertices);
+    for (Vertex v = 0; v < numVertices; ++v)
+    {
+      SerializeArcs(sink, m_up, m_upOffsets[v], m_upOffsets[v + 1]);
+      SerializeArcs(sink, m_down, m_downOffsets[v], m_downOffsets[v + 1]);
+    }
+  }
+
+  template <typename Source>
+  void Deserialize(Source & src)
+  {
+    auto const numVertices = ReadVarUint<uint32_t>(src);
+    m_upOffsets.assign(1, 0);
+    m_downOffsets.assign(1, 0);
+    m_upOffsets.reserve(numVertices + 1);
+    m_downOffsets.reserve(numVertices + 1);
+    m_up.clear();
+    m_down.clear();
+    for (Vertex v = 0; v < numVertices; ++v)
+    {
+      DeserializeArcs(src, m_up, m_upOffsets);
+      DeserializeArcs(src, m_down, m_downOffsets);
+    }
+  }
+
+private:
+  // Weights are stored in the hundredths of their units.
+  static double constexpr kWeightScale = 100.0;
+
+  struct Arc
+  {
+    Arc() = default;
+    Arc(Vertex vertex, Vertex middle, double weight)
+      : m_vertex(vertex), m_middle(middle), m_weight(weight)
+    {
+    }
+
+    // The other end of the arc.
+    Vertex m_vertex = kInvalidVertex;
+    // The contracted vertex the shortcut goes through or kInvalidVertex for an original edge.
+    Vertex m_middle = kInvalidVertex;
+    double m_weight = 0.0;
+  };
+
+  class Builder;
+
+  template <typename Sink>
+  static void SerializeArcs(Sink & sink, std::vector<Arc> const & arcs, uint32_t begin, uint32_t end)
+  {
+    WriteVarUint(sink, end - begin);
+    for (uint32_t i = begin; i < end; ++i)
+    {
+      auto const & arc = arcs[i];
+      WriteVarUint(sink, arc.m_vertex);
+      // 0 is reserved for original edges.
+      WriteVarUint(sink, arc.m_middle == kInvalidVertex ? 0 : arc.m_middle + 1);
+      WriteVarUint(sink, static_cast<uint64_t>(std::llround(arc.m_weight * kWeightScale)));
+    }
+  }
+
+  template <typename Source>
+  static void DeserializeArcs(Source & src, std::vector<Arc> & arcs, std::vector<uint32_t> & offsets)
+  {
+    auto const count = ReadVarUint<uint32_t>(src);
+    for (uint32_t i = 0; i < count; ++i)
+    {
+      auto const vertex = ReadVarUint<uint32_t>(src);
+      auto const middle = ReadVarUint<uint32_t>(src);
+      auto const weight = ReadVarUint<uint64_t>(src);
+      arcs.emplace_back(vertex, middle == 0 ? kInvalidVertex : middle - 1,
+                        static_cast<double>(weight) / kWeightScale);
+    }
+    offsets.push_back(base::asserted_cast<uint32_t>(arcs.size()));
+  }
+
+  // Appends vertices of the arc |from| -> |to| to |path| except |from|.
+  void UnpackArc(Vertex from, Vertex to, Vertex middle, std::vector<Vertex> & path) const;
+
+  // m_up[m_upOffsets[v]..m_upOffsets[v + 1]) are arcs from v to vertices of higher rank.
+  std::vector<uint32_t> m_upOffsets;
+  std::vector<Arc> m_up;
+  // m_down[m_downOffsets[v]..m_downOffsets[v + 1]) are arcs to v from vertices of higher rank,
+  // |m_vertex| of such arc is its start.
+  std::vector<uint32_t> m_downOffsets;
+  std::vector<Arc> m_down;
+};
+}  // namespace routing
@@ -608,6 +608,25 @@ public:
     });
   }
 
+  /// \param weights Matrix of weights with GetNumEnters() * GetNumExits() size, indexed by
+  /// ConnectorT::GetWeightIndex(enterIdx, exitIdx). connector::kNoRoute means no route.
+  void FillWeightsFromMatrix(std::vector<double> const & weights)
+  {
+    CHECK(m_vehicleType != VehicleType::Count, ("PrepareConnector should be called"));
+    CHECK_EQUAL(weights.size(), size_t(m_connector.GetNumEnters()) * m_connector.GetNumExits(), ());
+
+    m_weights.reserve(weights.size());
+    for (size_t i = 0; i < weights.size(); ++i)
+    {
+      auto const w = weights[i];
+      CHECK_LESS(w, std::numeric_limits<Weight>::max(), ());
+
+      // Edges weights should be >= astar heuristic, so use std::ceil.
+      if (w != connector::kNoRoute)
+        m_weights.emplace_back(base::asserted_cast<uint32_t>(i), static_cast<Weight>(std::ceil(w)));
+    }
+  }
+
   /// Used in tests only.
   void SetAndWriteWeights(std::vector<IdxWeightT> && weights, std::vector<uint8_t> & buffer)
   {
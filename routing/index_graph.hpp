@@ -83,6 +83,9 @@ public:
     return m_roadAccess.GetAccessWithoutConditional(segment.GetFeatureId()).first;
   }
 
+  RoadAccess const & GetRoadAccess() const { return m_roadAccess; }
+  RoutingOptions GetAvoidRoutingOptions() const { return m_avoidRoutingOptions; }
+
   uint32_t GetNumRoads() const { return m_roadIndex.GetSize(); }
   uint32_t GetNumJoints() const { return m_jointIndex.GetNumJoints(); }
   uint32_t GetNumPoints() const { return m_jointIndex.GetNumPoints(); }
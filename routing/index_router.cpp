@@ -17,6 +17,7 @@
 #include "routing/route.hpp"
 #include "routing/routing_helpers.hpp"
 #include "routing/routing_options.hpp"
+#include "routing/routing_shortcuts.hpp"
 #include "routing/single_vehicle_world_graph.hpp"
 #include "routing/speed_camera_prohibition.hpp"
 #include "routing/traffic_stash.hpp"
@@ -51,6 +52,7 @@
 #include <deque>
 #include <iterator>
 #include <map>
+#include <queue>
 
 namespace routing
 {
@@ -191,6 +193,57 @@ bool IsDeadEndCached(Segment const & segment, bool isOutgoing, bool useRoutingOp
 
   return false;
 }
+
+// Collects real segments which are reachable from the start (|isOutgoing|) or from which
+// the finish is reachable (!|isOutgoing|) by fake segments only, with the weights of the routes
+// between them and the ending. |parents| is filled with the links of these routes.
+// Returns false if the other ending is reachable by fake segments.
+bool CollectRealEndings(IndexGraphStarter & starter, bool isOutgoing,
+                        vector<pair<Segment, RouteWeight>> & realEndings,
+                        map<Segment, Segment> & parents)
+{
+  Segment const from = isOutgoing ? starter.GetStartSegment() : starter.GetFinishSegment();
+  Segment const other = isOutgoing ? starter.GetFinishSegment() : starter.GetStartSegment();
+
+  using QueueItem = pair<RouteWeight, Segment>;
+  priority_queue<QueueItem, vector<QueueItem>, greater<QueueItem>> queue;
+  map<Segment, RouteWeight> weights;
+  weights.emplace(from, GetAStarWeightZero<RouteWeight>());
+  queue.emplace(GetAStarWeightZero<RouteWeight>(), from);
+
+  IndexGraphStarter::EdgeListT edges;
+  while (!queue.empty())
+  {
+    auto const [weight, segment] = queue.top();
+    queue.pop();
+    if (weight > weights[segment])
+      continue;
+
+    if (segment == other)
+      return false;
+
+    if (!IndexGraphStarter::IsFakeSegment(segment))
+    {
+      realEndings.emplace_back(segment, weight);
+      continue;
+    }
+
+    starter.GetEdgesList(segment, isOutgoing, edges);
+    for (auto const & edge : edges)
+    {
+      RouteWeight const newWeight = weight + edge.GetWeight();
+      auto const it = weights.find(edge.GetTarget());
+      if (it != weights.cend() && it->second <= newWeight)
+        continue;
+
+      weights[edge.GetTarget()] = newWeight;
+      parents[edge.GetTarget()] = segment;
+      queue.emplace(newWeight, edge.GetTarget());
+    }
+  }
+
+  return true;
+}
 }  // namespace
 
 
@@ -715,6 +768,8 @@ RouterResultCode IndexRouter::CalculateSubroute(Checkpoints const & checkpoints,
   switch (mode)
   {
   case WorldGraphMode::Joints:
+    if (!guidesActive && CalculateSubrouteShortcutsMode(starter, subroute))
+      return RouterResultCode::NoError;
     return CalculateSubrouteJointsMode(starter, delegate, progress, subroute);
   case WorldGraphMode::NoLeaps:
     return CalculateSubrouteNoLeapsMode(starter, delegate, progress, subroute);
@@ -756,6 +811,101 @@ RouterResultCode IndexRouter::CalculateSubrouteJointsMode(
   return result;
 }
 
+bool IndexRouter::CalculateSubrouteShortcutsMode(IndexGraphStarter & starter,
+                                                 vector<Segment> & subroute)
+{
+  if (m_vehicleType != VehicleType::Car || starter.IsRegionsGraphMode())
+    return false;
+
+  set<NumMwmId> const mwmIds = starter.GetMwms();
+  if (mwmIds.size() != 1)
+    return false;
+
+  // Routing shortcuts are built without traffic and avoid routing options.
+  NumMwmId const mwmId = *mwmIds.begin();
+  if (m_trafficStash && m_trafficStash->Has(mwmId))
+    return false;
+
+  RoutingShortcuts const * shortcuts = GetRoutingShortcuts(mwmId);
+  if (!shortcuts)
+    return false;
+
+  // Avoid routing options are read from the settings once per route in MakeWorldGraph().
+  IndexGraph const & indexGraph = starter.GetGraph().GetIndexGraph(mwmId);
+  if (indexGraph.GetAvoidRoutingOptions().GetOptions() != 0)
+    return false;
+
+  vector<pair<Segment, RouteWeight>> starts;
+  vector<pair<Segment, RouteWeight>> finishes;
+  map<Segment, Segment> startParents;
+  map<Segment, Segment> finishParents;
+  if (!CollectRealEndings(starter, true /* isOutgoing */, starts, startParents) ||
+      !CollectRealEndings(starter, false /* isOutgoing */, finishes, finishParents))
+  {
+    return false;
+  }
+
+  vector<Segment> route;
+  auto const weight = shortcuts->FindRoute(indexGraph, mwmId, starts, finishes, route);
+  if (!weight || !starter.CheckLength(*weight))
+    return false;
+
+  LOG(LINFO, ("Route is found with routing shortcuts, weight:", *weight));
+
+  for (auto it = startParents.find(route.front()); it != startParents.cend();
+       it = startParents.find(it->second))
+  {
+    subroute.push_back(it->second);
+  }
+  reverse(subroute.begin(), subroute.end());
+  subroute.insert(subroute.end(), route.cbegin(), route.cend());
+  for (auto it = finishParents.find(route.back()); it != finishParents.cend();
+       it = finishParents.find(it->second))
+  {
+    subroute.push_back(it->second);
+  }
+
+  return true;
+}
+
+RoutingShortcuts const * IndexRouter::GetRoutingShortcuts(NumMwmId numMwmId)
+{
+  if (m_dataSource.GetSectionStatus(numMwmId, ROUTING_SHORTCUTS_FILE_TAG) !=
+      MwmDataSource::SectionExists)
+  {
+    return nullptr;
+  }
+
+  // The section is cached between routes, so a changed mwm has to be reloaded.
+  auto const & handle = m_dataSource.GetHandle(numMwmId);
+  auto const it = m_routingShortcuts.find(numMwmId);
+  if (it != m_routingShortcuts.cend() && it->second.first == handle.GetId())
+    return it->second.second.get();
+
+  if (m_routingShortcuts.size() >= kMaxRoutingShortcutsCacheSize)
+    m_routingShortcuts.clear();
+
+  auto shortcuts = make_unique<RoutingShortcuts>();
+  try
+  {
+    auto const reader = handle.GetValue()->m_cont.GetReader(ROUTING_SHORTCUTS_FILE_TAG);
+    ReaderSource src(reader);
+    shortcuts->Deserialize(src);
+  }
+  catch (Reader::Exception const & e)
+  {
+    LOG(LERROR, ("Error while reading", ROUTING_SHORTCUTS_FILE_TAG, "section.", e.Msg()));
+    shortcuts.reset();
+  }
+
+  if (shortcuts && shortcuts->IsEmpty())
+    shortcuts.reset();
+
+  auto & entry = m_routingShortcuts[numMwmId];
+  entry = make_pair(handle.GetId(), std::move(shortcuts));
+  return entry.second.get();
+}
+
 RouterResultCode IndexRouter::CalculateSubrouteNoLeapsMode(
     IndexGraphStarter & starter, RouterDelegate const & delegate,
     shared_ptr<AStarProgress> const & progress, vector<Segment> & subroute)
@@ -14,6 +14,7 @@
 #include "routing/regions_decl.hpp"
 #include "routing/router.hpp"
 #include "routing/routing_callbacks.hpp"
+#include "routing/routing_shortcuts.hpp"
 #include "routing/segment.hpp"
 #include "routing/segmented_route.hpp"
 
@@ -26,6 +27,7 @@
 #include "geometry/tree4d.hpp"
 
 #include <functional>
+#include <map>
 #include <memory>
 #include <set>
 #include <string>
@@ -94,6 +96,11 @@ private:
                                                RouterDelegate const & delegate,
                                                std::shared_ptr<AStarProgress> const & progress,
                                                std::vector<Segment> & subroute);
+  // Tries to find the route within a single mwm with the preprocessed routing shortcuts.
+  // Returns false if the shortcuts can't be used for |starter|.
+  bool CalculateSubrouteShortcutsMode(IndexGraphStarter & starter, std::vector<Segment> & subroute);
+  // Returns nullptr if there are no routing shortcuts in the mwm.
+  RoutingShortcuts const * GetRoutingShortcuts(NumMwmId numMwmId);
   RouterResultCode CalculateSubrouteNoLeapsMode(IndexGraphStarter & starter,
                                                 RouterDelegate const & delegate,
                                                 std::shared_ptr<AStarProgress> const & progress,
@@ -287,6 +294,11 @@ private:
   std::unique_ptr<SegmentedRoute> m_lastRoute;
   std::unique_ptr<FakeEdgesContainer> m_lastFakeEdges;
 
+  // Routing shortcuts of recently used mwms. Each one is kept with the id of the mwm file
+  // it was loaded from.
+  static size_t constexpr kMaxRoutingShortcutsCacheSize = 2;
+  std::map<NumMwmId, std::pair<MwmSet::MwmId, std::unique_ptr<RoutingShortcuts>>> m_routingShortcuts;
+
   // If a ckeckpoint is near to the guide track we need to build route through this track.
   GuidesConnections m_guides;
 
@@ -815,13 +815,11 @@ void RoutingSession::OnTrafficInfoClear()
 
 void RoutingSession::OnTrafficInfoAdded(TrafficInfo && info)
 {
-  TrafficInfo::Coloring const & fullColoring = info.GetColoring();
-  auto coloring = std::make_shared<TrafficInfo::Coloring>();
-  for (auto const & kv : fullColoring)
-  {
+  auto coloring = std::make_shared<TrafficInfo::Coloring>(info.GetColoring());
+#ifdef DEBUG
+  for (auto const & kv : *coloring)
     ASSERT_NOT_EQUAL(kv.second, SpeedGroup::Unknown, ());
-    coloring->insert(kv);
-  }
+#endif
 
   // Note. |coloring| should not be used after this call on gui thread.
   auto const mwmId = info.GetMwmId();
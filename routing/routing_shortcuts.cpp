@@ -0,0 +1,296 @@
+#include "routing/routing_shortcuts.hpp"
+
+#include "routing/road_access.hpp"
+
+#include "base/stl_helpers.hpp"
+#include "base/timer.hpp"
+
+#include <algorithm>
+#include <unordered_map>
+
+namespace routing
+{
+namespace
+{
+// Segments of a single mwm graph are compared without mwm id, so any real id works here.
+NumMwmId constexpr kBuildMwmId = 0;
+
+// Returns the weight of the turn from |from| to |to| (|to| included) or std::nullopt
+// if |to| can't be reached from |from| directly.
+std::optional<RouteWeight> GetTransitionWeight(IndexGraph const & graph, Segment const & from,
+                                               Segment const & to,
+                                               IndexGraph::Parents<Segment> const & parents = {})
+{
+  IndexGraph::SegmentEdgeListT edges;
+  graph.GetEdgeList(from, true /* isOutgoing */, false /* useRoutingOptions */, edges, parents);
+  for (auto const & edge : edges)
+  {
+    Segment const & target = edge.GetTarget();
+    if (target.GetFeatureId() == to.GetFeatureId() && target.GetSegmentIdx() == to.GetSegmentIdx() &&
+        target.IsForward() == to.IsForward())
+    {
+      return edge.GetWeight();
+    }
+  }
+  return {};
+}
+
+// Returns the weight of the part of |span| after |segment| or std::nullopt if the span
+// can't be passed through.
+std::optional<double> GetTailWeight(IndexGraph const & graph, RoutingShortcuts::Span const & span,
+                                    Segment segment)
+{
+  Segment const last = span.GetLastSegment(segment.GetMwmId());
+  double weight = 0.0;
+  while (segment != last)
+  {
+    Segment next = segment;
+    next.Next(span.m_forward);
+    auto const step = GetTransitionWeight(graph, segment, next);
+    if (!step)
+      return {};
+
+    weight += step->GetIntegratedWeight();
+    segment = next;
+  }
+  return weight;
+}
+
+bool HasConditionalAccess(RoadAccess const & roadAccess, Segment const & segment)
+{
+  auto const & wayToAccess = roadAccess.GetWayToAccessConditional();
+  if (wayToAccess.find(segment.GetFeatureId()) != wayToAccess.cend())
+    return true;
+
+  auto const & pointToAccess = roadAccess.GetPointToAccessConditional();
+  return pointToAccess.find(segment.GetRoadPoint(false /* front */)) != pointToAccess.cend() ||
+         pointToAccess.find(segment.GetRoadPoint(true /* front */)) != pointToAccess.cend();
+}
+}  // namespace
+
+// RoutingShortcuts::Span --------------------------------------------------------------------------
+Segment RoutingShortcuts::Span::GetFirstSegment(NumMwmId mwmId) const
+{
+  return {mwmId, m_featureId, m_forward ? m_lowPointId : m_highPointId - 1, m_forward};
+}
+
+Segment RoutingShortcuts::Span::GetLastSegment(NumMwmId mwmId) const
+{
+  return {mwmId, m_featureId, m_forward ? m_highPointId - 1 : m_lowPointId, m_forward};
+}
+
+// RoutingShortcuts --------------------------------------------------------------------------------
+// static
+RoutingShortcuts RoutingShortcuts::Build(IndexGraph const & graph)
+{
+  base::Timer timer;
+
+  std::vector<uint32_t> featureIds;
+  graph.ForEachRoad([&featureIds](uint32_t featureId, RoadJointIds const & /* roadJoints */) {
+    featureIds.push_back(featureId);
+  });
+  std::sort(featureIds.begin(), featureIds.end());
+
+  RoutingShortcuts shortcuts;
+  std::vector<uint32_t> breakPoints;
+  for (uint32_t const featureId : featureIds)
+  {
+    // Geometry may be evicted from the cache by the next call, so copy what is needed.
+    RoadGeometry const & road = graph.GetRoadGeometry(featureId);
+    if (!road.IsValid() || road.GetPointsCount() < 2)
+      continue;
+
+    uint32_t const pointsCount = road.GetPointsCount();
+    bool const isOneWay = road.IsOneWay();
+
+    breakPoints.assign({0, pointsCount - 1});
+    graph.GetRoad(featureId).ForEachJoint([&](uint32_t pointId, Joint::Id /* jointId */) {
+      if (pointId < pointsCount)
+        breakPoints.push_back(pointId);
+    });
+    base::SortUnique(breakPoints);
+
+    for (size_t i = 1; i < breakPoints.size(); ++i)
+    {
+      if (!isOneWay)
+        shortcuts.m_spans.emplace_back(featureId, breakPoints[i - 1], breakPoints[i], false /* forward */);
+      shortcuts.m_spans.emplace_back(featureId, breakPoints[i - 1], breakPoints[i], true /* forward */);
+    }
+  }
+  ASSERT(std::is_sorted(shortcuts.m_spans.cbegin(), shortcuts.m_spans.cend()), ());
+
+  auto const numSpans = base::asserted_cast<uint32_t>(shortcuts.m_spans.size());
+
+  // Weights of the segments of the spans, std::nullopt for spans which can't be passed through.
+  std::vector<std::optional<double>> spanWeights(numSpans);
+  for (Vertex v = 0; v < numSpans; ++v)
+  {
+    auto const & span = shortcuts.m_spans[v];
+    auto const first = span.GetFirstSegment(kBuildMwmId);
+    spanWeights[v] = GetTailWeight(graph, span, first);
+  }
+
+  std::vector<ContractionHierarchy::Edge> edges;
+  IndexGraph::SegmentEdgeListT segmentEdges;
+  for (Vertex from = 0; from < numSpans; ++from)
+  {
+    if (!spanWeights[from])
+      continue;
+
+    segmentEdges.clear();
+    graph.GetEdgeList(shortcuts.m_spans[from].GetLastSegment(kBuildMwmId), true /* isOutgoing */,
+                      false /* useRoutingOptions */, segmentEdges);
+    for (auto const & edge : segmentEdges)
+    {
+      Vertex const to = shortcuts.FindSpan(edge.GetTarget());
+      if (to == ContractionHierarchy::kInvalidVertex || !spanWeights[to])
+        continue;
+
+      // A span may be entered through its first segment only.
+      if (edge.GetTarget() != shortcuts.m_spans[to].GetFirstSegment(kBuildMwmId))
+        continue;
+
+      edges.emplace_back(from, to, edge.GetWeight().GetIntegratedWeight() + *spanWeights[to]);
+    }
+  }
+
+  LOG(LINFO, ("Routing shortcuts graph:", numSpans, "spans,", edges.size(), "edges, prepared in",
+              timer.ElapsedSeconds(), "seconds."));
+
+  shortcuts.m_hierarchy = ContractionHierarchy::Build(numSpans, edges);
+  return shortcuts;
+}
+
+std::optional<RouteWeight> RoutingShortcuts::FindRoute(
+    IndexGraph const & graph, NumMwmId mwmId,
+    std::vector<std::pair<Segment, RouteWeight>> const & starts,
+    std::vector<std::pair<Segment, RouteWeight>> const & finishes,
+    std::vector<Segment> & route) const
+{
+  route.clear();
+  if (IsEmpty())
+    return {};
+
+  // Every terminal keeps the ending with the best weight within its span.
+  struct Ending
+  {
+    Segment m_segment;
+    RouteWeight m_weight;
+    double m_terminalWeight = 0.0;
+  };
+
+  auto const collect = [&](std::vector<std::pair<Segment, RouteWeight>> const & endings, bool isStart,
+                           std::unordered_map<Vertex, Ending> & result) {
+    for (auto const & [segment, weight] : endings)
+    {
+      Vertex const v = FindSpan(segment);
+      if (v == ContractionHierarchy::kInvalidVertex)
+        continue;
+
+      auto const tail = GetTailWeight(graph, m_spans[v], segment);
+      if (!tail)
+        continue;
+
+      double const terminalWeight =
+          isStart ? weight.GetIntegratedWeight() + *tail : weight.GetIntegratedWeight() - *tail;
+      auto const it = result.find(v);
+      if (it == result.cend() || terminalWeight < it->second.m_terminalWeight)
+        result[v] = {segment, weight, terminalWeight};
+    }
+  };
+
+  std::unordered_map<Vertex, Ending> sourceEndings;
+  std::unordered_map<Vertex, Ending> targetEndings;
+  collect(starts, true /* isStart */, sourceEndings);
+  collect(finishes, false /* isStart */, targetEndings);
+  if (sourceEndings.empty() || targetEndings.empty())
+    return {};
+
+  std::vector<ContractionHierarchy::Terminal> sources;
+  for (auto const & [v, ending] : sourceEndings)
+  {
+    // The route within a single span is left to the usual search.
+    if (targetEndings.count(v) != 0)
+      return {};
+    sources.emplace_back(v, ending.m_terminalWeight);
+  }
+
+  std::vector<ContractionHierarchy::Terminal> targets;
+  for (auto const & [v, ending] : targetEndings)
+    targets.emplace_back(v, ending.m_terminalWeight);
+
+  std::vector<Vertex> path;
+  if (!m_hierarchy.FindPath(sources, targets, path))
+    return {};
+
+  CHECK_GREATER_OR_EQUAL(path.size(), 2, ());
+  Ending const & source = sourceEndings.at(path.front());
+  Ending const & target = targetEndings.at(path.back());
+
+  for (size_t i = 0; i < path.size(); ++i)
+  {
+    auto const & span = m_spans[path[i]];
+    Segment segment = i == 0 ? source.m_segment : span.GetFirstSegment(mwmId);
+    Segment const last = i + 1 == path.size() ? target.m_segment : span.GetLastSegment(mwmId);
+    route.push_back(segment);
+    while (segment != last)
+    {
+      segment.Next(span.m_forward);
+      route.push_back(segment);
+    }
+  }
+
+  // The hierarchy doesn't know about restrictions via several features and conditional
+  // access, so the route is checked against the index graph.
+  auto const & roadAccess = graph.GetRoadAccess();
+  IndexGraph::Parents<Segment> parents;
+  RouteWeight weight = source.m_weight;
+  for (size_t i = 0; i < route.size(); ++i)
+  {
+    if (HasConditionalAccess(roadAccess, route[i]))
+    {
+      route.clear();
+      return {};
+    }
+
+    if (i == 0)
+      continue;
+
+    auto const step = GetTransitionWeight(graph, route[i - 1], route[i], parents);
+    if (!step)
+    {
+      route.clear();
+      return {};
+    }
+
+    weight += *step;
+    parents[route[i]] = route[i - 1];
+  }
+
+  return weight + target.m_weight;
+}
+
+RoutingShortcuts::Vertex RoutingShortcuts::FindSpan(Segment const & segment) const
+{
+  uint32_t const featureId = segment.GetFeatureId();
+  uint32_t const segmentIdx = segment.GetSegmentIdx();
+
+  // Spans of the same direction don't intersect, so the span of |segment| is one of
+  // the two last spans which start not later than |segment|.
+  auto it = std::upper_bound(m_spans.cbegin(), m_spans.cend(),
+                             Span(featureId, segmentIdx, segmentIdx + 1, true /* forward */));
+  for (size_t i = 0; i < 2 && it != m_spans.cbegin(); ++i)
+  {
+    --it;
+    if (it->m_featureId != featureId)
+      break;
+
+    if (it->m_forward == segment.IsForward() && it->m_lowPointId <= segmentIdx &&
+        segmentIdx < it->m_highPointId)
+    {
+      return base::asserted_cast<Vertex>(std::distance(m_spans.cbegin(), it));
+    }
+  }
+  return ContractionHierarchy::kInvalidVertex;
+}
+}  // namespace routing
@@ -0,0 +1,150 @@
+#pragma once
+
+#include "routing/base/contraction_hierarchy.hpp"
+
+#include "routing/index_graph.hpp"
+#include "routing/route_weight.hpp"
+#include "routing/segment.hpp"
+
+#include "routing_common/num_mwm_id.hpp"
+
+#include "coding/reader.hpp"
+#include "coding/varint.hpp"
+#include "coding/write_to_sink.hpp"
+
+#include "base/assert.hpp"
+#include "base/checked_cast.hpp"
+#include "base/logging.hpp"
+
+#include <cstdint>
+#include <optional>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+namespace routing
+{
+// Contraction hierarchy preprocessed over the road graph of a single mwm.
+//
+// Vertices of the hierarchy are spans: directed parts of a road between two consecutive
+// joints (or road ends). A span is entered only through its first segment and left only
+// through its last one, so an edge between two spans is a turn of the index graph and turn
+// restrictions and u-turn penalties are kept by the hierarchy. The weight of the edge A -> B
+// is the weight of the turn from A to B plus the weights of all the segments of B.
+//
+// The hierarchy is built with the car model, routing options and conditional access are not
+// taken into account, so callers have to skip it in such cases.
+class RoutingShortcuts
+{
+public:
+  using Vertex = ContractionHierarchy::Vertex;
+
+  struct Span
+  {
+    Span() = default;
+    Span(uint32_t featureId, uint32_t lowPointId, uint32_t highPointId, bool forward)
+      : m_featureId(featureId), m_lowPointId(lowPointId), m_highPointId(highPointId), m_forward(forward)
+    {
+    }
+
+    bool operator<(Span const & rhs) const
+    {
+      return std::tie(m_featureId, m_lowPointId, m_forward) <
+             std::tie(rhs.m_featureId, rhs.m_lowPointId, rhs.m_forward);
+    }
+
+    bool operator==(Span const & rhs) const
+    {
+      return m_featureId == rhs.m_featureId && m_lowPointId == rhs.m_lowPointId &&
+             m_highPointId == rhs.m_highPointId && m_forward == rhs.m_forward;
+    }
+
+    Segment GetFirstSegment(NumMwmId mwmId) const;
+    Segment GetLastSegment(NumMwmId mwmId) const;
+
+    uint32_t m_featureId = 0;
+    uint32_t m_lowPointId = 0;
+    uint32_t m_highPointId = 0;
+    bool m_forward = true;
+  };
+
+  static uint16_t constexpr kLatestVersion = 0;
+
+  RoutingShortcuts() = default;
+
+  // Builds the hierarchy over all the roads of |graph|.
+  static RoutingShortcuts Build(IndexGraph const & graph);
+
+  // Finds the shortest route between one of |starts| and one of |finishes|.
+  // |starts| are real segments with the weights of the routes from the start to them
+  // (the segment included), |finishes| are real segments with the weights of the routes
+  // from them to the finish (the segment excluded). Fills |route| with the segments of
+  // the route and returns its weight including the weights of the start and the finish.
+  // Returns std::nullopt when the route can't be found with the hierarchy or the found
+  // route is not valid in |graph|, the caller should fall back to the usual search then.
+  std::optional<RouteWeight> FindRoute(IndexGraph const & graph, NumMwmId mwmId,
+                                       std::vector<std::pair<Segment, RouteWeight>> const & starts,
+                                       std::vector<std::pair<Segment, RouteWeight>> const & finishes,
+                                       std::vector<Segment> & route) const;
+
+  bool IsEmpty() const { return m_spans.empty(); }
+  size_t GetNumSpans() const { return m_spans.size(); }
+  ContractionHierarchy const & GetHierarchy() const { return m_hierarchy; }
+
+  template <typename Sink>
+  void Serialize(Sink & sink) const
+  {
+    WriteToSink(sink, kLatestVersion);
+    WriteVarUint(sink, base::asserted_cast<uint32_t>(m_spans.size()));
+
+    uint32_t prevFeatureId = 0;
+    for (auto const & span : m_spans)
+    {
+      CHECK_GREATER_OR_EQUAL(span.m_featureId, prevFeatureId, ());
+      WriteVarUint(sink, span.m_featureId - prevFeatureId);
+      WriteVarUint(sink, span.m_lowPointId);
+      WriteVarUint(sink, span.m_highPointId - span.m_lowPointId);
+      WriteToSink(sink, static_cast<uint8_t>(span.m_forward ? 1 : 0));
+      prevFeatureId = span.m_featureId;
+    }
+
+    m_hierarchy.Serialize(sink);
+  }
+
+  template <typename Source>
+  void Deserialize(Source & src)
+  {
+    m_spans.clear();
+    m_hierarchy = {};
+
+    auto const version = ReadPrimitiveFromSource<uint16_t>(src);
+    if (version != kLatestVersion)
+    {
+      LOG(LWARNING, ("Unknown routing shortcuts version", version, "skipping the section."));
+      return;
+    }
+
+    auto const numSpans = ReadVarUint<uint32_t>(src);
+    m_spans.reserve(numSpans);
+    uint32_t featureId = 0;
+    for (uint32_t i = 0; i < numSpans; ++i)
+    {
+      featureId += ReadVarUint<uint32_t>(src);
+      auto const lowPointId = ReadVarUint<uint32_t>(src);
+      auto const highPointId = lowPointId + ReadVarUint<uint32_t>(src);
+      bool const forward = ReadPrimitiveFromSource<uint8_t>(src) != 0;
+      m_spans.emplace_back(featureId, lowPointId, highPointId, forward);
+    }
+
+    m_hierarchy.Deserialize(src);
+    CHECK_EQUAL(m_hierarchy.GetNumVertices(), m_spans.size(), ());
+  }
+
+private:
+  // Returns the span which contains |segment| or ContractionHierarchy::kInvalidVertex.
+  Vertex FindSpan(Segment const & segment) const;
+
+  std::vector<Span> m_spans;
+  ContractionHierarchy m_hierarchy;
+};
+}  // namespace routing
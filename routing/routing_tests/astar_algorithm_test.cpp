@@ -18,20 +18,23 @@ using namespace routing_test;
 using namespace std;
 
 using Algorithm = AStarAlgorithm<uint32_t, SimpleEdge, double>;
+using LazyQueueAlgorithm = AStarAlgorithm<uint32_t, SimpleEdge, double, astar::LazyQueuePolicy>;
+using IndexedHeapAlgorithm = AStarAlgorithm<uint32_t, SimpleEdge, double, astar::IndexedHeapPolicy>;
 
+template <typename Algo>
 void TestAStar(UndirectedGraph & graph, vector<unsigned> const & expectedRoute, double const & expectedDistance)
 {
-  Algorithm algo;
+  Algo algo;
 
-  Algorithm::ParamsForTests<> params(graph, 0u /* startVertex */, 4u /* finishVertex */);
+  typename Algo::template ParamsForTests<> params(graph, 0u /* startVertex */, 4u /* finishVertex */);
 
   RoutingResult<unsigned /* Vertex */, double /* Weight */> actualRoute;
-  TEST_EQUAL(Algorithm::Result::OK, algo.FindPath(params, actualRoute), ());
+  TEST_EQUAL(Algo::Result::OK, algo.FindPath(params, actualRoute), ());
   TEST_EQUAL(expectedRoute, actualRoute.m_path, ());
   TEST_ALMOST_EQUAL_ULPS(expectedDistance, actualRoute.m_distance, ());
 
   actualRoute.m_path.clear();
-  TEST_EQUAL(Algorithm::Result::OK, algo.FindPathBidirectional(params, actualRoute), ());
+  TEST_EQUAL(Algo::Result::OK, algo.FindPathBidirectional(params, actualRoute), ());
   TEST_EQUAL(expectedRoute, actualRoute.m_path, ());
   TEST_ALMOST_EQUAL_ULPS(expectedDistance, actualRoute.m_distance, ());
 }
@@ -49,7 +52,39 @@ UNIT_TEST(AStarAlgorithm_Sample)
 
   vector<unsigned> const expectedRoute = {0, 1, 2, 3, 4};
 
-  TestAStar(graph, expectedRoute, 23);
+  TestAStar<LazyQueueAlgorithm>(graph, expectedRoute, 23);
+  TestAStar<IndexedHeapAlgorithm>(graph, expectedRoute, 23);
+}
+
+UNIT_TEST(AStarQueue_IndexedHeap)
+{
+  struct State
+  {
+    bool operator>(State const & rhs) const { return distance > rhs.distance; }
+
+    uint32_t vertex;
+    double distance;
+  };
+
+  astar::IndexedHeap<State, uint32_t> heap;
+  for (uint32_t v = 0; v < 10; ++v)
+    heap.Push({v, 10.0 + v});
+
+  // Decrease-key keeps the only state of the vertex.
+  heap.Push({7, 1.0});
+  heap.Push({3, 2.0});
+  // Worse states are ignored.
+  heap.Push({5, 100.0});
+  TEST_EQUAL(heap.Size(), 10, ());
+
+  vector<uint32_t> order;
+  while (!heap.Empty())
+  {
+    order.push_back(heap.Top().vertex);
+    heap.Pop();
+  }
+
+  TEST_EQUAL(order, vector<uint32_t>({7, 3, 0, 1, 2, 4, 5, 6, 8, 9}), ());
 }
 
 UNIT_TEST(AStarAlgorithm_CheckLength)
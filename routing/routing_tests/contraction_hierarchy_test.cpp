@@ -0,0 +1,192 @@
+#include "testing/testing.hpp"
+
+#include "routing/base/contraction_hierarchy.hpp"
+
+#include "coding/reader.hpp"
+#include "coding/writer.hpp"
+
+#include "base/math.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <optional>
+#include <queue>
+#include <random>
+#include <utility>
+#include <vector>
+
+namespace contraction_hierarchy_test
+{
+using namespace routing;
+using namespace std;
+
+using Edge = ContractionHierarchy::Edge;
+using Terminal = ContractionHierarchy::Terminal;
+using Vertex = ContractionHierarchy::Vertex;
+
+double constexpr kEps = 0.05;
+
+// Plain Dijkstra to check the hierarchy against.
+optional<double> FindPathDijkstra(uint32_t numVertices, vector<Edge> const & edges,
+                                  vector<Terminal> const & sources, vector<Terminal> const & targets)
+{
+  // Terminal weights may be negative, so all the distances are shifted.
+  double constexpr kShift = 1000.0;
+  double constexpr kInf = numeric_limits<double>::max();
+
+  vector<double> dist(numVertices, kInf);
+  using QueueItem = pair<double, Vertex>;
+  priority_queue<QueueItem, vector<QueueItem>, greater<QueueItem>> queue;
+  for (auto const & source : sources)
+  {
+    double const d = source.m_weight + kShift;
+    if (d < dist[source.m_vertex])
+    {
+      dist[source.m_vertex] = d;
+      queue.emplace(d, source.m_vertex);
+    }
+  }
+
+  while (!queue.empty())
+  {
+    auto const [d, v] = queue.top();
+    queue.pop();
+    if (d > dist[v])
+      continue;
+
+    for (auto const & edge : edges)
+    {
+      if (edge.m_from != v || d + edge.m_weight >= dist[edge.m_to])
+        continue;
+
+      dist[edge.m_to] = d + edge.m_weight;
+      queue.emplace(dist[edge.m_to], edge.m_to);
+    }
+  }
+
+  optional<double> best;
+  for (auto const & target : targets)
+  {
+    if (dist[target.m_vertex] == kInf)
+      continue;
+
+    double const d = dist[target.m_vertex] - kShift + target.m_weight;
+    if (!best || d < *best)
+      best = d;
+  }
+  return best;
+}
+
+// Returns the weight of |path| with its terminals.
+double CalcPathWeight(vector<Edge> const & edges, vector<Terminal> const & sources,
+                      vector<Terminal> const & targets, vector<Vertex> const & path)
+{
+  auto const terminalWeight = [](vector<Terminal> const & terminals, Vertex v) {
+    double weight = numeric_limits<double>::max();
+    for (auto const & terminal : terminals)
+    {
+      if (terminal.m_vertex == v)
+        weight = min(weight, terminal.m_weight);
+    }
+    TEST_NOT_EQUAL(weight, numeric_limits<double>::max(), (v));
+    return weight;
+  };
+
+  double weight = terminalWeight(sources, path.front()) + terminalWeight(targets, path.back());
+  for (size_t i = 1; i < path.size(); ++i)
+  {
+    double edgeWeight = numeric_limits<double>::max();
+    for (auto const & edge : edges)
+    {
+      if (edge.m_from == path[i - 1] && edge.m_to == path[i])
+        edgeWeight = min(edgeWeight, edge.m_weight);
+    }
+    TEST_NOT_EQUAL(edgeWeight, numeric_limits<double>::max(), (path[i - 1], path[i]));
+    weight += edgeWeight;
+  }
+  return weight;
+}
+
+UNIT_TEST(ContractionHierarchy_Line)
+{
+  //  0 -> 1 -> 2 -> 3 -> 4
+  //        \         /
+  //         -> 5 -> -
+  vector<Edge> const edges = {{0, 1, 1.0}, {1, 2, 1.0}, {2, 3, 1.0}, {3, 4, 1.0},
+                              {1, 5, 0.5}, {5, 3, 1.0}};
+  auto const ch = ContractionHierarchy::Build(6 /* numVertices */, edges);
+
+  vector<Vertex> path;
+  auto const weight = ch.FindPath({{0, 0.0}}, {{4, 0.0}}, path);
+  TEST(weight, ());
+  TEST(base::AlmostEqualAbs(*weight, 3.5, kEps), (*weight));
+  TEST_EQUAL(path, vector<Vertex>({0, 1, 5, 3, 4}), ());
+
+  TEST(!ch.FindPath({{4, 0.0}}, {{0, 0.0}}, path), ());
+}
+
+UNIT_TEST(ContractionHierarchy_Terminals)
+{
+  vector<Edge> const edges = {{0, 2, 1.0}, {1, 2, 1.0}, {2, 3, 1.0}, {2, 4, 1.0}};
+  auto const ch = ContractionHierarchy::Build(5 /* numVertices */, edges);
+
+  vector<Vertex> path;
+  auto const weight = ch.FindPath({{0, 5.0}, {1, 1.0}}, {{3, -0.5}, {4, 2.0}}, path);
+  TEST(weight, ());
+  TEST(base::AlmostEqualAbs(*weight, 2.5, kEps), (*weight));
+  TEST_EQUAL(path, vector<Vertex>({1, 2, 3}), ());
+}
+
+UNIT_TEST(ContractionHierarchy_RandomGraphs)
+{
+  mt19937 rng(0);
+  for (size_t iteration = 0; iteration < 100; ++iteration)
+  {
+    uint32_t const numVertices = 2 + rng() % 50;
+    vector<Edge> edges;
+    size_t const numEdges = rng() % (numVertices * 4);
+    for (size_t i = 0; i < numEdges; ++i)
+      edges.emplace_back(rng() % numVertices, rng() % numVertices, (rng() % 1000) / 10.0);
+
+    auto const built = ContractionHierarchy::Build(numVertices, edges);
+
+    vector<char> buffer;
+    {
+      MemWriter<vector<char>> writer(buffer);
+      built.Serialize(writer);
+    }
+
+    ContractionHierarchy ch;
+    {
+      MemReader reader(buffer.data(), buffer.size());
+      ReaderSource<MemReader> src(reader);
+      ch.Deserialize(src);
+    }
+    TEST_EQUAL(ch.GetNumVertices(), numVertices, ());
+    TEST_EQUAL(ch.GetNumArcs(), built.GetNumArcs(), ());
+
+    for (size_t query = 0; query < 20; ++query)
+    {
+      vector<Terminal> sources;
+      vector<Terminal> targets;
+      for (size_t i = 0, n = 1 + rng() % 3; i < n; ++i)
+        sources.emplace_back(rng() % numVertices, (static_cast<int>(rng() % 200) - 100) / 10.0);
+      for (size_t i = 0, n = 1 + rng() % 3; i < n; ++i)
+        targets.emplace_back(rng() % numVertices, (static_cast<int>(rng() % 200) - 100) / 10.0);
+
+      vector<Vertex> path;
+      auto const weight = ch.FindPath(sources, targets, path);
+      auto const expected = FindPathDijkstra(numVertices, edges, sources, targets);
+      TEST_EQUAL(weight.has_value(), expected.has_value(), ());
+      if (!expected)
+        continue;
+
+      TEST(base::AlmostEqualAbs(*weight, *expected, kEps), (*weight, *expected));
+      double const pathWeight = CalcPathWeight(edges, sources, targets, path);
+      TEST(base::AlmostEqualAbs(pathWeight, *expected, kEps), (pathWeight, *expected));
+    }
+  }
+}
+}  // namespace contraction_hierarchy_test
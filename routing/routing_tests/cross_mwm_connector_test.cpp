@@ -333,4 +333,50 @@ UNIT_TEST(CMWMC_WeightsSerialization)
   TestWeightsSerialization<base::GeoObjectId>();
   TestWeightsSerialization<TransitId>();
 }
+
+UNIT_TEST(CMWMC_FillWeightsFromMatrix)
+{
+  uint32_t constexpr segmentIdx = 1;
+  double const weights[] = { 4.0, 20.0, connector::kNoRoute, 12.0, connector::kNoRoute, 40.0, 48.0, 24.0, 12.0 };
+
+  auto const makeBuilder = []()
+  {
+    CrossMwmConnectorBuilderEx<base::GeoObjectId> builder;
+    for (uint32_t featureId : { 2, 0, 1 })
+    {
+      base::GeoObjectId id;
+      GetCrossMwmId(featureId, id);
+      builder.AddTransition(id, featureId, segmentIdx, kCarMask, 0 /* oneWayMask */, true /* forwardIsEnter */);
+    }
+    return builder;
+  };
+
+  auto const serialize = [](CrossMwmConnectorBuilderEx<base::GeoObjectId> & builder)
+  {
+    vector<uint8_t> buffer;
+    MemWriter<vector<uint8_t>> writer(buffer);
+    builder.Serialize(writer);
+    return buffer;
+  };
+
+  auto builder1 = makeBuilder();
+  builder1.PrepareConnector(VehicleType::Car);
+  size_t weightIdx = 0;
+  builder1.FillWeights([&](Segment const &, Segment const &) { return weights[weightIdx++]; });
+
+  auto builder2 = makeBuilder();
+  auto const & connector = builder2.PrepareConnector(VehicleType::Car);
+  vector<double> matrix(std::size(weights), connector::kNoRoute);
+  weightIdx = 0;
+  connector.ForEachEnter([&](uint32_t enterIdx, Segment const &)
+  {
+    connector.ForEachExit([&](uint32_t exitIdx, Segment const &)
+    {
+      matrix[connector.GetWeightIndex(enterIdx, exitIdx)] = weights[weightIdx++];
+    });
+  });
+  builder2.FillWeightsFromMatrix(matrix);
+
+  TEST_EQUAL(serialize(builder1), serialize(builder2), ());
+}
 } // namespace cross_mwm_connector_test
@@ -0,0 +1,184 @@
+#include "testing/testing.hpp"
+
+#include "generator/generator_tests_support/routing_helpers.hpp"
+
+#include "routing/routing_tests/index_graph_tools.hpp"
+
+#include "routing/geometry.hpp"
+#include "routing/index_graph.hpp"
+#include "routing/restrictions_serialization.hpp"
+#include "routing/routing_shortcuts.hpp"
+
+#include "traffic/traffic_cache.hpp"
+
+#include "indexer/classificator_loader.hpp"
+
+#include <cstdint>
+#include <memory>
+#include <utility>
+#include <vector>
+
+namespace routing_shortcuts_test
+{
+using namespace routing;
+using namespace routing_test;
+using namespace std;
+
+double constexpr kEps = 1e-5;
+
+//         F3        F4
+// 2 *------->--*--<-------*
+//   |          |          |
+//   |          |          |
+// 1 *F0        F1         F2
+//   |          |          |
+//   |          |          |
+// 0 *----------*----------*
+//   0   F5    1.2   F5   2.5
+// Note. F3 and F4 are one way features. F0 and F5 are two segments features, point 1 of F0 is
+// not a joint, so the segments of F0 are in the same span and the ones of F5 are not.
+unique_ptr<SingleVehicleWorldGraph> BuildGraph()
+{
+  classificator::Load();
+
+  auto loader = make_unique<TestGeometryLoader>();
+  loader->AddRoad(0 /* featureId */, false /* oneWay */, 1.0 /* speed */,
+                  RoadGeometry::Points({{0.0, 0.0}, {0.0, 1.0}, {0.0, 2.0}}));
+  loader->AddRoad(1 /* featureId */, false /* oneWay */, 1.0 /* speed */,
+                  RoadGeometry::Points({{1.2, 0.0}, {1.1, 2.0}}));
+  loader->AddRoad(2 /* featureId */, false /* oneWay */, 1.0 /* speed */,
+                  RoadGeometry::Points({{2.5, 0.0}, {2.5, 2.0}}));
+  loader->AddRoad(3 /* featureId */, true /* oneWay */, 1.0 /* speed */,
+                  RoadGeometry::Points({{0.0, 2.0}, {1.1, 2.0}}));
+  loader->AddRoad(4 /* featureId */, true /* oneWay */, 1.0 /* speed */,
+                  RoadGeometry::Points({{2.5, 2.0}, {1.1, 2.0}}));
+  loader->AddRoad(5 /* featureId */, false /* oneWay */, 1.0 /* speed */,
+                  RoadGeometry::Points({{0.0, 0.0}, {1.2, 0.0}, {2.5, 0.0}}));
+
+  vector<Joint> const joints = {
+      MakeJoint({{0, 0}, {5, 0}}),         /* joint at point (0, 0) */
+      MakeJoint({{5, 1}, {1, 0}}),         /* joint at point (1.2, 0) */
+      MakeJoint({{5, 2}, {2, 0}}),         /* joint at point (2.5, 0) */
+      MakeJoint({{0, 2}, {3, 0}}),         /* joint at point (0, 2) */
+      MakeJoint({{3, 1}, {1, 1}, {4, 1}}), /* joint at point (1.1, 2) */
+      MakeJoint({{2, 1}, {4, 0}}),         /* joint at point (2.5, 2) */
+  };
+
+  traffic::TrafficCache const trafficCache;
+  shared_ptr<EdgeEstimator> estimator = CreateEstimatorForCar(trafficCache);
+  return BuildWorldGraph(std::move(loader), estimator, joints);
+}
+
+vector<Segment> GetSegments(IndexGraph const & graph)
+{
+  vector<Segment> segments;
+  graph.ForEachRoad([&](uint32_t featureId, RoadJointIds const & /* roadJoints */) {
+    auto const & road = graph.GetRoadGeometry(featureId);
+    for (uint32_t segmentIdx = 0; segmentIdx + 1 < road.GetPointsCount(); ++segmentIdx)
+    {
+      segments.emplace_back(kTestNumMwmId, featureId, segmentIdx, true /* forward */);
+      if (!road.IsOneWay())
+        segments.emplace_back(kTestNumMwmId, featureId, segmentIdx, false /* forward */);
+    }
+  });
+  return segments;
+}
+
+// Returns the first point of the span of |segment|: the nearest joint or road end before it.
+uint32_t GetSpanStart(IndexGraph const & graph, Segment const & segment)
+{
+  uint32_t pointId = segment.GetMinPointId();
+  while (pointId != 0 && !graph.IsJoint(RoadPoint(segment.GetFeatureId(), pointId)))
+    --pointId;
+  return pointId;
+}
+
+bool AreInSameSpan(IndexGraph const & graph, Segment const & lhs, Segment const & rhs)
+{
+  return lhs.GetFeatureId() == rhs.GetFeatureId() && lhs.IsForward() == rhs.IsForward() &&
+         GetSpanStart(graph, lhs) == GetSpanStart(graph, rhs);
+}
+
+optional<RouteWeight> FindRoute(RoutingShortcuts const & shortcuts, IndexGraph const & graph,
+                                Segment const & start, Segment const & finish,
+                                vector<Segment> & route)
+{
+  return shortcuts.FindRoute(graph, kTestNumMwmId, {{start, RouteWeight(0.0)}},
+                             {{finish, RouteWeight(0.0)}}, route);
+}
+
+// Checks that routes with the shortcuts are the same as plain A* routes between all the segments
+// of |graph| which are not in the same span.
+void TestRoutes(unique_ptr<SingleVehicleWorldGraph> graph)
+{
+  WorldGraphForAStar graphForAStar(std::move(graph));
+  auto const & indexGraph = graphForAStar.GetWorldGraph().GetIndexGraph(kTestNumMwmId);
+  auto const shortcuts = RoutingShortcuts::Build(indexGraph);
+  TEST(!shortcuts.IsEmpty(), ());
+
+  auto const segments = GetSegments(indexGraph);
+  for (auto const & start : segments)
+  {
+    for (auto const & finish : segments)
+    {
+      if (AreInSameSpan(indexGraph, start, finish))
+        continue;
+
+      vector<Segment> route;
+      auto const weight = FindRoute(shortcuts, indexGraph, start, finish, route);
+
+      AlgorithmForWorldGraph algorithm;
+      AlgorithmForWorldGraph::ParamsForTests<> params(graphForAStar, start, finish);
+      RoutingResult<Segment, RouteWeight> result;
+      if (algorithm.FindPath(params, result) != AlgorithmForWorldGraph::Result::OK)
+      {
+        TEST(!weight, (start, finish, route));
+        continue;
+      }
+
+      TEST(weight, (start, finish));
+      TEST_EQUAL(route, result.m_path, (start, finish));
+      TEST(weight->IsAlmostEqualForTests(result.m_distance, kEps),
+           (start, finish, *weight, result.m_distance));
+    }
+  }
+}
+
+UNIT_TEST(RoutingShortcuts_OneWay)
+{
+  TestRoutes(BuildGraph());
+}
+
+UNIT_TEST(RoutingShortcuts_RestrictionAndNoUTurn)
+{
+  auto graph = BuildGraph();
+  auto & indexGraph = graph->GetIndexGraphForTests(kTestNumMwmId);
+  indexGraph.SetRestrictions({{5 /* feature from */, 1 /* feature to */}});
+  indexGraph.SetUTurnRestrictions({RestrictionUTurn(5 /* featureId */, false /* viaIsFirstPoint */),
+                                   RestrictionUTurn(2 /* featureId */, true /* viaIsFirstPoint */)});
+  TestRoutes(std::move(graph));
+}
+
+UNIT_TEST(RoutingShortcuts_SameSpan)
+{
+  auto graph = BuildGraph();
+  auto const & indexGraph = graph->GetIndexGraphForTests(kTestNumMwmId);
+  auto const shortcuts = RoutingShortcuts::Build(indexGraph);
+
+  // The route within a single span is left to the usual search.
+  Segment const first(kTestNumMwmId, 0 /* featureId */, 0 /* segmentIdx */, true /* forward */);
+  Segment const second(kTestNumMwmId, 0 /* featureId */, 1 /* segmentIdx */, true /* forward */);
+  vector<Segment> route;
+  TEST(!FindRoute(shortcuts, indexGraph, first, second, route), ());
+  TEST(route.empty(), ());
+  TEST(!FindRoute(shortcuts, indexGraph, second, first, route), ());
+  TEST(route.empty(), ());
+
+  // The segments of the other direction are in another span.
+  Segment const back(kTestNumMwmId, 0 /* featureId */, 0 /* segmentIdx */, false /* forward */);
+  auto const weight = FindRoute(shortcuts, indexGraph, first, back, route);
+  TEST(weight, ());
+  TEST_EQUAL(route.front(), first, ());
+  TEST_EQUAL(route.back(), back, ());
+}
+}  // namespace routing_shortcuts_test
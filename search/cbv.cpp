@@ -93,6 +93,36 @@ CBV CBV::Intersect(CBV const & rhs) const
   return CBV(coding::CompressedBitVector::Intersect(*m_p, *rhs.m_p));
 }
 
+void CBV::UniteWith(CBV const & rhs)
+{
+  auto * chunked = GetMutableChunked();
+  if (!chunked || rhs.IsEmpty() || rhs.IsFull())
+  {
+    *this = Union(rhs);
+    return;
+  }
+
+  if (rhs.m_p->GetStorageStrategy() == coding::CompressedBitVector::StorageStrategy::Chunked)
+    chunked->UniteWith(static_cast<coding::ChunkedCBV const &>(*rhs.m_p));
+  else
+    chunked->UniteWith(*coding::ChunkedCBV::FromCBV(*rhs.m_p));
+}
+
+void CBV::IntersectWith(CBV const & rhs)
+{
+  auto * chunked = GetMutableChunked();
+  if (!chunked || rhs.IsEmpty() || rhs.IsFull())
+  {
+    *this = Intersect(rhs);
+    return;
+  }
+
+  if (rhs.m_p->GetStorageStrategy() == coding::CompressedBitVector::StorageStrategy::Chunked)
+    chunked->IntersectWith(static_cast<coding::ChunkedCBV const &>(*rhs.m_p));
+  else
+    chunked->IntersectWith(*coding::ChunkedCBV::FromCBV(*rhs.m_p));
+}
+
 CBV CBV::Take(uint64_t n) const
 {
   if (IsEmpty())
@@ -112,6 +142,16 @@ CBV CBV::Take(uint64_t n) const
   return CBV(m_p->LeaveFirstSetNBits(n));
 }
 
+coding::ChunkedCBV * CBV::GetMutableChunked()
+{
+  if (m_isFull || !m_p || m_p->NumRefs() != 1 ||
+      m_p->GetStorageStrategy() != coding::CompressedBitVector::StorageStrategy::Chunked)
+  {
+    return nullptr;
+  }
+  return static_cast<coding::ChunkedCBV *>(m_p.Get());
+}
+
 uint64_t CBV::Hash() const
 {
   if (IsEmpty())
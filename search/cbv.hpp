@@ -48,6 +48,11 @@ public:
   CBV Union(CBV const & rhs) const;
   CBV Intersect(CBV const & rhs) const;
 
+  // Same as *this = Union(rhs) and *this = Intersect(rhs), but the operations are done in place
+  // when this CBV is the only owner of a chunked bit vector.
+  void UniteWith(CBV const & rhs);
+  void IntersectWith(CBV const & rhs);
+
   // Takes first set |n| bits.
   CBV Take(uint64_t n) const;
 
@@ -56,6 +61,9 @@ public:
 private:
   explicit CBV(bool full);
 
+  // Returns nullptr if the bit vector can't be changed in place.
+  coding::ChunkedCBV * GetMutableChunked();
+
   base::RefCountPtr<coding::CompressedBitVector> m_p;
 
   // True iff all bits are set to one.
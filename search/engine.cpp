@@ -93,6 +93,7 @@ Engine::Engine(DataSource & dataSource, CategoriesHolder const & categories,
   {
     auto processor = make_unique<Processor>(dataSource, categories, m_suggests, infoGetter);
     processor->SetPreferredLocale(params.m_locale);
+    processor->SetGeocoderThreadsCount(params.m_numGeocoderThreads);
     m_contexts[i].m_processor = std::move(processor);
   }
 
@@ -127,6 +128,16 @@ weak_ptr<ProcessorHandle> Engine::Search(SearchParams params)
   return handle;
 }
 
+weak_ptr<ProcessorHandle> Engine::SearchBatch(vector<SearchParams> batch)
+{
+  shared_ptr<ProcessorHandle> handle(new ProcessorHandle());
+  PostMessage(Message::TYPE_TASK, [this, batch = std::move(batch), handle](Processor & processor)
+              {
+                DoSearchBatch(std::move(batch), handle, processor);
+              });
+  return handle;
+}
+
 void Engine::SetLocale(string const & locale)
 {
   PostMessage(Message::TYPE_BROADCAST,
@@ -294,4 +305,31 @@ void Engine::DoSearch(SearchParams params, shared_ptr<ProcessorHandle> handle, P
 
   processor.Search(std::move(params));
 }
+
+void Engine::DoSearchBatch(vector<SearchParams> batch, shared_ptr<ProcessorHandle> handle,
+                           Processor & processor)
+{
+  LOG(LINFO, ("Batch search started:", batch.size(), "queries."));
+  base::Timer timer;
+  SCOPE_GUARD(printDuration, [&timer]()
+  {
+    LOG(LINFO, ("Batch search ended in", timer.ElapsedMilliseconds(), "ms."));
+  });
+
+  processor.GroupBatchByMwm(batch);
+
+  processor.SetBatchMode(true);
+  SCOPE_GUARD(resetBatchMode, [&processor] { processor.SetBatchMode(false); });
+
+  for (auto & params : batch)
+  {
+    // Every query has its own deadline. When the batch is cancelled, the handle
+    // cancels the processor again, so all remaining queries get cancelled results.
+    processor.Reset();
+    handle->Attach(processor);
+    SCOPE_GUARD(detach, [&handle] { handle->Detach(); });
+
+    processor.Search(std::move(params));
+  }
+}
 }  // namespace search
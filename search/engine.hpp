@@ -46,13 +46,13 @@ private:
 
   // Attaches the handle to a |processor|. If there was or will be a
   // cancel signal, this signal will be propagated to |processor|.
-  // This method is called only once, when search engine starts
-  // the processor this handle corresponds to.
+  // This method is called when search engine starts the processor
+  // this handle corresponds to, once per query of a batch.
   void Attach(Processor & processor);
 
-  // Detaches handle from a processor. This method is called only
-  // once, when search engine completes processing of the query
-  // that this handle corresponds to.
+  // Detaches handle from a processor. This method is called when
+  // search engine completes processing of the query that this
+  // handle corresponds to, once per query of a batch.
   void Detach();
 
   Processor * m_processor;
@@ -80,6 +80,11 @@ public:
     // to process queries. Use this field wisely as large values may
     // negatively affect performance due to false sharing.
     size_t m_numThreads;
+
+    // Number of threads every processor uses to geocode different mwms
+    // of a query in parallel. It helps the latency of Everywhere queries
+    // over many mwms but multiplies memory used by per-mwm caches.
+    size_t m_numGeocoderThreads = 1;
   };
 
   // Doesn't take ownership of dataSource and categories.
@@ -90,6 +95,14 @@ public:
   // Posts search request to the queue and returns its handle.
   std::weak_ptr<ProcessorHandle> Search(SearchParams params);
 
+  // Posts a batch of search requests to the queue and returns the handle
+  // which cancels the whole batch. All queries of the batch are processed
+  // by one thread, grouped by mwm and with features retrieved for query
+  // tokens shared between them. Results of every query are passed to its
+  // own |m_onResults| callback as soon as the query is processed, so the
+  // order of callbacks may differ from the order of |batch|.
+  std::weak_ptr<ProcessorHandle> SearchBatch(std::vector<SearchParams> batch);
+
   // Sets default locale on all query processors.
   void SetLocale(std::string const & locale);
 
@@ -167,6 +180,8 @@ private:
   void PostMessage(Args &&... args);
 
   void DoSearch(SearchParams params, std::shared_ptr<ProcessorHandle> handle, Processor & processor);
+  void DoSearchBatch(std::vector<SearchParams> batch, std::shared_ptr<ProcessorHandle> handle,
+                     Processor & processor);
 
   std::vector<Suggest> m_suggests;
 
@@ -36,8 +36,11 @@
 #include "base/macros.hpp"
 #include "base/scope_guard.hpp"
 #include "base/stl_helpers.hpp"
+#include "base/thread_pool_computational.hpp"
 
 #include <algorithm>
+#include <deque>
+#include <future>
 
 #include "defines.hpp"
 
@@ -71,6 +74,7 @@ size_t constexpr kPivotRectsCacheSize = 10;
 size_t constexpr kPostcodesRectsCacheSize = 10;
 size_t constexpr kSuburbsRectsCacheSize = 10;
 size_t constexpr kLocalityRectsCacheSize = 10;
+size_t constexpr kMaxTokenFeaturesCacheSize = 10000;
 
 UniString const kUniSpace(MakeUniString(" "));
 
@@ -317,6 +321,41 @@ void Geocoder::LocalitiesCaches::Clear()
   m_villages.Clear();
 }
 
+// Geocoder::CountryResults ------------------------------------------------------------------------
+struct Geocoder::CountryResults
+{
+  std::vector<PreRankerResult> & GetCurrent()
+  {
+    return m_aroundPivot ? m_aroundPivotResults : m_results;
+  }
+
+  // Results of MatchCategories() or MatchRegions().
+  std::vector<PreRankerResult> m_results;
+
+  // Results of MatchAroundPivot(). They are dropped on merge if the sequential
+  // geocoding wouldn't call MatchAroundPivot() for this mwm.
+  std::vector<PreRankerResult> m_aroundPivotResults;
+  bool m_aroundPivot = false;
+
+  // PreRanker::HaveFullyMatchedResult() value for the already processed mwms and this mwm.
+  bool m_haveFullyMatchedResult = false;
+};
+
+// Geocoder::Worker --------------------------------------------------------------------------------
+struct Geocoder::Worker
+{
+  explicit Worker(Geocoder const & geocoder)
+    : m_localitiesCaches(geocoder.m_cancellable)
+    , m_geocoder(geocoder.m_dataSource, geocoder.m_infoGetter, geocoder.m_categories,
+                 geocoder.m_citiesBoundaries, geocoder.m_preRanker, m_localitiesCaches,
+                 geocoder.m_cancellable)
+  {
+  }
+
+  LocalitiesCaches m_localitiesCaches;
+  Geocoder m_geocoder;
+};
+
 // Geocoder::Geocoder ------------------------------------------------------------------------------
 Geocoder::Geocoder(DataSource const & dataSource, storage::CountryInfoGetter const & infoGetter,
                    CategoriesHolder const & categories,
@@ -440,6 +479,43 @@ void Geocoder::ClearCaches()
   m_cuisineFilter.ClearCaches();
   m_postcodePointsCache.Clear();
   m_postcodes.Clear();
+  m_tokenFeaturesCache.clear();
+  m_tokenFeaturesCacheSize = 0;
+
+  for (auto & worker : m_workers)
+  {
+    worker->m_geocoder.ClearCaches();
+    worker->m_localitiesCaches.Clear();
+  }
+}
+
+void Geocoder::SetThreadsCount(size_t threadsCount)
+{
+  m_workersPool.reset();
+  m_workers.clear();
+
+  if (threadsCount <= 1)
+    return;
+
+  for (size_t i = 0; i < threadsCount; ++i)
+  {
+    m_workers.push_back(make_unique<Worker>(*this));
+    m_workers.back()->m_geocoder.SetBatchMode(m_batchMode);
+  }
+  m_workersPool = make_unique<base::thread_pool::computational::ThreadPool>(threadsCount);
+}
+
+void Geocoder::SetBatchMode(bool batchMode)
+{
+  m_batchMode = batchMode;
+  if (!m_batchMode)
+  {
+    m_tokenFeaturesCache.clear();
+    m_tokenFeaturesCacheSize = 0;
+  }
+
+  for (auto & worker : m_workers)
+    worker->m_geocoder.SetBatchMode(batchMode);
 }
 
 void Geocoder::SetParamsForCategorialSearch(Params const & params)
@@ -580,74 +656,188 @@ void Geocoder::GoImpl(vector<MwmInfoPtr> const & infos, bool inViewport)
   // found.
   auto const infosWithType = OrderCountries(inViewport, infos);
 
-  // MatchAroundPivot() should always be matched in mwms
-  // intersecting with position and viewport.
+  // Tracer isn't thread-safe, so traced queries are processed sequentially.
+  if (!m_workers.empty() && !m_params.m_tracer)
+  {
+    GoInParallel(infosWithType, inViewport);
+    return;
+  }
+
   auto processCountry = [&](unique_ptr<MwmContext> context, bool updatePreranker) {
-    ASSERT(context, ());
-    m_context = std::move(context);
+    MatchCountry(std::move(context), inViewport);
 
-    SCOPE_GUARD(cleanup, [&]() {
-      LOG(LDEBUG, (m_context->GetName(), "geocoding complete."));
-      m_matcher->OnQueryFinished();
-      m_matcher = nullptr;
-      m_context.reset();
-    });
+    if (updatePreranker)
+      m_preRanker.UpdateResults(false /* lastUpdate */);
 
-    auto it = m_matchersCache.find(m_context->GetId());
-    if (it == m_matchersCache.end())
-    {
-      it = m_matchersCache
-               .insert(make_pair(m_context->GetId(),
-                                 std::make_unique<FeaturesLayerMatcher>(m_dataSource, m_cancellable)))
-               .first;
-    }
-    m_matcher = it->second.get();
-    m_matcher->SetContext(m_context.get());
+    if (m_preRanker.IsFull())
+      return base::ControlFlow::Break;
+
+    return base::ControlFlow::Continue;
+  };
+
+  // Iterates through all alive mwms and performs geocoding.
+  ForEachCountry(infosWithType, processCountry);
+}
+
+void Geocoder::MatchCountry(unique_ptr<MwmContext> context, bool inViewport)
+{
+  ASSERT(context, ());
+  m_context = std::move(context);
+
+  SCOPE_GUARD(cleanup, [&]() {
+    LOG(LDEBUG, (m_context->GetName(), "geocoding complete."));
+    m_matcher->OnQueryFinished();
+    m_matcher = nullptr;
+    m_context.reset();
+  });
+
+  auto it = m_matchersCache.find(m_context->GetId());
+  if (it == m_matchersCache.end())
+  {
+    it = m_matchersCache
+             .insert(make_pair(m_context->GetId(),
+                               std::make_unique<FeaturesLayerMatcher>(m_dataSource, m_cancellable)))
+             .first;
+  }
+  m_matcher = it->second.get();
+  m_matcher->SetContext(m_context.get());
+
+  BaseContext ctx;
+  InitBaseContext(ctx);
+
+  if (inViewport)
+  {
+    auto const viewportCBV =
+        RetrieveGeometryFeatures(*m_context, m_params.m_pivot, RectId::Pivot);
+    for (auto & features : ctx.m_features)
+      features.IntersectWith(viewportCBV);
+  }
 
-    BaseContext ctx;
-    InitBaseContext(ctx);
+  ctx.m_villages = m_localitiesCaches.m_villages.Get(*m_context);
 
-    if (inViewport)
+  auto const citiesFromWorld = m_cities;
+  FillVillageLocalities(ctx);
+  SCOPE_GUARD(remove_villages, [&]() { m_cities = citiesFromWorld; });
+
+  if (m_params.IsCategorialRequest())
+  {
+    MatchCategories(ctx, m_context->GetType().m_viewportIntersected /* aroundPivot */);
+  }
+  else
+  {
+    MatchRegions(ctx, Region::TYPE_COUNTRY);
+
+    // MatchAroundPivot() should always be matched in mwms
+    // intersecting with position and viewport.
+    auto const & mwmType = m_context->GetType();
+    if (mwmType.m_viewportIntersected || mwmType.m_containsUserPosition ||
+        !HaveFullyMatchedResult())
     {
-      auto const viewportCBV =
-          RetrieveGeometryFeatures(*m_context, m_params.m_pivot, RectId::Pivot);
-      for (auto & features : ctx.m_features)
-        features = features.Intersect(viewportCBV);
+      if (m_countryResults)
+        m_countryResults->m_aroundPivot = true;
+      MatchAroundPivot(ctx);
     }
+  }
+}
 
-    ctx.m_villages = m_localitiesCaches.m_villages.Get(*m_context);
+void Geocoder::GoInParallel(ExtendedMwmInfos const & infos, bool inViewport)
+{
+  // The main geocoder state which is ready after FillLocalitiesTable().
+  for (auto & worker : m_workers)
+  {
+    auto & geocoder = worker->m_geocoder;
+    geocoder.SetParams(m_params);
+    geocoder.m_worldId = m_worldId;
+    geocoder.m_cities = m_cities;
+    for (size_t i = 0; i < Region::TYPE_COUNT; ++i)
+      geocoder.m_regions[i] = m_regions[i];
+    geocoder.m_resultTracer = m_resultTracer;
+  }
 
-    auto const citiesFromWorld = m_cities;
-    FillVillageLocalities(ctx);
-    SCOPE_GUARD(remove_villages, [&]() { m_cities = citiesFromWorld; });
+  struct Task
+  {
+    unique_ptr<CountryResults> m_results;
+    MwmContext::MwmType m_type;
+    bool m_updatePreranker = false;
+    std::future<void> m_done;
+  };
 
-    if (m_params.IsCategorialRequest())
+  // Tasks are merged in the submission order and there are at most |m_workers.size()| of them,
+  // so the i-th submitted task may safely use the (i % m_workers.size())-th worker.
+  std::deque<Task> tasks;
+  size_t nextWorker = 0;
+
+  SCOPE_GUARD(waitTasks, [&]() {
+    // Workers use |tasks|, so wait for them even if the query is cancelled or no more results are needed.
+    for (auto & task : tasks)
     {
-      MatchCategories(ctx, m_context->GetType().m_viewportIntersected /* aroundPivot */);
+      if (task.m_done.valid())
+        task.m_done.wait();
     }
-    else
-    {
-      MatchRegions(ctx, Region::TYPE_COUNTRY);
+  });
 
-      auto const & mwmType = m_context->GetType();
-      if (mwmType.m_viewportIntersected || mwmType.m_containsUserPosition ||
-          !m_preRanker.HaveFullyMatchedResult())
-      {
-        MatchAroundPivot(ctx);
-      }
+  // Does the same with |task| results as GoImpl() does when it processes an mwm.
+  auto const mergeTask = [&](Task & task) {
+    task.m_done.get();
+
+    for (auto & result : task.m_results->m_results)
+      m_preRanker.Emplace(std::move(result));
+
+    if (task.m_results->m_aroundPivot &&
+        (task.m_type.m_viewportIntersected || task.m_type.m_containsUserPosition ||
+         !m_preRanker.HaveFullyMatchedResult()))
+    {
+      for (auto & result : task.m_results->m_aroundPivotResults)
+        m_preRanker.Emplace(std::move(result));
     }
 
-    if (updatePreranker)
+    if (task.m_updatePreranker)
       m_preRanker.UpdateResults(false /* lastUpdate */);
 
-    if (m_preRanker.IsFull())
+    return m_preRanker.IsFull() ? base::ControlFlow::Break : base::ControlFlow::Continue;
+  };
+
+  auto const mergeFront = [&]() {
+    auto const res = mergeTask(tasks.front());
+    tasks.pop_front();
+    return res;
+  };
+
+  bool stopped = false;
+  ForEachCountry(infos, [&](unique_ptr<MwmContext> context, bool updatePreranker) {
+    if (tasks.size() == m_workers.size() && mergeFront() == base::ControlFlow::Break)
+    {
+      stopped = true;
       return base::ControlFlow::Break;
+    }
 
+    auto & task = tasks.emplace_back();
+    task.m_results = make_unique<CountryResults>();
+    task.m_results->m_haveFullyMatchedResult = m_preRanker.HaveFullyMatchedResult();
+    task.m_type = context->GetType();
+    task.m_updatePreranker = updatePreranker;
+
+    auto & geocoder = m_workers[nextWorker]->m_geocoder;
+    nextWorker = (nextWorker + 1) % m_workers.size();
+
+    task.m_done = m_workersPool->Submit(
+        [&geocoder, results = task.m_results.get(), context = std::move(context), inViewport]() mutable {
+          geocoder.m_countryResults = results;
+          SCOPE_GUARD(resetResults, [&]() { geocoder.m_countryResults = nullptr; });
+          geocoder.MatchCountry(std::move(context), inViewport);
+        });
     return base::ControlFlow::Continue;
-  };
+  });
 
-  // Iterates through all alive mwms and performs geocoding.
-  ForEachCountry(infosWithType, processCountry);
+  while (!stopped && !tasks.empty())
+    stopped = mergeFront() == base::ControlFlow::Break;
+}
+
+bool Geocoder::HaveFullyMatchedResult() const
+{
+  if (m_countryResults)
+    return m_countryResults->m_haveFullyMatchedResult;
+  return m_preRanker.HaveFullyMatchedResult();
 }
 
 void Geocoder::InitBaseContext(BaseContext & ctx)
@@ -666,19 +856,60 @@ void Geocoder::InitBaseContext(BaseContext & ctx)
       CategoriesCache cache(m_params.m_preferredTypes, m_cancellable);
       ctx.m_features[i] = Retrieval::ExtendedFeatures(cache.Get(*m_context));
     }
-    else if (m_params.IsPrefixToken(i))
-    {
-      ctx.m_features[i] = retrieval.RetrieveAddressFeatures(m_prefixTokenRequest);
-    }
     else
     {
-      ctx.m_features[i] = retrieval.RetrieveAddressFeatures(m_tokenRequests[i]);
+      ctx.m_features[i] = RetrieveTokenFeatures(retrieval, i);
     }
   }
 
   ctx.m_cuisineFilter = m_cuisineFilter.MakeScopedFilter(*m_context, m_params.m_cuisineTypes);
 }
 
+Retrieval::ExtendedFeatures Geocoder::RetrieveTokenFeatures(Retrieval const & retrieval, size_t i)
+{
+  auto const retrieve = [&]()
+  {
+    if (m_params.IsPrefixToken(i))
+      return retrieval.RetrieveAddressFeatures(m_prefixTokenRequest);
+    return retrieval.RetrieveAddressFeatures(m_tokenRequests[i]);
+  };
+
+  if (!m_batchMode)
+    return retrieve();
+
+  // The request of a token is built only from the token itself, its categories and query langs,
+  // see SetParams().
+  string key = m_params.IsPrefixToken(i) ? "p" : "f";
+  m_params.GetToken(i).ForOriginalAndSynonyms([&key](UniString const & s)
+  {
+    key += ToUtf8(s);
+    key += '\0';
+  });
+  for (auto const & index : m_params.GetTypeIndices(i))
+    key += "t" + strings::to_string(index);
+  for (uint64_t lang = 0; lang < StringUtf8Multilang::kMaxSupportedLanguages; ++lang)
+  {
+    if (m_params.GetLangs().Contains(lang))
+      key += "l" + strings::to_string(lang);
+  }
+
+  auto & mwmCache = m_tokenFeaturesCache[m_context->GetId()];
+  auto const it = mwmCache.find(key);
+  if (it != mwmCache.end())
+    return it->second;
+
+  auto features = retrieve();
+  if (m_tokenFeaturesCacheSize == kMaxTokenFeaturesCacheSize)
+  {
+    for (auto & entry : m_tokenFeaturesCache)
+      entry.second.clear();
+    m_tokenFeaturesCacheSize = 0;
+  }
+  mwmCache.emplace(std::move(key), features);
+  ++m_tokenFeaturesCacheSize;
+  return features;
+}
+
 void Geocoder::InitLayer(Model::Type type, TokenRange const & tokenRange, FeaturesLayer & layer)
 {
   layer.Clear();
@@ -1176,7 +1407,7 @@ void Geocoder::WithPostcodes(BaseContext & ctx, Fn && fn)
       for (auto const & p : points)
       {
         auto const rect = mercator::RectByCenterXYAndOffset(p, postcodePoints.GetRadius());
-        postcodes = postcodes.Union(RetrieveGeometryFeatures(*m_context, rect, RectId::Postcode));
+        postcodes.UniteWith(RetrieveGeometryFeatures(*m_context, rect, RectId::Postcode));
       }
     }
     SCOPE_GUARD(cleanup, [&]() { m_postcodes.Clear(); });
@@ -1506,7 +1737,7 @@ void Geocoder::MatchPOIsAndBuildings(BaseContext & ctx, size_t curToken, CBV con
       InitLayer(layer.m_type, TokenRange(curToken, endToken), layer);
     }
 
-    features = features.Intersect(ctx.m_features[idx]);
+    features.IntersectWith(ctx.m_features[idx]);
 
     CBV filtered = features.m_features;
     if (m_filter->NeedToFilter(features.m_features))
@@ -1879,7 +2110,16 @@ void Geocoder::EmitResult(BaseContext & ctx, FeatureID const & id,
   info.m_allTokensUsed = allTokensUsed;
   info.m_exactMatch = exactMatch;
 
-  m_preRanker.Emplace(id, info, m_resultTracer.GetProvenance());
+  if (m_countryResults)
+  {
+    m_countryResults->GetCurrent().emplace_back(id, info, m_resultTracer.GetProvenance());
+    if (info.m_allTokensUsed)
+      m_countryResults->m_haveFullyMatchedResult = true;
+  }
+  else
+  {
+    m_preRanker.Emplace(id, info, m_resultTracer.GetProvenance());
+  }
 
   ++ctx.m_numEmitted;
 }
@@ -1922,7 +2162,7 @@ void Geocoder::MatchUnclassified(BaseContext & ctx, size_t curToken)
   auto startToken = curToken;
   for (; curToken < ctx.NumTokens() && !ctx.IsTokenUsed(curToken); ++curToken)
   {
-    allFeatures = allFeatures.Intersect(ctx.m_features[curToken]);
+    allFeatures.IntersectWith(ctx.m_features[curToken]);
   }
 
   if (m_filter->NeedToFilter(allFeatures.m_features))
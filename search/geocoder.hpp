@@ -17,6 +17,7 @@
 #include "search/mwm_context.hpp"
 #include "search/postcode_points.hpp"
 #include "search/query_params.hpp"
+#include "search/retrieval.hpp"
 #include "search/streets_matcher.hpp"
 #include "search/token_range.hpp"
 #include "search/tracer.hpp"
@@ -33,12 +34,19 @@
 #include <map>
 #include <memory>
 #include <optional>
+#include <string>
+#include <unordered_map>
 #include <vector>
 
 class CategoriesHolder;
 class DataSource;
 class MwmValue;
 
+namespace base::thread_pool::computational
+{
+class ThreadPool;
+}  // namespace base::thread_pool::computational
+
 namespace storage
 {
 class CountryInfoGetter;
@@ -127,6 +135,15 @@ public:
   void CacheWorldLocalities();
   void ClearCaches();
 
+  // Sets number of threads used to geocode different mwms of a query in parallel.
+  // Results don't depend on the threads count. Query tracing is always sequential.
+  void SetThreadsCount(size_t threadsCount);
+
+  // In batch mode features retrieved for query tokens are kept per mwm between queries, so
+  // queries of a batch that share tokens don't repeat search index lookups. The cache is
+  // dropped when the batch mode is turned off.
+  void SetBatchMode(bool batchMode);
+
 private:
   enum class RectId
   {
@@ -179,11 +196,27 @@ private:
     CBV m_worldFeatures;
   };
 
+  struct CountryResults;
+  struct Worker;
+
   // Sets search query params for categorial search.
   void SetParamsForCategorialSearch(Params const & params);
 
   void GoImpl(std::vector<MwmInfoPtr> const & infos, bool inViewport);
 
+  // Performs geocoding in the mwm of |context|.
+  void MatchCountry(std::unique_ptr<MwmContext> context, bool inViewport);
+
+  // Performs geocoding of |infos| mwms on |m_workers| and moves their results
+  // to |m_preRanker| in the same order and with the same stop conditions as GoImpl() does.
+  void GoInParallel(ExtendedMwmInfos const & infos, bool inViewport);
+
+  bool HaveFullyMatchedResult() const;
+
+  // Retrieves features matching the |i|-th token in the current mwm, using
+  // |m_tokenFeaturesCache| in batch mode.
+  Retrieval::ExtendedFeatures RetrieveTokenFeatures(Retrieval const & retrieval, size_t i);
+
   template <typename Locality>
   using TokenToLocalities = std::map<TokenRange, std::vector<Locality>>;
 
@@ -372,8 +405,20 @@ private:
   std::vector<SearchTrieRequest<strings::LevenshteinDFA>> m_tokenRequests;
   SearchTrieRequest<strings::PrefixDFAModifier<strings::LevenshteinDFA>> m_prefixTokenRequest;
 
+  // Features retrieved for tokens of the batch queries, by mwm and by token key.
+  bool m_batchMode = false;
+  std::map<MwmSet::MwmId, std::unordered_map<std::string, Retrieval::ExtendedFeatures>> m_tokenFeaturesCache;
+  size_t m_tokenFeaturesCacheSize = 0;
+
   ResultTracer m_resultTracer;
 
   PreRanker & m_preRanker;
+
+  // Results of the mwm being processed by a worker geocoder, nullptr for the main geocoder.
+  CountryResults * m_countryResults = nullptr;
+
+  // Geocoders with their own per-mwm caches to process mwms in parallel.
+  std::vector<std::unique_ptr<Worker>> m_workers;
+  std::unique_ptr<base::thread_pool::computational::ThreadPool> m_workersPool;
 };
 }  // namespace search
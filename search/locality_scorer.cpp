@@ -154,7 +154,7 @@ void LocalityScorer::GetTopLocalities(MwmSet::MwmId const & countryId, BaseConte
       }
 
       if (endToken < numTokens)
-        intersection = intersection.Intersect(intersections[endToken]);
+        intersection.IntersectWith(intersections[endToken]);
     }
   }
 
@@ -18,7 +18,8 @@ void CoverRect(m2::RectD const & rect, int scale, covering::Intervals & result)
 MwmContext::MwmContext(MwmSet::MwmHandle handle)
   : m_handle(std::move(handle))
   , m_value(*m_handle.GetValue())
-  , m_vector(m_value.m_cont, m_value.GetHeader(), m_value.m_table.get(), m_value.m_metaDeserializer.get())
+  , m_vector(m_value.m_cont, m_value.GetHeader(), m_value.m_table.get(),
+             m_value.m_metaDeserializer.get(), m_value.m_features)
   , m_index(m_value.m_cont.GetReader(INDEX_FILE_TAG), m_value.m_factory)
   , m_centers(m_value)
   , m_editableSource(m_handle)
@@ -329,6 +329,32 @@ m2::RectD const & Processor::GetViewport() const
 
 void Processor::CacheWorldLocalities() { m_geocoder.CacheWorldLocalities(); }
 
+void Processor::SetGeocoderThreadsCount(size_t threadsCount)
+{
+  m_geocoder.SetThreadsCount(threadsCount);
+}
+
+void Processor::SetBatchMode(bool batchMode) { m_geocoder.SetBatchMode(batchMode); }
+
+void Processor::GroupBatchByMwm(vector<SearchParams> & batch) const
+{
+  vector<pair<storage::CountryId, size_t>> order;
+  order.reserve(batch.size());
+  for (size_t i = 0; i < batch.size(); ++i)
+  {
+    auto const & params = batch[i];
+    auto const pivot = params.m_position ? *params.m_position : params.m_viewport.Center();
+    order.emplace_back(m_infoGetter.GetRegionCountryId(pivot), i);
+  }
+  sort(order.begin(), order.end());
+
+  vector<SearchParams> grouped;
+  grouped.reserve(batch.size());
+  for (auto const & p : order)
+    grouped.push_back(std::move(batch[p.second]));
+  batch.swap(grouped);
+}
+
 void Processor::LoadCitiesBoundaries()
 {
   if (m_citiesBoundaries.Load())
@@ -62,6 +62,7 @@ public:
 
   void SetViewport(m2::RectD const & viewport);
   void SetPreferredLocale(std::string const & locale);
+  void SetGeocoderThreadsCount(size_t threadsCount);
   void SetInputLocale(std::string const & locale);
   void SetQuery(std::string const & query, bool categorialRequest = false);
 
@@ -69,6 +70,14 @@ public:
 
   void Search(SearchParams params);
 
+  // In batch mode features retrieved for query tokens are shared between
+  // queries processed one after another. See Geocoder::SetBatchMode().
+  void SetBatchMode(bool batchMode);
+
+  // Stable sorts |batch| by the mwm of the query pivot, so that queries
+  // of a batch that hit the same mwms are processed one after another.
+  void GroupBatchByMwm(std::vector<SearchParams> & batch) const;
+
   /// Tries to parse a custom debugging command from |m_query|.
   /// @return True if can stop further search.
   bool SearchDebug();
@@ -477,6 +477,8 @@ private:
       ReverseGeocoder::Address addr;
       if (GetExactAddress(*ft, center, addr))
       {
+        // The loader should outlive the street feature.
+        unique_ptr<FeaturesLoaderGuard> loader;
         unique_ptr<FeatureType> streetFeature;
 
         // We can't change m_loader here, because of the following RankerResult. So do this trick:
@@ -486,7 +488,7 @@ private:
         }
         else
         {
-          auto loader = make_unique<FeaturesLoaderGuard>(m_dataSource, addr.m_street.m_id.m_mwmId);
+          loader = make_unique<FeaturesLoaderGuard>(m_dataSource, addr.m_street.m_id.m_mwmId);
           streetFeature = LoadFeatureImpl(addr.m_street.m_id, *loader);
         }
 
@@ -69,6 +69,18 @@ public:
       return result;
     }
 
+    void IntersectWith(ExtendedFeatures const & rhs)
+    {
+      m_features.IntersectWith(rhs.m_features);
+      m_exactMatchingFeatures.IntersectWith(rhs.m_exactMatchingFeatures);
+    }
+
+    void IntersectWith(Features const & cbv)
+    {
+      m_features.IntersectWith(cbv);
+      m_exactMatchingFeatures.IntersectWith(cbv);
+    }
+
     void SetFull()
     {
       m_features.SetFull();
@@ -104,7 +104,8 @@ public:
     std::vector<uint64_t> ids(values.size());
     for (size_t i = 0; i < ids.size(); ++i)
       ids[i] = values[i].m_featureId;
-    m_cbv = coding::CompressedBitVectorBuilder::FromBitPositions(std::move(ids));
+    // The list is written to the search index, so it's never stored as a chunked vector.
+    m_cbv = coding::CompressedBitVectorBuilder::FromBitPositionsDenseOrSparse(std::move(ids));
   }
 
   // This method returns number of values in the current instance of
@@ -17,6 +17,8 @@
 
 #include "editor/editable_data_source.hpp"
 
+#include "storage/country_info_getter.hpp"
+
 #include "indexer/feature_impl.hpp"
 
 #include "geometry/mercator.hpp"
@@ -27,6 +29,7 @@
 #include "base/scope_guard.hpp"
 #include "base/string_utils.hpp"
 
+#include <memory>
 #include <string>
 #include <tuple>
 #include <vector>
@@ -476,6 +479,120 @@ UNIT_CLASS_TEST(ProcessorTest, SearchByName)
   }
 }
 
+UNIT_CLASS_TEST(ProcessorTest, ParallelGeocoding)
+{
+  string const lang = "en";
+  vector<TestCity> cities;
+  vector<TestStreet> streets;
+  vector<TestBuilding> buildings;
+  vector<TestCafe> cafes;
+  for (int i = 0; i < 6; ++i)
+  {
+    m2::PointD const center(2.0 * i, 2.0 * i);
+    cities.emplace_back(center, "Town " + strings::to_string(i), lang, 100 /* rank */);
+    streets.emplace_back(vector<m2::PointD>{center, center + m2::PointD(0.01, 0.01)}, "Main street", lang);
+    buildings.emplace_back(center + m2::PointD(0.005, 0.005), "" /* name */, "7", "Main street", lang);
+    cafes.emplace_back(center + m2::PointD(0.002, 0.0), "Sunny cafe", lang);
+  }
+
+  auto const worldId = BuildWorld([&](TestMwmBuilder & builder)
+  {
+    for (auto const & city : cities)
+      builder.Add(city);
+  });
+
+  Engine::Params params;
+  params.m_numGeocoderThreads = 3;
+  TestSearchEngine parallelEngine(m_dataSource, params, true /* mockCountryInfo */);
+  auto & infoGetter =
+      dynamic_cast<storage::CountryInfoGetterForTesting &>(parallelEngine.GetCountryInfoGetter());
+
+  for (size_t i = 0; i < cities.size(); ++i)
+  {
+    auto const countryId = BuildCountry("Country " + strings::to_string(i), [&](TestMwmBuilder & builder)
+    {
+      builder.Add(streets[i]);
+      builder.Add(buildings[i]);
+      builder.Add(cafes[i]);
+    });
+    infoGetter.AddCountry(storage::CountryDef(countryId.GetInfo()->GetCountryName(),
+                                              countryId.GetInfo()->m_bordersRect));
+  }
+  parallelEngine.LoadCitiesBoundaries();
+
+  SetViewport(m2::RectD(-1.0, -1.0, -0.9, -0.9));
+  for (string const query : {"Sunny cafe", "Main street 7", "Town 3 Main street", "cafe", "Town 5"})
+  {
+    TestSearchRequest request(m_engine, GetDefaultSearchParams(query));
+    request.Run();
+    TestSearchRequest parallelRequest(parallelEngine, GetDefaultSearchParams(query));
+    parallelRequest.Run();
+
+    auto const & expected = request.Results();
+    auto const & actual = parallelRequest.Results();
+    TEST(!expected.empty(), (query));
+    TEST_EQUAL(expected.size(), actual.size(), (query));
+    for (size_t i = 0; i < expected.size(); ++i)
+      TEST_EQUAL(expected[i].GetFeatureID(), actual[i].GetFeatureID(), (query, i));
+  }
+
+  TEST(ResultsMatch("Town 5", {ExactMatch(worldId, cities[5])}), ());
+}
+
+UNIT_CLASS_TEST(ProcessorTest, BatchGeocoding)
+{
+  string const lang = "en";
+  TestCity greenville({0, 0}, "Greenville", lang, 100 /* rank */);
+  TestCity redville({2, 2}, "Redville", lang, 100 /* rank */);
+  TestStreet greenStreet(vector<m2::PointD>{{0.0, 0.0}, {0.01, 0.01}}, "Main street", lang);
+  TestStreet redStreet(vector<m2::PointD>{{2.0, 2.0}, {2.01, 2.01}}, "Main street", lang);
+  TestBuilding greenBuilding({0.005, 0.005}, "" /* name */, "7", "Main street", lang);
+  TestBuilding redBuilding({2.005, 2.005}, "" /* name */, "7", "Main street", lang);
+
+  BuildWorld([&](TestMwmBuilder & builder)
+  {
+    builder.Add(greenville);
+    builder.Add(redville);
+  });
+  BuildCountry("Green", [&](TestMwmBuilder & builder)
+  {
+    builder.Add(greenStreet);
+    builder.Add(greenBuilding);
+  });
+  BuildCountry("Red", [&](TestMwmBuilder & builder)
+  {
+    builder.Add(redStreet);
+    builder.Add(redBuilding);
+  });
+
+  SetViewport(m2::RectD(-1.0, -1.0, -0.9, -0.9));
+  vector<string> const queries = {"Main street 7 Greenville", "Main street 7 Redville",
+                                  "Main street 7", "Greenville Main street 7", "Main street"};
+
+  vector<unique_ptr<TestSearchRequest>> requests;
+  vector<SearchParams> batch;
+  for (auto const & query : queries)
+  {
+    requests.push_back(make_unique<TestSearchRequest>(m_engine, GetDefaultSearchParams(query)));
+    batch.push_back(requests.back()->GetParams());
+  }
+  m_engine.SearchBatch(batch);
+
+  for (size_t i = 0; i < queries.size(); ++i)
+  {
+    requests[i]->Wait();
+    TestSearchRequest request(m_engine, GetDefaultSearchParams(queries[i]));
+    request.Run();
+
+    auto const & expected = request.Results();
+    auto const & actual = requests[i]->Results();
+    TEST(!expected.empty(), (queries[i]));
+    TEST_EQUAL(expected.size(), actual.size(), (queries[i]));
+    for (size_t j = 0; j < expected.size(); ++j)
+      TEST_EQUAL(expected[j].GetFeatureID(), actual[j].GetFeatureID(), (queries[i], j));
+  }
+}
+
 UNIT_CLASS_TEST(ProcessorTest, DisableSuggests)
 {
   TestCity london1({1, 1}, "London", "en", 100 /* rank */);
@@ -0,0 +1,77 @@
+#include "testing/testing.hpp"
+
+#include "search/cbv.hpp"
+
+#include "coding/compressed_bit_vector.hpp"
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace cbv_test
+{
+using namespace search;
+using std::vector;
+
+vector<uint64_t> GetSetBits(CBV const & cbv)
+{
+  vector<uint64_t> result;
+  cbv.ForEach([&result](uint64_t id) { result.push_back(id); });
+  return result;
+}
+
+CBV MakeChunked(vector<uint64_t> const & setBits)
+{
+  return CBV(std::make_unique<coding::ChunkedCBV>(setBits));
+}
+
+UNIT_TEST(CBV_IntersectWith)
+{
+  vector<uint64_t> bits1;
+  vector<uint64_t> bits2;
+  vector<uint64_t> expected;
+  for (uint64_t i = 0; i < 200000; ++i)
+  {
+    if (i % 3 == 0)
+      bits1.push_back(i);
+    if (i % 5 == 0)
+      bits2.push_back(i);
+    if (i % 15 == 0)
+      expected.push_back(i);
+  }
+
+  // In place.
+  auto cbv = MakeChunked(bits1);
+  cbv.IntersectWith(MakeChunked(bits2));
+  TEST_EQUAL(GetSetBits(cbv), expected, ());
+
+  // A shared bit vector must not be changed.
+  auto const shared = MakeChunked(bits1);
+  auto copy = shared;
+  copy.IntersectWith(CBV(coding::CompressedBitVectorBuilder::FromBitPositions(bits2)));
+  TEST_EQUAL(GetSetBits(copy), expected, ());
+  TEST_EQUAL(GetSetBits(shared), bits1, ());
+
+  copy.IntersectWith(CBV::GetFull());
+  TEST_EQUAL(GetSetBits(copy), expected, ());
+  copy.IntersectWith(CBV());
+  TEST(copy.IsEmpty(), ());
+}
+
+UNIT_TEST(CBV_UniteWith)
+{
+  vector<uint64_t> const bits1 = {1, 100000, 100001};
+  vector<uint64_t> const bits2 = {2, 100001, 300000};
+
+  auto cbv = MakeChunked(bits1);
+  cbv.UniteWith(MakeChunked(bits2));
+  TEST_EQUAL(GetSetBits(cbv), vector<uint64_t>({1, 2, 100000, 100001, 300000}), ());
+
+  CBV empty;
+  empty.UniteWith(cbv);
+  TEST_EQUAL(GetSetBits(empty), GetSetBits(cbv), ());
+
+  cbv.UniteWith(CBV::GetFull());
+  TEST(cbv.IsFull(), ());
+}
+}  // namespace cbv_test
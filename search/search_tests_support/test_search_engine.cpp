@@ -33,5 +33,10 @@ weak_ptr<ProcessorHandle> TestSearchEngine::Search(SearchParams const & params)
 {
   return m_engine.Search(params);
 }
+
+weak_ptr<ProcessorHandle> TestSearchEngine::SearchBatch(vector<SearchParams> const & batch)
+{
+  return m_engine.SearchBatch(batch);
+}
 }  // namespace tests_support
 }  // namespace search
@@ -7,6 +7,7 @@
 
 #include <memory>
 #include <string>
+#include <vector>
 
 class DataSource;
 
@@ -28,6 +29,7 @@ public:
   void LoadCitiesBoundaries() { m_engine.LoadCitiesBoundaries(); }
 
   std::weak_ptr<ProcessorHandle> Search(SearchParams const & params);
+  std::weak_ptr<ProcessorHandle> SearchBatch(std::vector<SearchParams> const & batch);
 
   storage::CountryInfoGetter & GetCountryInfoGetter() { return *m_infoGetter; }
 
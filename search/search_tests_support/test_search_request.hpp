@@ -31,6 +31,9 @@ public:
 
   void SetCategorial() { m_params.m_categorialRequest = true; }
 
+  // Params with callbacks of this request, e.g. to run it as a part of a batch.
+  SearchParams const & GetParams() const { return m_params; }
+
   // Initiates the search and waits for it to finish.
   void Run();
 
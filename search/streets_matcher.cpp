@@ -114,7 +114,7 @@ void FindStreets(BaseContext const & ctx, CBV const & candidates, FeaturesFilter
       emit();
 
     streets = buffer;
-    all = all.Intersect(ctx.m_features[tag].m_features);
+    all.IntersectWith(ctx.m_features[tag].m_features);
     emptyIntersection = false;
 
   }, withMisprints);
@@ -15,8 +15,11 @@
 #include "base/logging.hpp"
 #include "base/string_utils.hpp"
 
+#include <algorithm>
+#include <cmath>
 #include <functional>
 #include <limits>
+#include <numeric>
 #include <utility>
 
 
@@ -34,6 +37,27 @@ CountryId CountryInfoGetterBase::GetRegionCountryId(m2::PointD const & pt) const
   return id == kInvalidId ? kInvalidCountryId : m_countries[id].m_countryId;
 }
 
+void CountryInfoGetterBase::GetRegionCountryIds(std::vector<m2::PointD> const & points,
+                                                CountriesVec & countryIds) const
+{
+  // Order points by 1x1 mercator cells to look up close points one after another.
+  auto const getCell = [](m2::PointD const & pt)
+  {
+    return std::make_pair(static_cast<int>(std::floor(pt.y)), static_cast<int>(std::floor(pt.x)));
+  };
+
+  std::vector<size_t> order(points.size());
+  std::iota(order.begin(), order.end(), 0);
+  std::sort(order.begin(), order.end(), [&](size_t lhs, size_t rhs)
+  {
+    return getCell(points[lhs]) < getCell(points[rhs]);
+  });
+
+  countryIds.assign(points.size(), kInvalidCountryId);
+  for (auto const i : order)
+    countryIds[i] = GetRegionCountryId(points[i]);
+}
+
 bool CountryInfoGetterBase::BelongsToAnyRegion(m2::PointD const & pt,
                                                RegionIdVec const & regions) const
 {
@@ -229,6 +253,14 @@ void CountryInfoReader::LoadRegionsFromDisk(size_t id, std::vector<m2::RegionD>
   }
 }
 
+void CountryInfoReader::BuildPolygonsIndex(CountryPolygonsIndex::Params const & params)
+{
+  m_polygonsIndex = std::make_unique<CountryPolygonsIndex>(
+      m_countries.size(),
+      [this](size_t id, std::vector<m2::RegionD> & regions) { LoadRegionsFromDisk(id, regions); },
+      params);
+}
+
 CountryInfoReader::CountryInfoReader(ModelReaderPtr polyR, ModelReaderPtr countryR)
   : m_reader(polyR), m_cache(3 /* logCacheSize */)
 
@@ -268,6 +300,16 @@ std::invoke_result_t<Fn, std::vector<m2::RegionD>> CountryInfoReader::WithRegion
   return fn(regions);
 }
 
+CountryInfoGetterBase::RegionId CountryInfoReader::FindFirstCountry(m2::PointD const & pt) const
+{
+  if (!m_polygonsIndex)
+    return CountryInfoGetter::FindFirstCountry(pt);
+
+  static_assert(CountryPolygonsIndex::kInvalidId == kInvalidId);
+  return m_polygonsIndex->FindFirstCountry(
+      pt, [this](m2::PointD const & p, size_t id) { return BelongsToRegion(p, id); });
+}
+
 bool CountryInfoReader::BelongsToRegion(m2::PointD const & pt, size_t id) const
 {
   if (!m_countries[id].m_rect.IsPointInside(pt))
@@ -2,6 +2,7 @@
 
 #include "storage/country.hpp"
 #include "storage/country_decl.hpp"
+#include "storage/country_polygons_index.hpp"
 #include "storage/storage_defines.hpp"
 
 #include "platform/platform.hpp"
@@ -40,6 +41,10 @@ public:
   // string.
   CountryId GetRegionCountryId(m2::PointD const & pt) const;
 
+  // Fills |countryIds| with country ids for |points|, see GetRegionCountryId(). Close points
+  // are looked up one after another, so it's faster than separate calls for scattered points.
+  void GetRegionCountryIds(std::vector<m2::PointD> const & points, CountriesVec & countryIds) const;
+
   // Returns true when |pt| belongs to at least one of the specified
   // |regions|.
   bool BelongsToAnyRegion(m2::PointD const & pt, RegionIdVec const & regions) const;
@@ -51,7 +56,7 @@ public:
 
 protected:
   // Returns identifier of the first country containing |pt| or |kInvalidId| if there is none.
-  RegionId FindFirstCountry(m2::PointD const & pt) const;
+  virtual RegionId FindFirstCountry(m2::PointD const & pt) const;
 
   // Returns true when |pt| belongs to the country identified by |id|.
   virtual bool BelongsToRegion(m2::PointD const & pt, size_t id) const = 0;
@@ -142,9 +147,17 @@ public:
   // Loads all regions for country number |id| from |m_reader|.
   void LoadRegionsFromDisk(size_t id, std::vector<m2::RegionD> & regions) const;
 
+  // Builds a resident index of simplified country borders, so the lookups of countries by
+  // points load polygons only for the points which are close to borders. It pays off for bulk
+  // lookups only. Must be called before the reader is shared between threads.
+  void BuildPolygonsIndex(CountryPolygonsIndex::Params const & params = {});
+
 protected:
   CountryInfoReader(ModelReaderPtr polyR, ModelReaderPtr countryR);
 
+  // CountryInfoGetterBase overrides:
+  RegionId FindFirstCountry(m2::PointD const & pt) const override;
+
   // CountryInfoGetter overrides:
   void ClearCachesImpl() const override;
   bool BelongsToRegion(m2::PointD const & pt, size_t id) const override;
@@ -157,6 +170,8 @@ protected:
   FilesContainerR m_reader;
   mutable base::Cache<uint32_t, std::vector<m2::RegionD>> m_cache;
   mutable std::mutex m_cacheMutex;
+
+  std::unique_ptr<CountryPolygonsIndex> m_polygonsIndex;
 };
 
 // This class allows users to get info about very simply rectangular
@@ -0,0 +1,338 @@
+#include "storage/country_polygons_index.hpp"
+
+#include "geometry/mercator.hpp"
+#include "geometry/parametrized_segment.hpp"
+#include "geometry/robust_orientation.hpp"
+#include "geometry/simplification.hpp"
+
+#include "base/assert.hpp"
+#include "base/logging.hpp"
+#include "base/math.hpp"
+
+#include <algorithm>
+#include <unordered_map>
+#include <utility>
+
+namespace storage
+{
+namespace
+{
+uint32_t constexpr kMinCellsPerSide = 16;
+// Candidates for a reference point of a cell: the center and the centers of the quarters.
+uint8_t constexpr kRefPointsCount = 5;
+
+template <typename T>
+size_t GetBytes(std::vector<T> const & v)
+{
+  return v.capacity() * sizeof(T);
+}
+}  // namespace
+
+CountryPolygonsIndex::CountryPolygonsIndex(size_t countriesCount, LoadRegionsFn const & loadRegions,
+                                           Params const & params)
+  : m_margin(2 * params.m_simplificationEps), m_countriesCount(countriesCount)
+{
+  CHECK_GREATER(params.m_simplificationEps, 0.0, ());
+
+  double const squaredEps = base::Pow2(params.m_simplificationEps);
+  std::vector<m2::RegionD> regions;
+  std::vector<m2::PointD> ring;
+  for (size_t id = 0; id < countriesCount; ++id)
+  {
+    loadRegions(id, regions);
+    for (auto const & region : regions)
+    {
+      // Such regions contain nothing.
+      if (region.Size() < 3)
+        continue;
+
+      auto const & points = region.Data();
+      ring.assign(points.cbegin(), points.cend());
+      if (ring.front() != ring.back())
+        ring.push_back(ring.front());
+
+      // Simplify two halves of the ring, because the ends of a simplified chain are fixed.
+      Ring r;
+      r.m_countryId = static_cast<uint32_t>(id);
+      r.m_begin = static_cast<uint32_t>(m_points.size());
+      auto const addPoint = [this, &r](m2::PointD const & p)
+      {
+        m_points.push_back(p);
+        r.m_rect.Add(p);
+      };
+      auto const middle = ring.begin() + ring.size() / 2;
+      SimplifyDP(ring.begin(), middle + 1, squaredEps, m2::SquaredDistanceFromSegmentToPoint(), addPoint);
+      m_points.pop_back();
+      SimplifyDP(middle, ring.end(), squaredEps, m2::SquaredDistanceFromSegmentToPoint(), addPoint);
+      r.m_end = static_cast<uint32_t>(m_points.size());
+      m_rings.push_back(r);
+    }
+  }
+
+  uint32_t cellsPerSide = std::max(params.m_maxCellsPerSide, kMinCellsPerSide);
+  while (true)
+  {
+    BuildGrid(cellsPerSide);
+    if (GetMemoryBytes() <= params.m_maxMemoryBytes || cellsPerSide / 2 < kMinCellsPerSide)
+      break;
+    cellsPerSide /= 2;
+  }
+
+  LOG(LINFO, ("Countries polygons index:", m_rings.size(), "rings,", m_points.size(), "points,",
+              m_cellsPerSide, "cells per side,", GetMemoryBytes(), "bytes."));
+}
+
+size_t CountryPolygonsIndex::FindFirstCountry(m2::PointD const & pt, ExactTestFn const & exactTest) const
+{
+  if (!mercator::Bounds::FullRect().IsPointInside(pt))
+  {
+    for (size_t id = 0; id < m_countriesCount; ++id)
+    {
+      if (exactTest(pt, id))
+        return id;
+    }
+    return kInvalidId;
+  }
+
+  uint32_t const x = GetCellCoord(pt.x);
+  uint32_t const y = GetCellCoord(pt.y);
+  m2::RectD const cellRect = GetCellRect(x, y);
+  size_t const cell = static_cast<size_t>(y) * m_cellsPerSide + x;
+
+  // Entries are ordered by country ids and a country may have several rings in a cell.
+  size_t unknownId = kInvalidId;
+  for (uint32_t i = m_cellOffsets[cell]; i < m_cellOffsets[cell + 1]; ++i)
+  {
+    auto const & entry = m_entries[i];
+    if (unknownId != kInvalidId && unknownId != entry.m_countryId)
+    {
+      if (exactTest(pt, unknownId))
+        return unknownId;
+      unknownId = kInvalidId;
+    }
+
+    switch (Check(entry, cellRect, pt))
+    {
+    case Result::Inside: return entry.m_countryId;
+    case Result::Outside: break;
+    case Result::Unknown: unknownId = entry.m_countryId; break;
+    }
+  }
+
+  if (unknownId != kInvalidId && exactTest(pt, unknownId))
+    return unknownId;
+
+  return kInvalidId;
+}
+
+size_t CountryPolygonsIndex::GetMemoryBytes() const
+{
+  return GetBytes(m_rings) + GetBytes(m_points) + GetBytes(m_cellOffsets) + GetBytes(m_entries) +
+         GetBytes(m_cellEdges);
+}
+
+void CountryPolygonsIndex::BuildGrid(uint32_t cellsPerSide)
+{
+  m_cellsPerSide = cellsPerSide;
+  m_cellSize = (mercator::Bounds::kMaxX - mercator::Bounds::kMinX) / cellsPerSide;
+
+  std::vector<std::pair<uint32_t, Entry>> cellEntries;
+  std::vector<uint32_t> cellEdges;
+  std::unordered_map<uint32_t, std::vector<uint32_t>> borderCells;
+  std::vector<double> crossings;
+
+  for (auto const & ring : m_rings)
+  {
+    // Cells which are closer than the margin to some edge of the ring.
+    borderCells.clear();
+    for (uint32_t i = ring.m_begin; i + 1 < ring.m_end; ++i)
+    {
+      m2::RectD rect(m_points[i], m_points[i + 1]);
+      rect.Inflate(m_margin, m_margin);
+      for (uint32_t y = GetCellCoord(rect.minY()); y <= GetCellCoord(rect.maxY()); ++y)
+      {
+        for (uint32_t x = GetCellCoord(rect.minX()); x <= GetCellCoord(rect.maxX()); ++x)
+          borderCells[y * cellsPerSide + x].push_back(i);
+      }
+    }
+
+    m2::RectD rect = ring.m_rect;
+    rect.Inflate(m_margin, m_margin);
+    uint32_t const minX = GetCellCoord(rect.minX());
+    uint32_t const maxX = GetCellCoord(rect.maxX());
+    for (uint32_t y = GetCellCoord(rect.minY()); y <= GetCellCoord(rect.maxY()); ++y)
+    {
+      // Crossings of the horizontal line through the centers of the row cells with the ring.
+      double const centerY = GetCellRect(minX, y).Center().y;
+      crossings.clear();
+      for (uint32_t i = ring.m_begin; i + 1 < ring.m_end; ++i)
+      {
+        auto const & a = m_points[i];
+        auto const & b = m_points[i + 1];
+        if ((a.y > centerY) != (b.y > centerY))
+          crossings.push_back(a.x + (centerY - a.y) * (b.x - a.x) / (b.y - a.y));
+      }
+      std::sort(crossings.begin(), crossings.end());
+
+      size_t crossingsOnLeft = 0;
+      for (uint32_t x = minX; x <= maxX; ++x)
+      {
+        m2::RectD const cellRect = GetCellRect(x, y);
+        m2::PointD const center = cellRect.Center();
+        while (crossingsOnLeft < crossings.size() && crossings[crossingsOnLeft] < center.x)
+          ++crossingsOnLeft;
+        bool const centerInside = (crossings.size() - crossingsOnLeft) % 2 == 1;
+
+        uint32_t const cell = y * cellsPerSide + x;
+        Entry entry;
+        entry.m_countryId = ring.m_countryId;
+
+        auto const it = borderCells.find(cell);
+        if (it == borderCells.cend())
+        {
+          // The whole cell is either inside or outside the ring.
+          if (centerInside)
+          {
+            entry.m_refPoint = 0;
+            entry.m_refInside = true;
+            cellEntries.emplace_back(cell, entry);
+          }
+          continue;
+        }
+
+        entry.m_edgesBegin = static_cast<uint32_t>(cellEdges.size());
+        cellEdges.insert(cellEdges.end(), it->second.cbegin(), it->second.cend());
+        entry.m_edgesEnd = static_cast<uint32_t>(cellEdges.size());
+
+        for (uint8_t refPoint = 0; refPoint < kRefPointsCount; ++refPoint)
+        {
+          auto const p = GetRefPoint(cellRect, refPoint);
+          if (!IsFarFromEdges(p, entry.m_edgesBegin, entry.m_edgesEnd, cellEdges))
+            continue;
+
+          entry.m_refPoint = refPoint;
+          entry.m_refInside = refPoint == 0 ? centerInside : IsInsideRing(ring, p);
+          break;
+        }
+        cellEntries.emplace_back(cell, entry);
+      }
+    }
+  }
+
+  std::stable_sort(cellEntries.begin(), cellEntries.end(), [](auto const & lhs, auto const & rhs)
+  {
+    if (lhs.first != rhs.first)
+      return lhs.first < rhs.first;
+    return lhs.second.m_countryId < rhs.second.m_countryId;
+  });
+
+  size_t const cellsCount = static_cast<size_t>(cellsPerSide) * cellsPerSide;
+  m_cellOffsets.assign(cellsCount + 1, 0);
+  for (auto const & cellEntry : cellEntries)
+    ++m_cellOffsets[cellEntry.first + 1];
+  for (size_t i = 0; i < cellsCount; ++i)
+    m_cellOffsets[i + 1] += m_cellOffsets[i];
+
+  m_entries.clear();
+  m_entries.reserve(cellEntries.size());
+  for (auto const & cellEntry : cellEntries)
+    m_entries.push_back(cellEntry.second);
+
+  cellEdges.shrink_to_fit();
+  m_cellEdges = std::move(cellEdges);
+}
+
+uint32_t CountryPolygonsIndex::GetCellCoord(double coord) const
+{
+  auto const c = static_cast<int64_t>((coord - mercator::Bounds::kMinX) / m_cellSize);
+  return static_cast<uint32_t>(base::Clamp(c, int64_t{0}, static_cast<int64_t>(m_cellsPerSide) - 1));
+}
+
+m2::RectD CountryPolygonsIndex::GetCellRect(uint32_t x, uint32_t y) const
+{
+  double const minX = mercator::Bounds::kMinX + x * m_cellSize;
+  double const minY = mercator::Bounds::kMinY + y * m_cellSize;
+  return {minX, minY, minX + m_cellSize, minY + m_cellSize};
+}
+
+m2::PointD CountryPolygonsIndex::GetRefPoint(m2::RectD const & cellRect, uint8_t refPoint) const
+{
+  ASSERT_LESS(refPoint, kRefPointsCount, ());
+  auto const center = cellRect.Center();
+  if (refPoint == 0)
+    return center;
+
+  double const dx = (refPoint % 2 == 0 ? 1 : -1) * cellRect.SizeX() / 4;
+  double const dy = (refPoint <= 2 ? 1 : -1) * cellRect.SizeY() / 4;
+  return {center.x + dx, center.y + dy};
+}
+
+bool CountryPolygonsIndex::IsFarFromEdges(m2::PointD const & pt, uint32_t edgesBegin,
+                                          uint32_t edgesEnd,
+                                          std::vector<uint32_t> const & cellEdges) const
+{
+  double const squaredMargin = base::Pow2(m_margin);
+  for (uint32_t i = edgesBegin; i < edgesEnd; ++i)
+  {
+    uint32_t const edge = cellEdges[i];
+    m2::ParametrizedSegment<m2::PointD> const segment(m_points[edge], m_points[edge + 1]);
+    if (segment.SquaredDistanceToPoint(pt) <= squaredMargin)
+      return false;
+  }
+  return true;
+}
+
+bool CountryPolygonsIndex::IsInsideRing(Ring const & ring, m2::PointD const & pt) const
+{
+  bool inside = false;
+  for (uint32_t i = ring.m_begin; i + 1 < ring.m_end; ++i)
+  {
+    auto const & a = m_points[i];
+    auto const & b = m_points[i + 1];
+    if ((a.y > pt.y) != (b.y > pt.y) && pt.x < a.x + (pt.y - a.y) * (b.x - a.x) / (b.y - a.y))
+      inside = !inside;
+  }
+  return inside;
+}
+
+CountryPolygonsIndex::Result CountryPolygonsIndex::Check(Entry const & entry,
+                                                         m2::RectD const & cellRect,
+                                                         m2::PointD const & pt) const
+{
+  if (entry.m_edgesBegin == entry.m_edgesEnd)
+    return entry.m_refInside ? Result::Inside : Result::Outside;
+
+  if (entry.m_refPoint == kNoRefPoint ||
+      !IsFarFromEdges(pt, entry.m_edgesBegin, entry.m_edgesEnd, m_cellEdges))
+  {
+    return Result::Unknown;
+  }
+
+  // Both the reference point and |pt| are in the cell and far from the edges, so all the edges
+  // crossed by the segment between them are in the cell and the crossings are proper.
+  auto const ref = GetRefPoint(cellRect, entry.m_refPoint);
+  bool inside = entry.m_refInside;
+  for (uint32_t i = entry.m_edgesBegin; i < entry.m_edgesEnd; ++i)
+  {
+    uint32_t const edge = m_cellEdges[i];
+    auto const & a = m_points[edge];
+    auto const & b = m_points[edge + 1];
+
+    double const refSide = m2::robust::OrientedS(a, b, ref);
+    double const ptSide = m2::robust::OrientedS(a, b, pt);
+    if (refSide == 0.0 || ptSide == 0.0 || (refSide > 0.0) == (ptSide > 0.0))
+      continue;
+
+    double const aSide = m2::robust::OrientedS(ref, pt, a);
+    double const bSide = m2::robust::OrientedS(ref, pt, b);
+    // The segment goes through a vertex.
+    if (aSide == 0.0 || bSide == 0.0)
+      return Result::Unknown;
+
+    if ((aSide > 0.0) != (bSide > 0.0))
+      inside = !inside;
+  }
+
+  return inside ? Result::Inside : Result::Outside;
+}
+}  // namespace storage
@@ -0,0 +1,110 @@
+#pragma once
+
+#include "geometry/point2d.hpp"
+#include "geometry/rect2d.hpp"
+#include "geometry/region2d.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <vector>
+
+namespace storage
+{
+// Resident index which answers point-in-country queries without loading country polygons.
+// Borders are simplified with |m_simplificationEps| tolerance and put into a uniform grid.
+// A cell which is farther than 2 * |m_simplificationEps| from the simplified borders of a region
+// is entirely inside or outside the region. Otherwise a point is compared with a reference
+// point of the cell by counting crossings with the simplified borders. Such answers are exact,
+// because the simplified and the original borders are close to each other. The points which are
+// too close to the simplified borders are checked by the caller's exact test.
+class CountryPolygonsIndex
+{
+public:
+  struct Params
+  {
+    // In mercator units, 1e-4 is about 10 meters on the equator.
+    double m_simplificationEps = 1e-4;
+    // The grid is made coarser until the index fits into the budget.
+    size_t m_maxMemoryBytes = 64 * 1024 * 1024;
+    uint32_t m_maxCellsPerSide = 1024;
+  };
+
+  static size_t constexpr kInvalidId = std::numeric_limits<size_t>::max();
+
+  // Loads all the regions of the country |id|.
+  using LoadRegionsFn = std::function<void(size_t id, std::vector<m2::RegionD> & regions)>;
+  // Returns true if |pt| belongs to the country |id|.
+  using ExactTestFn = std::function<bool(m2::PointD const & pt, size_t id)>;
+
+  CountryPolygonsIndex(size_t countriesCount, LoadRegionsFn const & loadRegions,
+                       Params const & params);
+
+  // Returns the smallest id of a country which contains |pt| or |kInvalidId|.
+  // |exactTest| is called for the countries the index can't decide on.
+  size_t FindFirstCountry(m2::PointD const & pt, ExactTestFn const & exactTest) const;
+
+  uint32_t GetCellsPerSide() const { return m_cellsPerSide; }
+  size_t GetMemoryBytes() const;
+
+private:
+  static uint8_t constexpr kNoRefPoint = std::numeric_limits<uint8_t>::max();
+
+  // A region which intersects a cell.
+  struct Entry
+  {
+    uint32_t m_countryId = 0;
+    // Range of |m_cellEdges| with the edges of the region near the cell. Empty if the whole
+    // cell is inside the region.
+    uint32_t m_edgesBegin = 0;
+    uint32_t m_edgesEnd = 0;
+    uint8_t m_refPoint = kNoRefPoint;
+    bool m_refInside = false;
+  };
+
+  // Simplified closed ring of a region.
+  struct Ring
+  {
+    uint32_t m_countryId = 0;
+    // Range of |m_points|, the last point is equal to the first one.
+    uint32_t m_begin = 0;
+    uint32_t m_end = 0;
+    m2::RectD m_rect;
+  };
+
+  enum class Result
+  {
+    Inside,
+    Outside,
+    Unknown
+  };
+
+  void BuildGrid(uint32_t cellsPerSide);
+
+  uint32_t GetCellCoord(double coord) const;
+  m2::RectD GetCellRect(uint32_t x, uint32_t y) const;
+  m2::PointD GetRefPoint(m2::RectD const & cellRect, uint8_t refPoint) const;
+
+  // Returns true if |pt| is farther than the margin from all the edges in
+  // [edgesBegin, edgesEnd) range of |cellEdges|.
+  bool IsFarFromEdges(m2::PointD const & pt, uint32_t edgesBegin, uint32_t edgesEnd,
+                      std::vector<uint32_t> const & cellEdges) const;
+  bool IsInsideRing(Ring const & ring, m2::PointD const & pt) const;
+  Result Check(Entry const & entry, m2::RectD const & cellRect, m2::PointD const & pt) const;
+
+  double m_margin = 0.0;
+  size_t m_countriesCount = 0;
+  uint32_t m_cellsPerSide = 0;
+  double m_cellSize = 0.0;
+
+  std::vector<Ring> m_rings;
+  std::vector<m2::PointD> m_points;
+
+  // Entries of the cell i are [m_cellOffsets[i], m_cellOffsets[i + 1]), ordered by country ids.
+  std::vector<uint32_t> m_cellOffsets;
+  std::vector<Entry> m_entries;
+  // Indices of the first points of the edges in |m_points|.
+  std::vector<uint32_t> m_cellEdges;
+};
+}  // namespace storage
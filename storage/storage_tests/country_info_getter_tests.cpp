@@ -249,6 +249,50 @@ UNIT_TEST(CountryInfoGetter_RegionRects)
   }
 }
 
+UNIT_TEST(CountryInfoGetter_PolygonsIndex)
+{
+  auto reader = CountryInfoReader::CreateCountryInfoReader(GetPlatform());
+  CHECK(reader != nullptr, ());
+  auto indexedReader = CountryInfoReader::CreateCountryInfoReader(GetPlatform());
+  CHECK(indexedReader != nullptr, ());
+  indexedReader->BuildPolygonsIndex();
+
+  mt19937 rng(0);
+  vector<m2::PointD> points;
+
+  // Points all over the world.
+  uniform_real_distribution<double> coordDistr(mercator::Bounds::kMinX, mercator::Bounds::kMaxX);
+  for (size_t i = 0; i < 10000; ++i)
+    points.emplace_back(coordDistr(rng), coordDistr(rng));
+
+  // Points on and near borders.
+  auto const & countries = reader->GetCountries();
+  uniform_real_distribution<double> offsetDistr(-1e-3, 1e-3);
+  for (size_t id = 0; id < countries.size(); ++id)
+  {
+    vector<m2::RegionD> regions;
+    reader->LoadRegionsFromDisk(id, regions);
+    for (auto const & region : regions)
+    {
+      auto const & regionPoints = region.Data();
+      uniform_int_distribution<size_t> pointDistr(0, regionPoints.size() - 1);
+      auto const & pt = regionPoints[pointDistr(rng)];
+      points.push_back(pt);
+      points.emplace_back(pt.x + offsetDistr(rng), pt.y + offsetDistr(rng));
+    }
+  }
+
+  CountriesVec countryIds;
+  indexedReader->GetRegionCountryIds(points, countryIds);
+  TEST_EQUAL(countryIds.size(), points.size(), ());
+  for (size_t i = 0; i < points.size(); ++i)
+  {
+    auto const expected = reader->GetRegionCountryId(points[i]);
+    TEST_EQUAL(indexedReader->GetRegionCountryId(points[i]), expected, (points[i]));
+    TEST_EQUAL(countryIds[i], expected, (points[i]));
+  }
+}
+
 // This is a test for consistency between data/countries.txt and data/packed_polygons.bin.
 UNIT_TEST(CountryInfoGetter_Countries_And_Polygons)
 {
@@ -424,3 +468,51 @@ BENCHMARK_TEST(CountryInfoGetter_RegionsByRect)
                 avgTimeByCountry[longest]));
   }
 }
+
+BENCHMARK_TEST(CountryInfoGetter_PolygonsIndex)
+{
+  auto reader = CountryInfoReader::CreateCountryInfoReader(GetPlatform());
+  CHECK(reader != nullptr, ());
+
+  // Points scattered over all the countries like the points of bulk jobs.
+  vector<m2::RegionD> allRegions;
+  for (size_t id = 0; id < reader->GetCountries().size(); ++id)
+  {
+    vector<m2::RegionD> regions;
+    reader->LoadRegionsFromDisk(id, regions);
+    allRegions.insert(allRegions.end(), regions.begin(), regions.end());
+  }
+
+  mt19937 rng(0);
+  RandomPointGenerator pointGen(rng, allRegions);
+  vector<m2::PointD> points;
+  for (size_t i = 0; i < 100000; ++i)
+    points.push_back(pointGen());
+
+  base::Timer timer;
+  CountriesVec expected;
+  for (auto const & pt : points)
+    expected.push_back(reader->GetRegionCountryId(pt));
+  LOG(LINFO, ("Point by point:", timer.ElapsedSeconds(), "seconds"));
+
+  timer.Reset();
+  CountriesVec countryIds;
+  reader->GetRegionCountryIds(points, countryIds);
+  LOG(LINFO, ("Batch:", timer.ElapsedSeconds(), "seconds"));
+  TEST_EQUAL(countryIds, expected, ());
+
+  timer.Reset();
+  reader->BuildPolygonsIndex();
+  LOG(LINFO, ("Index building:", timer.ElapsedSeconds(), "seconds"));
+
+  timer.Reset();
+  for (size_t i = 0; i < points.size(); ++i)
+    countryIds[i] = reader->GetRegionCountryId(points[i]);
+  LOG(LINFO, ("Point by point with index:", timer.ElapsedSeconds(), "seconds"));
+  TEST_EQUAL(countryIds, expected, ());
+
+  timer.Reset();
+  reader->GetRegionCountryIds(points, countryIds);
+  LOG(LINFO, ("Batch with index:", timer.ElapsedSeconds(), "seconds"));
+  TEST_EQUAL(countryIds, expected, ());
+}
@@ -38,6 +38,7 @@ class GenTool:
         "make_coasts": bool,
         "make_cross_mwm": bool,
         "make_routing_index": bool,
+        "make_routing_shortcuts": bool,
         "make_transit_cross_mwm": bool,
         "make_transit_cross_mwm_experimental": bool,
         "preprocess": bool,
@@ -10,10 +10,23 @@ from src.logger import LOG
 from src import graph_scripts, utils
 
 
+def get_version_name(*, version):
+    version_name = utils.get_branch_hash_name(branch=version['branch'], hash=version['hash'])
+    if version['astar_queue'] is not None:
+        version_name += f'_{version["astar_queue"]}'
+    return version_name
+
+
+def get_binary_cache_suffix(*, version):
+    suffix = 'heap'
+    if version['astar_queue'] is not None:
+        suffix += f'_{version["astar_queue"]}'
+    return suffix
+
+
 def get_version_dump_path(*, config_ini, version):
     results_save_dir = config_ini.read_value_by_path(path=['PATHS', 'ResultsSaveDir'])
-    branch_hash = utils.get_branch_hash_name(branch=version['branch'], hash=version['hash'])
-    return os.path.join(results_save_dir, branch_hash)
+    return os.path.join(results_save_dir, get_version_name(version=version))
 
 
 def get_version_heapprof_dump_path(*, config_ini, version):
@@ -63,8 +76,8 @@ def run_routes_builder_tool_one_route(omim, version, config_ini, id, route_line)
         'HEAPPROFILE': heap_prof_path
     }
 
-    omim.run(binary='routes_builder_tool', binary_cache_suffix='heap', args=args, env=env, output_file=output_file,
-             log_error_code=False)
+    omim.run(binary='routes_builder_tool', binary_cache_suffix=get_binary_cache_suffix(version=version), args=args,
+             env=env, output_file=output_file, log_error_code=False)
     return {'id': id,
             'max_mb_usage': get_max_mb_usage(log_file=output_file)}
 
@@ -78,7 +91,7 @@ def run_heap_comparison(*, omim, config_ini, versions):
         branch = version['branch']
         hash = version['hash']
 
-        branch_hash = utils.get_branch_hash_name(branch=branch, hash=hash)
+        branch_hash = get_version_name(version=version)
 
         version_dump_path = get_version_dump_path(config_ini=config_ini, version=version)
         heapprof_dump_path = get_version_heapprof_dump_path(config_ini=config_ini, version=version)
@@ -91,7 +104,12 @@ def run_heap_comparison(*, omim, config_ini, versions):
         LOG.info(f'Get: {name} {branch_hash}')
 
         omim.checkout(branch=branch, hash=hash)
-        omim.build(aim='routes_builder_tool', binary_cache_suffix='heap', cmake_options="-DUSE_HEAPPROF=ON")
+        # The build directory is shared by the versions and CMake keeps the cached ASTAR_QUEUE
+        # of the previous build, so the queue is always set. Revisions without the option ignore it.
+        astar_queue = version['astar_queue'] or 'lazy'
+        cmake_options = f'-DUSE_HEAPPROF=ON -DASTAR_QUEUE={astar_queue}'
+        omim.build(aim='routes_builder_tool', binary_cache_suffix=get_binary_cache_suffix(version=version),
+                   cmake_options=cmake_options)
 
         LOG.info(f'Start build routes from file: {routes_file}')
         pool_args = []
@@ -212,8 +230,8 @@ def compare_two_versions(*, config_ini, old_version_data, new_version_data):
 def run_results_comparison(*, config_ini, old_versions, new_versions, data_from_heap_comparison):
     for old_version in old_versions:
         for new_version in new_versions:
-            old_branch_hash = utils.get_branch_hash_name(branch=old_version['branch'], hash=old_version['hash'])
-            new_branch_hash = utils.get_branch_hash_name(branch=new_version['branch'], hash=new_version['hash'])
+            old_branch_hash = get_version_name(version=old_version)
+            new_branch_hash = get_version_name(version=new_version)
 
             compare_two_versions(config_ini=config_ini,
                                  old_version_data=data_from_heap_comparison[old_branch_hash],
@@ -226,6 +244,10 @@ def main():
     old_versions = utils.load_run_config_ini(config_ini=config_ini, path=["OLD_VERSION", "Params"])
     new_versions = utils.load_run_config_ini(config_ini=config_ini, path=["NEW_VERSION", "Params"])
 
+    for version in old_versions + new_versions:
+        if 'astar_queue' not in version:
+            version['astar_queue'] = None
+
     all_versions = []
     all_versions.extend(old_versions)
     all_versions.extend(new_versions)
@@ -76,13 +76,13 @@ bool LoadTileProfiles(std::string const & fileName, std::set<std::string> & prof
 class SrtmProvider : public ValuesProvider<Altitude>
 {
 public:
-  explicit SrtmProvider(std::string const & srtmDir):
-    m_srtmManager(srtmDir)
+  explicit SrtmProvider(generator::SrtmTileManager & srtmManager):
+    m_srtmManager(srtmManager)
   {}
 
   void SetPrefferedTile(ms::LatLon const & pos)
   {
-    m_preferredTile = &m_srtmManager.GetTile(pos);
+    m_preferredTile = m_srtmManager.GetTile(pos);
     m_leftBottomOfPreferredTile = {std::floor(pos.m_lat), std::floor(pos.m_lon)};
   }
 
@@ -164,8 +164,8 @@ private:
     return kernel[kernel.size() / 2];
   }
 
-  generator::SrtmTileManager m_srtmManager;
-  generator::SrtmTile const * m_preferredTile = nullptr;
+  generator::SrtmTileManager & m_srtmManager;
+  std::shared_ptr<generator::SrtmTile const> m_preferredTile;
   ms::LatLon m_leftBottomOfPreferredTile;
 };
 
@@ -239,22 +239,28 @@ class TileIsolinesTask
 {
 public:
   TileIsolinesTask(int left, int bottom, int right, int top, std::string const & srtmDir,
-                   TileIsolinesParams const * params, bool forceRegenerate)
+                   generator::SrtmTileManager & srtmManager,
+                   TileIsolinesParams const * params, bool forceRegenerate,
+                   size_t squaresThreadsCount)
     : m_strmDir(srtmDir)
-    , m_srtmProvider(srtmDir)
+    , m_srtmProvider(srtmManager)
     , m_params(params)
     , m_forceRegenerate(forceRegenerate)
+    , m_squaresThreadsCount(squaresThreadsCount)
   {
     CHECK(params != nullptr, ());
     Init(left, bottom, right, top);
   }
 
   TileIsolinesTask(int left, int bottom, int right, int top, std::string const & srtmDir,
-                   TileIsolinesProfileParams const * profileParams, bool forceRegenerate)
+                   generator::SrtmTileManager & srtmManager,
+                   TileIsolinesProfileParams const * profileParams, bool forceRegenerate,
+                   size_t squaresThreadsCount)
     : m_strmDir(srtmDir)
-    , m_srtmProvider(srtmDir)
+    , m_srtmProvider(srtmManager)
     , m_profileParams(profileParams)
     , m_forceRegenerate(forceRegenerate)
+    , m_squaresThreadsCount(squaresThreadsCount)
   {
     CHECK(profileParams != nullptr, ());
     Init(left, bottom, right, top);
@@ -405,7 +411,7 @@ private:
 
     MarchingSquares<Altitude> squares(leftBottom, rightTop,
                                       squaresStep, params.m_alitudesStep,
-                                      altProvider, m_debugId);
+                                      altProvider, m_debugId, m_squaresThreadsCount);
     squares.GenerateContours(contours);
   }
 
@@ -418,19 +424,25 @@ private:
   TileIsolinesParams const * m_params = nullptr;
   TileIsolinesProfileParams const * m_profileParams = nullptr;
   bool m_forceRegenerate;
+  size_t m_squaresThreadsCount;
   std::string m_debugId;
 };
 
 template <typename ParamsType>
 void RunGenerateIsolinesTasks(int left, int bottom, int right, int top,
-                              std::string const & srtmPath, ParamsType const & params,
-                              long threadsCount, long maxCachedTilesPerThread,
-                              bool forceRegenerate)
+                              std::string const & srtmPath, std::string const & srtmCachePath,
+                              ParamsType const & params, long threadsCount,
+                              long maxCachedTilesPerThread, bool forceRegenerate)
 {
   std::vector<std::unique_ptr<TileIsolinesTask>> tasks;
 
-  CHECK_GREATER(right, left, ());
-  CHECK_GREATER(top, bottom, ());
+  // There are no tasks for an empty tiles range, so the threads can't be split between them.
+  if (right <= left || top <= bottom)
+  {
+    LOG(LWARNING, ("Empty tiles range. Left:", left, "bottom:", bottom, "right:", right,
+                   "top:", top));
+    return;
+  }
 
   int tilesRowPerTask = top - bottom;
   int tilesColPerTask = right - left;
@@ -451,6 +463,18 @@ void RunGenerateIsolinesTasks(int left, int bottom, int right, int top,
     }
   }
 
+  // Threads which are not busy with tasks are used to generate isolines of a tile.
+  long const tasksCount = ((top - bottom + tilesRowPerTask - 1) / tilesRowPerTask) *
+                          ((right - left + tilesColPerTask - 1) / tilesColPerTask);
+  auto const squaresThreadsCount = static_cast<size_t>(std::max(threadsCount / tasksCount, 1L));
+
+  // All the tasks share tiles. Tasks cover adjacent areas and load the border tiles of
+  // their neighbours, so the shared cache is bigger than the one of a single task.
+  generator::SrtmTileManager srtmManager(
+      srtmPath, static_cast<size_t>(std::max(threadsCount * (maxCachedTilesPerThread + 2), 1L)),
+      srtmCachePath);
+
+  // The pool is destroyed before |srtmManager| after all the tasks are done.
   base::thread_pool::computational::ThreadPool threadPool(threadsCount);
 
   for (int lat = bottom; lat < top; lat += tilesRowPerTask)
@@ -459,8 +483,9 @@ void RunGenerateIsolinesTasks(int left, int bottom, int right, int top,
     for (int lon = left; lon < right; lon += tilesColPerTask)
     {
       int const rightLon = std::min(lon + tilesColPerTask - 1, right - 1);
-      auto task = std::make_unique<TileIsolinesTask>(lon, lat, rightLon, topLat, srtmPath, &params,
-                                                     forceRegenerate);
+      auto task = std::make_unique<TileIsolinesTask>(lon, lat, rightLon, topLat, srtmPath,
+                                                     srtmManager, &params, forceRegenerate,
+                                                     squaresThreadsCount);
       threadPool.SubmitWork([task = std::move(task)](){ task->Do(); });
     }
   }
@@ -468,17 +493,19 @@ void RunGenerateIsolinesTasks(int left, int bottom, int right, int top,
 }  // namespace
 
 Generator::Generator(std::string const & srtmPath, long threadsCount,
-                     long maxCachedTilesPerThread, bool forceRegenerate)
+                     long maxCachedTilesPerThread, bool forceRegenerate,
+                     std::string const & srtmCachePath)
   : m_threadsCount(threadsCount)
   , m_maxCachedTilesPerThread(maxCachedTilesPerThread)
   , m_srtmPath(srtmPath)
+  , m_srtmCachePath(srtmCachePath)
   , m_forceRegenerate(forceRegenerate)
 {}
 
 void Generator::GenerateIsolines(int left, int bottom, int right, int top,
                                  TileIsolinesParams const & params)
 {
-  RunGenerateIsolinesTasks(left, bottom, right, top, m_srtmPath, params,
+  RunGenerateIsolinesTasks(left, bottom, right, top, m_srtmPath, m_srtmCachePath, params,
                            m_threadsCount, m_maxCachedTilesPerThread, m_forceRegenerate);
 }
 
@@ -487,7 +514,7 @@ void Generator::GenerateIsolines(int left, int bottom, int right, int top,
                                  std::string const & tilesProfilesDir)
 {
   TileIsolinesProfileParams params(m_profileToTileParams, tilesProfilesDir);
-  RunGenerateIsolinesTasks(left, bottom, right, top, m_srtmPath, params,
+  RunGenerateIsolinesTasks(left, bottom, right, top, m_srtmPath, m_srtmCachePath, params,
                            m_threadsCount, m_maxCachedTilesPerThread, m_forceRegenerate);
 }
 
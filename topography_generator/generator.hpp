@@ -51,8 +51,9 @@ using ProfileToIsolinesPackingParams = std::map<std::string, IsolinesPackingPara
 class Generator
 {
 public:
+  // Zipped SRTM tiles are decompressed into |srtmCachePath| if it's not empty.
   Generator(std::string const & srtmPath, long threadsCount, long maxCachedTilesPerThread,
-            bool forceRegenerate);
+            bool forceRegenerate, std::string const & srtmCachePath = {});
 
   void InitCountryInfoGetter(std::string const & dataDir);
 
@@ -98,6 +99,7 @@ private:
   long m_threadsCount;
   long m_maxCachedTilesPerThread;
   std::string m_srtmPath;
+  std::string m_srtmCachePath;
   bool m_forceRegenerate;
 };
 }  // namespace topography_generator
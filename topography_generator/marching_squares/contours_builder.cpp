@@ -2,6 +2,11 @@
 
 #include "geometry/mercator.hpp"
 
+#include "base/assert.hpp"
+
+#include <cmath>
+#include <iterator>
+
 namespace topography_generator
 {
 ContoursBuilder::ContoursBuilder(size_t levelsCount, std::string const & debugId)
@@ -76,6 +81,68 @@ void ContoursBuilder::EndLine(bool finalLine)
   }
 }
 
+void ContoursBuilder::AppendTopBand(ContoursBuilder && rhs, double borderLat)
+{
+  CHECK_EQUAL(m_levelsCount, rhs.m_levelsCount, (m_debugId));
+
+  auto const isOnBorder = [borderLat](ms::LatLon const & pos)
+  {
+    return fabs(pos.m_lat - borderLat) < mercator::kPointEqualityEps;
+  };
+
+  for (size_t levelInd = 0; levelInd < m_levelsCount; ++levelInd)
+  {
+    CHECK(m_activeContours[levelInd].empty() && rhs.m_activeContours[levelInd].empty(), (m_debugId));
+
+    auto & contours = m_finalizedContours[levelInd];
+    contours.splice(contours.end(), rhs.m_finalizedContours[levelInd]);
+
+    // Only contours with an end on the border may continue in the other band.
+    ContoursList crossing;
+    for (auto it = contours.begin(); it != contours.end();)
+    {
+      auto const current = it++;
+      if (isOnBorder(current->front()) || isOnBorder(current->back()))
+        crossing.splice(crossing.end(), contours, current);
+    }
+
+    while (!crossing.empty())
+    {
+      auto contour = std::move(crossing.front());
+      crossing.pop_front();
+
+      bool stitched = true;
+      while (stitched)
+      {
+        stitched = false;
+        for (auto it = crossing.begin(); it != crossing.end(); ++it)
+        {
+          if (isOnBorder(contour.back()) &&
+              it->front().EqualDxDy(contour.back(), mercator::kPointEqualityEps))
+          {
+            contour.insert(contour.end(), std::next(it->begin()), it->end());
+          }
+          else if (isOnBorder(contour.front()) &&
+                   it->back().EqualDxDy(contour.front(), mercator::kPointEqualityEps))
+          {
+            contour.insert(contour.begin(), it->begin(), std::prev(it->end()));
+          }
+          else
+          {
+            continue;
+          }
+
+          crossing.erase(it);
+          stitched = true;
+          break;
+        }
+      }
+
+      contours.push_back(std::move(contour));
+    }
+  }
+}
+
 ContoursBuilder::ActiveContourIter ContoursBuilder::FindContourWithStartPoint(size_t levelInd, ms::LatLon const & pos)
 {
   auto & contours = m_activeContours[levelInd];
@@ -22,6 +22,11 @@ public:
   void BeginLine();
   void EndLine(bool finalLine);
 
+  // Appends contours of |rhs| which are built for the lines right above the lines of this builder.
+  // Contours which cross the border line at |borderLat| are stitched. Both builders must be
+  // finished with the final line.
+  void AppendTopBand(ContoursBuilder && rhs, double borderLat);
+
   template <typename ValueType>
   void GetContours(ValueType minValue, ValueType valueStep,
                    std::unordered_map<ValueType, std::vector<Contour>> & contours)
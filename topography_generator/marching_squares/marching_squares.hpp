@@ -3,23 +3,37 @@
 #include "topography_generator/marching_squares/contours_builder.hpp"
 #include "topography_generator/marching_squares/square.hpp"
 #include "topography_generator/utils/contours.hpp"
+#include "topography_generator/utils/values_provider.hpp"
 
+#include "base/assert.hpp"
 #include "base/logging.hpp"
+#include "base/thread_pool_computational.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <future>
+#include <limits>
+#include <string>
+#include <vector>
 
 namespace topography_generator
 {
+// Values are read from |valuesProvider| once and in one thread, so the provider doesn't need
+// to be thread-safe. Then the grid is split into |threadsCount| bands of lines which are
+// processed concurrently, and contours crossing the borders of bands are stitched.
 template <typename ValueType>
 class MarchingSquares
 {
 public:
   MarchingSquares(ms::LatLon const & leftBottom, ms::LatLon const & rightTop,
                   double step, ValueType valueStep, ValuesProvider<ValueType> & valuesProvider,
-                  std::string const & debugId)
+                  std::string const & debugId, size_t threadsCount = 1)
     : m_leftBottom(leftBottom)
     , m_rightTop(rightTop)
     , m_step(step)
     , m_valueStep(valueStep)
     , m_valuesProvider(valuesProvider)
+    , m_threadsCount(std::max(threadsCount, size_t(1)))
     , m_debugId(debugId)
   {
     CHECK_GREATER(m_rightTop.m_lon, m_leftBottom.m_lon, ());
@@ -44,36 +58,122 @@ public:
       return;
     }
 
-    ContoursBuilder contoursBuilder(levelsCount, m_debugId);
+    size_t const bandsCount = std::min(m_threadsCount, m_stepsCountLat);
+    std::vector<ContoursBuilder> builders(bandsCount, ContoursBuilder(levelsCount, m_debugId));
+    auto const getBandBegin = [this, bandsCount](size_t band)
+    {
+      return m_stepsCountLat * band / bandsCount;
+    };
+
+    if (bandsCount == 1)
+    {
+      GenerateBand(0, m_stepsCountLat, result.m_minValue, builders[0]);
+    }
+    else
+    {
+      base::thread_pool::computational::ThreadPool pool(bandsCount);
+      std::vector<std::future<void>> results;
+      for (size_t band = 0; band < bandsCount; ++band)
+      {
+        results.emplace_back(pool.Submit([&, band]()
+        {
+          GenerateBand(getBandBegin(band), getBandBegin(band + 1), result.m_minValue,
+                       builders[band]);
+        }));
+      }
+
+      for (auto & r : results)
+        r.get();
+    }
+
+    for (size_t band = 1; band < bandsCount; ++band)
+    {
+      builders[0].AppendTopBand(std::move(builders[band]),
+                                m_leftBottom.m_lat + m_step * getBandBegin(band));
+    }
+
+    builders[0].GetContours(result.m_minValue, result.m_valueStep, result.m_contours);
+  }
 
-    for (size_t i = 0; i < m_stepsCountLat; ++i)
+private:
+  // Generates segments of the squares in the lines [|beginLine|, |endLine|).
+  void GenerateBand(size_t beginLine, size_t endLine, ValueType minValue,
+                    ContoursBuilder & contoursBuilder) const
+  {
+    auto const invalidValue = m_valuesProvider.GetInvalidValue();
+    size_t const nodesCount = m_stepsCountLon + 1;
+
+    // Levels are the indices of the values intervals between isolines. A square is crossed by
+    // isolines only if the levels of its corners differ. These checks are done for the whole line
+    // in simple loops over arrays which are vectorized by the compiler. Squares of the same level
+    // are skipped, which are the most of them.
+    std::vector<ValueType> bottomLevels(nodesCount);
+    std::vector<ValueType> topLevels(nodesCount);
+    std::vector<uint8_t> isCrossed(m_stepsCountLon);
+    GetLevels(beginLine, invalidValue, bottomLevels);
+
+    for (size_t i = beginLine; i < endLine; ++i)
     {
+      GetLevels(i + 1, invalidValue, topLevels);
+      for (size_t j = 0; j < m_stepsCountLon; ++j)
+      {
+        auto const minLevel = std::min(std::min(bottomLevels[j], bottomLevels[j + 1]),
+                                       std::min(topLevels[j], topLevels[j + 1]));
+        auto const maxLevel = std::max(std::max(bottomLevels[j], bottomLevels[j + 1]),
+                                       std::max(topLevels[j], topLevels[j + 1]));
+        isCrossed[j] = minLevel != maxLevel ? 1 : 0;
+      }
+
+      ValueType const * bottomValues = &m_values[i * nodesCount];
+      ValueType const * topValues = bottomValues + nodesCount;
+
       contoursBuilder.BeginLine();
       for (size_t j = 0; j < m_stepsCountLon; ++j)
       {
+        if (isCrossed[j] == 0)
+          continue;
+
         auto const leftBottom = ms::LatLon(m_leftBottom.m_lat + m_step * i,
                                            m_leftBottom.m_lon + m_step * j);
         // Use std::min to prevent floating-point number precision error.
         auto const rightTop = ms::LatLon(std::min(leftBottom.m_lat + m_step, m_rightTop.m_lat),
                                          std::min(leftBottom.m_lon + m_step, m_rightTop.m_lon));
 
-        Square<ValueType> square(leftBottom, rightTop, result.m_minValue, m_valueStep,
-                                 m_valuesProvider, m_debugId);
+        Square<ValueType> square(leftBottom, rightTop, bottomValues[j], topValues[j],
+                                 topValues[j + 1], bottomValues[j + 1], invalidValue, minValue,
+                                 m_valueStep, m_debugId);
         square.GenerateSegments(contoursBuilder);
       }
-      auto const isLastLine = i == m_stepsCountLat - 1;
+      auto const isLastLine = i == endLine - 1;
       contoursBuilder.EndLine(isLastLine);
+
+      bottomLevels.swap(topLevels);
     }
+  }
 
-    contoursBuilder.GetContours(result.m_minValue, result.m_valueStep, result.m_contours);
+  void GetLevels(size_t line, ValueType invalidValue, std::vector<ValueType> & levels) const
+  {
+    // Invalid values get a level which differs from the levels of all valid values, so squares
+    // with invalid corners aren't skipped and are reported by Square.
+    auto constexpr kInvalidLevel = std::numeric_limits<ValueType>::min();
+    ValueType const * values = &m_values[line * levels.size()];
+    for (size_t j = 0; j < levels.size(); ++j)
+    {
+      auto const value = Square<ValueType>::ShiftFromLevel(m_valueStep, values[j]);
+      // Floor division, values are never equal to levels after the shift.
+      auto const level = static_cast<ValueType>(value >= 0 ? value / m_valueStep
+                                                           : (value + 1) / m_valueStep - 1);
+      levels[j] = values[j] == invalidValue ? kInvalidLevel : level;
+    }
   }
 
-private:
-  void ScanValuesInRect(ValueType & minValue, ValueType & maxValue, size_t & invalidValuesCount) const
+  void ScanValuesInRect(ValueType & minValue, ValueType & maxValue, size_t & invalidValuesCount)
   {
     minValue = maxValue = m_valuesProvider.GetValue(m_leftBottom);
     invalidValuesCount = 0;
 
+    m_values.clear();
+    m_values.reserve((m_stepsCountLat + 1) * (m_stepsCountLon + 1));
     for (size_t i = 0; i <= m_stepsCountLat; ++i)
     {
       for (size_t j = 0; j <= m_stepsCountLon; ++j)
@@ -81,6 +181,7 @@ private:
         auto const pos = ms::LatLon(m_leftBottom.m_lat + m_step * i,
                                     m_leftBottom.m_lon + m_step * j);
         auto const value = m_valuesProvider.GetValue(pos);
+        m_values.push_back(value);
         if (value == m_valuesProvider.GetInvalidValue())
         {
           ++invalidValuesCount;
@@ -106,10 +207,14 @@ private:
   double const m_step;
   ValueType const m_valueStep;
   ValuesProvider<ValueType> & m_valuesProvider;
+  size_t const m_threadsCount;
 
   size_t m_stepsCountLon;
   size_t m_stepsCountLat;
 
+  // Values in the nodes of the grid line by line from the bottom one.
+  std::vector<ValueType> m_values;
+
   std::string m_debugId;
 };
 }  // namespace topography_generator
@@ -1,7 +1,15 @@
 #pragma once
 
 #include "topography_generator/marching_squares/contours_builder.hpp"
-#include "topography_generator/utils/values_provider.hpp"
+
+#include "geometry/latlon.hpp"
+
+#include "base/assert.hpp"
+#include "base/logging.hpp"
+
+#include <cstdlib>
+#include <string>
+#include <type_traits>
 
 namespace topography_generator
 {
@@ -9,10 +17,11 @@ template <typename ValueType>
 class Square
 {
 public:
+  // |valueLB|, |valueLT|, |valueRT| and |valueRB| are the values in the corners of the square.
   Square(ms::LatLon const & leftBottom,
          ms::LatLon const & rightTop,
-         ValueType minValue, ValueType valueStep,
-         ValuesProvider<ValueType> & valuesProvider,
+         ValueType valueLB, ValueType valueLT, ValueType valueRT, ValueType valueRB,
+         ValueType invalidValue, ValueType minValue, ValueType valueStep,
          std::string const & debugId)
     : m_minValue(minValue)
     , m_valueStep(valueStep)
@@ -24,10 +33,10 @@ public:
   {
     static_assert(std::is_integral<ValueType>::value, "Only integral types are supported.");
 
-    m_valueLB = GetValue(leftBottom, valuesProvider);
-    m_valueLT = GetValue(ms::LatLon(m_top, m_left), valuesProvider);
-    m_valueRT = GetValue(ms::LatLon(m_top, m_right), valuesProvider);
-    m_valueRB = GetValue(ms::LatLon(m_bottom, m_right), valuesProvider);
+    m_valueLB = GetValue(leftBottom, valueLB, invalidValue);
+    m_valueLT = GetValue(ms::LatLon(m_top, m_left), valueLT, invalidValue);
+    m_valueRT = GetValue(ms::LatLon(m_top, m_right), valueRT, invalidValue);
+    m_valueRB = GetValue(ms::LatLon(m_bottom, m_right), valueRB, invalidValue);
   }
 
   void GenerateSegments(ContoursBuilder & builder)
@@ -59,6 +68,15 @@ public:
       maxVal = step * ((maxVal + 1) / step);
   }
 
+  // If a contour goes right through the corner of the square false segments can be generated.
+  // Shift the value slightly from the corner.
+  static ValueType ShiftFromLevel(ValueType step, ValueType val)
+  {
+    if (abs(val) % step == 0)
+      return val + 1;
+    return val;
+  }
+
 private:
   enum class Rib
   {
@@ -70,21 +88,16 @@ private:
     Unclear,
   };
 
-  ValueType GetValue(ms::LatLon const & pos, ValuesProvider<ValueType> & valuesProvider)
+  ValueType GetValue(ms::LatLon const & pos, ValueType val, ValueType invalidValue)
   {
-    // If a contour goes right through the corner of the square false segments can be generated.
-    // Shift the value slightly from the corner.
-    ValueType val = valuesProvider.GetValue(pos);
-    if (val == valuesProvider.GetInvalidValue())
+    if (val == invalidValue)
     {
       LOG(LWARNING, ("Invalid value at the position", pos, m_debugId));
       m_isValid = false;
       return val;
     }
 
-    if (abs(val) % m_valueStep == 0)
-      return val + 1;
-    return val;
+    return ShiftFromLevel(m_valueStep, val);
   }
 
   void AddSegments(ValueType val, uint16_t ind, ContoursBuilder & builder)
@@ -0,0 +1,126 @@
+#include "testing/testing.hpp"
+
+#include "topography_generator/marching_squares/marching_squares.hpp"
+#include "topography_generator/utils/contours.hpp"
+#include "topography_generator/utils/values_provider.hpp"
+
+#include "geometry/latlon.hpp"
+#include "geometry/mercator.hpp"
+#include "geometry/point2d.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <map>
+#include <vector>
+
+namespace marching_squares_tests
+{
+using namespace topography_generator;
+using std::vector;
+
+using Altitude = int16_t;
+Altitude constexpr kInvalidAltitude = -32768;
+
+// Hills and a pit on the [0, 1] x [0, 1] square, so the isolines cross the borders of bands in
+// many places and some of them are closed within a band.
+class TestAltitudes : public ValuesProvider<Altitude>
+{
+public:
+  explicit TestAltitudes(bool withInvalid) : m_withInvalid(withInvalid) {}
+
+  // ValuesProvider overrides:
+  Altitude GetValue(ms::LatLon const & pos) override
+  {
+    if (m_withInvalid && std::fabs(pos.m_lat - 0.5) < 0.04 && std::fabs(pos.m_lon - 0.3) < 0.04)
+      return kInvalidAltitude;
+
+    double const hills = 300.0 * std::sin(pos.m_lat * 9.0) * std::cos(pos.m_lon * 7.0);
+    double const dx = pos.m_lon - 0.7;
+    double const dy = pos.m_lat - 0.4;
+    double const pit = -400.0 * std::exp(-(dx * dx + dy * dy) / 0.02);
+    return static_cast<Altitude>(std::lround(1000.0 + hills + pit + 50.0 * pos.m_lon));
+  }
+
+  Altitude GetInvalidValue() const override { return kInvalidAltitude; }
+
+private:
+  bool m_withInvalid;
+};
+
+// Contours of the levels in the order which doesn't depend on the order of building.
+using NormalizedContours = std::map<Altitude, vector<Contour>>;
+
+NormalizedContours GenerateContours(bool withInvalid, size_t threadsCount)
+{
+  TestAltitudes altitudes(withInvalid);
+  MarchingSquares<Altitude> squares(ms::LatLon(0.0, 0.0), ms::LatLon(1.0, 1.0), 0.01 /* step */,
+                                    20 /* valueStep */, altitudes, "test", threadsCount);
+  Contours<Altitude> contours;
+  squares.GenerateContours(contours);
+
+  NormalizedContours result;
+  for (auto & [level, levelContours] : contours.m_contours)
+  {
+    for (auto & contour : levelContours)
+    {
+      TEST_GREATER(contour.size(), 1, ());
+      // Closed contours start at their minimal point. Points on the borders of squares are
+      // calculated by both adjacent squares, so the copies of a point may slightly differ.
+      if (contour.front().EqualDxDy(contour.back(), mercator::kPointEqualityEps))
+      {
+        contour.pop_back();
+        std::rotate(contour.begin(), std::min_element(contour.begin(), contour.end()),
+                    contour.end());
+        contour.push_back(contour.front());
+      }
+    }
+    std::sort(levelContours.begin(), levelContours.end());
+    result[level] = std::move(levelContours);
+  }
+  return result;
+}
+
+bool AreEqual(vector<Contour> const & lhs, vector<Contour> const & rhs)
+{
+  auto const areEqualPoints = [](m2::PointD const & l, m2::PointD const & r)
+  {
+    return l.EqualDxDy(r, mercator::kPointEqualityEps);
+  };
+  auto const areEqualContours = [&areEqualPoints](Contour const & l, Contour const & r)
+  {
+    return std::equal(l.begin(), l.end(), r.begin(), r.end(), areEqualPoints);
+  };
+  return std::equal(lhs.begin(), lhs.end(), rhs.begin(), rhs.end(), areEqualContours);
+}
+
+void TestBandsMatchSingleBand(bool withInvalid)
+{
+  auto const expected = GenerateContours(withInvalid, 1 /* threadsCount */);
+  TEST_GREATER(expected.size(), 10, ());
+
+  // 100 lines are split into bands of one line when there are more threads than lines.
+  for (size_t const threadsCount : {2, 3, 7, 16, 150})
+  {
+    auto const contours = GenerateContours(withInvalid, threadsCount);
+    TEST_EQUAL(contours.size(), expected.size(), (threadsCount));
+    for (auto const & [level, levelContours] : expected)
+    {
+      auto const it = contours.find(level);
+      TEST(it != contours.end(), (threadsCount, level));
+      TEST_EQUAL(it->second.size(), levelContours.size(), (threadsCount, level));
+      TEST(AreEqual(it->second, levelContours), (threadsCount, level));
+    }
+  }
+}
+
+UNIT_TEST(MarchingSquares_BandsMatchSingleBand)
+{
+  TestBandsMatchSingleBand(false /* withInvalid */);
+}
+
+UNIT_TEST(MarchingSquares_BandsMatchSingleBandWithInvalidValues)
+{
+  TestBandsMatchSingleBand(true /* withInvalid */);
+}
+}  // namespace marching_squares_tests
@@ -5,6 +5,7 @@
 #include "track_analyzing/track_analyzer/utils.hpp"
 #include "track_analyzing/track_matcher.hpp"
 #include "track_analyzing/utils.hpp"
+#include "track_analyzing/work_stealing_queue.hpp"
 
 #include "routing_common/num_mwm_id.hpp"
 
@@ -20,13 +21,20 @@
 #include "base/assert.hpp"
 #include "base/file_name_utils.hpp"
 #include "base/logging.hpp"
+#include "base/lru_cache.hpp"
+#include "base/thread_safe_queue.hpp"
 #include "base/timer.hpp"
 
 #include <algorithm>
+#include <atomic>
 #include <exception>
+#include <iterator>
 #include <memory>
+#include <mutex>
 #include <string>
 #include <thread>
+#include <utility>
+#include <vector>
 
 using namespace routing;
 using namespace std;
@@ -35,8 +43,6 @@ using namespace track_analyzing;
 
 namespace
 {
-using Iter = typename vector<string>::iterator;
-
 void MatchTracks(MwmToTracks const & mwmToTracks, storage::Storage const & storage,
                  NumMwmIds const & numMwmIds, MwmToMatchedTracks & mwmToMatchedTracks)
 {
@@ -89,6 +95,263 @@ void MatchTracks(MwmToTracks const & mwmToTracks, storage::Storage const & stora
       ("Matching finished, elapsed:", timer.ElapsedSeconds(), "seconds, tracks:", tracksCount,
        ", points:", pointsCount, ", non matched points:", nonMatchedPointsCount));
 }
+
+// Matching of a log file which is in progress.
+struct FileJob
+{
+  explicit FileJob(string const & trackFile) : m_trackFile(trackFile) {}
+
+  string const m_trackFile;
+  mutex m_mutex;
+  MwmToMatchedTracks m_mwmToMatchedTracks;
+  // Not matched units of the file plus one until all the units of the file are queued.
+  atomic<size_t> m_pendingCount{1};
+};
+
+// Track of one user in one mwm.
+struct WorkUnit
+{
+  shared_ptr<FileJob> m_job;
+  NumMwmId m_mwmId = kFakeNumMwmId;
+  string m_user;
+  Track m_track;
+};
+
+struct MatchingCounters
+{
+  void Add(MatchingCounters const & rhs)
+  {
+    m_tracksCount += rhs.m_tracksCount;
+    m_pointsCount += rhs.m_pointsCount;
+    m_nonMatchedPointsCount += rhs.m_nonMatchedPointsCount;
+  }
+
+  uint64_t m_tracksCount = 0;
+  uint64_t m_pointsCount = 0;
+  uint64_t m_nonMatchedPointsCount = 0;
+};
+
+// Unzips |file| next to it. |logFile| is the path of the unzipped file.
+bool UnzipLog(string const & file, string & logFile)
+{
+  string data;
+  try
+  {
+    auto const r = GetPlatform().GetReader(file);
+    r->ReadAsString(data);
+  }
+  catch (FileReader::ReadException const & e)
+  {
+    LOG(LWARNING, (e.what()));
+    return false;
+  }
+
+  using Inflate = coding::ZLib::Inflate;
+  Inflate inflate(Inflate::Format::GZip);
+  string track;
+  inflate(data.data(), data.size(), back_inserter(track));
+  logFile = file;
+  base::GetNameWithoutExt(logFile);
+  try
+  {
+    FileWriter w(logFile);
+    w.Write(track.data(), track.size());
+  }
+  catch (std::exception const & e)
+  {
+    LOG(LWARNING, (e.what()));
+    return false;
+  }
+  return true;
+}
+
+// Matches logs of a directory with three stages which work at once:
+// * parsers unzip and parse files and split them into units of a user track in an mwm;
+// * matchers match units;
+// * serializer saves tracks of a file when all its units are matched.
+// Units of an mwm are queued to the same matcher to reuse its TrackMatcher, idle matchers
+// steal units of the others. So a huge log or an mwm with a lot of tracks don't stall the job.
+class MatchingPipeline
+{
+public:
+  MatchingPipeline(vector<string> const & files, string const & trackExt,
+                   shared_ptr<NumMwmIds> numMwmIds, Storage const & storage)
+    : m_files(files)
+    , m_trackExt(trackExt)
+    , m_numMwmIds(std::move(numMwmIds))
+    , m_storage(storage)
+    , m_parser(CreateLogParser(m_numMwmIds))
+  {
+  }
+
+  void Run(size_t parsersCount, size_t matchersCount, Stats & stats)
+  {
+    CHECK_GREATER(parsersCount, 0, ());
+    CHECK_GREATER(matchersCount, 0, ());
+
+    base::Timer timer;
+    m_units = make_unique<WorkStealingQueue<WorkUnit>>(matchersCount,
+                                                       matchersCount * kQueuedUnitsPerMatcher);
+
+    thread serializer(&MatchingPipeline::Serialize, this);
+
+    vector<MatchingCounters> counters(matchersCount);
+    vector<thread> matchers;
+    for (size_t i = 0; i < matchersCount; ++i)
+      matchers.emplace_back(&MatchingPipeline::Match, this, i, ref(counters[i]));
+
+    vector<Stats> parsersStats(parsersCount);
+    vector<thread> parsers;
+    for (size_t i = 1; i < parsersCount; ++i)
+      parsers.emplace_back(&MatchingPipeline::Parse, this, ref(parsersStats[i]));
+
+    Parse(parsersStats[0]);
+    for (auto & t : parsers)
+      t.join();
+
+    m_units->Close();
+    for (auto & t : matchers)
+      t.join();
+
+    // All the files are queued for serialization when the matchers are done.
+    m_jobs.Push(nullptr);
+    serializer.join();
+
+    for (auto const & s : parsersStats)
+      stats.Add(s);
+
+    MatchingCounters total;
+    for (auto const & c : counters)
+      total.Add(c);
+
+    LOG(LINFO, ("Matching finished, elapsed:", timer.ElapsedSeconds(), "seconds, tracks:",
+                total.m_tracksCount, ", points:", total.m_pointsCount,
+                ", non matched points:", total.m_nonMatchedPointsCount));
+  }
+
+private:
+  static size_t constexpr kQueuedUnitsPerMatcher = 256;
+  static size_t constexpr kMatchersCacheSize = 4;
+
+  void Parse(Stats & stats)
+  {
+    for (size_t i = m_nextFile++; i < m_files.size(); i = m_nextFile++)
+    {
+      string logFile;
+      if (!UnzipLog(m_files[i], logFile))
+        continue;
+
+      MwmToTracks mwmToTracks;
+      try
+      {
+        LOG(LINFO, ("Parsing", logFile));
+        m_parser->Parse(logFile, mwmToTracks);
+      }
+      catch (RootException const & e)
+      {
+        LOG(LERROR, ("Can't parse", logFile, ":", e.what()));
+        FileWriter::DeleteFileX(logFile);
+        continue;
+      }
+      FileWriter::DeleteFileX(logFile);
+
+      stats.AddTracksStats(mwmToTracks, *m_numMwmIds, m_storage);
+
+      auto job = make_shared<FileJob>(logFile + m_trackExt);
+      for (auto & [mwmId, userToTrack] : mwmToTracks)
+      {
+        for (auto & [user, track] : userToTrack)
+        {
+          ++job->m_pendingCount;
+          m_units->Push(mwmId, {job, mwmId, user, std::move(track)});
+        }
+      }
+      FinishUnit(job);
+    }
+  }
+
+  void Match(size_t matcherNum, MatchingCounters & counters)
+  {
+    // Storage is bound to the thread it's created in.
+    Storage storage;
+    storage.RegisterAllLocalMaps();
+    LruCache<NumMwmId, unique_ptr<TrackMatcher>> matchers(kMatchersCacheSize);
+
+    WorkUnit unit;
+    while (m_units->Pop(matcherNum, unit))
+    {
+      bool found = false;
+      auto & matcher = matchers.Find(unit.m_mwmId, found);
+      if (!found)
+      {
+        matcher = make_unique<TrackMatcher>(storage, unit.m_mwmId,
+                                            m_numMwmIds->GetFile(unit.m_mwmId));
+      }
+
+      auto const tracksCount = matcher->GetTracksCount();
+      auto const pointsCount = matcher->GetPointsCount();
+      auto const nonMatchedPointsCount = matcher->GetNonMatchedPointsCount();
+
+      vector<MatchedTrack> matchedTracks;
+      try
+      {
+        matcher->MatchTrack(unit.m_track, matchedTracks);
+      }
+      catch (RootException const & e)
+      {
+        LOG(LERROR, ("Can't match track for mwm:", m_numMwmIds->GetFile(unit.m_mwmId).GetName(),
+                     ", user:", unit.m_user));
+        LOG(LERROR, ("  ", e.what()));
+      }
+
+      counters.m_tracksCount += matcher->GetTracksCount() - tracksCount;
+      counters.m_pointsCount += matcher->GetPointsCount() - pointsCount;
+      counters.m_nonMatchedPointsCount +=
+          matcher->GetNonMatchedPointsCount() - nonMatchedPointsCount;
+
+      if (!matchedTracks.empty())
+      {
+        lock_guard lock(unit.m_job->m_mutex);
+        unit.m_job->m_mwmToMatchedTracks[unit.m_mwmId][unit.m_user] = std::move(matchedTracks);
+      }
+
+      FinishUnit(unit.m_job);
+      unit = {};
+    }
+  }
+
+  void Serialize()
+  {
+    MwmToMatchedTracksSerializer serializer(m_numMwmIds);
+    for (;;)
+    {
+      shared_ptr<FileJob> job;
+      m_jobs.WaitAndPop(job);
+      if (!job)
+        break;
+
+      FileWriter writer(job->m_trackFile, FileWriter::OP_WRITE_TRUNCATE);
+      serializer.Serialize(job->m_mwmToMatchedTracks, writer);
+      LOG(LINFO, ("Matched tracks were saved to", job->m_trackFile));
+    }
+  }
+
+  void FinishUnit(shared_ptr<FileJob> const & job)
+  {
+    if (--job->m_pendingCount == 0)
+      m_jobs.Push(job);
+  }
+
+  vector<string> const & m_files;
+  string const m_trackExt;
+  shared_ptr<NumMwmIds> const m_numMwmIds;
+  Storage const & m_storage;
+  unique_ptr<LogParser> const m_parser;
+
+  atomic<size_t> m_nextFile{0};
+  unique_ptr<WorkStealingQueue<WorkUnit>> m_units;
+  threads::ThreadSafeQueue<shared_ptr<FileJob>> m_jobs;
+};
 }  // namespace
 
 namespace track_analyzing
@@ -122,47 +385,6 @@ void CmdMatch(string const & logFile, string const & trackFile, string const & i
   stats.Log();
 }
 
-void UnzipAndMatch(Iter begin, Iter end, string const & trackExt, Stats & stats)
-{
-  Storage storage;
-  storage.RegisterAllLocalMaps();
-  shared_ptr<NumMwmIds> numMwmIds = CreateNumMwmIds(storage);
-  for (auto it = begin; it != end; ++it)
-  {
-    auto & file = *it;
-    string data;
-    try
-    {
-      auto const r = GetPlatform().GetReader(file);
-      r->ReadAsString(data);
-    }
-    catch (FileReader::ReadException const & e)
-    {
-      LOG(LWARNING, (e.what()));
-      continue;
-    }
-
-    using Inflate = coding::ZLib::Inflate;
-    Inflate inflate(Inflate::Format::GZip);
-    string track;
-    inflate(data.data(), data.size(), back_inserter(track));
-    base::GetNameWithoutExt(file);
-    try
-    {
-      FileWriter w(file);
-      w.Write(track.data(), track.size());
-    }
-    catch (std::exception const & e)
-    {
-      LOG(LWARNING, (e.what()));
-      continue;
-    }
-
-    CmdMatch(file, file + trackExt, numMwmIds, storage, stats);
-    FileWriter::DeleteFileX(file);
-  }
-}
-
 void CmdMatchDir(string const & logDir, string const & trackExt, string const & inputDistribution)
 {
   LOG(LINFO,
@@ -196,30 +418,18 @@ void CmdMatchDir(string const & logDir, string const & trackExt, string const &
     return;
   }
 
-  auto const size = filesList.size();
   auto const hardwareConcurrency = static_cast<size_t>(thread::hardware_concurrency());
   CHECK_GREATER(hardwareConcurrency, 0, ("No available threads."));
   LOG(LINFO, ("Number of available threads =", hardwareConcurrency));
-  auto const threadsCount = min(size, hardwareConcurrency);
-  auto const blockSize = size / threadsCount;
-  vector<thread> threads(threadsCount - 1);
-  vector<Stats> stats(threadsCount);
-  auto begin = filesList.begin();
-  for (size_t i = 0; i < threadsCount - 1; ++i)
-  {
-    auto end = begin + blockSize;
-    threads[i] = thread(UnzipAndMatch, begin, end, trackExt, ref(stats[i]));
-    begin = end;
-  }
+  // Matching takes much more time than unzipping and parsing.
+  auto const parsersCount = min(filesList.size(), max(hardwareConcurrency / 4, size_t(1)));
 
-  UnzipAndMatch(begin, filesList.end(), trackExt, ref(stats[threadsCount - 1]));
-  for (auto & t : threads)
-    t.join();
+  Storage storage;
+  storage.RegisterAllLocalMaps();
+  MatchingPipeline pipeline(filesList, trackExt, CreateNumMwmIds(storage), storage);
 
   Stats statSum;
-  for (auto const & s : stats)
-    statSum.Add(s);
-
+  pipeline.Run(parsersCount, hardwareConcurrency, statSum);
   statSum.SaveMwmDistributionToCsv(inputDistribution);
   statSum.Log();
 }
@@ -220,17 +220,22 @@ void MappingFromCsv(basic_istream<char> & ss, Stats::NameToCountMapping & mappin
   }
 }
 
-void ParseTracks(string const & logFile, shared_ptr<NumMwmIds> const & numMwmIds,
-                 MwmToTracks & mwmToTracks)
+unique_ptr<LogParser> CreateLogParser(shared_ptr<NumMwmIds> const & numMwmIds)
 {
   Platform const & platform = GetPlatform();
   string const dataDir = platform.WritableDir();
   auto countryInfoGetter = CountryInfoReader::CreateCountryInfoGetter(platform);
   unique_ptr<m4::Tree<NumMwmId>> mwmTree = MakeNumMwmTree(*numMwmIds, *countryInfoGetter);
+  return make_unique<LogParser>(numMwmIds, std::move(mwmTree), dataDir);
+}
+
+void ParseTracks(string const & logFile, shared_ptr<NumMwmIds> const & numMwmIds,
+                 MwmToTracks & mwmToTracks)
+{
+  auto const parser = CreateLogParser(numMwmIds);
 
   LOG(LINFO, ("Parsing", logFile));
-  LogParser parser(numMwmIds, std::move(mwmTree), dataDir);
-  parser.Parse(logFile, mwmToTracks);
+  parser->Parse(logFile, mwmToTracks);
 }
 
 void WriteCsvTableHeader(basic_ostream<char> & stream)
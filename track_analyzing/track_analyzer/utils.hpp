@@ -4,6 +4,7 @@
 
 #include "routing_common/num_mwm_id.hpp"
 
+#include "track_analyzing/log_parser.hpp"
 #include "track_analyzing/track.hpp"
 
 #include <cstdint>
@@ -65,6 +66,10 @@ void MappingToCsv(std::string const & keyName, Stats::NameToCountMapping const &
 /// \breif Fills |mapping| according to csv in |ss|. Csv header is skipped.
 void MappingFromCsv(std::basic_istream<char> & ss, Stats::NameToCountMapping & mapping);
 
+/// \brief Creates a parser which splits tracks into the mwms of |numMwmIds|.
+/// The parser may be shared by several threads.
+std::unique_ptr<LogParser> CreateLogParser(std::shared_ptr<routing::NumMwmIds> const & numMwmIds);
+
 /// \brief Parses tracks from |logFile| and fills |mwmToTracks|.
 void ParseTracks(std::string const & logFile, std::shared_ptr<routing::NumMwmIds> const & numMwmIds,
                  MwmToTracks & mwmToTracks);
@@ -0,0 +1,74 @@
+#include "testing/testing.hpp"
+
+#include "track_analyzing/work_stealing_queue.hpp"
+
+#include <atomic>
+#include <cstddef>
+#include <thread>
+#include <vector>
+
+namespace work_stealing_queue_tests
+{
+using namespace std;
+using namespace track_analyzing;
+
+UNIT_TEST(WorkStealingQueue_Order)
+{
+  WorkStealingQueue<int> queue(2 /* consumersCount */, 10 /* capacity */);
+  queue.Push(0, 1);
+  queue.Push(0, 2);
+  queue.Push(0, 3);
+  queue.Close();
+
+  int item = 0;
+  // The owner takes the oldest item.
+  TEST(queue.Pop(0, item), ());
+  TEST_EQUAL(item, 1, ());
+  // Other consumers steal the newest one.
+  TEST(queue.Pop(1, item), ());
+  TEST_EQUAL(item, 3, ());
+  TEST(queue.Pop(1, item), ());
+  TEST_EQUAL(item, 2, ());
+  TEST(!queue.Pop(0, item), ());
+  TEST(!queue.Pop(1, item), ());
+}
+
+UNIT_TEST(WorkStealingQueue_Skewed)
+{
+  size_t constexpr kConsumersCount = 4;
+  int constexpr kItemsCount = 10000;
+
+  // All the items go to the first consumer and the capacity is small, so the producer
+  // finishes only if the other consumers steal.
+  WorkStealingQueue<int> queue(kConsumersCount, 8 /* capacity */);
+  atomic<long long> sum(0);
+  vector<size_t> popped(kConsumersCount);
+
+  vector<thread> consumers;
+  for (size_t i = 0; i < kConsumersCount; ++i)
+  {
+    consumers.emplace_back([&, i]()
+    {
+      int item = 0;
+      while (queue.Pop(i, item))
+      {
+        sum += item;
+        ++popped[i];
+      }
+    });
+  }
+
+  for (int i = 1; i <= kItemsCount; ++i)
+    queue.Push(0, int{i});
+  queue.Close();
+
+  for (auto & t : consumers)
+    t.join();
+
+  TEST_EQUAL(sum.load(), static_cast<long long>(kItemsCount) * (kItemsCount + 1) / 2, ());
+  size_t total = 0;
+  for (auto const p : popped)
+    total += p;
+  TEST_EQUAL(total, static_cast<size_t>(kItemsCount), ());
+}
+}  // namespace work_stealing_queue_tests
@@ -0,0 +1,95 @@
+#pragma once
+
+#include "base/assert.hpp"
+
+#include <algorithm>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+namespace track_analyzing
+{
+/// \brief Bounded queue with a deque for each consumer.
+/// Producers choose the deque of an item, so items with the same key may be processed by the
+/// same consumer. A consumer whose deque is empty steals the newest item of the longest deque,
+/// so a consumer with a lot of items doesn't make the other consumers wait.
+template <typename T>
+class WorkStealingQueue
+{
+public:
+  WorkStealingQueue(size_t consumersCount, size_t capacity)
+    : m_deques(consumersCount), m_capacity(capacity)
+  {
+    CHECK_GREATER(consumersCount, 0, ());
+    CHECK_GREATER(capacity, 0, ());
+  }
+
+  /// \brief Adds |item| to the deque of |consumer|. Blocks while the queue is full.
+  void Push(size_t consumer, T && item)
+  {
+    {
+      std::unique_lock lock(m_mutex);
+      m_notFull.wait(lock, [this]() { return m_size < m_capacity; });
+      CHECK(!m_closed, ());
+      m_deques[consumer % m_deques.size()].push_back(std::move(item));
+      ++m_size;
+    }
+    m_notEmpty.notify_all();
+  }
+
+  /// \brief Takes the oldest item of the deque of |consumer| or steals an item of another one.
+  /// Blocks while the queue is empty and not closed.
+  /// \returns false if the queue is closed and empty.
+  bool Pop(size_t consumer, T & item)
+  {
+    {
+      std::unique_lock lock(m_mutex);
+      m_notEmpty.wait(lock, [this]() { return m_size != 0 || m_closed; });
+      if (m_size == 0)
+        return false;
+
+      auto & own = m_deques[consumer % m_deques.size()];
+      if (!own.empty())
+      {
+        item = std::move(own.front());
+        own.pop_front();
+      }
+      else
+      {
+        auto & victim = *std::max_element(m_deques.begin(), m_deques.end(),
+                                           [](auto const & lhs, auto const & rhs)
+                                           {
+                                             return lhs.size() < rhs.size();
+                                           });
+        item = std::move(victim.back());
+        victim.pop_back();
+      }
+      --m_size;
+    }
+    m_notFull.notify_one();
+    return true;
+  }
+
+  /// \brief Wakes up the consumers when there are no items left. Nothing may be pushed after.
+  void Close()
+  {
+    {
+      std::lock_guard lock(m_mutex);
+      m_closed = true;
+    }
+    m_notEmpty.notify_all();
+  }
+
+private:
+  std::mutex m_mutex;
+  std::condition_variable m_notEmpty;
+  std::condition_variable m_notFull;
+  std::vector<std::deque<T>> m_deques;
+  size_t const m_capacity;
+  size_t m_size = 0;
+  bool m_closed = false;
+};
+}  // namespace track_analyzing
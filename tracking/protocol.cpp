@@ -2,17 +2,37 @@
 
 #include "coding/endianness.hpp"
 #include "coding/reader.hpp"
+#include "coding/varint.hpp"
 #include "coding/writer.hpp"
+#include "coding/zlib.hpp"
 
 #include "base/assert.hpp"
 #include "base/logging.hpp"
 
+#include <cstring>
+#include <iterator>
 #include <sstream>
 
 using namespace std;
 
 namespace
 {
+size_t constexpr kHeaderSize = sizeof(uint32_t);
+uint32_t constexpr kMaxPayloadSize = 0x00FFFFFF;
+// Version of the points encoding inside data batch packets.
+uint32_t constexpr kDataBatchPointsVersion = 1;
+
+pair<tracking::Protocol::PacketType, size_t> DecodeHeaderImpl(uint8_t const * header)
+{
+  // The header may be unaligned in the buffer of a stream decoder.
+  uint32_t size;
+  memcpy(&size, header, sizeof(size));
+  size &= 0xFFFFFF00;
+  if (!IsBigEndianMacroBased())
+    size = ReverseByteOrder(size);
+  return make_pair(tracking::Protocol::PacketType(header[0]), size);
+}
+
 template <typename Container>
 vector<uint8_t> CreateDataPacketImpl(Container const & points,
                                      tracking::Protocol::PacketType const type)
@@ -27,6 +47,7 @@ vector<uint8_t> CreateDataPacketImpl(Container const & points,
   case tracking::Protocol::PacketType::DataV1: version = 1; break;
   case tracking::Protocol::PacketType::Error:
   case tracking::Protocol::PacketType::AuthV0:
+  case tracking::Protocol::PacketType::DataBatchV0:
     LOG(LERROR, ("Can't create a non-DATA packet as a DATA packet. PacketType =", type));
     return {};
   }
@@ -78,19 +99,65 @@ vector<uint8_t> Protocol::CreateDataPacket(DataElementsVec const & points, Packe
   return CreateDataPacketImpl(points, type);
 }
 
+//  static
+vector<uint8_t> Protocol::CreateDataBatchPacket(DevicesData const & devices, PacketType type)
+{
+  if (type != PacketType::DataBatchV0)
+  {
+    LOG(LERROR, ("Can't create a non-DATA BATCH packet as a DATA BATCH packet. PacketType =", type));
+    return {};
+  }
+
+  vector<uint8_t> buffer;
+  {
+    MemWriter<decltype(buffer)> writer(buffer);
+    WriteVarUint(writer, static_cast<uint64_t>(devices.size()));
+
+    vector<uint8_t> pointsBuffer;
+    for (auto const & device : devices)
+    {
+      WriteVarUint(writer, static_cast<uint64_t>(device.m_clientId.size()));
+      writer.Write(device.m_clientId.data(), device.m_clientId.size());
+
+      pointsBuffer.clear();
+      MemWriter<decltype(pointsBuffer)> pointsWriter(pointsBuffer);
+      Encoder::SerializeDataPoints(kDataBatchPointsVersion, pointsWriter, device.m_points);
+      WriteVarUint(writer, static_cast<uint64_t>(pointsBuffer.size()));
+      writer.Write(pointsBuffer.data(), pointsBuffer.size());
+    }
+  }
+
+  if (buffer.size() > kMaxDataBatchSize)
+  {
+    LOG(LERROR, ("Too much data for a DATA BATCH packet:", buffer.size(), "bytes."));
+    return {};
+  }
+
+  using Deflate = coding::ZLib::Deflate;
+  Deflate deflate(Deflate::Format::ZLib, Deflate::Level::BestSpeed);
+  vector<uint8_t> compressed;
+  if (!deflate(buffer.data(), buffer.size(), back_inserter(compressed)) ||
+      compressed.size() >= kMaxPayloadSize)
+  {
+    LOG(LERROR, ("Can't create a DATA BATCH packet for", devices.size(), "devices."));
+    return {};
+  }
+
+  auto packet = CreateHeader(type, static_cast<uint32_t>(compressed.size()));
+  packet.insert(packet.end(), begin(compressed), end(compressed));
+  return packet;
+}
+
 //  static
 pair<Protocol::PacketType, size_t> Protocol::DecodeHeader(vector<uint8_t> const & data)
 {
-  if (data.size() < sizeof(uint32_t /* header */))
+  if (data.size() < kHeaderSize)
   {
-    LOG(LWARNING, ("Header size is too small", data.size(), sizeof(uint32_t /* header */)));
+    LOG(LWARNING, ("Header size is too small", data.size(), kHeaderSize));
     return make_pair(PacketType::Error, data.size());
   }
 
-  uint32_t size = (*reinterpret_cast<uint32_t const *>(data.data())) & 0xFFFFFF00;
-  if (!IsBigEndianMacroBased())
-    size = ReverseByteOrder(size);
-  return make_pair(PacketType(static_cast<uint8_t>(data[0])), size);
+  return DecodeHeaderImpl(data.data());
 }
 
 //  static
@@ -102,6 +169,7 @@ string Protocol::DecodeAuthPacket(Protocol::PacketType type, vector<uint8_t> con
   case Protocol::PacketType::Error:
   case Protocol::PacketType::DataV0:
   case Protocol::PacketType::DataV1:
+  case Protocol::PacketType::DataBatchV0:
     LOG(LERROR, ("Error decoding AUTH packet. PacketType =", type));
     break;
   }
@@ -112,6 +180,15 @@ string Protocol::DecodeAuthPacket(Protocol::PacketType type, vector<uint8_t> con
 Protocol::DataElementsVec Protocol::DecodeDataPacket(PacketType type, vector<uint8_t> const & data)
 {
   DataElementsVec points;
+  DecodeDataPacket(type, data, points);
+  return points;
+}
+
+//  static
+bool Protocol::DecodeDataPacket(PacketType type, vector<uint8_t> const & data,
+                                DataElementsVec & points)
+{
+  points.clear();
   MemReaderWithExceptions memReader(data.data(), data.size());
   ReaderSource<MemReaderWithExceptions> src(memReader);
   try
@@ -126,15 +203,77 @@ Protocol::DataElementsVec Protocol::DecodeDataPacket(PacketType type, vector<uin
       break;
     case Protocol::PacketType::Error:
     case Protocol::PacketType::AuthV0:
+    case Protocol::PacketType::DataBatchV0:
       LOG(LERROR, ("Error decoding DATA packet. PacketType =", type));
-      return {};
+      return false;
     }
-    return points;
+    return true;
   }
   catch (Reader::SizeException const & ex)
   {
     LOG(LWARNING, ("Wrong packet. SizeException. Msg:", ex.Msg(), ". What:", ex.what()));
-    return {};
+    points.clear();
+    return false;
+  }
+}
+
+//  static
+bool Protocol::DecodeDataBatchPacket(PacketType type, vector<uint8_t> const & data,
+                                     DevicesData & devices)
+{
+  if (type != PacketType::DataBatchV0)
+  {
+    LOG(LERROR, ("Error decoding DATA BATCH packet. PacketType =", type));
+    devices.clear();
+    return false;
+  }
+
+  using Inflate = coding::ZLib::Inflate;
+  Inflate inflate(Inflate::Format::ZLib);
+  vector<uint8_t> buffer;
+  if (!inflate(data.data(), data.size(), kMaxDataBatchSize, back_inserter(buffer)))
+  {
+    LOG(LWARNING, ("Wrong packet. Can't decompress DATA BATCH packet or it's too big."));
+    devices.clear();
+    return false;
+  }
+
+  MemReaderWithExceptions memReader(buffer.data(), buffer.size());
+  ReaderSource<MemReaderWithExceptions> src(memReader);
+  try
+  {
+    auto const devicesCount = ReadVarUint<uint64_t>(src);
+    // Every device takes two bytes at least. It protects from huge allocations for wrong counts.
+    if (devicesCount > src.Size() / 2)
+      MYTHROW(Reader::SizeException, ("Wrong devices count", devicesCount));
+
+    devices.resize(static_cast<size_t>(devicesCount));
+    for (auto & device : devices)
+    {
+      auto const clientIdSize = ReadVarUint<uint64_t>(src);
+      if (clientIdSize > src.Size())
+        MYTHROW(Reader::SizeException, ("Wrong client id size", clientIdSize));
+      device.m_clientId.resize(static_cast<size_t>(clientIdSize));
+      src.Read(device.m_clientId.data(), device.m_clientId.size());
+
+      auto const pointsSize = ReadVarUint<uint64_t>(src);
+      if (pointsSize > src.Size())
+        MYTHROW(Reader::SizeException, ("Wrong points size", pointsSize));
+      auto pointsReader = src.SubReader(pointsSize);
+      ReaderSource<MemReaderWithExceptions> pointsSrc(pointsReader);
+      device.m_points.clear();
+      Encoder::DeserializeDataPoints(kDataBatchPointsVersion, pointsSrc, device.m_points);
+    }
+
+    if (src.Size() != 0)
+      MYTHROW(Reader::SizeException, ("Unexpected data after the devices", src.Size()));
+    return true;
+  }
+  catch (Reader::SizeException const & ex)
+  {
+    LOG(LWARNING, ("Wrong packet. SizeException. Msg:", ex.Msg(), ". What:", ex.what()));
+    devices.clear();
+    return false;
   }
 }
 
@@ -145,7 +284,7 @@ void Protocol::InitHeader(vector<uint8_t> & packet, PacketType type, uint32_t pa
   uint32_t & size = *reinterpret_cast<uint32_t *>(packet.data());
   size = payloadSize;
 
-  ASSERT_LESS(size, 0x00FFFFFF, ());
+  ASSERT_LESS(size, kMaxPayloadSize, ());
 
   if (!IsBigEndianMacroBased())
     size = ReverseByteOrder(size);
@@ -153,6 +292,34 @@ void Protocol::InitHeader(vector<uint8_t> & packet, PacketType type, uint32_t pa
   packet[0] = static_cast<uint8_t>(type);
 }
 
+// PacketStreamDecoder -----------------------------------------------------------------------------
+void PacketStreamDecoder::Append(uint8_t const * data, size_t size)
+{
+  // Drops the extracted packets when they take a half of the buffer at least.
+  if (m_begin > 0 && m_begin >= m_buffer.size() / 2)
+  {
+    m_buffer.erase(m_buffer.begin(), m_buffer.begin() + m_begin);
+    m_begin = 0;
+  }
+  m_buffer.insert(m_buffer.end(), data, data + size);
+}
+
+bool PacketStreamDecoder::NextPacket(Protocol::PacketType & type, vector<uint8_t> & payload)
+{
+  if (GetPendingSize() < kHeaderSize)
+    return false;
+
+  auto const header = DecodeHeaderImpl(m_buffer.data() + m_begin);
+  if (GetPendingSize() < kHeaderSize + header.second)
+    return false;
+
+  type = header.first;
+  auto const payloadBegin = m_buffer.cbegin() + m_begin + kHeaderSize;
+  payload.assign(payloadBegin, payloadBegin + header.second);
+  m_begin += kHeaderSize + header.second;
+  return true;
+}
+
 string DebugPrint(Protocol::PacketType type)
 {
   switch (type)
@@ -161,6 +328,7 @@ string DebugPrint(Protocol::PacketType type)
   case Protocol::PacketType::AuthV0: return "AuthV0";
   case Protocol::PacketType::DataV0: return "DataV0";
   case Protocol::PacketType::DataV1: return "DataV1";
+  case Protocol::PacketType::DataBatchV0: return "DataBatchV0";
   }
   stringstream ss;
   ss << "Unknown(" << static_cast<uint32_t>(type) << ")";
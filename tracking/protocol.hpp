@@ -2,6 +2,7 @@
 
 #include "coding/traffic.hpp"
 
+#include <cstddef>
 #include <cstdint>
 #include <string>
 #include <utility>
@@ -28,29 +29,80 @@ public:
   static uint8_t const kOk[4];
   static uint8_t const kFail[4];
 
+  // Limit of the decompressed size of a data batch packet. A serialized point takes much less
+  // than 32 bytes. Packets which inflate to a bigger size are rejected, so a small packet can't
+  // make the receiver allocate a lot of memory.
+  static size_t constexpr kMaxDataBatchPointsCount = 1 << 20;
+  static size_t constexpr kMaxDataBatchSize = 32 * kMaxDataBatchPointsCount;
+
   enum class PacketType
   {
     Error = 0x0,
     AuthV0 = 0x81,
     DataV0 = 0x82,
     DataV1 = 0x92,
+    // Compressed points of several devices in one packet.
+    DataBatchV0 = 0x83,
 
     CurrentAuth = AuthV0,
-    CurrentData = DataV1
+    CurrentData = DataV1,
+    CurrentDataBatch = DataBatchV0
   };
 
+  // Points of a device in a data batch packet.
+  struct DeviceData
+  {
+    bool operator==(DeviceData const & rhs) const
+    {
+      return m_clientId == rhs.m_clientId && m_points == rhs.m_points;
+    }
+
+    std::string m_clientId;
+    DataElementsVec m_points;
+  };
+  using DevicesData = std::vector<DeviceData>;
+
   static std::vector<uint8_t> CreateHeader(PacketType type, uint32_t payloadSize);
   static std::vector<uint8_t> CreateAuthPacket(std::string const & clientId);
   static std::vector<uint8_t> CreateDataPacket(DataElementsCirc const & points, PacketType type);
   static std::vector<uint8_t> CreateDataPacket(DataElementsVec const & points, PacketType type);
+  static std::vector<uint8_t> CreateDataBatchPacket(DevicesData const & devices, PacketType type);
 
   static std::pair<PacketType, size_t> DecodeHeader(std::vector<uint8_t> const & data);
   static std::string DecodeAuthPacket(PacketType type, std::vector<uint8_t> const & data);
   static DataElementsVec DecodeDataPacket(PacketType type, std::vector<uint8_t> const & data);
+  // Decodes the points into |points| reusing its memory.
+  // Returns false and clears |points| if |data| is malformed.
+  static bool DecodeDataPacket(PacketType type, std::vector<uint8_t> const & data,
+                               DataElementsVec & points);
+  // Decodes the points of all the devices into |devices| reusing memory of its elements, so
+  // a collector may decode packets into the same buffers without allocations.
+  // Returns false and clears |devices| if |data| is malformed.
+  static bool DecodeDataBatchPacket(PacketType type, std::vector<uint8_t> const & data,
+                                    DevicesData & devices);
 
 private:
   static void InitHeader(std::vector<uint8_t> & packet, PacketType type, uint32_t payloadSize);
 };
 
+// Splits the bytes received from a connection into packets of any types.
+class PacketStreamDecoder
+{
+public:
+  // Appends |size| bytes received from the connection.
+  void Append(uint8_t const * data, size_t size);
+
+  // Moves the next complete packet to |type| and |payload| reusing memory of |payload|.
+  // Returns false if the packet isn't received completely yet.
+  bool NextPacket(Protocol::PacketType & type, std::vector<uint8_t> & payload);
+
+  // Returns the number of received bytes which are not extracted as packets yet.
+  size_t GetPendingSize() const { return m_buffer.size() - m_begin; }
+
+private:
+  std::vector<uint8_t> m_buffer;
+  size_t m_begin = 0;
+};
+
 std::string DebugPrint(Protocol::PacketType type);
 }  // namespace tracking
@@ -11,6 +11,17 @@
 #include <boost/python.hpp>
 #include <boost/python/suite/indexing/vector_indexing_suite.hpp>
 
+namespace
+{
+// Returns no devices if |data| is malformed, like Protocol::DecodeDataPacket returns no points.
+tracking::Protocol::DevicesData DecodeDataBatchPacket(tracking::Protocol::PacketType type,
+                                                      std::vector<uint8_t> const & data)
+{
+  tracking::Protocol::DevicesData devices;
+  tracking::Protocol::DecodeDataBatchPacket(type, data, devices);
+  return devices;
+}
+}  // namespace
 
 BOOST_PYTHON_MODULE(pytracking)
 {
@@ -27,6 +38,13 @@ BOOST_PYTHON_MODULE(pytracking)
   class_<Protocol::DataElementsVec>("DataElementsVec")
       .def(vector_indexing_suite<Protocol::DataElementsVec>());
 
+  class_<Protocol::DeviceData>("DeviceData")
+      .def_readwrite("client_id", &Protocol::DeviceData::m_clientId)
+      .def_readwrite("points", &Protocol::DeviceData::m_points);
+
+  class_<Protocol::DevicesData>("DevicesData")
+      .def(vector_indexing_suite<Protocol::DevicesData>());
+
   class_<ms::LatLon>("LatLon")
       .def_readwrite("lat", &ms::LatLon::m_lat)
       .def_readwrite("lon", &ms::LatLon::m_lon);
@@ -42,8 +60,10 @@ BOOST_PYTHON_MODULE(pytracking)
       .value("AuthV0", Protocol::PacketType::AuthV0)
       .value("DataV0", Protocol::PacketType::DataV0)
       .value("DataV1", Protocol::PacketType::DataV1)
+      .value("DataBatchV0", Protocol::PacketType::DataBatchV0)
       .value("CurrentAuth", Protocol::PacketType::CurrentAuth)
-      .value("CurrentData", Protocol::PacketType::CurrentData);
+      .value("CurrentData", Protocol::PacketType::CurrentData)
+      .value("CurrentDataBatch", Protocol::PacketType::CurrentDataBatch);
 
   std::vector<uint8_t> (*CreateDataPacket1)(Protocol::DataElementsCirc const &,
                                             tracking::Protocol::PacketType) =
@@ -51,6 +71,9 @@ BOOST_PYTHON_MODULE(pytracking)
   std::vector<uint8_t> (*CreateDataPacket2)(Protocol::DataElementsVec const &,
                                             tracking::Protocol::PacketType) =
       &Protocol::CreateDataPacket;
+  Protocol::DataElementsVec (*DecodeDataPacket)(Protocol::PacketType,
+                                                std::vector<uint8_t> const &) =
+      &Protocol::DecodeDataPacket;
 
   class_<Protocol>("Protocol")
       .def("CreateAuthPacket", &Protocol::CreateAuthPacket)
@@ -58,10 +81,14 @@ BOOST_PYTHON_MODULE(pytracking)
       .def("CreateDataPacket", CreateDataPacket1)
       .def("CreateDataPacket", CreateDataPacket2)
       .staticmethod("CreateDataPacket")
+      .def("CreateDataBatchPacket", &Protocol::CreateDataBatchPacket)
+      .staticmethod("CreateDataBatchPacket")
       .def("CreateHeader", &Protocol::CreateHeader)
       .staticmethod("CreateHeader")
       .def("DecodeHeader", &Protocol::DecodeHeader)
       .staticmethod("DecodeHeader")
-      .def("DecodeDataPacket", &Protocol::DecodeDataPacket)
-      .staticmethod("DecodeDataPacket");
+      .def("DecodeDataPacket", DecodeDataPacket)
+      .staticmethod("DecodeDataPacket")
+      .def("DecodeDataBatchPacket", &DecodeDataBatchPacket)
+      .staticmethod("DecodeDataBatchPacket");
 }
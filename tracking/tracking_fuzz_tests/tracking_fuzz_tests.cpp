@@ -56,14 +56,26 @@ extern "C" int LLVMFuzzerTestOneInput(uint8_t const * data, size_t size)
     dataElementsVec.push_back(PopDataPoint(dataVecToConv));
   Protocol::DataElementsCirc dataElementsCirc(dataElementsVec.cbegin(), dataElementsVec.cend());
 
+  Protocol::DevicesData devices = {{"fuzz", dataElementsVec}};
+
   Protocol::DecodeHeader(dataVec);
   for (auto const type : {Protocol::PacketType::Error, Protocol::PacketType::AuthV0,
-                          Protocol::PacketType::DataV0, Protocol::PacketType::DataV1})
+                          Protocol::PacketType::DataV0, Protocol::PacketType::DataV1,
+                          Protocol::PacketType::DataBatchV0})
   {
     Protocol::CreateDataPacket(dataElementsVec, type);
     Protocol::CreateDataPacket(dataElementsCirc, type);
+    Protocol::CreateDataBatchPacket(devices, type);
     Protocol::DecodeAuthPacket(type, dataVec);
     Protocol::DecodeDataPacket(type, dataVec);
+    Protocol::DecodeDataBatchPacket(type, dataVec, devices);
   }
+
+  PacketStreamDecoder decoder;
+  decoder.Append(data, size);
+  Protocol::PacketType type;
+  std::vector<uint8_t> payload;
+  while (decoder.NextPacket(type, payload))
+    Protocol::DecodeDataBatchPacket(type, payload, devices);
   return 0;
 }
@@ -2,7 +2,16 @@
 
 #include "tracking/protocol.hpp"
 
+#include "coding/varint.hpp"
+#include "coding/writer.hpp"
+#include "coding/zlib.hpp"
+
+#include "base/logging.hpp"
+
+#include <algorithm>
+#include <iterator>
 #include <string>
+#include <vector>
 
 using namespace std;
 using namespace tracking;
@@ -141,3 +150,150 @@ UNIT_TEST(Protocol_DecodeWrongDataPacket)
     }
   }
 }
+
+UNIT_TEST(Protocol_DecodeDataBatchPacket)
+{
+  using Container = Protocol::DataElementsVec;
+
+  Protocol::DevicesData devices(3);
+  devices[0].m_clientId = "first";
+  devices[0].m_points.push_back(Container::value_type(1, ms::LatLon(10, 10), 1));
+  devices[0].m_points.push_back(Container::value_type(2, ms::LatLon(15, 15), 2));
+  devices[1].m_clientId = "empty";
+  devices[2].m_clientId = "third";
+  for (uint64_t i = 0; i < 100; ++i)
+    devices[2].m_points.push_back(Container::value_type(i, ms::LatLon(55.0 + i * 1e-4, 37.0), 0));
+
+  auto const packet = Protocol::CreateDataBatchPacket(devices, Protocol::PacketType::CurrentDataBatch);
+  TEST_GREATER(packet.size(), sizeof(uint32_t /* header */), ());
+  auto const header = Protocol::DecodeHeader(packet);
+  TEST_EQUAL(header.first, Protocol::PacketType::DataBatchV0, ());
+  TEST_EQUAL(header.second, packet.size() - sizeof(uint32_t /* header */), ());
+
+  auto const payload = vector<uint8_t>(begin(packet) + sizeof(uint32_t /* header */), end(packet));
+  // Decoding into the buffers of a bigger batch reuses them.
+  Protocol::DevicesData result(5);
+  result[0].m_points.resize(10);
+  TEST(Protocol::DecodeDataBatchPacket(header.first, payload, result), ());
+
+  double const kEps = 1e-5;
+  TEST_EQUAL(result.size(), devices.size(), ());
+  for (size_t i = 0; i < devices.size(); ++i)
+  {
+    TEST_EQUAL(result[i].m_clientId, devices[i].m_clientId, ());
+    auto const & points = devices[i].m_points;
+    TEST_EQUAL(result[i].m_points.size(), points.size(), ());
+    for (size_t j = 0; j < points.size(); ++j)
+    {
+      TEST_EQUAL(points[j].m_timestamp, result[i].m_points[j].m_timestamp, ());
+      TEST(base::AlmostEqualAbsOrRel(points[j].m_latLon.m_lat, result[i].m_points[j].m_latLon.m_lat, kEps),
+           (points[j].m_latLon, result[i].m_points[j].m_latLon));
+      TEST(base::AlmostEqualAbsOrRel(points[j].m_latLon.m_lon, result[i].m_points[j].m_latLon.m_lon, kEps),
+           (points[j].m_latLon, result[i].m_points[j].m_latLon));
+    }
+  }
+
+  {
+    base::ScopedLogAbortLevelChanger ignoreLogError;
+    TEST(!Protocol::DecodeDataBatchPacket(Protocol::PacketType::DataV1, payload, result), ());
+  }
+  TEST(result.empty(), ());
+}
+
+UNIT_TEST(Protocol_DecodeWrongDataBatchPacket)
+{
+  vector<vector<uint8_t>> payloads = {
+      vector<uint8_t>{},
+      vector<uint8_t>{0x25},
+      vector<uint8_t>{0x0, 0x0, 0x23, 0xFF},
+      // zlib stream of {0x7F}: too many devices.
+      vector<uint8_t>{0x78, 0x9C, 0xAB, 0x07, 0x00, 0x00, 0x80, 0x00, 0x80},
+  };
+  for (auto const & payload : payloads)
+  {
+    Protocol::DevicesData devices(1);
+    TEST(!Protocol::DecodeDataBatchPacket(Protocol::PacketType::DataBatchV0, payload, devices),
+         (payload));
+    TEST(devices.empty(), (payload));
+  }
+}
+
+UNIT_TEST(Protocol_DecodeTooBigDataBatchPacket)
+{
+  // Payload of one device with a huge client id and no points. It's compressed to a small packet.
+  auto const makePayload = [](size_t clientIdSize)
+  {
+    vector<uint8_t> buffer;
+    {
+      MemWriter<decltype(buffer)> writer(buffer);
+      WriteVarUint(writer, uint64_t{1} /* devicesCount */);
+      WriteVarUint(writer, static_cast<uint64_t>(clientIdSize));
+      buffer.resize(buffer.size() + clientIdSize, 'a');
+    }
+    buffer.push_back(0 /* pointsSize */);
+
+    using Deflate = coding::ZLib::Deflate;
+    Deflate const deflate(Deflate::Format::ZLib, Deflate::Level::BestCompression);
+    vector<uint8_t> payload;
+    TEST(deflate(buffer.data(), buffer.size(), back_inserter(payload)), ());
+    TEST_LESS(payload.size(), clientIdSize / 100, ());
+    return payload;
+  };
+
+  Protocol::DevicesData devices;
+  size_t const kSmallSize = Protocol::kMaxDataBatchSize / 2;
+  TEST(Protocol::DecodeDataBatchPacket(Protocol::PacketType::DataBatchV0, makePayload(kSmallSize),
+                                       devices), ());
+  TEST_EQUAL(devices.size(), 1, ());
+  TEST_EQUAL(devices[0].m_clientId.size(), kSmallSize, ());
+
+  TEST(!Protocol::DecodeDataBatchPacket(Protocol::PacketType::DataBatchV0,
+                                        makePayload(Protocol::kMaxDataBatchSize), devices), ());
+  TEST(devices.empty(), ());
+}
+
+UNIT_TEST(Protocol_PacketStreamDecoder)
+{
+  using Container = Protocol::DataElementsVec;
+
+  Container points;
+  points.push_back(Container::value_type(1, ms::LatLon(10, 10), 1));
+  Protocol::DevicesData devices = {{"device", points}};
+
+  vector<uint8_t> stream;
+  for (auto const & packet : {Protocol::CreateAuthPacket("ABC"),
+                              Protocol::CreateDataPacket(points, Protocol::PacketType::CurrentData),
+                              Protocol::CreateDataBatchPacket(devices, Protocol::PacketType::CurrentDataBatch)})
+  {
+    stream.insert(stream.end(), packet.begin(), packet.end());
+  }
+
+  for (size_t const chunkSize : {size_t(1), size_t(3), size_t(7), stream.size()})
+  {
+    PacketStreamDecoder decoder;
+    vector<Protocol::PacketType> types;
+    vector<vector<uint8_t>> payloads;
+    Protocol::PacketType type;
+    vector<uint8_t> payload;
+    for (size_t i = 0; i < stream.size(); i += chunkSize)
+    {
+      decoder.Append(stream.data() + i, min(chunkSize, stream.size() - i));
+      while (decoder.NextPacket(type, payload))
+      {
+        types.push_back(type);
+        payloads.push_back(payload);
+      }
+    }
+
+    TEST_EQUAL(decoder.GetPendingSize(), 0, ());
+    TEST_EQUAL(types, vector<Protocol::PacketType>({Protocol::PacketType::AuthV0,
+                                                    Protocol::PacketType::DataV1,
+                                                    Protocol::PacketType::DataBatchV0}), ());
+    TEST_EQUAL(Protocol::DecodeAuthPacket(types[0], payloads[0]), "ABC", ());
+    TEST_EQUAL(Protocol::DecodeDataPacket(types[1], payloads[1]).size(), 1, ());
+    Protocol::DevicesData result;
+    TEST(Protocol::DecodeDataBatchPacket(types[2], payloads[2], result), ());
+    TEST_EQUAL(result.size(), 1, ());
+    TEST_EQUAL(result[0].m_clientId, "device", ());
+  }
+}
@@ -85,6 +85,95 @@ TrafficInfo::RoadSegmentId::RoadSegmentId(uint32_t fid, uint16_t idx, uint8_t di
 {
 }
 
+// TrafficInfo::Coloring ----------------------------------------------------------------------
+TrafficInfo::Coloring::Coloring(initializer_list<ValueType> init) : m_entries(init)
+{
+  // The same as std::map: the first of equal segments is kept.
+  stable_sort(m_entries.begin(), m_entries.end(),
+              [](ValueType const & l, ValueType const & r) { return l.first < r.first; });
+  m_entries.erase(unique(m_entries.begin(), m_entries.end(),
+                         [](ValueType const & l, ValueType const & r) { return l.first == r.first; }),
+                  m_entries.end());
+}
+
+void TrafficInfo::Coloring::Insert(RoadSegmentId const & id, SpeedGroup speedGroup)
+{
+  if (m_entries.empty() || m_entries.back().first < id)
+  {
+    m_entries.emplace_back(id, speedGroup);
+    return;
+  }
+
+  auto const it = lower_bound(m_entries.begin(), m_entries.end(), id,
+                              [](ValueType const & l, RoadSegmentId const & r) { return l.first < r; });
+  if (it != m_entries.end() && it->first == id)
+    it->second = speedGroup;
+  else
+    m_entries.emplace(it, id, speedGroup);
+}
+
+size_t TrafficInfo::Coloring::Update(vector<RoadSegmentId> const & keys,
+                                     vector<SpeedGroup> const & values)
+{
+  CHECK_EQUAL(keys.size(), values.size(), ());
+  ASSERT(is_sorted(keys.begin(), keys.end()), ());
+
+  size_t numChanged = 0;
+  bool sameSegments = true;
+  auto it = m_entries.begin();
+  for (size_t i = 0; i < keys.size(); ++i)
+  {
+    for (; it != m_entries.end() && it->first < keys[i]; ++it)
+    {
+      sameSegments = false;
+      ++numChanged;
+    }
+
+    bool const wasKnown = it != m_entries.end() && it->first == keys[i];
+    bool const isKnown = values[i] != SpeedGroup::Unknown;
+    if (wasKnown != isKnown)
+    {
+      sameSegments = false;
+      ++numChanged;
+    }
+    else if (isKnown && it->second != values[i])
+    {
+      it->second = values[i];
+      ++numChanged;
+    }
+
+    if (wasKnown)
+      ++it;
+  }
+
+  if (it != m_entries.end())
+  {
+    sameSegments = false;
+    numChanged += static_cast<size_t>(m_entries.end() - it);
+  }
+
+  if (!sameSegments)
+  {
+    m_entries.clear();
+    for (size_t i = 0; i < keys.size(); ++i)
+    {
+      if (values[i] != SpeedGroup::Unknown)
+        m_entries.emplace_back(keys[i], values[i]);
+    }
+  }
+
+  return numChanged;
+}
+
+TrafficInfo::Coloring::ConstIterator TrafficInfo::Coloring::find(RoadSegmentId const & id) const
+{
+  auto const it = lower_bound(m_entries.cbegin(), m_entries.cend(), id,
+                              [](ValueType const & l, RoadSegmentId const & r) { return l.first < r; });
+  if (it != m_entries.cend() && it->first == id)
+    return it;
+  return m_entries.cend();
+}
+
 // TrafficInfo --------------------------------------------------------------------------------
 
 // static
@@ -149,6 +238,7 @@ void TrafficInfo::SetTrafficKeysForTesting(vector<RoadSegmentId> const & keys)
 
 bool TrafficInfo::ReceiveTrafficData(string & etag)
 {
+  m_changedSegmentsCount = 0;
   vector<SpeedGroup> values;
   switch (ReceiveTrafficValues(etag, values))
   {
@@ -205,17 +295,18 @@ void TrafficInfo::CombineColorings(vector<TrafficInfo::RoadSegmentId> const & ke
 #ifdef DEBUG
   size_t numUnexpectedKeys = knownColors.size();
 #endif
+  ASSERT(is_sorted(keys.begin(), keys.end()), ());
   for (auto const & key : keys)
   {
     auto it = knownColors.find(key);
     if (it == knownColors.end())
     {
-      result[key] = SpeedGroup::Unknown;
+      result.Insert(key, SpeedGroup::Unknown);
       ++numUnknown;
     }
     else
     {
-      result[key] = it->second;
+      result.Insert(key, it->second);
       ASSERT_GREATER(numUnexpectedKeys--, 0, ());
       ++numKnown;
     }
@@ -477,23 +568,20 @@ TrafficInfo::ServerDataStatus TrafficInfo::ReceiveTrafficValues(string & etag, v
 
 bool TrafficInfo::UpdateTrafficData(vector<SpeedGroup> const & values)
 {
-  m_coloring.clear();
-
   if (m_keys.size() != values.size())
   {
     LOG(LWARNING,
         ("The number of received traffic values does not correspond to the number of keys:",
          m_keys.size(), "keys", values.size(), "values."));
+    m_changedSegmentsCount = m_coloring.size();
+    m_coloring.clear();
     m_availability = Availability::NoData;
     return false;
   }
 
-  for (size_t i = 0; i < m_keys.size(); ++i)
-  {
-    if (values[i] != SpeedGroup::Unknown)
-      m_coloring.emplace(m_keys[i], values[i]);
-  }
-
+  m_changedSegmentsCount = m_coloring.Update(m_keys, values);
+  LOG(LDEBUG, ("Traffic of", m_keys.size(), "road segments is updated,", m_changedSegmentsCount,
+               "changed."));
   return true;
 }
 
@@ -4,8 +4,10 @@
 
 #include "indexer/mwm_set.hpp"
 
+#include <cstddef>
 #include <cstdint>
-#include <map>
+#include <initializer_list>
+#include <utility>
 #include <vector>
 
 namespace platform
@@ -71,8 +73,43 @@ public:
     uint8_t m_dir : 1;
   };
 
-  // todo(@m) unordered_map?
-  using Coloring = std::map<RoadSegmentId, SpeedGroup>;
+  // The mapping from road segments to speed groups. It's a flat array sorted by segments,
+  // i.e. in the order of the traffic keys, so a lookup is a binary search over contiguous memory.
+  class Coloring
+  {
+  public:
+    using ValueType = std::pair<RoadSegmentId, SpeedGroup>;
+    using ConstIterator = std::vector<ValueType>::const_iterator;
+
+    Coloring() = default;
+    Coloring(std::initializer_list<ValueType> init);
+
+    // Adds the speed group of |id| or replaces the existing one.
+    // It's O(1) when segments are inserted in the ascending order.
+    void Insert(RoadSegmentId const & id, SpeedGroup speedGroup);
+
+    // Sets speed groups of segments |keys| to |values| and removes segments with
+    // SpeedGroup::Unknown. |keys| must be sorted. When the set of segments with known speed
+    // groups is unchanged the speed groups are updated in place. Returns the number of
+    // segments whose speed group is changed.
+    size_t Update(std::vector<RoadSegmentId> const & keys, std::vector<SpeedGroup> const & values);
+
+    ConstIterator find(RoadSegmentId const & id) const;
+
+    ConstIterator begin() const { return m_entries.cbegin(); }
+    ConstIterator end() const { return m_entries.cend(); }
+    ConstIterator cbegin() const { return m_entries.cbegin(); }
+    ConstIterator cend() const { return m_entries.cend(); }
+
+    size_t size() const { return m_entries.size(); }
+    bool empty() const { return m_entries.empty(); }
+    void clear() { m_entries.clear(); }
+
+    bool operator==(Coloring const & rhs) const { return m_entries == rhs.m_entries; }
+
+  private:
+    std::vector<ValueType> m_entries;
+  };
 
   TrafficInfo() = default;
 
@@ -96,6 +133,8 @@ public:
   MwmSet::MwmId const & GetMwmId() const { return m_mwmId; }
   Coloring const & GetColoring() const { return m_coloring; }
   Availability GetAvailability() const { return m_availability; }
+  // Returns the number of segments whose speed group is changed by the last ReceiveTrafficData().
+  size_t GetChangedSegmentsCount() const { return m_changedSegmentsCount; }
 
   // Extracts RoadSegmentIds from mwm and stores them in a sorted order.
   static void ExtractTrafficKeys(std::string const & mwmPath, std::vector<RoadSegmentId> & result);
@@ -155,6 +194,7 @@ private:
   MwmSet::MwmId m_mwmId;
   Availability m_availability = Availability::Unknown;
   int64_t m_currentDataVersion = 0;
+  size_t m_changedSegmentsCount = 0;
 };
 
 class TrafficObserver
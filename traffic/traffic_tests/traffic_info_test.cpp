@@ -118,6 +118,58 @@ UNIT_TEST(TrafficInfo_Serialization)
   }
 }
 
+UNIT_TEST(TrafficInfo_Coloring)
+{
+  using RoadSegmentId = TrafficInfo::RoadSegmentId;
+
+  TrafficInfo::Coloring coloring = {
+      {RoadSegmentId(5, 0, 0), SpeedGroup::G2},
+      {RoadSegmentId(1, 0, 1), SpeedGroup::G3},
+      {RoadSegmentId(1, 0, 0), SpeedGroup::G1},
+      {RoadSegmentId(1, 0, 0), SpeedGroup::G4},
+  };
+
+  TEST_EQUAL(coloring.size(), 3, ());
+  TEST(is_sorted(coloring.begin(), coloring.end()), ());
+  TEST_EQUAL(coloring.find(RoadSegmentId(1, 0, 0))->second, SpeedGroup::G1, ());
+  TEST(coloring.find(RoadSegmentId(1, 1, 0)) == coloring.end(), ());
+
+  coloring.Insert(RoadSegmentId(7, 0, 0), SpeedGroup::G0);
+  coloring.Insert(RoadSegmentId(3, 0, 0), SpeedGroup::G5);
+  coloring.Insert(RoadSegmentId(5, 0, 0), SpeedGroup::TempBlock);
+  TEST(coloring == TrafficInfo::Coloring({{RoadSegmentId(1, 0, 0), SpeedGroup::G1},
+                                          {RoadSegmentId(1, 0, 1), SpeedGroup::G3},
+                                          {RoadSegmentId(3, 0, 0), SpeedGroup::G5},
+                                          {RoadSegmentId(5, 0, 0), SpeedGroup::TempBlock},
+                                          {RoadSegmentId(7, 0, 0), SpeedGroup::G0}}),
+       ());
+
+  vector<RoadSegmentId> const keys = {RoadSegmentId(1, 0, 0), RoadSegmentId(1, 0, 1),
+                                      RoadSegmentId(3, 0, 0), RoadSegmentId(5, 0, 0),
+                                      RoadSegmentId(7, 0, 0)};
+
+  // The same segments are known, the speed groups are updated in place.
+  TEST_EQUAL(coloring.Update(keys, {SpeedGroup::G1, SpeedGroup::G2, SpeedGroup::G5,
+                                    SpeedGroup::G2, SpeedGroup::G0}),
+             2, ());
+  TEST_EQUAL(coloring.find(RoadSegmentId(1, 0, 1))->second, SpeedGroup::G2, ());
+  TEST_EQUAL(coloring.find(RoadSegmentId(5, 0, 0))->second, SpeedGroup::G2, ());
+
+  TEST_EQUAL(coloring.Update(keys, {SpeedGroup::Unknown, SpeedGroup::G2, SpeedGroup::G5,
+                                    SpeedGroup::Unknown, SpeedGroup::G4}),
+             3, ());
+  TEST(coloring == TrafficInfo::Coloring({{RoadSegmentId(1, 0, 1), SpeedGroup::G2},
+                                          {RoadSegmentId(3, 0, 0), SpeedGroup::G5},
+                                          {RoadSegmentId(7, 0, 0), SpeedGroup::G4}}),
+       ());
+
+  TEST_EQUAL(coloring.Update(keys, {SpeedGroup::G0, SpeedGroup::G2, SpeedGroup::G5,
+                                    SpeedGroup::Unknown, SpeedGroup::G4}),
+             1, ());
+  TEST_EQUAL(coloring.size(), 4, ());
+  TEST_EQUAL(coloring.find(RoadSegmentId(1, 0, 0))->second, SpeedGroup::G0, ());
+}
+
 UNIT_TEST(TrafficInfo_UpdateTrafficData)
 {
   vector<TrafficInfo::RoadSegmentId> const keys = {
@@ -138,10 +190,15 @@ UNIT_TEST(TrafficInfo_UpdateTrafficData)
   info.SetTrafficKeysForTesting(keys);
 
   TEST(info.UpdateTrafficData(values1), ());
+  TEST_EQUAL(info.GetChangedSegmentsCount(), 3, ());
   for (size_t i = 0; i < keys.size(); ++i)
     TEST_EQUAL(info.GetSpeedGroup(keys[i]), values1[i], ());
 
+  TEST(info.UpdateTrafficData(values1), ());
+  TEST_EQUAL(info.GetChangedSegmentsCount(), 0, ());
+
   TEST(info.UpdateTrafficData(values2), ());
+  TEST_EQUAL(info.GetChangedSegmentsCount(), 3, ());
   for (size_t i = 0; i < keys.size(); ++i)
     TEST_EQUAL(info.GetSpeedGroup(keys[i]), values2[i], ());
 }